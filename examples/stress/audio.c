@@ -0,0 +1,91 @@
+// Voices mixed through ma_audio_commit. Windowless, runs without a display or an audio device.
+#define OSLO_IMPL
+#include "../../oslo.h"
+#include "stress.h"
+
+#ifndef STRESS_VOICE_COUNT
+    #define STRESS_VOICE_COUNT 1000
+#endif
+
+// Mixed per frame, a bit more than a 60 Hz frame at 44.1 kHz
+#define STRESS_MIX_FRAMES 1024
+#define STRESS_SAMPLE_RATE 44100
+
+typedef struct audio_data_t
+{
+    // Stands in for the playback device, ma_audio_commit only reads its channels and format
+    ma_device device;
+    s16 output[STRESS_MIX_FRAMES * 2];
+} audio_data_t;
+
+static void audio_init(void* user_data)
+{
+    audio_data_t* data = (audio_data_t*)user_data;
+    data->device.playback.channels = 2;
+    data->device.playback.format = ma_format_s16;
+
+    // Only the commits below should mix, not the device thread when a device was found
+    miniaudio_data_t* ma = (miniaudio_data_t*)instance->audio.user_data;
+    if (ma_device_is_started(&ma->device))
+    {
+        ma_device_stop(&ma->device);
+    }
+
+    // One second of stereo square wave, freed with the other sources at shutdown
+    oslo_audio_source_t src = default_val();
+    src.channels = 2;
+    src.sample_rate = STRESS_SAMPLE_RATE;
+    src.sample_count = STRESS_SAMPLE_RATE * 2;
+    src.samples = oslo_malloc(src.sample_count * sizeof(s16));
+    for (s32 i = 0; i < src.sample_count; ++i)
+    {
+        ((s16*)src.samples)[i] = (i / 200) % 2 ? 8000 : -8000;
+    }
+
+    oslo_audio_mutex_lock();
+    oslo_audio_source_id source = oslo_slot_array_insert(instance->audio.sources, src);
+    oslo_audio_mutex_unlock();
+
+    for (u32 i = 0; i < STRESS_VOICE_COUNT; ++i)
+    {
+        oslo_audio_instance_t voice = default_val();
+        voice.src = source;
+        voice.volume = 1.0f / STRESS_VOICE_COUNT;
+        voice.pitch = 0.5f + (float)(i % 100) / 100.0f;
+        voice.loop = true;
+        voice.persistent = true;
+        voice.playing = true;
+        oslo_audio_create_instance(&voice);
+    }
+}
+
+static void audio_update(void* user_data)
+{
+    audio_data_t* data = (audio_data_t*)user_data;
+    ma_audio_commit(&data->device, data->output, NULL, STRESS_MIX_FRAMES);
+}
+
+static void audio_shutdown(void* user_data)
+{
+    (void)user_data;
+
+    char scene[64];
+    snprintf(scene, sizeof(scene), "audio_%u", (u32)STRESS_VOICE_COUNT);
+    stress_report(scene);
+}
+
+oslo_desc_t oslo_main()
+{
+    static audio_data_t data;
+
+    return (oslo_desc_t)
+    {
+        .window_title = "Stress: audio",
+        .windowless = true,
+        .max_frames = STRESS_FRAMES,
+        .user_data = &data,
+        .init = audio_init,
+        .update = audio_update,
+        .shutdown = audio_shutdown
+    };
+}
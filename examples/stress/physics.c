@@ -0,0 +1,72 @@
+// A pile of bodies settling on a floor through oslo_physics_update. Windowless, runs without a display.
+#define OSLO_IMPL
+#include "../../oslo.h"
+#define OSLO_PHYSICS_IMPL
+#include "../../utils/oslo_physics.h"
+#include "stress.h"
+
+#ifndef STRESS_BODY_COUNT
+    #define STRESS_BODY_COUNT 10000
+#endif
+
+#define STRESS_COLUMNS 100
+#define STRESS_RADIUS 4.0f
+
+typedef struct physics_data_t
+{
+    oslo_physics_t physics;
+} physics_data_t;
+
+static void physics_init(void* user_data)
+{
+    physics_data_t* data = (physics_data_t*)user_data;
+    oslo_physics_init(&data->physics);
+
+    // Neighbours overlap a little, so the pile has contacts from the first step on
+    float spacing = STRESS_RADIUS * 1.9f;
+    float width = STRESS_COLUMNS * spacing;
+    float floor_y = (STRESS_BODY_COUNT / STRESS_COLUMNS + 1) * spacing;
+
+    // Static floor, mass 0
+    oslo_physics_body_handle floor = oslo_physics_add_body(&data->physics, v2(width * 0.5f, floor_y + 16.0f), 0.0f);
+    oslo_physics_body_set_box(&data->physics, floor, v2(width, 16.0f), v2(0.0f, 0.0f));
+
+    for (u32 i = 0; i < STRESS_BODY_COUNT; ++i)
+    {
+        vec2 position = v2((i % STRESS_COLUMNS) * spacing + (i / STRESS_COLUMNS % 2) * STRESS_RADIUS, (i / STRESS_COLUMNS) * spacing);
+        oslo_physics_body_handle body = oslo_physics_add_body(&data->physics, position, 1.0f);
+        oslo_physics_body_set_circle(&data->physics, body, STRESS_RADIUS, v2(0.0f, 0.0f));
+    }
+}
+
+static void physics_update(void* user_data)
+{
+    physics_data_t* data = (physics_data_t*)user_data;
+    oslo_physics_update(&data->physics);
+}
+
+static void physics_shutdown(void* user_data)
+{
+    physics_data_t* data = (physics_data_t*)user_data;
+    oslo_physics_shutdown(&data->physics);
+
+    char scene[64];
+    snprintf(scene, sizeof(scene), "physics_%u", (u32)STRESS_BODY_COUNT);
+    stress_report(scene);
+}
+
+oslo_desc_t oslo_main()
+{
+    static physics_data_t data;
+
+    return (oslo_desc_t)
+    {
+        .window_title = "Stress: physics",
+        .windowless = true,
+        .max_frames = STRESS_FRAMES,
+        .user_data = &data,
+        .init = physics_init,
+        .update = physics_update,
+        .shutdown = physics_shutdown
+    };
+}
@@ -0,0 +1,68 @@
+// Sprites through oslo_gfx_draw_texture, needs GL: run under a display or a virtual framebuffer.
+// Build with -DSTRESS_SPRITE_COUNT=100000 or 1000000 for the larger scenes.
+#define OSLO_IMPL
+#include "../../oslo.h"
+#include "stress.h"
+
+#ifndef STRESS_SPRITE_COUNT
+    #define STRESS_SPRITE_COUNT 10000
+#endif
+
+#define STRESS_WIDTH 1280
+#define STRESS_HEIGHT 720
+
+typedef struct sprites_data_t
+{
+    oslo_texture_id texture;
+} sprites_data_t;
+
+static void sprites_init(void* user_data)
+{
+    sprites_data_t* data = (sprites_data_t*)user_data;
+
+    u32 pixels[16 * 16];
+    memset(pixels, 0xFF, sizeof(pixels));
+    data->texture = oslo_gfx_create_texture(pixels, 16, 16, 4);
+}
+
+static void sprites_update(void* user_data)
+{
+    sprites_data_t* data = (sprites_data_t*)user_data;
+    float rotation = (float)oslo_get_frame_count() * 0.01f;
+
+    oslo_gfx_begin();
+    for (u32 i = 0; i < STRESS_SPRITE_COUNT; ++i)
+    {
+        vec2 position = v2((float)((i * 37u) % STRESS_WIDTH), (float)((i * 101u) % STRESS_HEIGHT));
+        oslo_gfx_draw_texture(position, rotation + (float)i, v2(8.0f, 8.0f), OSLO_COLOR_WHITE, data->texture);
+    }
+    oslo_gfx_end();
+}
+
+static void sprites_shutdown(void* user_data)
+{
+    sprites_data_t* data = (sprites_data_t*)user_data;
+    oslo_gfx_unload_texture(data->texture);
+
+    char scene[64];
+    snprintf(scene, sizeof(scene), "sprites_%u", (u32)STRESS_SPRITE_COUNT);
+    stress_report(scene);
+}
+
+oslo_desc_t oslo_main()
+{
+    static sprites_data_t data;
+
+    return (oslo_desc_t)
+    {
+        .window_width = STRESS_WIDTH,
+        .window_height = STRESS_HEIGHT,
+        .window_title = "Stress: sprites",
+        .headless = true,
+        .max_frames = STRESS_FRAMES,
+        .user_data = &data,
+        .init = sprites_init,
+        .update = sprites_update,
+        .shutdown = sprites_shutdown
+    };
+}
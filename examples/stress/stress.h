@@ -0,0 +1,67 @@
+#pragma once
+
+// Shared by the stress scenes. Each scene runs STRESS_FRAMES frames, then stress_report() prints
+// the p50/p99 frame times of the last OSLO_FRAME_HISTORY_SIZE frames and compares them against
+// the scene's line in the budget file. Over budget, or no budget at all, exits with 1.
+
+// Frames run before the measured ones, they fall out of the frame history
+#ifndef STRESS_WARMUP_FRAMES
+    #define STRESS_WARMUP_FRAMES 16
+#endif
+
+#define STRESS_FRAMES (STRESS_WARMUP_FRAMES + OSLO_FRAME_HISTORY_SIZE)
+
+// Relative to the working directory, the scenes are meant to be run from examples/stress
+#ifndef STRESS_BUDGET_FILE
+    #define STRESS_BUDGET_FILE "budgets.txt"
+#endif
+
+// Lines are "<scene> <p50 ms> <p99 ms>", '#' starts a comment
+static bool stress_find_budget(const char* scene, double* out_p50_ms, double* out_p99_ms)
+{
+    FILE* file = fopen(STRESS_BUDGET_FILE, "r");
+    if (file == NULL)
+    {
+        return false;
+    }
+
+    char line[256];
+    char name[128];
+    bool found = false;
+    while (!found && fgets(line, sizeof(line), file) != NULL)
+    {
+        if (line[0] == '#')
+        {
+            continue;
+        }
+
+        found = sscanf(line, "%127s %lf %lf", name, out_p50_ms, out_p99_ms) == 3 && strcmp(name, scene) == 0;
+    }
+
+    fclose(file);
+    return found;
+}
+
+// Call from the shutdown callback
+static void stress_report(const char* scene)
+{
+    const oslo_frame_history_t* history = oslo_get_frame_history();
+    double p50_ms = oslo_frame_history_percentile(history, 50.0f) / 1000000.0;
+    double p99_ms = oslo_frame_history_percentile(history, 99.0f) / 1000000.0;
+    printf("%s: p50 %.3f ms, p99 %.3f ms over %u frames\n", scene, p50_ms, p99_ms, history->count);
+
+    double budget_p50_ms = 0.0;
+    double budget_p99_ms = 0.0;
+    if (!stress_find_budget(scene, &budget_p50_ms, &budget_p99_ms))
+    {
+        printf("%s: no budget in %s\n", scene, STRESS_BUDGET_FILE);
+        oslo_set_exit_code(1);
+        return;
+    }
+
+    if (p50_ms > budget_p50_ms || p99_ms > budget_p99_ms)
+    {
+        printf("%s: over budget (p50 %.3f ms, p99 %.3f ms)\n", scene, budget_p50_ms, budget_p99_ms);
+        oslo_set_exit_code(1);
+    }
+}
@@ -0,0 +1,90 @@
+// Text glyphs through oslo_gfx_text, needs GL: run under a display or a virtual framebuffer.
+// The font is a generated fixed width grid so the scene doesn't depend on a font file.
+#define OSLO_IMPL
+#include "../../oslo.h"
+#include "stress.h"
+
+#ifndef STRESS_GLYPH_COUNT
+    #define STRESS_GLYPH_COUNT 10000
+#endif
+
+#define STRESS_LINE_LENGTH 100
+#define STRESS_ATLAS_SIZE 512
+#define STRESS_CELL_SIZE 32
+
+typedef struct text_data_t
+{
+    oslo_font_t font;
+    char line[STRESS_LINE_LENGTH + 1];
+} text_data_t;
+
+static void text_init(void* user_data)
+{
+    text_data_t* data = (text_data_t*)user_data;
+
+    // 16x6 cells for the 96 printable characters oslo_gfx_text looks up
+    u32 columns = STRESS_ATLAS_SIZE / STRESS_CELL_SIZE;
+    for (u32 i = 0; i < 96; ++i)
+    {
+        oslo_baked_char_t* glyph = &data->font.glyphs[i];
+        glyph->x0 = (unsigned short)((i % columns) * STRESS_CELL_SIZE);
+        glyph->y0 = (unsigned short)((i / columns) * STRESS_CELL_SIZE);
+        glyph->x1 = (unsigned short)(glyph->x0 + STRESS_CELL_SIZE);
+        glyph->y1 = (unsigned short)(glyph->y0 + STRESS_CELL_SIZE);
+        glyph->xoff = 0.0f;
+        glyph->yoff = -(float)STRESS_CELL_SIZE;
+        glyph->xadvance = STRESS_CELL_SIZE / 2.0f;
+    }
+
+    size_t atlas_bytes = STRESS_ATLAS_SIZE * STRESS_ATLAS_SIZE * 4;
+    void* atlas = oslo_malloc(atlas_bytes);
+    memset(atlas, 0xFF, atlas_bytes);
+    data->font.texture = oslo_gfx_create_texture(atlas, STRESS_ATLAS_SIZE, STRESS_ATLAS_SIZE, 4);
+    oslo_free(atlas);
+
+    for (u32 i = 0; i < STRESS_LINE_LENGTH; ++i)
+    {
+        data->line[i] = (char)(33 + i % 94);
+    }
+    data->line[STRESS_LINE_LENGTH] = '\0';
+}
+
+static void text_update(void* user_data)
+{
+    text_data_t* data = (text_data_t*)user_data;
+
+    oslo_gfx_begin();
+    for (u32 i = 0; i < STRESS_GLYPH_COUNT / STRESS_LINE_LENGTH; ++i)
+    {
+        oslo_gfx_text(data->line, v2(0.0f, (float)(i % 64) * 12.0f), 12.0f, OSLO_COLOR_WHITE, &data->font);
+    }
+    oslo_gfx_end();
+}
+
+static void text_shutdown(void* user_data)
+{
+    text_data_t* data = (text_data_t*)user_data;
+    oslo_gfx_unload_texture(data->font.texture);
+
+    char scene[64];
+    snprintf(scene, sizeof(scene), "text_%u", (u32)STRESS_GLYPH_COUNT);
+    stress_report(scene);
+}
+
+oslo_desc_t oslo_main()
+{
+    static text_data_t data;
+
+    return (oslo_desc_t)
+    {
+        .window_width = 1280,
+        .window_height = 720,
+        .window_title = "Stress: text",
+        .headless = true,
+        .max_frames = STRESS_FRAMES,
+        .user_data = &data,
+        .init = text_init,
+        .update = text_update,
+        .shutdown = text_shutdown
+    };
+}
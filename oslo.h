@@ -25,6 +25,9 @@
 #include <ctype.h>      // tolower
 #include <assert.h>     // assert
 #include <malloc.h>     // alloca/_alloca
+#ifndef _WIN32
+#include <unistd.h>     // sysconf
+#endif
 
 #include "oslo_math.h"
 
@@ -105,6 +108,95 @@
 
 #pragma endregion
 
+#pragma region ALLOCATOR
+/*===================================
+// Allocator
+===================================*/
+
+// Every allocation made by oslo goes through an allocator. Containers take an optional allocator
+// on creation and fall back to the global one, which wraps malloc/realloc/free unless replaced
+// through oslo_desc_t.allocator. Allocators used by the job system, the audio thread or the
+// string interner must be thread safe.
+typedef struct oslo_allocator_t
+{
+    void* (*alloc)(size_t size, void* user_data);
+    void* (*realloc)(void* ptr, size_t size, void* user_data);
+    void (*free)(void* ptr, void* user_data);
+    void* user_data;
+} oslo_allocator_t;
+
+OSLO_API_DECL const oslo_allocator_t* oslo_get_allocator();
+// Copies the allocator. Set it before anything is allocated, memory owned by containers without
+// their own allocator is released through whichever global allocator is current at that time.
+OSLO_API_DECL void oslo_set_allocator(const oslo_allocator_t* allocator);
+
+// A NULL allocator means the global one
+OSLO_API_DECL void* oslo_allocator_alloc(const oslo_allocator_t* allocator, size_t size);
+OSLO_API_DECL void* oslo_allocator_realloc(const oslo_allocator_t* allocator, void* ptr, size_t size);
+OSLO_API_DECL void oslo_allocator_free(const oslo_allocator_t* allocator, void* ptr);
+
+#define oslo_malloc(__SZ)\
+    oslo_allocator_alloc(NULL, (__SZ))
+
+#define oslo_realloc(__P, __SZ)\
+    oslo_allocator_realloc(NULL, (__P), (__SZ))
+
+#define oslo_free(__P)\
+    oslo_allocator_free(NULL, (__P))
+
+#pragma endregion
+
+#pragma region MEMORY_TRACKING
+/*===================================
+// Memory Tracking
+===================================*/
+
+// Built with OSLO_MEMORY_TRACKING defined, allocations through the global allocator carry a 16 byte
+// header with their size and category, and feed the per category stats below. The category is the
+// calling thread's current one, set by the subsystem doing the work. Memory from containers with
+// their own allocator is not tracked, the blocks they get from the global allocator are.
+// Without OSLO_MEMORY_TRACKING all the stats stay at zero.
+
+typedef enum oslo_memory_category
+{
+    OSLO_MEMORY_GENERAL,
+    // Growth of dyn arrays, slot arrays, hash tables and pools
+    OSLO_MEMORY_CONTAINERS,
+    // Arena blocks, including the frame arena
+    OSLO_MEMORY_SCRATCH,
+    OSLO_MEMORY_STRINGS,
+    OSLO_MEMORY_GFX,
+    OSLO_MEMORY_FONTS,
+    OSLO_MEMORY_AUDIO,
+    OSLO_MEMORY_JOBS,
+    OSLO_MEMORY_CATEGORY_COUNT
+} oslo_memory_category;
+
+typedef struct oslo_memory_stats_t
+{
+    int64_t live_bytes;
+    int64_t peak_bytes;
+    int64_t live_allocs;
+    uint64_t total_allocs;
+    // Allocations and reallocations during the last completed frame
+    uint32_t frame_allocs;
+    // Estimated memory owned by the driver, textures count width * height * 4
+    int64_t gpu_bytes;
+} oslo_memory_stats_t;
+
+// Returns the previous category, hand it back to oslo_memory_pop_category
+OSLO_API_DECL oslo_memory_category oslo_memory_push_category(oslo_memory_category category);
+OSLO_API_DECL void oslo_memory_pop_category(oslo_memory_category previous);
+OSLO_API_DECL oslo_memory_category oslo_memory_current_category();
+
+OSLO_API_DECL void oslo_memory_get_stats(oslo_memory_category category, oslo_memory_stats_t* out_stats);
+OSLO_API_DECL void oslo_memory_get_total_stats(oslo_memory_stats_t* out_stats);
+OSLO_API_DECL const char* oslo_memory_category_name(oslo_memory_category category);
+// For memory living outside the heap, bytes is negative when released
+OSLO_API_DECL void oslo_memory_track_gpu(oslo_memory_category category, int64_t bytes);
+
+#pragma endregion
+
 #pragma region DYN_ARRAY
 /*===================================
 // Dynamic Array
@@ -114,6 +206,8 @@ typedef struct oslo_dyn_array
 {
     int32_t size;
     int32_t capacity;
+    // NULL uses the global allocator
+    const oslo_allocator_t* allocator;
 } oslo_dyn_array;
 
 #define oslo_dyn_array_head(__ARR)\
@@ -140,6 +234,11 @@ OSLO_API_DECL void* oslo_dyn_array_resize_impl(void* arr, size_t sz, size_t amou
     oslo_dyn_array_resize_impl((__ARR), (__SZ ), oslo_dyn_array_capacity(__ARR) ? oslo_dyn_array_capacity(__ARR) * 2 : 1)
 
 OSLO_API_DECL void** oslo_dyn_array_init(void** arr, size_t val_len);
+OSLO_API_DECL void** oslo_dyn_array_init_allocator_impl(void** arr, size_t val_len, const oslo_allocator_t* allocator);
+
+// Creates the array with its own allocator, must come before the first push
+#define oslo_dyn_array_init_allocator(__ARR, __ALLOCATOR)\
+    oslo_dyn_array_init_allocator_impl((void**)&(__ARR), sizeof(*(__ARR)), (__ALLOCATOR))
 
 OSLO_API_DECL void oslo_dyn_array_push_data(void** arr, void* val, size_t val_len);
 
@@ -197,109 +296,307 @@ oslo_inline void oslo_dyn_array_set_data_i(void** arr, void* val, size_t val_len
 #define oslo_dyn_array_free(__ARR)\
     do {\
         if (__ARR) {\
-            free(oslo_dyn_array_head(__ARR));\
+            oslo_allocator_free(oslo_dyn_array_head(__ARR)->allocator, oslo_dyn_array_head(__ARR));\
             (__ARR) = NULL;\
         }\
     } while (0)
 
 #pragma endregion
 
+#pragma region ARENA
+/*===================================
+// Linear Arena
+===================================*/
+
+// Bump allocator. Memory is only released all at once by oslo_arena_reset. When the current block
+// runs out a new one is chained, and the next reset merges them into one block sized to the peak,
+// so a steady workload stops allocating after its first frames.
+
+#ifndef OSLO_ARENA_DEFAULT_ALIGN
+    #define OSLO_ARENA_DEFAULT_ALIGN    16
+#endif
+
+typedef struct oslo_arena_block_t
+{
+    struct oslo_arena_block_t* next;
+    size_t capacity;
+    size_t offset;
+} oslo_arena_block_t;
+
+typedef struct oslo_arena_t
+{
+    // Current block first
+    oslo_arena_block_t* blocks;
+    size_t block_size;
+    // Blocks are never merged past this size, bigger peaks keep chaining
+    size_t max_block_size;
+    // Bytes handed out since the last reset and the highest value seen
+    size_t used;
+    size_t peak;
+    // Where blocks come from, NULL uses the global allocator
+    const oslo_allocator_t* backing;
+    // Hands out arena memory to containers, free only gives back the most recent allocation
+    oslo_allocator_t allocator;
+} oslo_arena_t;
+
+OSLO_API_DECL void oslo_arena_init(oslo_arena_t* arena, size_t block_size, const oslo_allocator_t* backing);
+OSLO_API_DECL void oslo_arena_free(oslo_arena_t* arena);
+OSLO_API_DECL void oslo_arena_reset(oslo_arena_t* arena);
+OSLO_API_DECL void* oslo_arena_alloc_aligned(oslo_arena_t* arena, size_t size, size_t align);
+
+#define oslo_arena_alloc(__ARENA, __SZ)\
+    oslo_arena_alloc_aligned((__ARENA), (__SZ), OSLO_ARENA_DEFAULT_ALIGN)
+
+#define oslo_arena_allocator(__ARENA)\
+    ((const oslo_allocator_t*)&(__ARENA)->allocator)
+
+/*=== Frame Arena ===*/
+
+// Scratch memory reset by main at the start of every frame. Main thread only, and nothing allocated
+// from it may be kept across frames, including by async tasks that wait.
+OSLO_API_DECL oslo_arena_t* oslo_frame_arena();
+
+#define oslo_frame_alloc(__SZ)\
+    oslo_arena_alloc(oslo_frame_arena(), (__SZ))
+
+#define oslo_frame_alloc_aligned(__SZ, __ALIGN)\
+    oslo_arena_alloc_aligned(oslo_frame_arena(), (__SZ), (__ALIGN))
+
+#define oslo_frame_allocator()\
+    oslo_arena_allocator(oslo_frame_arena())
+
+// Dyn array living in the frame arena. Growing the most recent allocation extends it in place.
+#define oslo_frame_dyn_array(__T)\
+    oslo_dyn_array(__T)
+
+#define oslo_frame_dyn_array_init(__ARR)\
+    oslo_dyn_array_init_allocator(__ARR, oslo_frame_allocator())
+
+#pragma endregion
+
+#pragma region POOL
+/*===================================
+// Object Pool
+===================================*/
+
+// Fixed-size objects stored in chunks that never move, so pointers stay valid until the object is
+// deleted. Every slot is preceded by a word pointing back to its chunk, the low bit marks it alive.
+// Deleted slots are chained in a free list and reused first.
+
+#ifndef OSLO_POOL_DEFAULT_ALIGN
+    #define OSLO_POOL_DEFAULT_ALIGN     8
+#endif
+
+typedef struct oslo_pool_chunk_t
+{
+    struct oslo_pool_chunk_t* next;
+    uint32_t capacity;
+    // Slots handed out at least once, the rest of the chunk is untouched
+    uint32_t used;
+    // Live objects
+    uint32_t count;
+} oslo_pool_chunk_t;
+
+typedef struct oslo_pool_t
+{
+    oslo_pool_chunk_t* chunks;
+    oslo_pool_chunk_t* last;
+    void* free_list;
+    size_t elem_size;
+    // Bytes between the chunk header and the first slot header, and from a slot header to its object
+    size_t data_offset;
+    size_t header_size;
+    size_t stride;
+    uint32_t chunk_capacity;
+    uint32_t size;
+    const oslo_allocator_t* allocator;
+} oslo_pool_t;
+
+// Alignment up to 16 is supported
+OSLO_API_DECL void oslo_pool_init_func(oslo_pool_t* pool, size_t elem_size, size_t align, uint32_t chunk_capacity, const oslo_allocator_t* allocator);
+OSLO_API_DECL void oslo_pool_free(oslo_pool_t* pool);
+OSLO_API_DECL void oslo_pool_clear(oslo_pool_t* pool);
+// Returns zeroed memory
+OSLO_API_DECL void* oslo_pool_alloc_func(oslo_pool_t* pool);
+OSLO_API_DECL void oslo_pool_delete_func(oslo_pool_t* pool, void* ptr);
+
+#define oslo_pool_init(__POOL, __T, __CHUNK_CAPACITY)\
+    oslo_pool_init_func((__POOL), sizeof(__T), OSLO_POOL_DEFAULT_ALIGN, (__CHUNK_CAPACITY), NULL)
+
+#define oslo_pool_init_allocator(__POOL, __T, __CHUNK_CAPACITY, __ALLOCATOR)\
+    oslo_pool_init_func((__POOL), sizeof(__T), OSLO_POOL_DEFAULT_ALIGN, (__CHUNK_CAPACITY), (__ALLOCATOR))
+
+#define oslo_pool_new(__POOL, __T)\
+    ((__T*)oslo_pool_alloc_func(__POOL))
+
+#define oslo_pool_delete(__POOL, __PTR)\
+    oslo_pool_delete_func((__POOL), (__PTR))
+
+#define oslo_pool_size(__POOL)\
+    ((__POOL)->size)
+
+#define __oslo_pool_slot(__POOL, __CHUNK, __I)\
+    ((uint8_t*)(__CHUNK) + (__POOL)->data_offset + (size_t)(__I) * (__POOL)->stride)
+
+#define oslo_pool_chunk_alive(__POOL, __CHUNK, __I)\
+    ((*(uintptr_t*)__oslo_pool_slot(__POOL, __CHUNK, __I)) & 1)
+
+#define oslo_pool_chunk_getp(__POOL, __CHUNK, __I, __T)\
+    ((__T*)(__oslo_pool_slot(__POOL, __CHUNK, __I) + (__POOL)->header_size))
+
+// Walks chunk by chunk, slots inside a chunk are contiguous. Deleting the current object is safe.
+// break only leaves the inner loop.
+#define oslo_pool_for(__POOL, __CHUNK, __I)\
+    for (oslo_pool_chunk_t* __CHUNK = (__POOL)->chunks; __CHUNK != NULL; __CHUNK = __CHUNK->next)\
+        for (uint32_t __I = 0; __I < __CHUNK->used; ++__I)\
+            if (oslo_pool_chunk_alive(__POOL, __CHUNK, __I))
+
+#pragma endregion
+
+#pragma region VEC2_SOA
+/*===================================
+// Vec2 SoA Storage
+===================================*/
+
+// Allocates x and y for count elements in a single block. Both arrays start 32 byte aligned and
+// are padded to a multiple of 8 floats, so the SoA kernels run without misaligned loads.
+OSLO_API_DECL void oslo_vec2_soa_alloc(vec2_soa* soa, size_t count, const oslo_allocator_t* allocator);
+OSLO_API_DECL void oslo_vec2_soa_free(vec2_soa* soa, const oslo_allocator_t* allocator);
+
+#pragma endregion
+
 #pragma region SLOT_ARRAY
 /*===================================
 // Slot Array
 ===================================*/
 
+// Handles pack a slot index in the low bits and a generation in the high bits. Erasing bumps the
+// generation of the slot, so handles to erased elements never alias the element reusing the slot.
 #define oslo_slot_array_INVALID_HANDLE    UINT32_MAX
 
-#define oslo_slot_array_handle_valid(__SA, __ID)\
-    (__ID < oslo_dyn_array_size((__SA)->indices) && (__SA)->indices[__ID] != oslo_slot_array_INVALID_HANDLE)
+#ifndef OSLO_SLOT_ARRAY_INDEX_BITS
+    #define OSLO_SLOT_ARRAY_INDEX_BITS    20
+#endif
+
+#define oslo_slot_array_INDEX_MASK    ((1u << OSLO_SLOT_ARRAY_INDEX_BITS) - 1)
+#define oslo_slot_array_GENERATION_MASK    (UINT32_MAX >> OSLO_SLOT_ARRAY_INDEX_BITS)
+
+#define oslo_slot_array_handle_index(__ID)\
+    ((uint32_t)(__ID) & oslo_slot_array_INDEX_MASK)
+
+#define oslo_slot_array_handle_generation(__ID)\
+    ((uint32_t)(__ID) >> OSLO_SLOT_ARRAY_INDEX_BITS)
 
+// Generation of the slot's next occupant. The last generation of the last slot would pack to
+// oslo_slot_array_INVALID_HANDLE, so that slot wraps one early.
+#define oslo_slot_array_next_generation(__GEN, __IDX)\
+    ((((__GEN) + 1) & oslo_slot_array_GENERATION_MASK) == oslo_slot_array_GENERATION_MASK && (__IDX) == oslo_slot_array_INDEX_MASK ?\
+        0u : (((__GEN) + 1) & oslo_slot_array_GENERATION_MASK))
+
+// All slot arrays share this layout up to data, only the element type differs
 typedef struct __oslo_slot_array_dummy_header {
+    // Slot -> data index, or the next free slot while the slot is unused
     oslo_dyn_array(uint32_t) indices;
-    oslo_dyn_array(uint32_t) data;
+    oslo_dyn_array(uint32_t) generations;
+    // Data index -> handle
+    oslo_dyn_array(uint32_t) handles;
+    void* data;
+    uint32_t free_head;
+    const oslo_allocator_t* allocator;
 } __oslo_slot_array_dummy_header;
 
 #define oslo_slot_array(__T)\
     struct\
     {\
         oslo_dyn_array(uint32_t) indices;\
+        oslo_dyn_array(uint32_t) generations;\
+        oslo_dyn_array(uint32_t) handles;\
         oslo_dyn_array(__T) data;\
+        uint32_t free_head;\
+        const oslo_allocator_t* allocator;\
         __T tmp;\
     }*
 
 #define oslo_slot_array_new(__T)\
     NULL
 
-oslo_inline
-uint32_t __oslo_slot_array_find_next_available_index(oslo_dyn_array(uint32_t) indices)
-{
-    uint32_t idx = oslo_slot_array_INVALID_HANDLE;
-    for (uint32_t i = 0; i < (uint32_t)oslo_dyn_array_size(indices); ++i)
-    {
-        uint32_t handle = indices[i];
-        if (handle == oslo_slot_array_INVALID_HANDLE)
-        {
-            idx = i;
-            break;
-        }
-    }
-    if (idx == oslo_slot_array_INVALID_HANDLE)
-    {
-        idx = oslo_dyn_array_size(indices);
-    }
-
-    return idx;
-}
+#define __oslo_slot_array_header(__SA)\
+    ((__oslo_slot_array_dummy_header*)(__SA))
 
 OSLO_API_DECL void** oslo_slot_array_init(void** sa, size_t sz);
+OSLO_API_DECL void** oslo_slot_array_init_allocator_impl(void** sa, size_t sz, const oslo_allocator_t* allocator);
 
 #define oslo_slot_array_init_all(__SA)\
-    (oslo_slot_array_init((void**)&(__SA), sizeof(*(__SA))), oslo_dyn_array_init((void**)&((__SA)->indices), sizeof(uint32_t)),\
-        oslo_dyn_array_init((void**)&((__SA)->data), sizeof((__SA)->tmp)))
+    (oslo_slot_array_init((void**)&(__SA), sizeof(*(__SA))),\
+        oslo_dyn_array_init_allocator_impl((void**)&((__SA)->indices), sizeof(uint32_t), (__SA)->allocator),\
+        oslo_dyn_array_init_allocator_impl((void**)&((__SA)->generations), sizeof(uint32_t), (__SA)->allocator),\
+        oslo_dyn_array_init_allocator_impl((void**)&((__SA)->handles), sizeof(uint32_t), (__SA)->allocator),\
+        oslo_dyn_array_init_allocator_impl((void**)&((__SA)->data), sizeof((__SA)->tmp), (__SA)->allocator))
+
+// Creates the slot array with its own allocator, must come before the first insert
+#define oslo_slot_array_init_allocator(__SA, __ALLOCATOR)\
+    (oslo_slot_array_init_allocator_impl((void**)&(__SA), sizeof(*(__SA)), (__ALLOCATOR)), oslo_slot_array_init_all(__SA))
 
+// Returns oslo_slot_array_INVALID_HANDLE without inserting once all 1 << OSLO_SLOT_ARRAY_INDEX_BITS slots are live
 oslo_inline
-uint32_t oslo_slot_array_insert_func(void** indices, void** data, void* val, size_t val_len, uint32_t* ip)
+uint32_t oslo_slot_array_insert_func(__oslo_slot_array_dummy_header* sa, void* val, size_t val_len, uint32_t* ip)
 {
-    // Find next available index
-    u32 idx = __oslo_slot_array_find_next_available_index((uint32_t*)*indices);
-
-    if (idx == oslo_dyn_array_size(*indices)) {
+    // Pop a free slot, or append a new one
+    uint32_t idx = sa->free_head;
+    if (idx != oslo_slot_array_INVALID_HANDLE)
+    {
+        sa->free_head = sa->indices[idx];
+    }
+    else
+    {
         uint32_t v = 0;
-        oslo_dyn_array_push_data(indices, &v, sizeof(uint32_t));  
-        idx = oslo_dyn_array_size(*indices) - 1;
+        idx = oslo_dyn_array_size(sa->indices);
+        if (idx > oslo_slot_array_INDEX_MASK)
+        {
+            // Any further index would run into the generation bits
+            if (ip)
+            {
+                *ip = oslo_slot_array_INVALID_HANDLE;
+            }
+            return oslo_slot_array_INVALID_HANDLE;
+        }
+        oslo_dyn_array_push_data((void**)&sa->indices, &v, sizeof(uint32_t));
+        oslo_dyn_array_push_data((void**)&sa->generations, &v, sizeof(uint32_t));
     }
 
-    // Push data to array
-    oslo_dyn_array_push_data(data, val, val_len);
+    uint32_t handle = (sa->generations[idx] << OSLO_SLOT_ARRAY_INDEX_BITS) | idx;
 
-    // Set data in indices
-    uint32_t bi = oslo_dyn_array_size(*data) - 1;
-    oslo_dyn_array_set_data_i(indices, &bi, sizeof(uint32_t), idx);
+    // Push data to array
+    sa->indices[idx] = oslo_dyn_array_size(sa->data);
+    oslo_dyn_array_push_data(&sa->data, val, val_len);
+    oslo_dyn_array_push_data((void**)&sa->handles, &handle, sizeof(uint32_t));
 
     if (ip){
-        *ip = idx;
+        *ip = handle;
     }
 
-    return idx;
+    return handle;
 }
 
 #define oslo_slot_array_reserve(__SA, __NUM)\
     do {\
         oslo_slot_array_init_all(__SA);\
         oslo_dyn_array_reserve((__SA)->data, __NUM);\
+        oslo_dyn_array_reserve((__SA)->handles, __NUM);\
         oslo_dyn_array_reserve((__SA)->indices, __NUM);\
+        oslo_dyn_array_reserve((__SA)->generations, __NUM);\
     } while (0)
 
 #define oslo_slot_array_insert(__SA, __VAL)\
     (oslo_slot_array_init_all(__SA), (__SA)->tmp = (__VAL),\
-        oslo_slot_array_insert_func((void**)&((__SA)->indices), (void**)&((__SA)->data), (void*)&((__SA)->tmp), sizeof(((__SA)->tmp)), NULL))
+        oslo_slot_array_insert_func(__oslo_slot_array_header(__SA), (void*)&((__SA)->tmp), sizeof(((__SA)->tmp)), NULL))
 
 #define oslo_slot_array_insert_hp(__SA, __VAL, __hp)\
     (oslo_slot_array_init_all(__SA), (__SA)->tmp = (__VAL),\
-        oslo_slot_array_insert_func((void**)&((__SA)->indices), (void**)&((__SA)->data), &((__SA)->tmp), sizeof(((__SA)->tmp)), (__hp)))
+        oslo_slot_array_insert_func(__oslo_slot_array_header(__SA), &((__SA)->tmp), sizeof(((__SA)->tmp)), (__hp)))
 
 #define oslo_slot_array_insert_no_init(__SA, __VAL)\
-    ((__SA)->tmp = (__VAL), oslo_slot_array_insert_func((void**)&((__SA)->indices), (void**)&((__SA)->data), &((__SA)->tmp), sizeof(((__SA)->tmp)), NULL))
+    ((__SA)->tmp = (__VAL), oslo_slot_array_insert_func(__oslo_slot_array_header(__SA), &((__SA)->tmp), sizeof(((__SA)->tmp)), NULL))
 
 #define oslo_slot_array_size(__SA)\
     ((__SA) == NULL ? 0 : oslo_dyn_array_size((__SA)->data))
@@ -307,19 +604,27 @@ uint32_t oslo_slot_array_insert_func(void** indices, void** data, void* val, siz
  #define oslo_slot_array_empty(__SA)\
     (oslo_slot_array_size(__SA) == 0)
 
+OSLO_API_DECL void oslo_slot_array_clear_func(__oslo_slot_array_dummy_header* sa);
+
+// Live handles become stale, slots are kept so their generations carry on
 #define oslo_slot_array_clear(__SA)\
     do {\
         if ((__SA) != NULL) {\
-            oslo_dyn_array_clear((__SA)->data);\
-            oslo_dyn_array_clear((__SA)->indices);\
+            oslo_slot_array_clear_func(__oslo_slot_array_header(__SA));\
         }\
     } while (0)
 
+// A live slot maps to a data element whose handle is exactly __SID, which rejects free slots and stale generations
 #define oslo_slot_array_exists(__SA, __SID)\
-    ((__SA) && (__SID) < (uint32_t)oslo_dyn_array_size((__SA)->indices) && (__SA)->indices[__SID] != oslo_slot_array_INVALID_HANDLE)
+    ((__SA) && oslo_slot_array_handle_index(__SID) < (uint32_t)oslo_dyn_array_size((__SA)->indices) &&\
+        (__SA)->indices[oslo_slot_array_handle_index(__SID)] < (uint32_t)oslo_dyn_array_size((__SA)->handles) &&\
+        (__SA)->handles[(__SA)->indices[oslo_slot_array_handle_index(__SID)]] == (uint32_t)(__SID))
+
+#define oslo_slot_array_handle_valid(__SA, __ID)\
+    oslo_slot_array_exists(__SA, __ID)
 
  #define oslo_slot_array_get(__SA, __SID)\
-    ((__SA)->data[(__SA)->indices[(__SID) % oslo_dyn_array_size(((__SA)->indices))]])
+    ((__SA)->data[(__SA)->indices[oslo_slot_array_handle_index(__SID)]])
 
  #define oslo_slot_array_getp(__SA, __SID)\
     (&(oslo_slot_array_get(__SA, (__SID))))
@@ -328,80 +633,89 @@ uint32_t oslo_slot_array_insert_func(void** indices, void** data, void* val, siz
     do {\
         if ((__SA) != NULL) {\
             oslo_dyn_array_free((__SA)->data);\
+            oslo_dyn_array_free((__SA)->handles);\
+            oslo_dyn_array_free((__SA)->generations);\
             oslo_dyn_array_free((__SA)->indices);\
-            (__SA)->indices = NULL;\
-            (__SA)->data = NULL;\
-            free((__SA));\
+            oslo_allocator_free((__SA)->allocator, (__SA));\
             (__SA) = NULL;\
         }\
     } while (0)
 
+oslo_inline
+void oslo_slot_array_erase_func(__oslo_slot_array_dummy_header* sa, uint32_t handle, size_t val_len)
+{
+    uint32_t idx = oslo_slot_array_handle_index(handle);
+    uint32_t og_data_idx = sa->indices[idx];
+    uint32_t last = oslo_dyn_array_size(sa->handles) - 1;
+
+    // Swap and pop data, the reverse index tells which slot pointed at the last element
+    if (og_data_idx != last)
+    {
+        memcpy((uint8_t*)sa->data + og_data_idx * val_len, (uint8_t*)sa->data + last * val_len, val_len);
+        sa->handles[og_data_idx] = sa->handles[last];
+        sa->indices[oslo_slot_array_handle_index(sa->handles[og_data_idx])] = og_data_idx;
+    }
+    oslo_dyn_array_head(sa->data)->size--;
+    oslo_dyn_array_head(sa->handles)->size--;
+
+    // Retire the handle and push the slot on the free list
+    sa->generations[idx] = oslo_slot_array_next_generation(sa->generations[idx], idx);
+    sa->indices[idx] = sa->free_head;
+    sa->free_head = idx;
+}
+
  #define oslo_slot_array_erase(__SA, __id)\
     do {\
-        uint32_t __H0 = (__id) /*% oslo_dyn_array_size((__SA)->indices)*/;\
-        if (oslo_slot_array_size(__SA) == 1) {\
-            oslo_slot_array_clear(__SA);\
-        }\
-        else if (!oslo_slot_array_handle_valid(__SA, __H0)) {\
+        uint32_t __H0 = (__id);\
+        if (!oslo_slot_array_exists(__SA, __H0)) {\
             notify_error(instance, SLOT_ARRAY_ERROR, "Attempting to erase invalid slot array handle");\
         }\
         else {\
-            uint32_t __OG_DATA_IDX = (__SA)->indices[__H0];\
-            /* Iterate through handles until last index of data found */\
-            uint32_t __H = 0;\
-            for (uint32_t __I = 0; __I < oslo_dyn_array_size((__SA)->indices); ++__I)\
-            {\
-                if ((__SA)->indices[__I] == oslo_dyn_array_size((__SA)->data) - 1)\
-                {\
-                    __H = __I;\
-                    break;\
-                }\
-            }\
-        \
-            /* Swap and pop data */\
-            (__SA)->data[__OG_DATA_IDX] = oslo_dyn_array_back((__SA)->data);\
-            oslo_dyn_array_pop((__SA)->data);\
-        \
-            /* Point new handle, Set og handle to invalid */\
-            (__SA)->indices[__H] = __OG_DATA_IDX;\
-            (__SA)->indices[__H0] = oslo_slot_array_INVALID_HANDLE;\
+            oslo_slot_array_erase_func(__oslo_slot_array_header(__SA), __H0, sizeof((__SA)->tmp));\
         }\
     } while (0)
 
 /*=== Slot Array Iterator ===*/
 
-// Slot array iterator new
+// Slot array iterator new, walks slots and yields the slot index. Use oslo_slot_array_iter_handle to get the handle.
 typedef uint32_t oslo_slot_array_iter;
 
+oslo_inline
+bool __oslo_slot_array_slot_live(__oslo_slot_array_dummy_header* sa, uint32_t slot)
+{
+    uint32_t d = sa->indices[slot];
+    return d < (uint32_t)oslo_dyn_array_size(sa->handles) && oslo_slot_array_handle_index(sa->handles[d]) == slot;
+}
+
 #define oslo_slot_array_iter_valid(__SA, __IT)\
-    (__SA && oslo_slot_array_exists(__SA, __IT))
+    ((__SA) && (__IT) < (uint32_t)oslo_dyn_array_size((__SA)->indices) && __oslo_slot_array_slot_live(__oslo_slot_array_header(__SA), (__IT)))
 
 oslo_inline
-void _oslo_slot_array_iter_advance_func(oslo_dyn_array(uint32_t) indices, uint32_t* it)
+void _oslo_slot_array_iter_advance_func(__oslo_slot_array_dummy_header* sa, uint32_t* it)
 {
-    if (!indices) {
+    if (!sa) {
        *it = oslo_slot_array_INVALID_HANDLE; 
         return;
     }
 
     (*it)++;
-    for (; *it < (uint32_t)oslo_dyn_array_size(indices); ++*it)
-    {\
-        if (indices[*it] != oslo_slot_array_INVALID_HANDLE)\
-        {\
-            break;\
-        }\
-    }\
+    for (; *it < (uint32_t)oslo_dyn_array_size(sa->indices); ++*it)
+    {
+        if (__oslo_slot_array_slot_live(sa, *it))
+        {
+            break;
+        }
+    }
 }
 
 oslo_inline
-uint32_t _oslo_slot_array_iter_find_first_valid_index(oslo_dyn_array(uint32_t) indices)
+uint32_t _oslo_slot_array_iter_find_first_valid_index(__oslo_slot_array_dummy_header* sa)
 {
-    if (!indices) return oslo_slot_array_INVALID_HANDLE;
+    if (!sa) return oslo_slot_array_INVALID_HANDLE;
 
-    for (uint32_t i = 0; i < (uint32_t)oslo_dyn_array_size(indices); ++i)
+    for (uint32_t i = 0; i < (uint32_t)oslo_dyn_array_size(sa->indices); ++i)
     {
-        if (indices[i] != oslo_slot_array_INVALID_HANDLE)
+        if (__oslo_slot_array_slot_live(sa, i))
         {
             return i;
         }
@@ -409,242 +723,916 @@ uint32_t _oslo_slot_array_iter_find_first_valid_index(oslo_dyn_array(uint32_t) i
     return oslo_slot_array_INVALID_HANDLE;
 }
 
-#define oslo_slot_array_iter_new(__SA) (_oslo_slot_array_iter_find_first_valid_index((__SA) ? (__SA)->indices : 0))
+#define oslo_slot_array_iter_new(__SA) (_oslo_slot_array_iter_find_first_valid_index(__oslo_slot_array_header(__SA)))
 
 #define oslo_slot_array_iter_advance(__SA, __IT)\
-    _oslo_slot_array_iter_advance_func((__SA) ? (__SA)->indices : NULL, &(__IT))
+    _oslo_slot_array_iter_advance_func(__oslo_slot_array_header(__SA), &(__IT))
+
+#define oslo_slot_array_iter_handle(__SA, __IT)\
+    ((__SA)->handles[(__SA)->indices[(__IT)]])
 
 #define oslo_slot_array_iter_get(__SA, __IT)\
-    oslo_slot_array_get(__SA, __IT)
+    ((__SA)->data[(__SA)->indices[(__IT)]])
 
 #define oslo_slot_array_iter_getp(__SA, __IT)\
-    oslo_slot_array_getp(__SA, __IT)
-
-#pragma endregion
-
-#pragma region AUDIO
-
-typedef struct oslo_audio_source_t
-{
-    int32_t channels;
-    int32_t sample_rate;
-    void* samples;
-    int32_t sample_count;
-} oslo_audio_source_t;
-
-typedef uint32_t oslo_audio_source_id;
-typedef uint32_t oslo_audio_instance_id;
-
-typedef struct oslo_audio_instance_t
-{
-    oslo_audio_source_id src;
-    float volume;
-    float pitch;
-    bool loop;
-    bool persistent;
-    bool playing;
-    double sample_position;
-} oslo_audio_instance_t;
-
-typedef void (*oslo_audio_commit)(int16_t* output, uint32_t num_channels, uint32_t sample_rate, uint32_t frame_count);
+    (&(oslo_slot_array_iter_get(__SA, __IT)))
 
-typedef struct oslo_audio_t
-{
-    oslo_slot_array(oslo_audio_source_t) sources;
-    oslo_slot_array(oslo_audio_instance_t) instances;
-    float max_volume;
-    float min_volume;
-    void* sample_out;
+/*=== Slot Array Dense Iteration ===*/
 
-    void* user_data;
+// Walks data contiguously, [0, oslo_slot_array_size). Erasing swaps the last element into __I,
+// so loops that erase while iterating should walk backwards.
+#define oslo_slot_array_dense_for(__SA, __I)\
+    for (uint32_t __I = 0; __I < (uint32_t)oslo_slot_array_size(__SA); ++__I)
 
-    oslo_audio_commit commit;
-} oslo_audio_t;
+#define oslo_slot_array_dense_get(__SA, __I)\
+    ((__SA)->data[(__I)])
 
-OSLO_API_DECL void oslo_audio_register_commit(oslo_audio_commit commit);
-OSLO_API_DECL oslo_audio_source_id oslo_audio_load_from_file(const char* path);
-OSLO_API_DECL oslo_audio_instance_id oslo_audio_create_instance(oslo_audio_instance_t* inst);
-OSLO_API_DECL void oslo_audio_mutex_lock();
-OSLO_API_DECL void oslo_audio_mutex_unlock();
+#define oslo_slot_array_dense_getp(__SA, __I)\
+    (&((__SA)->data[(__I)]))
 
-OSLO_API_DECL void oslo_audio_play_source(oslo_audio_source_id src, float volume);
-OSLO_API_DECL void oslo_audio_play(oslo_audio_instance_id inst);
-OSLO_API_DECL void oslo_audio_pause(oslo_audio_instance_id inst);
-OSLO_API_DECL void oslo_audio_stop(oslo_audio_instance_id inst);
-OSLO_API_DECL void oslo_audio_restart(oslo_audio_instance_id inst);
-OSLO_API_DECL bool oslo_audio_is_playing(oslo_audio_instance_id inst);
-OSLO_API_DECL float oslo_audio_get_volume(oslo_audio_instance_id inst);
-OSLO_API_DECL void oslo_audio_set_volume(oslo_audio_instance_id inst, float volume);
+#define oslo_slot_array_dense_handle(__SA, __I)\
+    ((__SA)->handles[(__I)])
 
-OSLO_API_DECL bool oslo_audio_load_ogg_from_file(const char* path, int32_t* sample_count, int32_t* channels, int32_t* sample_rate, void** samples);
-OSLO_API_DECL bool oslo_audio_load_wav_from_file(const char* path, int32_t* sample_count, int32_t* channels, int32_t* sample_rate, void** samples);
-OSLO_API_DECL bool oslo_audio_load_mp3_from_file(const char* path, int32_t* sample_count, int32_t* channels, int32_t* sample_rate, void** samples);
+#define oslo_slot_array_dense_erase(__SA, __I)\
+    oslo_slot_array_erase_func(__oslo_slot_array_header(__SA), (__SA)->handles[(__I)], sizeof((__SA)->tmp))
 
 #pragma endregion
 
-#pragma region OSLO_2D_STRUCTS
-/*================================================================================
-// Oslo 2D
-================================================================================*/
+#pragma region HASH
+oslo_inline 
+uint32_t oslo_hash_uint32_t(uint32_t x)
+{
+    x = ((x >> 16) ^ x) * 0x45d9f3b;
+    x = ((x >> 16) ^ x) * 0x45d9f3b;
+    x = (x >> 16) ^ x;
+    return x;
+}
 
-// Helper macro for an in place for-range loop
-#define oslo_for_range_i(__COUNT)\
-    for (uint32_t i = 0; i < __COUNT; ++i)
+#define oslo_hash_u32_ip(__X, __OUT)\
+    do {\
+        __OUT = ((__X >> 16) ^ __X) * 0x45d9f3b;\
+        __OUT = ((__OUT >> 16) ^ __OUT) * 0x45d9f3b;\
+        __OUT = (__OUT >> 16) ^ __OUT;\
+    } while (0) 
 
-typedef struct oslo_rect_t
+oslo_inline 
+uint32_t oslo_hash_u64(uint64_t x)
 {
-    vec2 min;
-    vec2 max;
-} oslo_rect_t;
+    x = (x ^ (x >> 31) ^ (x >> 62)) * UINT64_C(0x319642b2d24d8ec3);
+    x = (x ^ (x >> 27) ^ (x >> 54)) * UINT64_C(0x96de1b173f119089);
+    x = x ^ (x >> 30) ^ (x >> 60);
+    return (uint32_t)x; 
+}
 
-typedef enum oslo_error_code
+// http://www.cse.yorku.ca/~oz/hash.html
+// djb2 hash by dan bernstein
+oslo_inline 
+uint32_t oslo_hash_str(const char* str)
 {
-    OSLO_SHADER_COMPILE_ERROR,
-    OSLO_SHADER_LINKER_ERROR,
-    OSLO_PLATFORM_INIT_ERROR,
-    OSLO_GFX_INIT_ERROR,
-    OSLO_AUDIO_INIT_ERROR,
-    OSLO_LOAD_ERROR,
-    SLOT_ARRAY_ERROR
-} oslo_error_code;
+    uint32_t hash = 5381;
+    s32 c;
+    while ((c = *str++))
+    {
+        hash = ((hash << 5) + hash) + c; /* hash * 33 + c */
+    }
+    return hash;
+}
 
-typedef struct oslo_desc_t
+oslo_inline uint32_t 
+string_length(const char* txt)
 {
-	u32 window_width;
-	u32 window_height;
-	const char* window_title;
-    float max_fps;
+    uint32_t sz = 0;
+    while (txt != NULL && txt[ sz ] != '\0') 
+    {
+        sz++;
+    }
+    return sz;
+}
 
-	void(*init)(void*);
-	void(*update)(void*);
-	void(*shutdown)(void*);
-    void(*on_oslo_error)(oslo_error_code, const char*);
+oslo_inline 
+uint64_t oslo_hash_str64(const char* str)
+{
+    uint32_t hash1 = 5381;
+    uint32_t hash2 = 52711;
+    uint32_t i = string_length(str);
+    while(i--) 
+    {
+        char c = str[ i ];
+        hash1 = (hash1 * 33) ^ c;
+        hash2 = (hash2 * 33) ^ c;
+    }
 
-	void* user_data;
-} oslo_desc_t;
+    return (hash1 >> 0) * 4096 + (hash2 >> 0);
+}
 
-typedef struct oslo_gfx_vertex_t
+oslo_inline
+bool oslo_compare_bytes(void* b0, void* b1, size_t len)
 {
-    vec4 position;
-    vec4 color;
-    vec2 uv;
-    float tex_index;
-} oslo_gfx_vertex_t;
+    return 0 == memcmp(b0, b1, len);
+}
 
-typedef struct oslo_gfx_texture_t
+// Hash generic bytes using (ripped directly from Sean Barret's stb_ds.h)
+#define OSLO_SIZE_T_BITS  ((sizeof(size_t)) * 8)
+#define OSLO_SIPHASH_C_ROUNDS 1
+#define OSLO_SIPHASH_D_ROUNDS 1
+#define oslo_rotate_left(__V, __N)   (((__V) << (__N)) | ((__V) >> (OSLO_SIZE_T_BITS - (__N))))
+#define oslo_rotate_right(__V, __N)  (((__V) >> (__N)) | ((__V) << (OSLO_SIZE_T_BITS - (__N))))
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable:4127) // conditional expression is constant, for do..while(0) and sizeof()==
+#endif
+
+oslo_inline 
+size_t oslo_hash_siphash_bytes(void *p, size_t len, size_t seed)
 {
-    int id;
-    uint32_t width;
-    uint32_t height;
-    uint32_t channels;
-} oslo_gfx_texture_t;
+  unsigned char *d = (unsigned char *) p;
+  size_t i,j;
+  size_t v0,v1,v2,v3, data;
 
-#define MAX_BATCH_TEXTURES 32
+  // hash that works on 32- or 64-bit registers without knowing which we have
+  // (computes different results on 32-bit and 64-bit platform)
+  // derived from siphash, but on 32-bit platforms very different as it uses 4 32-bit state not 4 64-bit
+  v0 = ((((size_t) 0x736f6d65 << 16) << 16) + 0x70736575) ^  seed;
+  v1 = ((((size_t) 0x646f7261 << 16) << 16) + 0x6e646f6d) ^ ~seed;
+  v2 = ((((size_t) 0x6c796765 << 16) << 16) + 0x6e657261) ^  seed;
+  v3 = ((((size_t) 0x74656462 << 16) << 16) + 0x79746573) ^ ~seed;
 
-typedef uint32_t oslo_texture_id;
+  #ifdef STBDS_TEST_SIPHASH_2_4
+  // hardcoded with key material in the siphash test vectors
+  v0 ^= 0x0706050403020100ull ^  seed;
+  v1 ^= 0x0f0e0d0c0b0a0908ull ^ ~seed;
+  v2 ^= 0x0706050403020100ull ^  seed;
+  v3 ^= 0x0f0e0d0c0b0a0908ull ^ ~seed;
+  #endif
 
-typedef struct oslo_gfx_quad_batch_t
-{
-    int vao;
-    int vbo;
-    int ibo;
+  #define oslo_sipround() \
+    do {                   \
+      v0 += v1; v1 = oslo_rotate_left(v1, 13);  v1 ^= v0; v0 = oslo_rotate_left(v0,OSLO_SIZE_T_BITS/2); \
+      v2 += v3; v3 = oslo_rotate_left(v3, 16);  v3 ^= v2;                                                 \
+      v2 += v1; v1 = oslo_rotate_left(v1, 17);  v1 ^= v2; v2 = oslo_rotate_left(v2,OSLO_SIZE_T_BITS/2); \
+      v0 += v3; v3 = oslo_rotate_left(v3, 21);  v3 ^= v0;                                                 \
+    } while (0)
 
-    oslo_gfx_vertex_t* vertices;
-    oslo_gfx_vertex_t* vert_ptr;
+  for (i=0; i+sizeof(size_t) <= len; i += sizeof(size_t), d += sizeof(size_t)) {
+    data = d[0] | (d[1] << 8) | (d[2] << 16) | (d[3] << 24);
+    data |= (size_t) (d[4] | (d[5] << 8) | (d[6] << 16) | (d[7] << 24)) << 16 << 16; // discarded if size_t == 4
 
-    float texture_index;
-    oslo_texture_id bound_textures[MAX_BATCH_TEXTURES];
+    v3 ^= data;
+    for (j=0; j < OSLO_SIPHASH_C_ROUNDS; ++j)
+      oslo_sipround();
+    v0 ^= data;
+  }
+  data = len << (OSLO_SIZE_T_BITS-8);
+  switch (len - i) {
+    case 7: data |= ((size_t) d[6] << 24) << 24; // fall through
+    case 6: data |= ((size_t) d[5] << 20) << 20; // fall through
+    case 5: data |= ((size_t) d[4] << 16) << 16; // fall through
+    case 4: data |= (d[3] << 24); // fall through
+    case 3: data |= (d[2] << 16); // fall through
+    case 2: data |= (d[1] << 8); // fall through
+    case 1: data |= d[0]; // fall through
+    case 0: break;
+  }
+  v3 ^= data;
+  for (j=0; j < OSLO_SIPHASH_C_ROUNDS; ++j)
+    oslo_sipround();
+  v0 ^= data;
+  v2 ^= 0xff;
+  for (j=0; j < OSLO_SIPHASH_D_ROUNDS; ++j)
+    oslo_sipround();
 
-    uint32_t max_indices;
-    uint32_t index_count;
-} oslo_gfx_quad_batch_t;
+#if 0
+  return v0^v1^v2^v3;
+#else
+  return v1^v2^v3; // slightly stronger since v0^v3 in above cancels out final round operation? I tweeted at the authors of SipHash about this but they didn't reply
+#endif
+}
 
-typedef struct draw_texture_section_desc_t
+oslo_inline
+size_t oslo_hash_bytes(void *p, size_t len, size_t seed)
 {
-    vec2 position;
-    float rotation;
-    vec2 size;
-    vec4 color;
-    oslo_rect_t section;
-    oslo_texture_id texture;
-    bool flip_horizontal;
-} draw_texture_section_desc_t;
+#if 0
+  return oslo_hash_siphash_bytes(p,len,seed);
+#else
+  unsigned char *d = (unsigned char *) p;
 
-typedef struct draw_textured_quad_desc_t
+  // Len == 4 (off for now, so to force 64 bit hash)
+  if (len == 4) {
+    unsigned int hash = d[0] | (d[1] << 8) | (d[2] << 16) | (d[3] << 24);
+    hash ^= seed;
+    hash *= 0xcc9e2d51;
+    hash = (hash << 17) | (hash >> 15);
+    hash *= 0x1b873593;
+    hash ^= seed;
+    hash = (hash << 19) | (hash >> 13);
+    hash = hash*5 + 0xe6546b64;
+    hash ^= hash >> 16;
+    hash *= 0x85ebca6b;
+    hash ^= seed;
+    hash ^= hash >> 13;
+    hash *= 0xc2b2ae35;
+    hash ^= hash >> 16;
+    return (((size_t) hash << 16 << 16) | hash) ^ seed;
+  } else if (len == 8 && sizeof(size_t) == 8) {
+    size_t hash = d[0] | (d[1] << 8) | (d[2] << 16) | (d[3] << 24);
+    hash |= (size_t) (d[4] | (d[5] << 8) | (d[6] << 16) | (d[7] << 24)) << 16 << 16; // avoid warning if size_t == 4
+    hash ^= seed;
+    hash = (~hash) + (hash << 21);
+    hash ^= oslo_rotate_right(hash,24);
+    hash *= 265;
+    hash ^= oslo_rotate_right(hash,14);
+    hash ^= seed;
+    hash *= 21;
+    hash ^= oslo_rotate_right(hash,28);
+    hash += (hash << 31);
+    hash = (~hash) + (hash << 18);
+    return hash;
+  } else {
+    return oslo_hash_siphash_bytes(p,len,seed);
+  }
+#endif
+}
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+#pragma endregion
+
+#pragma region HASH_TABLE
+
+/*
+    Open addressing table in the style of Swiss tables. Every slot has a control byte, either
+    EMPTY, DELETED (tombstone) or the low 7 bits of the key's hash. Lookups compare a whole group of
+    control bytes against the tag at once and only touch entries whose tag matches. Probing walks
+    groups triangularly and stops at the first group with an EMPTY byte.
+*/
+
+#define OSLO_HASH_TABLE_HASH_SEED         0x31415296
+#define OSLO_HASH_TABLE_INVALID_INDEX     UINT32_MAX
+
+#define OSLO_HASH_TABLE_CTRL_EMPTY        0x80
+#define OSLO_HASH_TABLE_CTRL_DELETED      0xFE
+
+#if !defined(OSLO_HASH_TABLE_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+    #define OSLO_HASH_TABLE_SSE2
+#endif
+
+#ifdef OSLO_HASH_TABLE_SSE2
+    #include <emmintrin.h>
+    #define OSLO_HASH_TABLE_GROUP_WIDTH   16
+    typedef uint32_t __oslo_hash_table_mask;
+#else
+    // Portable fallback, 8 control bytes in a u64 (assumes little endian)
+    #define OSLO_HASH_TABLE_GROUP_WIDTH   8
+    typedef uint64_t __oslo_hash_table_mask;
+#endif
+
+#ifdef _MSC_VER
+    #include <intrin.h>
+#endif
+
+oslo_inline
+uint32_t __oslo_hash_table_mask_next(__oslo_hash_table_mask mask)
 {
-    vec4 quad[4];
-    vec4 color;
-    oslo_rect_t section;
-    oslo_texture_id texture;
-    bool flip_horizontal;
-} draw_textured_quad_desc_t;
+#ifdef _MSC_VER
+    unsigned long idx;
+    #ifdef OSLO_HASH_TABLE_SSE2
+        _BitScanForward(&idx, mask);
+        return (uint32_t)idx;
+    #else
+        _BitScanForward64(&idx, mask);
+        return (uint32_t)idx >> 3;
+    #endif
+#else
+    #ifdef OSLO_HASH_TABLE_SSE2
+        return (uint32_t)__builtin_ctz(mask);
+    #else
+        return (uint32_t)__builtin_ctzll(mask) >> 3;
+    #endif
+#endif
+}
 
-typedef struct draw_texture_desc_t
+#ifdef OSLO_HASH_TABLE_SSE2
+
+oslo_inline
+__oslo_hash_table_mask __oslo_hash_table_group_match(const uint8_t* ctrl, uint8_t tag)
 {
-    vec2 position;
-    float rotation;
-    vec2 size;
-    vec4 color;
-    oslo_texture_id texture;
-} draw_texture_desc_t;
+    __m128i group = _mm_loadu_si128((const __m128i*)ctrl);
+    return (__oslo_hash_table_mask)_mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8((char)tag)));
+}
 
-typedef struct draw_quad_desc_t
+oslo_inline
+__oslo_hash_table_mask __oslo_hash_table_group_match_empty(const uint8_t* ctrl)
 {
-    vec2 position;
-    float rotation;
-    vec2 size;
-    vec4 color;
-} draw_quad_desc_t;
+    return __oslo_hash_table_group_match(ctrl, OSLO_HASH_TABLE_CTRL_EMPTY);
+}
 
-typedef struct oslo_gfx_t
+// EMPTY or DELETED, the only control bytes with the high bit set
+oslo_inline
+__oslo_hash_table_mask __oslo_hash_table_group_match_available(const uint8_t* ctrl)
 {
-    int shader;
-    mat4 projection;
-    oslo_texture_id white_texture;
+    return (__oslo_hash_table_mask)_mm_movemask_epi8(_mm_loadu_si128((const __m128i*)ctrl));
+}
 
-    oslo_gfx_quad_batch_t default_batch;
+#else
 
-    oslo_slot_array(oslo_gfx_texture_t) textures;
-} oslo_gfx_t;
+#define __OSLO_HASH_TABLE_LSBS    UINT64_C(0x0101010101010101)
+#define __OSLO_HASH_TABLE_MSBS    UINT64_C(0x8080808080808080)
 
-typedef enum oslo_mouse_button_code
+// May report false positives after a real match, callers compare keys anyway
+oslo_inline
+__oslo_hash_table_mask __oslo_hash_table_group_match(const uint8_t* ctrl, uint8_t tag)
 {
-    OSLO_MOUSE_LBUTTON,
-    OSLO_MOUSE_RBUTTON,
-    OSLO_MOUSE_MBUTTON,
-    OSLO_MOUSE_BUTTON_CODE_COUNT
-} oslo_mouse_button_code;
+    uint64_t group;
+    memcpy(&group, ctrl, sizeof(uint64_t));
+    uint64_t x = group ^ (__OSLO_HASH_TABLE_LSBS * tag);
+    return (x - __OSLO_HASH_TABLE_LSBS) & ~x & __OSLO_HASH_TABLE_MSBS;
+}
 
-typedef enum oslo_keycode
+oslo_inline
+__oslo_hash_table_mask __oslo_hash_table_group_match_empty(const uint8_t* ctrl)
 {
-    OSLO_KEYCODE_INVALID,
-    OSLO_KEYCODE_SPACE,
-    OSLO_KEYCODE_APOSTROPHE,  /* ' */
-    OSLO_KEYCODE_COMMA,  /* , */
-    OSLO_KEYCODE_MINUS,  /* - */
-    OSLO_KEYCODE_PERIOD,  /* . */
-    OSLO_KEYCODE_SLASH,  /* / */
-    OSLO_KEYCODE_0,
-    OSLO_KEYCODE_1,
-    OSLO_KEYCODE_2,
-    OSLO_KEYCODE_3,
-    OSLO_KEYCODE_4,
-    OSLO_KEYCODE_5,
-    OSLO_KEYCODE_6,
-    OSLO_KEYCODE_7,
-    OSLO_KEYCODE_8,
-    OSLO_KEYCODE_9,
-    OSLO_KEYCODE_SEMICOLON,  /* ; */
-    OSLO_KEYCODE_EQUAL,  /* = */
-    OSLO_KEYCODE_A,
-    OSLO_KEYCODE_B,
-    OSLO_KEYCODE_C,
-    OSLO_KEYCODE_D,
-    OSLO_KEYCODE_E,
-    OSLO_KEYCODE_F,
-    OSLO_KEYCODE_G,
-    OSLO_KEYCODE_H,
-    OSLO_KEYCODE_I,
+    uint64_t group;
+    memcpy(&group, ctrl, sizeof(uint64_t));
+    return group & ~(group << 6) & __OSLO_HASH_TABLE_MSBS;
+}
+
+oslo_inline
+__oslo_hash_table_mask __oslo_hash_table_group_match_available(const uint8_t* ctrl)
+{
+    uint64_t group;
+    memcpy(&group, ctrl, sizeof(uint64_t));
+    return group & __OSLO_HASH_TABLE_MSBS;
+}
+
+#endif
+
+// Entries store their key's hash, so growing never rehashes keys
+#define __oslo_hash_table_entry(__HMK, __HMV)\
+    struct\
+    {\
+        __HMK key;\
+        __HMV val;\
+        uint32_t hash;\
+    }
+
+// All hash tables share this layout up to tmp_key
+typedef struct __oslo_hash_table_header_t
+{
+    void* data;
+    uint8_t* ctrl;
+    uint32_t size;
+    uint32_t capacity;
+    uint32_t growth_left;
+    size_t stride;
+    size_t klpvl;
+    size_t tmp_idx;
+    const oslo_allocator_t* allocator;
+} __oslo_hash_table_header_t;
+
+#define oslo_hash_table(__HMK, __HMV)\
+    struct {\
+        __oslo_hash_table_entry(__HMK, __HMV)* data;\
+        uint8_t* ctrl;\
+        uint32_t size;\
+        uint32_t capacity;\
+        uint32_t growth_left;\
+        size_t stride;\
+        size_t klpvl;\
+        size_t tmp_idx;\
+        const oslo_allocator_t* allocator;\
+        __HMK tmp_key;\
+        __HMV tmp_val;\
+    }*
+
+#define __oslo_hash_table_header(__HT)\
+    ((__oslo_hash_table_header_t*)(__HT))
+
+#define oslo_hash_table_new(__K, __V)\
+    NULL
+
+OSLO_API_DECL void __oslo_hash_table_init_impl(void** ht, size_t sz, const oslo_allocator_t* allocator);
+OSLO_API_DECL void __oslo_hash_table_resize(__oslo_hash_table_header_t* ht, uint32_t capacity);
+OSLO_API_DECL void __oslo_hash_table_reserve_func(__oslo_hash_table_header_t* ht, uint32_t count);
+OSLO_API_DECL void __oslo_hash_table_clear_func(__oslo_hash_table_header_t* ht);
+OSLO_API_DECL uint32_t __oslo_hash_table_insert_func(__oslo_hash_table_header_t* ht, const void* key, size_t key_len);
+OSLO_API_DECL void __oslo_hash_table_erase_func(__oslo_hash_table_header_t* ht, const void* key, size_t key_len);
+
+// klpvl is the offset of the stored hash inside an entry
+#define oslo_hash_table_init_allocator(__HT, __K, __V, __ALLOCATOR)\
+    do {\
+        __oslo_hash_table_init_impl((void**)&(__HT), sizeof(*(__HT)), (__ALLOCATOR));\
+        (__HT)->stride = sizeof(*((__HT)->data));\
+        __oslo_hash_table_resize(__oslo_hash_table_header(__HT), OSLO_HASH_TABLE_GROUP_WIDTH);\
+        (__HT)->klpvl = (size_t)((uintptr_t)&((__HT)->data[0].hash) - (uintptr_t)&((__HT)->data[0]));\
+    } while (0)
+
+#define oslo_hash_table_init(__HT, __K, __V)\
+    oslo_hash_table_init_allocator(__HT, __K, __V, NULL)
+
+#define oslo_hash_table_reserve(_HT, _KT, _VT, _CT)\
+    do {\
+        if ((_HT) == NULL) {\
+            oslo_hash_table_init((_HT), _KT, _VT);\
+        }\
+        __oslo_hash_table_reserve_func(__oslo_hash_table_header(_HT), (uint32_t)(_CT));\
+    } while (0)
+
+#define oslo_hash_table_size(__HT)\
+    ((__HT) != NULL ? (__HT)->size : 0)
+
+#define oslo_hash_table_capacity(__HT)\
+    ((__HT) != NULL ? (__HT)->capacity : 0)
+
+#define oslo_hash_table_load_factor(__HT)\
+    (oslo_hash_table_capacity(__HT) ? (float)(oslo_hash_table_size(__HT)) / (float)(oslo_hash_table_capacity(__HT)) : 0.f)
+
+#define oslo_hash_table_grow(__HT, __C)\
+    __oslo_hash_table_reserve_func(__oslo_hash_table_header(__HT), (uint32_t)(__C))
+
+#define oslo_hash_table_empty(__HT)\
+    ((__HT) != NULL ? (__HT)->size == 0 : true)
+
+#define oslo_hash_table_clear(__HT)\
+    do {\
+        if ((__HT) != NULL) {\
+            __oslo_hash_table_clear_func(__oslo_hash_table_header(__HT));\
+        }\
+    } while (0)
+
+#define oslo_hash_table_free(__HT)\
+    do {\
+        if ((__HT) != NULL) {\
+            oslo_allocator_free((__HT)->allocator, (__HT)->data);\
+            oslo_allocator_free((__HT)->allocator, (__HT)->ctrl);\
+            oslo_allocator_free((__HT)->allocator, (__HT));\
+            (__HT) = NULL;\
+        }\
+    } while (0)
+
+oslo_inline
+uint32_t __oslo_hash_table_hash(const void* key, size_t key_len)
+{
+    return (uint32_t)oslo_hash_bytes((void*)key, key_len, OSLO_HASH_TABLE_HASH_SEED);
+}
+
+oslo_inline
+uint32_t __oslo_hash_table_find(const __oslo_hash_table_header_t* ht, const void* key, size_t key_len, uint32_t hash)
+{
+    uint32_t group_mask = ht->capacity / OSLO_HASH_TABLE_GROUP_WIDTH - 1;
+    uint32_t group = (hash >> 7) & group_mask;
+    uint8_t tag = (uint8_t)(hash & 0x7F);
+
+    for (uint32_t probe = 1; probe <= group_mask + 1; ++probe)
+    {
+        const uint8_t* ctrl = ht->ctrl + group * OSLO_HASH_TABLE_GROUP_WIDTH;
+        for (__oslo_hash_table_mask m = __oslo_hash_table_group_match(ctrl, tag); m; m &= m - 1)
+        {
+            uint32_t i = group * OSLO_HASH_TABLE_GROUP_WIDTH + __oslo_hash_table_mask_next(m);
+            const uint8_t* entry = (const uint8_t*)ht->data + i * ht->stride;
+            if (*(const uint32_t*)(entry + ht->klpvl) == hash && oslo_compare_bytes((void*)entry, (void*)key, key_len))
+            {
+                return i;
+            }
+        }
+
+        if (__oslo_hash_table_group_match_empty(ctrl))
+        {
+            break;
+        }
+
+        group = (group + probe) & group_mask;
+    }
+
+    return OSLO_HASH_TABLE_INVALID_INDEX;
+}
+
+oslo_inline
+uint32_t oslo_hash_table_get_key_index_func(const void* table, const void* key, size_t key_len)
+{
+    const __oslo_hash_table_header_t* ht = (const __oslo_hash_table_header_t*)table;
+    if (!ht || !key || !ht->size) return OSLO_HASH_TABLE_INVALID_INDEX;
+    return __oslo_hash_table_find(ht, key, key_len, __oslo_hash_table_hash(key, key_len));
+}
+
+// Inserts the key if missing, overwrites the value otherwise
+#define oslo_hash_table_insert(__HT, __HMK, __HMV)\
+    do {\
+        /* Check for null hash table, init if necessary */\
+        if ((__HT) == NULL) {\
+            oslo_hash_table_init((__HT), (__HMK), (__HMV));\
+        }\
+        (__HT)->tmp_key = (__HMK);\
+        (__HT)->tmp_idx = __oslo_hash_table_insert_func(__oslo_hash_table_header(__HT), (void*)&((__HT)->tmp_key), sizeof((__HT)->tmp_key));\
+        (__HT)->data[(__HT)->tmp_idx].val = (__HMV);\
+    } while (0)
+
+// Get key at index
+#define oslo_hash_table_getk(__HT, __I)\
+    (((__HT))->data[(__I)].key)
+
+// Get val at index
+#define oslo_hash_table_geti(__HT, __I)\
+    ((__HT)->data[(__I)].val)
+
+#define oslo_hash_table_get(__HT, __HTK)\
+    ((__HT)->tmp_key = (__HTK),\
+        (oslo_hash_table_geti((__HT),\
+            oslo_hash_table_get_key_index_func((__HT), (void*)&((__HT)->tmp_key), sizeof((__HT)->tmp_key)))))
+
+#define oslo_hash_table_getp(__HT, __HTK)\
+    (\
+        (__HT)->tmp_key = (__HTK),\
+        ((__HT)->tmp_idx = oslo_hash_table_get_key_index_func((__HT), (void*)&((__HT)->tmp_key), sizeof((__HT)->tmp_key))),\
+        ((__HT)->tmp_idx != OSLO_HASH_TABLE_INVALID_INDEX ? &oslo_hash_table_geti((__HT), (__HT)->tmp_idx) : NULL)\
+    )
+
+#define oslo_hash_table_key_exists(__HT, __HTK)\
+    ((__HT)->tmp_key = (__HTK),\
+        (oslo_hash_table_get_key_index_func((__HT), (void*)&((__HT)->tmp_key), sizeof((__HT)->tmp_key)) != OSLO_HASH_TABLE_INVALID_INDEX))
+
+#define oslo_hash_table_exists(__HT, __HTK)\
+		(__HT && oslo_hash_table_key_exists((__HT), (__HTK)))
+
+#define oslo_hash_table_erase(__HT, __HTK)\
+    do {\
+        if ((__HT) != NULL) {\
+            (__HT)->tmp_key = (__HTK);\
+            __oslo_hash_table_erase_func(__oslo_hash_table_header(__HT), (void*)&((__HT)->tmp_key), sizeof((__HT)->tmp_key));\
+        }\
+    } while (0)
+
+/*===== Hash Table Iterator ====*/
+
+typedef uint32_t oslo_hash_table_iter;
+
+oslo_inline
+uint32_t __oslo_find_first_valid_iterator(const __oslo_hash_table_header_t* ht, uint32_t idx)
+{
+    uint32_t it = idx;
+    for (; ht && it < ht->capacity; ++it)
+    {
+        if (!(ht->ctrl[it] & 0x80))
+        {
+            break;
+        }
+    }
+    return it;
+}
+
+/* Find first valid iterator idx */
+#define oslo_hash_table_iter_new(__HT)\
+    ((__HT) ? __oslo_find_first_valid_iterator(__oslo_hash_table_header(__HT), 0) : 0)
+
+#define oslo_hash_table_iter_valid(__HT, __IT)\
+    ((__IT) < oslo_hash_table_capacity((__HT)))
+
+#define oslo_hash_table_find_valid_iter(__HT, __IT)\
+    ((__IT) = __oslo_find_first_valid_iterator(__oslo_hash_table_header(__HT), (__IT)))
+
+#define oslo_hash_table_iter_advance(__HT, __IT)\
+    ((__IT) = __oslo_find_first_valid_iterator(__oslo_hash_table_header(__HT), (__IT) + 1))
+
+#define oslo_hash_table_iter_get(__HT, __IT)\
+    oslo_hash_table_geti(__HT, __IT)
+
+#define oslo_hash_table_iter_getp(__HT, __IT)\
+    (&(oslo_hash_table_geti(__HT, __IT)))
+
+#define oslo_hash_table_iter_getk(__HT, __IT)\
+    (oslo_hash_table_getk(__HT, __IT))
+
+#define oslo_hash_table_iter_getkp(__HT, __IT)\
+    (&(oslo_hash_table_getk(__HT, __IT)))
+
+#pragma endregion
+
+#pragma region STRING
+/*===================================
+// String Interning
+===================================*/
+
+// Interned strings are stored once and referred to by a 32-bit id, so comparing or hashing them is
+// an integer operation. Ids are never released. Id 0 is reserved for NULL and strings never interned.
+typedef uint32_t oslo_string_id;
+
+#define OSLO_STRING_ID_INVALID    0
+
+// Returns the id of str, interning a copy on first use. Thread safe.
+OSLO_API_DECL oslo_string_id oslo_string_intern(const char* str);
+// Returns the id of str if it was interned before, OSLO_STRING_ID_INVALID otherwise
+OSLO_API_DECL oslo_string_id oslo_string_find(const char* str);
+OSLO_API_DECL const char* oslo_string_get(oslo_string_id id);
+OSLO_API_DECL uint32_t oslo_string_length(oslo_string_id id);
+
+/*=== String Map ===*/
+
+// Hash table keyed by interned string ids. Lookups by text only hash the string and never intern it.
+#define oslo_string_map(__V)\
+    oslo_hash_table(oslo_string_id, __V)
+
+#define oslo_string_map_new(__V)\
+    NULL
+
+#define oslo_string_map_insert(__SM, __STR, __V)\
+    oslo_hash_table_insert((__SM), oslo_string_intern(__STR), (__V))
+
+#define oslo_string_map_insert_id(__SM, __ID, __V)\
+    oslo_hash_table_insert((__SM), (oslo_string_id)(__ID), (__V))
+
+#define oslo_string_map_getp_id(__SM, __ID)\
+    ((__SM) ? oslo_hash_table_getp((__SM), (oslo_string_id)(__ID)) : NULL)
+
+#define oslo_string_map_getp(__SM, __STR)\
+    oslo_string_map_getp_id((__SM), oslo_string_find(__STR))
+
+#define oslo_string_map_exists_id(__SM, __ID)\
+    oslo_hash_table_exists((__SM), (oslo_string_id)(__ID))
+
+#define oslo_string_map_exists(__SM, __STR)\
+    oslo_string_map_exists_id((__SM), oslo_string_find(__STR))
+
+#define oslo_string_map_erase_id(__SM, __ID)\
+    oslo_hash_table_erase((__SM), (oslo_string_id)(__ID))
+
+#define oslo_string_map_erase(__SM, __STR)\
+    oslo_string_map_erase_id((__SM), oslo_string_find(__STR))
+
+#define oslo_string_map_size(__SM)\
+    oslo_hash_table_size(__SM)
+
+#define oslo_string_map_free(__SM)\
+    oslo_hash_table_free(__SM)
+
+#pragma endregion
+
+#pragma region AUDIO
+
+typedef struct oslo_audio_source_t
+{
+    int32_t channels;
+    int32_t sample_rate;
+    void* samples;
+    int32_t sample_count;
+} oslo_audio_source_t;
+
+typedef uint32_t oslo_audio_source_id;
+typedef uint32_t oslo_audio_instance_id;
+
+typedef struct oslo_audio_instance_t
+{
+    oslo_audio_source_id src;
+    float volume;
+    float pitch;
+    bool loop;
+    bool persistent;
+    bool playing;
+    double sample_position;
+} oslo_audio_instance_t;
+
+typedef void (*oslo_audio_commit)(int16_t* output, uint32_t num_channels, uint32_t sample_rate, uint32_t frame_count);
+
+typedef struct oslo_audio_t
+{
+    oslo_slot_array(oslo_audio_source_t) sources;
+    oslo_slot_array(oslo_audio_instance_t) instances;
+    // Loaded source paths -> source
+    oslo_string_map(oslo_audio_source_id) source_names;
+    float max_volume;
+    float min_volume;
+    void* sample_out;
+
+    void* user_data;
+
+    oslo_audio_commit commit;
+} oslo_audio_t;
+
+OSLO_API_DECL void oslo_audio_register_commit(oslo_audio_commit commit);
+OSLO_API_DECL oslo_audio_source_id oslo_audio_load_from_file(const char* path);
+// Source last loaded from path, -1 if none
+OSLO_API_DECL oslo_audio_source_id oslo_audio_find_source(const char* path);
+OSLO_API_DECL oslo_audio_instance_id oslo_audio_create_instance(oslo_audio_instance_t* inst);
+OSLO_API_DECL void oslo_audio_mutex_lock();
+OSLO_API_DECL void oslo_audio_mutex_unlock();
+
+OSLO_API_DECL void oslo_audio_play_source(oslo_audio_source_id src, float volume);
+OSLO_API_DECL void oslo_audio_play(oslo_audio_instance_id inst);
+OSLO_API_DECL void oslo_audio_pause(oslo_audio_instance_id inst);
+OSLO_API_DECL void oslo_audio_stop(oslo_audio_instance_id inst);
+OSLO_API_DECL void oslo_audio_restart(oslo_audio_instance_id inst);
+OSLO_API_DECL bool oslo_audio_is_playing(oslo_audio_instance_id inst);
+OSLO_API_DECL float oslo_audio_get_volume(oslo_audio_instance_id inst);
+OSLO_API_DECL void oslo_audio_set_volume(oslo_audio_instance_id inst, float volume);
+
+OSLO_API_DECL bool oslo_audio_load_ogg_from_file(const char* path, int32_t* sample_count, int32_t* channels, int32_t* sample_rate, void** samples);
+OSLO_API_DECL bool oslo_audio_load_wav_from_file(const char* path, int32_t* sample_count, int32_t* channels, int32_t* sample_rate, void** samples);
+OSLO_API_DECL bool oslo_audio_load_mp3_from_file(const char* path, int32_t* sample_count, int32_t* channels, int32_t* sample_rate, void** samples);
+
+#pragma endregion
+
+#pragma region OSLO_2D_STRUCTS
+/*================================================================================
+// Oslo 2D
+================================================================================*/
+
+// Helper macro for an in place for-range loop
+#define oslo_for_range_i(__COUNT)\
+    for (uint32_t i = 0; i < __COUNT; ++i)
+
+typedef struct oslo_rect_t
+{
+    vec2 min;
+    vec2 max;
+} oslo_rect_t;
+
+typedef enum oslo_error_code
+{
+    OSLO_SHADER_COMPILE_ERROR,
+    OSLO_SHADER_LINKER_ERROR,
+    OSLO_PLATFORM_INIT_ERROR,
+    OSLO_GFX_INIT_ERROR,
+    OSLO_AUDIO_INIT_ERROR,
+    OSLO_LOAD_ERROR,
+    SLOT_ARRAY_ERROR,
+    // Reported at shutdown with OSLO_MEMORY_TRACKING, once per leaking category
+    OSLO_MEMORY_LEAK
+} oslo_error_code;
+
+typedef struct oslo_desc_t
+{
+	u32 window_width;
+	u32 window_height;
+	const char* window_title;
+    float max_fps;
+
+    // Headless runs use a hidden window with vsync and the fps cap disabled,
+    // so scripted scenes run as fast as the frame loop allows. The hidden window still
+    // needs a display, use a virtual framebuffer such as Xvfb on machines without one.
+    bool headless;
+    // Skips glfw, the window and the GL context entirely, for CPU only scenes (physics,
+    // audio mixing, jobs) on machines without a display. Implies headless. Gfx, input and
+    // window calls must not be made.
+    bool windowless;
+    // Stops the frame loop after this many frames. 0 runs until the window is closed.
+    u32 max_frames;
+    // Pacing is done by the frame pacer only, useful for 144/240 Hz targets on 60 Hz swap chains.
+    bool disable_vsync;
+    // Fixed timestep in seconds for fixed_update. Defaults to 1/60 when fixed_update is set.
+    float fixed_timestep;
+    // GL calls and buffer swaps move to a render thread that owns the context, so update for
+    // frame N+1 overlaps submission of frame N. User code must not call GL directly when enabled.
+    bool render_thread;
+    // Threads in the job system, main thread included. 0 uses one per core.
+    u32 job_workers;
+    // Global allocator, installed before oslo allocates anything. Left zeroed it uses malloc/realloc/free.
+    oslo_allocator_t allocator;
+    // Initial size of the frame arena. 0 uses OSLO_FRAME_ARENA_DEFAULT_SIZE.
+    size_t frame_arena_size;
+    // Seed for oslo_rng_thread(). 0 seeds from the clock.
+    u64 rng_seed;
+
+	void(*init)(void*);
+	void(*update)(void*);
+    // Called zero or more times per frame, before update, with a constant oslo_get_delta_time()
+    void(*fixed_update)(void*);
+	void(*shutdown)(void*);
+    void(*on_oslo_error)(oslo_error_code, const char*);
+
+	void* user_data;
+} oslo_desc_t;
+
+typedef struct oslo_gfx_vertex_t
+{
+    vec4 position;
+    vec4 color;
+    vec2 uv;
+    float tex_index;
+} oslo_gfx_vertex_t;
+
+typedef struct oslo_gfx_texture_t
+{
+    int id;
+    uint32_t width;
+    uint32_t height;
+    uint32_t channels;
+    // Path the texture was loaded from, if any
+    oslo_string_id name;
+    // Category its estimated gpu memory is tracked under
+    oslo_memory_category memory_category;
+} oslo_gfx_texture_t;
+
+#define MAX_BATCH_TEXTURES 32
+
+typedef uint32_t oslo_texture_id;
+
+typedef struct oslo_gfx_quad_batch_t
+{
+    int vao;
+    int vbo;
+    int ibo;
+
+    oslo_gfx_vertex_t* vertices;
+    oslo_gfx_vertex_t* vert_ptr;
+
+    float texture_index;
+    oslo_texture_id bound_textures[MAX_BATCH_TEXTURES];
+
+    uint32_t max_indices;
+    uint32_t index_count;
+} oslo_gfx_quad_batch_t;
+
+typedef struct draw_texture_section_desc_t
+{
+    vec2 position;
+    float rotation;
+    vec2 size;
+    vec4 color;
+    oslo_rect_t section;
+    oslo_texture_id texture;
+    bool flip_horizontal;
+} draw_texture_section_desc_t;
+
+typedef struct draw_textured_quad_desc_t
+{
+    vec4 quad[4];
+    vec4 color;
+    oslo_rect_t section;
+    oslo_texture_id texture;
+    bool flip_horizontal;
+} draw_textured_quad_desc_t;
+
+typedef struct draw_texture_desc_t
+{
+    vec2 position;
+    float rotation;
+    vec2 size;
+    vec4 color;
+    oslo_texture_id texture;
+} draw_texture_desc_t;
+
+typedef struct draw_quad_desc_t
+{
+    vec2 position;
+    float rotation;
+    vec2 size;
+    vec4 color;
+} draw_quad_desc_t;
+
+typedef struct oslo_gfx_t
+{
+    int shader;
+    mat4 projection;
+    oslo_texture_id white_texture;
+
+    oslo_gfx_quad_batch_t default_batch;
+
+    oslo_slot_array(oslo_gfx_texture_t) textures;
+    // Loaded texture paths -> texture
+    oslo_string_map(oslo_texture_id) texture_names;
+
+    // oslo_gfx_render_thread_t, NULL when gfx runs on the main thread
+    void* render_thread;
+} oslo_gfx_t;
+
+typedef enum oslo_mouse_button_code
+{
+    OSLO_MOUSE_LBUTTON,
+    OSLO_MOUSE_RBUTTON,
+    OSLO_MOUSE_MBUTTON,
+    OSLO_MOUSE_BUTTON_CODE_COUNT
+} oslo_mouse_button_code;
+
+typedef enum oslo_keycode
+{
+    OSLO_KEYCODE_INVALID,
+    OSLO_KEYCODE_SPACE,
+    OSLO_KEYCODE_APOSTROPHE,  /* ' */
+    OSLO_KEYCODE_COMMA,  /* , */
+    OSLO_KEYCODE_MINUS,  /* - */
+    OSLO_KEYCODE_PERIOD,  /* . */
+    OSLO_KEYCODE_SLASH,  /* / */
+    OSLO_KEYCODE_0,
+    OSLO_KEYCODE_1,
+    OSLO_KEYCODE_2,
+    OSLO_KEYCODE_3,
+    OSLO_KEYCODE_4,
+    OSLO_KEYCODE_5,
+    OSLO_KEYCODE_6,
+    OSLO_KEYCODE_7,
+    OSLO_KEYCODE_8,
+    OSLO_KEYCODE_9,
+    OSLO_KEYCODE_SEMICOLON,  /* ; */
+    OSLO_KEYCODE_EQUAL,  /* = */
+    OSLO_KEYCODE_A,
+    OSLO_KEYCODE_B,
+    OSLO_KEYCODE_C,
+    OSLO_KEYCODE_D,
+    OSLO_KEYCODE_E,
+    OSLO_KEYCODE_F,
+    OSLO_KEYCODE_G,
+    OSLO_KEYCODE_H,
+    OSLO_KEYCODE_I,
     OSLO_KEYCODE_J,
     OSLO_KEYCODE_K,
     OSLO_KEYCODE_L,
@@ -741,1619 +1729,2803 @@ typedef enum oslo_keycode
     OSLO_KEYCODE_COUNT
 } oslo_keycode;
 
-typedef struct oslo_mouse_t
+typedef struct oslo_mouse_t
+{
+    b32 button_map[OSLO_MOUSE_BUTTON_CODE_COUNT];
+    b32 prev_map[OSLO_MOUSE_BUTTON_CODE_COUNT];
+    vec2 position;
+    vec2 delta;
+    vec2 wheel;
+    b32 moved_this_frame;
+    b32 locked;
+} oslo_mouse_t;
+
+typedef struct oslo_input_t
+{
+    b32 key_map[OSLO_KEYCODE_COUNT];
+    b32 prev_key_map[OSLO_KEYCODE_COUNT];
+    oslo_mouse_t mouse;
+} oslo_input_t;
+
+#ifndef OSLO_FRAME_HISTORY_SIZE
+    #define OSLO_FRAME_HISTORY_SIZE 256
+#endif
+
+// Ring buffer with the durations of the last OSLO_FRAME_HISTORY_SIZE frames, in nanoseconds
+typedef struct oslo_frame_history_t
+{
+    uint64_t durations[OSLO_FRAME_HISTORY_SIZE];
+    uint32_t head;
+    uint32_t count;
+} oslo_frame_history_t;
+
+typedef struct oslo_time_t
+{
+    // Monotonic nanoseconds
+    uint64_t start_ns;
+    uint64_t previous_ns;
+    uint64_t elapsed_ns;
+    uint64_t delta_ns;
+    uint64_t fixed_delta_ns;
+
+    float delta;
+    float fixed_delta;
+    float alpha;
+    uint64_t frame_count;
+
+    oslo_frame_history_t history;
+} oslo_time_t;
+
+typedef struct oslo_t
+{
+	oslo_desc_t desc;
+    oslo_gfx_t gfx;
+    oslo_audio_t audio;
+    oslo_input_t input;
+    oslo_time_t time;
+    bool running;
+
+    // oslo_job_system_t
+    void* jobs;
+    // oslo_async_scheduler_t
+    void* async;
+    // Reset at the start of every frame
+    oslo_arena_t frame_arena;
+    int32_t exit_code;
+
+    struct GLFWwindow* window;
+} oslo_t;
+
+typedef struct oslo_baked_char_t
+{
+   unsigned short x0,y0,x1,y1; // coordinates of bbox in bitmap
+   float xoff,yoff,xadvance;
+} oslo_baked_char_t;
+
+typedef struct oslo_font_t
+{
+    oslo_baked_char_t glyphs[96];
+    oslo_texture_id texture;
+} oslo_font_t;
+#pragma endregion
+
+#pragma region OSLO_GFX
+OSLO_API_DECL void oslo_gfx_begin();
+OSLO_API_DECL void oslo_gfx_end();
+OSLO_API_DECL void oslo_gfx_draw_quad(vec2 position, float rotation, vec2 size, vec4 color);
+OSLO_API_DECL oslo_texture_id oslo_gfx_load_texture(const char* path);
+OSLO_API_DECL void oslo_gfx_unload_texture(oslo_texture_id texture);
+// Texture last loaded from path, oslo_slot_array_INVALID_HANDLE if none
+OSLO_API_DECL oslo_texture_id oslo_gfx_find_texture(const char* path);
+OSLO_API_DECL void oslo_gfx_draw_texture(vec2 position, float rotation, vec2 size, vec4 tint, oslo_texture_id texture);
+OSLO_API_DECL void oslo_gfx_draw_texture_section(vec2 position, float rotation, vec2 size, vec4 tint, oslo_texture_id texture, oslo_rect_t rect, bool flip_horizontal);
+OSLO_API_DECL void oslo_gfx_draw_textured_quad(vec4 quad[4], vec4 tint, oslo_texture_id texture, oslo_rect_t rect, bool flip_horizontal);
+OSLO_API_DECL oslo_texture_id oslo_gfx_create_texture(void* data, uint32_t width, uint32_t height, uint32_t num_channels);
+OSLO_API_DECL void oslo_gfx_text(const char* text, vec2 position, float size, vec4 color, oslo_font_t* font);
+OSLO_API_DECL bool oslo_gfx_quad_batch_create(size_t max_quads, oslo_gfx_quad_batch_t* out_batch);
+OSLO_API_DECL void oslo_gfx_quad_batch_destroy(oslo_gfx_quad_batch_t* batch);
+OSLO_API_DECL void oslo_gfx_quad_batch_render(oslo_gfx_quad_batch_t* batch);
+OSLO_API_DECL void oslo_gfx_quad_batch_update_content(oslo_gfx_quad_batch_t* batch);
+OSLO_API_DECL void oslo_gfx_quad_batch_reset(oslo_gfx_quad_batch_t* batch);
+OSLO_API_DECL bool oslo_gfx_quad_batch_is_full(oslo_gfx_quad_batch_t* batch);
+OSLO_API_DECL void oslo_gfx_quad_batch_draw_quad(oslo_gfx_quad_batch_t* batch, draw_quad_desc_t* desc);
+OSLO_API_DECL void oslo_gfx_quad_batch_draw_texture_section(oslo_gfx_quad_batch_t* batch, draw_texture_section_desc_t* desc);
+OSLO_API_DECL void oslo_gfx_quad_batch_draw_textured_quad(oslo_gfx_quad_batch_t* batch, draw_textured_quad_desc_t* desc);
+OSLO_API_DECL void oslo_gfx_quad_batch_draw_texture(oslo_gfx_quad_batch_t* batch, draw_texture_desc_t* desc);
+#pragma endregion
+
+#pragma region FILESYSTEM
+OSLO_API_DECL char* oslo_read_file_contents(const char* file_path, const char* mode, size_t* sz);
+// Same as above with the buffer coming from allocator, release it with oslo_allocator_free
+OSLO_API_DECL char* oslo_read_file_contents_allocator(const char* file_path, const char* mode, size_t* sz, const oslo_allocator_t* allocator);
+OSLO_API_DECL int32_t oslo_file_size_in_bytes(const char* file_path);
+#pragma endregion
+
+#pragma region FONTS
+// Fonts
+OSLO_API_DECL bool oslo_load_font_from_file(const char* path, uint32_t point_size, oslo_font_t* out_font);
+OSLO_API_DECL bool oslo_load_font_from_memory(void* memory, size_t len, uint32_t point_size, oslo_font_t* out_fount);
+OSLO_API_DECL void oslo_unload_font(oslo_font_t* font);
+#pragma endregion
+
+#pragma region INPUT
+// Input
+OSLO_API_DECL b32 oslo_is_key_pressed(oslo_keycode code);
+OSLO_API_DECL b32 oslo_was_key_pressed(oslo_keycode code);
+OSLO_API_DECL b32 oslo_is_key_released(oslo_keycode code);
+OSLO_API_DECL vec2 oslo_get_mouse_position();
+OSLO_API_DECL vec2 oslo_get_mouse_delta();
+OSLO_API_DECL b32 oslo_is_mouse_button_pressed(oslo_mouse_button_code code);
+OSLO_API_DECL b32 oslo_was_mouse_button_pressed(oslo_mouse_button_code code);
+OSLO_API_DECL b32 oslo_is_mouse_button_released(oslo_mouse_button_code code);
+
+#pragma endregion
+
+#pragma region WINDOW
+OSLO_API_DECL void oslo_set_window_title(const char* title);
+OSLO_API_DECL void* oslo_get_window_native_handle();
+#pragma endregion
+
+#pragma region TIME
+// Time
+OSLO_API_DECL float oslo_get_delta_time();
+OSLO_API_DECL float oslo_get_elapsed_time();
+OSLO_API_DECL double oslo_get_delta_time_f64();
+OSLO_API_DECL double oslo_get_elapsed_time_f64();
+OSLO_API_DECL uint64_t oslo_get_delta_time_ns();
+OSLO_API_DECL uint64_t oslo_get_time_ns();
+OSLO_API_DECL uint64_t oslo_get_frame_count();
+OSLO_API_DECL float oslo_get_fixed_delta_time();
+OSLO_API_DECL float oslo_get_interpolation_alpha();
+
+// Frame history
+OSLO_API_DECL const oslo_frame_history_t* oslo_get_frame_history();
+OSLO_API_DECL void oslo_frame_history_push(oslo_frame_history_t* history, uint64_t duration_ns);
+OSLO_API_DECL uint64_t oslo_frame_history_min(const oslo_frame_history_t* history);
+OSLO_API_DECL uint64_t oslo_frame_history_max(const oslo_frame_history_t* history);
+OSLO_API_DECL uint64_t oslo_frame_history_avg(const oslo_frame_history_t* history);
+OSLO_API_DECL uint64_t oslo_frame_history_percentile(const oslo_frame_history_t* history, float percentile);
+#pragma endregion
+
+#pragma region RANDOM
+// Generator of the calling thread, replaces rand(). The main thread stream only depends on the seed,
+// job worker streams depend on which worker asks first, use an own oslo_rng for replay critical code.
+OSLO_API_DECL oslo_rng* oslo_rng_thread();
+// Reseeds every thread generator on its next oslo_rng_thread() call
+OSLO_API_DECL void oslo_rng_set_seed(u64 seed);
+OSLO_API_DECL u64 oslo_rng_get_seed();
+#pragma endregion
+
+#pragma region NOISE
+// oslo_noise_fill_grid2/3 with the rows spread over the job workers, same output
+OSLO_API_DECL void oslo_noise_fill_grid2_parallel(const oslo_noise_desc* desc, f32* out, u32 width, u32 height, vec2 origin, f32 step);
+OSLO_API_DECL void oslo_noise_fill_grid3_parallel(const oslo_noise_desc* desc, f32* out, u32 width, u32 height, u32 depth, vec3 origin, f32 step);
+#pragma endregion
+
+#pragma region JOB
+/*===================================
+// Job System
+===================================*/
+
+typedef void (*oslo_job_func)(void* data);
+typedef void (*oslo_job_range_func)(uint32_t start, uint32_t end, void* data);
+
+// Number of jobs still running, zero once all of them have finished
+typedef struct oslo_job_counter_t
+{
+    volatile uint32_t value;
+} oslo_job_counter_t;
+
+typedef struct oslo_job_desc_t
+{
+    oslo_job_func func;
+    void* data;
+    // Optional, the job doesn't start its work until this counter reaches zero
+    oslo_job_counter_t* dependency;
+} oslo_job_desc_t;
+
+OSLO_API_DECL void oslo_job_run(const oslo_job_desc_t* jobs, uint32_t count, oslo_job_counter_t* counter);
+OSLO_API_DECL void oslo_job_wait(oslo_job_counter_t* counter);
+OSLO_API_DECL bool oslo_job_is_done(oslo_job_counter_t* counter);
+OSLO_API_DECL void oslo_job_parallel_for(uint32_t count, uint32_t batch_size, oslo_job_range_func func, void* data);
+OSLO_API_DECL uint32_t oslo_job_worker_count();
+#pragma endregion
+
+#pragma region ASYNC
+/*===================================
+// Async
+===================================*/
+
+// Coroutines for game logic, resumed once per frame on the main thread before update.
+// The oslo_async_wait_* calls suspend the calling coroutine and do nothing outside of one.
+
+typedef uint32_t oslo_async_id;
+typedef void (*oslo_async_func)(void* data);
+
+OSLO_API_DECL oslo_async_id oslo_async_spawn(oslo_async_func func, void* data);
+OSLO_API_DECL bool oslo_async_is_running(oslo_async_id id);
+OSLO_API_DECL void oslo_async_wait_frames(uint32_t frames);
+OSLO_API_DECL void oslo_async_wait_seconds(float seconds);
+// Resumes once the counter reaches zero, e.g. assets loaded with oslo_job_run
+OSLO_API_DECL void oslo_async_wait_counter(oslo_job_counter_t* counter);
+#pragma endregion
+
+#pragma region OSLO_MAIN
+
+OSLO_API_DECL oslo_desc_t oslo_main();
+// Value returned from main once the frame loop exits, 0 unless set
+OSLO_API_DECL void oslo_set_exit_code(int32_t code);
+
+#pragma endregion
+
+#ifdef OSLO_IMPL
+#pragma region EXTERNAL_IMPL
+
+// Created as a global variable to avoid sending the instance around. It will have conflicts if working with dll.
+static oslo_t* instance = NULL;
+
+#define GLAD_IMPL
+#include "external/glad/glad_impl.h"
+
+#define GLFW_IMPL
+#include "external/glfw/glfw_impl.h"
+
+// Route the loaders and coroutine stacks through the global allocator
+#define STBI_MALLOC(sz)           oslo_malloc(sz)
+#define STBI_REALLOC(p, newsz)    oslo_realloc(p, newsz)
+#define STBI_FREE(p)              oslo_free(p)
+#define STBTT_malloc(x, u)        ((void)(u), oslo_malloc(x))
+#define STBTT_free(x, u)          ((void)(u), oslo_free(x))
+#define DRWAV_MALLOC(sz)          oslo_malloc((sz))
+#define DRWAV_REALLOC(p, sz)      oslo_realloc((p), (sz))
+#define DRWAV_FREE(p)             oslo_free((p))
+#define DRMP3_MALLOC(sz)          oslo_malloc((sz))
+#define DRMP3_REALLOC(p, sz)      oslo_realloc((p), (sz))
+#define DRMP3_FREE(p)             oslo_free((p))
+#define MCO_MALLOC                oslo_malloc
+#define MCO_FREE                  oslo_free
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "external/stb/stb_image.h"
+
+#define STB_TRUETYPE_IMPLEMENTATION
+#include "external/stb/stb_truetype.h"
+
+#include "external/stb/stb_vorbis.c"
+#include "external/dr_libs/dr_wav.h"
+#include "external/dr_libs/dr_mp3.h"
+
+#define MINIAUDIO_IMPLEMENTATION
+#include "external/miniaudio/miniaudio.h"
+
+#define MINICORO_IMPL
+#include "external/minicoro/minicoro.h"
+
+#pragma endregion
+
+#pragma region INPUT_CALLBACKS
+// Input callbacks
+void __glfw_key_callback(GLFWwindow* window, s32 key, s32 scancode, s32 action, s32 mods);
+void __glfw_char_callback(GLFWwindow* window, uint32_t codepoint);
+void __glfw_mouse_button_callback(GLFWwindow* window, s32 button, s32 action, s32 mods);
+void __glfw_mouse_cursor_position_callback(GLFWwindow* window, f64 x, f64 y);
+void __glfw_mouse_scroll_wheel_callback(GLFWwindow* window, f64 xoffset, f64 yoffset);
+void __glfw_mouse_cursor_enter_callback(GLFWwindow* window, s32 entered);
+void __glfw_frame_buffer_size_callback(GLFWwindow* window, s32 width, s32 height);
+void __glfw_drop_callback(GLFWwindow* window);
+#pragma endregion
+
+#pragma region GFX
+// GFX
+void oslo_gfx_init(oslo_t* oslo);
+void oslo_gfx_shutdown(oslo_t* oslo);
+void oslo_gfx_begin_batch(oslo_t* oslo);
+void oslo_gfx_next_batch(oslo_t* oslo);
+void unload_texture(oslo_gfx_texture_t* texture);
+void oslo_gfx_exec(void(*fn)(void*), void* data);
+void oslo_gfx_render_thread_start(oslo_t* oslo);
+void oslo_gfx_render_thread_stop(oslo_t* oslo);
+void oslo_gfx_render_thread_submit(oslo_t* oslo);
+void oslo_gfx_record_clear(vec4 color);
+void oslo_gfx_record_viewport(int32_t width, int32_t height, mat4 projection);
+void oslo_gfx_record_batch(oslo_gfx_quad_batch_t* batch, const int* texture_ids);
+#pragma endregion
+
+#pragma region AUDIO
+void oslo_audio_init();
+void oslo_audio_shutdown();
+#pragma endregion
+
+#pragma region JOB
+void oslo_job_init(oslo_t* oslo);
+void oslo_job_shutdown(oslo_t* oslo);
+#pragma endregion
+
+#pragma region STRING
+void oslo_string_shutdown();
+#pragma endregion
+
+#pragma region MEMORY_TRACKING
+void __oslo_memory_new_frame();
+void __oslo_memory_report_leaks(void(*on_error)(oslo_error_code, const char*));
+#pragma endregion
+
+#pragma region ARENA
+#ifndef OSLO_FRAME_ARENA_DEFAULT_SIZE
+    #define OSLO_FRAME_ARENA_DEFAULT_SIZE (1024 * 1024)
+#endif
+
+// The frame arena when called from the main thread outside of a job, NULL (global allocator) otherwise.
+// Only for memory released before the call returns.
+const oslo_allocator_t* __oslo_scratch_allocator();
+
+static MCO_THREAD_LOCAL bool __oslo_is_main_thread = false;
+#pragma endregion
+
+#pragma region ASYNC
+void oslo_async_init(oslo_t* oslo);
+void oslo_async_shutdown(oslo_t* oslo);
+void oslo_async_update(oslo_t* oslo);
+#pragma endregion
+
+#pragma region INPUT
+// Input
+void oslo_input_init(oslo_t* oslo);
+void oslo_update_input(oslo_input_t* input);
+#pragma endregion
+
+#pragma region SHADERS
+const char* v_src_2D = 
+"#version 330 core\n"
+"layout (location = 0) in vec4 aPos;\n"
+"layout (location = 1) in vec4 aColor;\n"
+"layout (location = 2) in vec2 aUV;\n"
+"layout (location = 3) in float aTextureIndex;\n"
+"uniform mat4 u_projection;\n"
+"out vec4 color;\n"
+"out vec2 uv;\n"
+"out float tex_index;\n"
+"void main()\n"
+"{\n"
+"   color = aColor;\n"
+"   tex_index = aTextureIndex;\n"
+"   uv = aUV;\n"
+"   gl_Position = u_projection * aPos;\n"
+"}\0";
+
+const char* f_src_2D =
+"#version 330 core\n"
+"in vec4 color;\n"
+"in float tex_index;\n"
+"in vec2 uv;\n"
+"out vec4 FragColor;\n"
+"uniform sampler2D u_textures[32];\n"
+"void main()\n"
+"{\n"
+"	vec4 final_color = color;\n"
+"	switch (int(tex_index))							\n"
+"	{														\n"
+"	case  0: final_color *= texture(u_textures[0], uv); break;	\n"
+"	case  1: final_color *= texture(u_textures[1], uv); break;	\n"
+"	case  2: final_color *= texture(u_textures[2], uv); break;	\n"
+"	case  3: final_color *= texture(u_textures[3], uv); break;	\n"
+"	case  4: final_color *= texture(u_textures[4], uv); break;	\n"
+"	case  5: final_color *= texture(u_textures[5], uv); break;	\n"
+"	case  6: final_color *= texture(u_textures[6], uv); break;	\n"
+"	case  7: final_color *= texture(u_textures[7], uv); break;	\n"
+"	case  8: final_color *= texture(u_textures[8], uv); break;	\n"
+"	case  9: final_color *= texture(u_textures[9], uv); break;	\n"
+"	case 10: final_color *= texture(u_textures[10], uv); break;	\n"
+"	case 11: final_color *= texture(u_textures[11], uv); break;	\n"
+"	case 12: final_color *= texture(u_textures[12], uv); break;	\n"
+"	case 13: final_color *= texture(u_textures[13], uv); break;	\n"
+"	case 14: final_color *= texture(u_textures[14], uv); break;	\n"
+"	case 15: final_color *= texture(u_textures[15], uv); break;	\n"
+"	case 16: final_color *= texture(u_textures[16], uv); break;	\n"
+"	case 17: final_color *= texture(u_textures[17], uv); break;	\n"
+"	case 18: final_color *= texture(u_textures[18], uv); break;	\n"
+"	case 19: final_color *= texture(u_textures[19], uv); break;	\n"
+"	case 20: final_color *= texture(u_textures[20], uv); break;	\n"
+"	case 21: final_color *= texture(u_textures[21], uv); break;	\n"
+"	case 22: final_color *= texture(u_textures[22], uv); break;	\n"
+"	case 23: final_color *= texture(u_textures[23], uv); break;	\n"
+"	case 24: final_color *= texture(u_textures[24], uv); break;	\n"
+"	case 25: final_color *= texture(u_textures[25], uv); break;	\n"
+"	case 26: final_color *= texture(u_textures[26], uv); break;	\n"
+"	case 27: final_color *= texture(u_textures[27], uv); break;	\n"
+"	case 28: final_color *= texture(u_textures[28], uv); break;	\n"
+"	case 29: final_color *= texture(u_textures[29], uv); break;	\n"
+"	case 30: final_color *= texture(u_textures[30], uv); break;	\n"
+"	case 31: final_color *= texture(u_textures[31], uv); break;	\n"
+"	}\n"
+"   FragColor = final_color;\n"
+"}\n\0";
+#pragma endregion
+
+#pragma region GFX_DEFINES
+
+#define MAX_QUADS 20000
+#define MAX_VERTICES MAX_QUADS * 4
+#define MAX_INDICES MAX_QUADS * 6
+
+static vec2 _uvs[] =
 {
-    b32 button_map[OSLO_MOUSE_BUTTON_CODE_COUNT];
-    b32 prev_map[OSLO_MOUSE_BUTTON_CODE_COUNT];
-    vec2 position;
-    vec2 delta;
-    vec2 wheel;
-    b32 moved_this_frame;
-    b32 locked;
-} oslo_mouse_t;
+	{ 0.0f, 0.0f },
+	{ 1.0f, 0.0f },
+	{ 1.0f, 1.0f },
+	{ 0.0f, 1.0f }
+};
+
+static vec2 quad_positions[] =
+{
+	{ -1.0f, -1.0f }, // TL
+	{  1.0f, -1.0f }, // TR
+	{  1.0f,  1.0f }, // BR
+	{ -1.0f,  1.0f } // BL
+};
+#pragma endregion
+
+#pragma region UTILITY_FUNCS
+
+#define oslo_min(A, B) ((A) < (B) ? (A) : (B))
+#define oslo_clamp(V, MIN, MAX) ((V) > (MAX) ? (MAX) : (V) < (MIN) ? (MIN) : (V))
+
+// Trig tier used for sprite rotation, OSLO_MATH_PRECISION_MEDIUM is well below a pixel for sprites up to a few thousand pixels
+#ifndef OSLO_GFX_TRIG_PRECISION
+    #define OSLO_GFX_TRIG_PRECISION OSLO_MATH_PRECISION_EXACT
+#endif
+
+// Same as T(position) * T(size / 2) * R(rotation) * T(-size / 2) * S(size), built directly
+oslo_inline oslo_transform2d __oslo_gfx_quad_model(vec2 position, vec2 size, float rotation)
+{
+    float s, c;
+    oslo_sincos(rotation, &s, &c, OSLO_GFX_TRIG_PRECISION);
+    float hx = 0.5f * size.x;
+    float hy = 0.5f * size.y;
+    return transform2d_ctor(
+        c * size.x, s * size.x,
+        -s * size.y, c * size.y,
+        position.x + hx - (c * hx - s * hy),
+        position.y + hy - (s * hx + c * hy)
+    );
+}
+
+void __oslo_gfx_delete_texture_gl(void* data)
+{
+    glDeleteTextures(1, (GLuint*)data);
+}
+
+// RGB8 is usually padded to 4 bytes per texel by drivers
+#define __oslo_gfx_texture_gpu_bytes(__TEX) ((int64_t)(__TEX)->width * (__TEX)->height * 4)
+
+void unload_texture(oslo_gfx_texture_t* texture)
+{
+    oslo_gfx_exec(__oslo_gfx_delete_texture_gl, &texture->id);
+    oslo_memory_track_gpu(texture->memory_category, -__oslo_gfx_texture_gpu_bytes(texture));
+}
+
+vec2 get_framebuffer_size(oslo_t* oslo)
+{
+    uint32_t w = 0;
+    uint32_t h = 0;
+    glfwGetFramebufferSize(oslo->window, &w, &h);
+
+    return v2(w, h);
+}
+
+void notify_error(oslo_t* oslo, oslo_error_code code, const char* msg)
+{
+    if (oslo->desc.on_oslo_error != NULL)
+    {
+        oslo->desc.on_oslo_error(code, msg);
+    }
+}
+
+uint64_t oslo_platform_time_ns();
+
+float oslo_get_elapsed_time()
+{
+    return (float)oslo_get_elapsed_time_f64();
+}
+
+double oslo_get_elapsed_time_f64()
+{
+    return oslo_get_time_ns() / 1000000000.0;
+}
+
+uint64_t oslo_get_time_ns()
+{
+    return oslo_platform_time_ns() - instance->time.start_ns;
+}
+
+void oslo_platform_sleep(float ms)
+{
+    #if (defined OSLO_PLATFORM_WIN)
+
+            timeBeginPeriod(1);
+            Sleep((uint64_t)ms);
+            timeEndPeriod(1);
+
+    #elif (defined OSLO_PLATFORM_APPLE)
+
+            usleep(ms * 1000.f); // unistd.h
+    #else
+	    if (ms < 0.f) {
+		return;
+	    }
+
+	    struct timespec ts = default_val();
+	    int32_t res = 0;
+	    ts.tv_sec = (time_t)(ms / 1000.f);
+	    ts.tv_nsec = (long)((ms - ts.tv_sec * 1000.f) * 1000000.f);
+	    do {
+		res = nanosleep(&ts, &ts);
+	    } while (res && errno == EINTR);
+
+            // usleep(ms * 1000.f); // unistd.h
+    #endif
+}
+
+// Monotonic clock in nanoseconds, read from the OS directly so it works before glfwInit and in windowless runs
+uint64_t oslo_platform_time_ns()
+{
+    #if (defined OSLO_PLATFORM_WIN)
+        LARGE_INTEGER value, frequency;
+        QueryPerformanceCounter(&value);
+        QueryPerformanceFrequency(&frequency);
+        return ((uint64_t)value.QuadPart / frequency.QuadPart) * 1000000000ull + (((uint64_t)value.QuadPart % frequency.QuadPart) * 1000000000ull) / frequency.QuadPart;
+    #else
+        struct timespec ts = default_val();
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+    #endif
+}
+
+// Time left below this threshold is spun instead of slept, since sleeps overshoot by up to a scheduler tick
+#ifndef OSLO_FRAME_PACER_SPIN_NS
+    #define OSLO_FRAME_PACER_SPIN_NS 2000000ull
+#endif
+
+// Blocks until the monotonic clock reaches target_ns, coarse sleep first then spin-wait for the tail
+void oslo_frame_pacer_wait(uint64_t target_ns)
+{
+    uint64_t now = oslo_platform_time_ns();
+    while (now + OSLO_FRAME_PACER_SPIN_NS < target_ns)
+    {
+        oslo_platform_sleep((float)(target_ns - now - OSLO_FRAME_PACER_SPIN_NS) / 1000000.f);
+        now = oslo_platform_time_ns();
+    }
+
+    while (now < target_ns)
+    {
+        now = oslo_platform_time_ns();
+    }
+}
+
+uint32_t oslo_platform_cpu_count()
+{
+    #if (defined OSLO_PLATFORM_WIN)
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        return (uint32_t)info.dwNumberOfProcessors;
+    #else
+        long count = sysconf(_SC_NPROCESSORS_ONLN);
+        return count > 0 ? (uint32_t)count : 1;
+    #endif
+}
+
+bool oslo_platform_file_exists(const char* file_path)
+{
+    const char* path = file_path;
+
+    #ifdef OSLO_PLATFORM_ANDROID
+        const char* internal_data_path = oslo_app()->android.internal_data_path;
+        oslo_snprintfc(tmp_path, 1024, "%s/%s", internal_data_path, file_path);
+        path = tmp_path;
+    #endif
+
+    FILE* fp = fopen(path, "r");
+    if (fp) {
+        fclose(fp);
+        return true;
+    }
+    return false;
+}
+
+oslo_inline void
+oslo_str_to_lower
+(
+    const char* src,
+    char* buffer,
+    size_t buffer_sz
+)
+{
+    size_t src_sz = string_length(src);
+    size_t len = oslo_min(src_sz, buffer_sz);
+
+    for (uint32_t i = 0; i < len; ++i) {
+        buffer[i] = tolower(src[i]);
+    }
+}
+
+oslo_inline bool 
+oslo_string_compare_equal
+(
+    const char*     txt, 
+    const char*     cmp 
+)
+{
+    // Grab sizes of both strings
+    uint32_t a_sz = string_length(txt);
+    uint32_t b_sz = string_length(cmp);
+
+    // Return false if sizes do not match
+    if (a_sz != b_sz) 
+    {
+        return false;
+    }
+
+    for(uint32_t i = 0; i < a_sz; ++i) 
+    {
+        if (*txt++ != *cmp++)
+        {
+            return false;
+        }
+    };
+
+    return true;
+}
+
+oslo_inline 
+void oslo_get_file_extension
+(
+    char* buffer,
+    uint32_t buffer_size,
+    const char* file_path 
+)
+{
+    uint32_t str_len = string_length(file_path);
+    const char* at = (file_path + str_len - 1);
+    while (*at != '.' && at != file_path)
+    {
+        at--;
+    }
+
+    if (*at == '.')
+    {
+        at++;
+        uint32_t i = 0; 
+        while (*at)
+        {
+            char c = *at;
+            buffer[i++] = *at++;
+        }
+        buffer[i] = '\0';
+    }
+}
+
+#pragma endregion
+
+#pragma region RANDOM
+static u64 __oslo_rng_seed = 0;
+// Bumped on reseed, threads compare it with the generation they were seeded with
+static u32 __oslo_rng_generation = 0;
+static u32 __oslo_rng_worker_count = 0;
+
+static MCO_THREAD_LOCAL oslo_rng __oslo_thread_rng;
+static MCO_THREAD_LOCAL u32 __oslo_thread_rng_generation = 0;
+static MCO_THREAD_LOCAL u32 __oslo_thread_rng_stream = 0;
+
+oslo_rng* oslo_rng_thread()
+{
+    u32 generation = c89atomic_load_32(&__oslo_rng_generation);
+    if (__oslo_thread_rng_generation != generation)
+    {
+        if (__oslo_thread_rng_stream == 0)
+        {
+            __oslo_thread_rng_stream = __oslo_is_main_thread ? 1 : 2 + c89atomic_fetch_add_32(&__oslo_rng_worker_count, 1);
+        }
+        oslo_rng_seed(&__oslo_thread_rng, c89atomic_load_64(&__oslo_rng_seed) + __oslo_thread_rng_stream * 0x9E3779B97F4A7C15ull);
+        __oslo_thread_rng_generation = generation;
+    }
+    return &__oslo_thread_rng;
+}
 
-typedef struct oslo_input_t
+void oslo_rng_set_seed(u64 seed)
 {
-    b32 key_map[OSLO_KEYCODE_COUNT];
-    b32 prev_key_map[OSLO_KEYCODE_COUNT];
-    oslo_mouse_t mouse;
-} oslo_input_t;
+    c89atomic_store_64(&__oslo_rng_seed, seed);
+    c89atomic_fetch_add_32(&__oslo_rng_generation, 1);
+}
 
-typedef struct oslo_time_t
+u64 oslo_rng_get_seed()
 {
-    float previous;
-    float elapsed;
-    float delta;
-} oslo_time_t;
+    return c89atomic_load_64(&__oslo_rng_seed);
+}
+#pragma endregion
 
-typedef struct oslo_t
+#pragma region NOISE
+typedef struct __oslo_noise_grid_t
 {
-	oslo_desc_t desc;
-    oslo_gfx_t gfx;
-    oslo_audio_t audio;
-    oslo_input_t input;
-    oslo_time_t time;
-    bool running;
+    const oslo_noise_desc* desc;
+    f32* out;
+    u32 width;
+    u32 height;
+    vec3 origin;
+    f32 step;
+    bool is_3d;
+} __oslo_noise_grid_t;
 
-    struct GLFWwindow* window;
-} oslo_t;
+// Rows are numbered across slices, row = slice * height + r
+void __oslo_noise_fill_rows(uint32_t start, uint32_t end, void* data)
+{
+    __oslo_noise_grid_t* grid = (__oslo_noise_grid_t*)data;
+    for (uint32_t row = start; row < end; ++row)
+    {
+        u32 slice = row / grid->height;
+        u32 r = row % grid->height;
+        __oslo_noise_fill_row(grid->desc, grid->out + (size_t)row * grid->width, grid->width,
+            grid->origin.x, grid->origin.y + (f32)r * grid->step, grid->origin.z + (f32)slice * grid->step, grid->step, grid->is_3d);
+    }
+}
 
-typedef struct oslo_baked_char_t
+void oslo_noise_fill_grid2_parallel(const oslo_noise_desc* desc, f32* out, u32 width, u32 height, vec2 origin, f32 step)
 {
-   unsigned short x0,y0,x1,y1; // coordinates of bbox in bitmap
-   float xoff,yoff,xadvance;
-} oslo_baked_char_t;
+    __oslo_noise_grid_t grid = { desc, out, width, height, v3(origin.x, origin.y, 0.f), step, false };
+    oslo_job_parallel_for(height, 0, __oslo_noise_fill_rows, &grid);
+}
 
-typedef struct oslo_font_t
+void oslo_noise_fill_grid3_parallel(const oslo_noise_desc* desc, f32* out, u32 width, u32 height, u32 depth, vec3 origin, f32 step)
 {
-    oslo_baked_char_t glyphs[96];
-    oslo_texture_id texture;
-} oslo_font_t;
+    __oslo_noise_grid_t grid = { desc, out, width, height, origin, step, true };
+    oslo_job_parallel_for(height * depth, 0, __oslo_noise_fill_rows, &grid);
+}
 #pragma endregion
 
-#pragma region OSLO_GFX
-OSLO_API_DECL void oslo_gfx_begin();
-OSLO_API_DECL void oslo_gfx_end();
-OSLO_API_DECL void oslo_gfx_draw_quad(vec2 position, float rotation, vec2 size, vec4 color);
-OSLO_API_DECL oslo_texture_id oslo_gfx_load_texture(const char* path);
-OSLO_API_DECL void oslo_gfx_unload_texture(oslo_texture_id texture);
-OSLO_API_DECL void oslo_gfx_draw_texture(vec2 position, float rotation, vec2 size, vec4 tint, oslo_texture_id texture);
-OSLO_API_DECL void oslo_gfx_draw_texture_section(vec2 position, float rotation, vec2 size, vec4 tint, oslo_texture_id texture, oslo_rect_t rect, bool flip_horizontal);
-OSLO_API_DECL void oslo_gfx_draw_textured_quad(vec4 quad[4], vec4 tint, oslo_texture_id texture, oslo_rect_t rect, bool flip_horizontal);
-OSLO_API_DECL oslo_texture_id oslo_gfx_create_texture(void* data, uint32_t width, uint32_t height, uint32_t num_channels);
-OSLO_API_DECL void oslo_gfx_text(const char* text, vec2 position, float size, vec4 color, oslo_font_t* font);
-OSLO_API_DECL bool oslo_gfx_quad_batch_create(size_t max_quads, oslo_gfx_quad_batch_t* out_batch);
-OSLO_API_DECL void oslo_gfx_quad_batch_destroy(oslo_gfx_quad_batch_t* batch);
-OSLO_API_DECL void oslo_gfx_quad_batch_render(oslo_gfx_quad_batch_t* batch);
-OSLO_API_DECL void oslo_gfx_quad_batch_update_content(oslo_gfx_quad_batch_t* batch);
-OSLO_API_DECL void oslo_gfx_quad_batch_reset(oslo_gfx_quad_batch_t* batch);
-OSLO_API_DECL bool oslo_gfx_quad_batch_is_full(oslo_gfx_quad_batch_t* batch);
-OSLO_API_DECL void oslo_gfx_quad_batch_draw_quad(oslo_gfx_quad_batch_t* batch, draw_quad_desc_t* desc);
-OSLO_API_DECL void oslo_gfx_quad_batch_draw_texture_section(oslo_gfx_quad_batch_t* batch, draw_texture_section_desc_t* desc);
-OSLO_API_DECL void oslo_gfx_quad_batch_draw_textured_quad(oslo_gfx_quad_batch_t* batch, draw_textured_quad_desc_t* desc);
-OSLO_API_DECL void oslo_gfx_quad_batch_draw_texture(oslo_gfx_quad_batch_t* batch, draw_texture_desc_t* desc);
-#pragma endregion
+#pragma region MAIN
+void oslo_set_exit_code(int32_t code)
+{
+    instance->exit_code = code;
+}
 
-#pragma region FILESYSTEM
-OSLO_API_DECL char* oslo_read_file_contents(const char* file_path, const char* mode, size_t* sz);
-OSLO_API_DECL int32_t oslo_file_size_in_bytes(const char* file_path);
-#pragma endregion
+int main(int argc, char *argv[])
+{
+    oslo_desc_t desc = oslo_main();
+    desc.headless |= desc.windowless;
+    desc.render_thread &= !desc.windowless;
 
-#pragma region FONTS
-// Fonts
-OSLO_API_DECL bool oslo_load_font_from_file(const char* path, uint32_t point_size, oslo_font_t* out_font);
-OSLO_API_DECL bool oslo_load_font_from_memory(void* memory, size_t len, uint32_t point_size, oslo_font_t* out_fount);
-OSLO_API_DECL void oslo_unload_font(oslo_font_t* font);
-#pragma endregion
+    if (!desc.windowless && !glfwInit())
+        return -1;
 
-#pragma region INPUT
-// Input
-OSLO_API_DECL b32 oslo_is_key_pressed(oslo_keycode code);
-OSLO_API_DECL b32 oslo_was_key_pressed(oslo_keycode code);
-OSLO_API_DECL b32 oslo_is_key_released(oslo_keycode code);
-OSLO_API_DECL vec2 oslo_get_mouse_position();
-OSLO_API_DECL vec2 oslo_get_mouse_delta();
-OSLO_API_DECL b32 oslo_is_mouse_button_pressed(oslo_mouse_button_code code);
-OSLO_API_DECL b32 oslo_was_mouse_button_pressed(oslo_mouse_button_code code);
-OSLO_API_DECL b32 oslo_is_mouse_button_released(oslo_mouse_button_code code);
+    if (desc.allocator.alloc != NULL)
+    {
+        oslo_set_allocator(&desc.allocator);
+    }
 
-#pragma endregion
+    instance = oslo_malloc(sizeof(oslo_t));
+    memset(instance, 0, sizeof(oslo_t));
+    
+    instance->running = false;
+    instance->desc = desc;
+    instance->time.start_ns = oslo_platform_time_ns();
 
-#pragma region WINDOW
-OSLO_API_DECL void oslo_set_window_title(const char* title);
-OSLO_API_DECL void* oslo_get_window_native_handle();
-#pragma endregion
+    __oslo_is_main_thread = true;
+    oslo_rng_set_seed(desc.rng_seed ? desc.rng_seed : oslo_platform_time_ns());
+    oslo_arena_init(&instance->frame_arena, desc.frame_arena_size ? desc.frame_arena_size : OSLO_FRAME_ARENA_DEFAULT_SIZE, NULL);
 
-#pragma region HASH
-oslo_inline 
-uint32_t oslo_hash_uint32_t(uint32_t x)
-{
-    x = ((x >> 16) ^ x) * 0x45d9f3b;
-    x = ((x >> 16) ^ x) * 0x45d9f3b;
-    x = (x >> 16) ^ x;
-    return x;
-}
+    if (!desc.windowless)
+    {
+#if (defined PLATFORM_APPLE)
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 1);
+        glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+        glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+        glfwWindowHint(GLFW_COCOA_RETINA_FRAMEBUFFER, GLFW_FALSE);
+#else
+        glfwWindowHint(GLFW_SCALE_TO_MONITOR, GLFW_TRUE);
+        // glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, platform->settings.video.graphics.opengl.major_version);
+        // glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, platform->settings.video.graphics.opengl.minor_version);
+        // glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+        // glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 1);
+        // glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+        glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+   
+        //glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, GLFW_TRUE);
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 5);
+#endif
 
-#define oslo_hash_u32_ip(__X, __OUT)\
-    do {\
-        __OUT = ((__X >> 16) ^ __X) * 0x45d9f3b;\
-        __OUT = ((__OUT >> 16) ^ __OUT) * 0x45d9f3b;\
-        __OUT = (__OUT >> 16) ^ __OUT;\
-    } while (0) 
+        if (desc.headless)
+        {
+            glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+        }
+    
+        instance->window = glfwCreateWindow(desc.window_width, desc.window_height, desc.window_title, NULL, NULL);
+        if (!instance->window)
+        {
+            notify_error(instance, OSLO_PLATFORM_INIT_ERROR, "Failed create window!");
+            oslo_free(instance);
+            glfwTerminate();
+            return -1;
+        }
 
-oslo_inline 
-uint32_t oslo_hash_u64(uint64_t x)
-{
-    x = (x ^ (x >> 31) ^ (x >> 62)) * UINT64_C(0x319642b2d24d8ec3);
-    x = (x ^ (x >> 27) ^ (x >> 54)) * UINT64_C(0x96de1b173f119089);
-    x = x ^ (x >> 30) ^ (x >> 60);
-    return (uint32_t)x; 
-}
+        /* Make the window's context current */
+        glfwMakeContextCurrent(instance->window);
+        glfwSwapInterval((desc.headless || desc.disable_vsync) ? 0 : 1);
+    
+        if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+        {
+            notify_error(instance, OSLO_GFX_INIT_ERROR, "Failed to initialize glad");
+            glfwDestroyWindow(instance->window);
+            oslo_free(instance);
+            glfwTerminate();
 
-// http://www.cse.yorku.ca/~oz/hash.html
-// djb2 hash by dan bernstein
-oslo_inline 
-uint32_t oslo_hash_str(const char* str)
-{
-    uint32_t hash = 5381;
-    s32 c;
-    while ((c = *str++))
+            return -1;
+        }
+
+        oslo_input_init(instance);
+        oslo_gfx_init(instance);
+    }
+
+    oslo_audio_init();
+    oslo_job_init(instance);
+    oslo_async_init(instance);
+
+    if (desc.init != NULL)
+	{
+		desc.init(desc.user_data);
+	}
+
+    if (desc.render_thread)
     {
-        hash = ((hash << 5) + hash) + c; /* hash * 33 + c */
+        oslo_gfx_render_thread_start(instance);
     }
-    return hash;
+
+    instance->running = true;
+
+    uint64_t target_frame_ns = desc.max_fps > 0.f ? (uint64_t)(1000000000.0 / desc.max_fps) : 0;
+    uint64_t fixed_step_ns = (uint64_t)(1000000000.0 * (desc.fixed_timestep > 0.f ? desc.fixed_timestep : 1.0f / 60.0f));
+    uint64_t accumulator_ns = 0;
+
+    instance->time.fixed_delta_ns = fixed_step_ns;
+    instance->time.fixed_delta = fixed_step_ns / 1000000000.0f;
+    instance->time.previous_ns = oslo_platform_time_ns();
+
+    while(instance->running)
+    {
+        oslo_time_t* time = &instance->time;
+        oslo_arena_reset(&instance->frame_arena);
+        __oslo_memory_new_frame();
+
+        uint64_t frame_start_ns = oslo_platform_time_ns();
+        uint64_t frame_delta_ns = frame_start_ns - time->previous_ns;
+        time->delta_ns = frame_delta_ns;
+        time->delta = frame_delta_ns / 1000000000.0f;
+        time->elapsed_ns = frame_start_ns - time->start_ns;
+        time->previous_ns = frame_start_ns;
+        oslo_frame_history_push(&time->history, frame_delta_ns);
+
+        if (!desc.windowless)
+        {
+            oslo_update_input(&instance->input);
+             /* Poll for and process events */
+            glfwPollEvents();
+
+             // Render
+            if (instance->gfx.render_thread)
+            {
+                oslo_gfx_record_clear(v4(0.2f, 0.3f, 0.3f, 1.0f));
+            }
+            else
+            {
+                glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+                glClear(GL_COLOR_BUFFER_BIT);
+            }
+        }
+
+        oslo_async_update(instance);
+
+        // Fixed update, clamped to a few steps per frame so a long stall can't spiral
+        if (desc.fixed_update != NULL)
+        {
+            accumulator_ns += oslo_min(frame_delta_ns, fixed_step_ns * 8);
+
+            time->delta = time->fixed_delta;
+            time->delta_ns = time->fixed_delta_ns;
+            while (accumulator_ns >= fixed_step_ns)
+            {
+                desc.fixed_update(desc.user_data);
+                accumulator_ns -= fixed_step_ns;
+            }
+            time->delta = frame_delta_ns / 1000000000.0f;
+            time->delta_ns = frame_delta_ns;
+            time->alpha = (float)accumulator_ns / (float)fixed_step_ns;
+        }
+
+        // Update
+        if (desc.update != NULL)
+		{
+			desc.update(desc.user_data);
+		}
+
+        /* Swap front and back buffers */
+        if (instance->gfx.render_thread)
+        {
+            oslo_gfx_render_thread_submit(instance);
+        }
+        else if (!desc.windowless)
+        {
+            glfwSwapBuffers(instance->window);
+        }
+
+        if (!desc.headless && target_frame_ns)
+        {
+            oslo_frame_pacer_wait(frame_start_ns + target_frame_ns);
+        }
+
+        time->frame_count++;
+        instance->running = desc.windowless || !glfwWindowShouldClose(instance->window);
+        if (desc.max_frames && time->frame_count >= desc.max_frames)
+        {
+            instance->running = false;
+        }
+    }
+
+    if (desc.shutdown != NULL)
+	{
+		desc.shutdown(desc.user_data);
+	}
+
+    oslo_gfx_render_thread_stop(instance);
+    oslo_async_shutdown(instance);
+    oslo_job_shutdown(instance);
+    oslo_audio_shutdown();
+    if (!desc.windowless)
+    {
+        oslo_gfx_shutdown(instance);
+        glfwDestroyWindow(instance->window);
+    }
+    oslo_arena_free(&instance->frame_arena);
+    void(*on_error)(oslo_error_code, const char*) = desc.on_oslo_error;
+    int32_t exit_code = instance->exit_code;
+    oslo_free(instance);
+    instance = NULL;
+    if (!desc.windowless)
+    {
+        glfwTerminate();
+    }
+    oslo_string_shutdown();
+    __oslo_memory_report_leaks(on_error);
+
+    return exit_code;
 }
 
-oslo_inline uint32_t 
-string_length(const char* txt)
+#pragma endregion
+
+#pragma region GFX
+/*========================
+// GFX
+========================*/
+
+void load_shader(oslo_t* oslo)
 {
-    uint32_t sz = 0;
-    while (txt != NULL && txt[ sz ] != '\0') 
+    oslo_gfx_t* gfx = &oslo->gfx;
+    // Create and compile shader
+    unsigned int vertex, fragment;
+    int success;
+    char infoLog[512];
+    
+    // vertex Shader
+    vertex = glCreateShader(GL_VERTEX_SHADER);
+    glShaderSource(vertex, 1, &v_src_2D, NULL);
+    glCompileShader(vertex);
+    // print compile errors if any
+    glGetShaderiv(vertex, GL_COMPILE_STATUS, &success);
+    if(!success)
+    {
+        glGetShaderInfoLog(vertex, 512, NULL, infoLog);
+        notify_error(oslo, OSLO_SHADER_COMPILE_ERROR, infoLog);
+    };
+
+    // Fragment Shader
+    fragment = glCreateShader(GL_FRAGMENT_SHADER);
+    glShaderSource(fragment, 1, &f_src_2D, NULL);
+    glCompileShader(fragment);
+    // print compile errors if any
+    glGetShaderiv(fragment, GL_COMPILE_STATUS, &success);
+    if(!success)
+    {
+        glGetShaderInfoLog(fragment, 512, NULL, infoLog);
+        notify_error(oslo, OSLO_SHADER_COMPILE_ERROR, infoLog);
+    };
+
+    // shader Program
+    gfx->shader = glCreateProgram();
+    glAttachShader(gfx->shader, vertex);
+    glAttachShader(gfx->shader, fragment);
+    glLinkProgram(gfx->shader);
+    // print linking errors if any
+    glGetProgramiv(gfx->shader, GL_LINK_STATUS, &success);
+    if(!success)
     {
-        sz++;
+        glGetProgramInfoLog(gfx->shader, 512, NULL, infoLog);
+        notify_error(oslo, OSLO_SHADER_LINKER_ERROR, infoLog);
     }
-    return sz;
-}
+    
+    // delete the shaders as they're linked into our program now and no longer necessary
+    glDeleteShader(vertex);
+    glDeleteShader(fragment);
+}  
 
-oslo_inline 
-uint64_t oslo_hash_str64(const char* str)
+void setup_projection(oslo_t* oslo)
 {
-    uint32_t hash1 = 5381;
-    uint32_t hash2 = 52711;
-    uint32_t i = string_length(str);
-    while(i--) 
-    {
-        char c = str[ i ];
-        hash1 = (hash1 * 33) ^ c;
-        hash2 = (hash2 * 33) ^ c;
-    }
-
-    return (hash1 >> 0) * 4096 + (hash2 >> 0);
-}
+    vec2 fbs = get_framebuffer_size(oslo);
 
-oslo_inline
-bool oslo_compare_bytes(void* b0, void* b1, size_t len)
-{
-    return 0 == memcmp(b0, b1, len);
-}
+    oslo_gfx_t* gfx = &oslo->gfx;
 
-// Hash generic bytes using (ripped directly from Sean Barret's stb_ds.h)
-#define OSLO_SIZE_T_BITS  ((sizeof(size_t)) * 8)
-#define OSLO_SIPHASH_C_ROUNDS 1
-#define OSLO_SIPHASH_D_ROUNDS 1
-#define oslo_rotate_left(__V, __N)   (((__V) << (__N)) | ((__V) >> (OSLO_SIZE_T_BITS - (__N))))
-#define oslo_rotate_right(__V, __N)  (((__V) >> (__N)) | ((__V) << (OSLO_SIZE_T_BITS - (__N))))
+    // Setup projection based on window size
+    gfx->projection = mat4_ortho(0.0f, fbs.x, fbs.y, 0.0f, -1.0f, 1.0f);  
 
-#ifdef _MSC_VER
-#pragma warning(push)
-#pragma warning(disable:4127) // conditional expression is constant, for do..while(0) and sizeof()==
-#endif
+    // Upload projection
+    glUseProgram(gfx->shader);
+    glUniformMatrix4fv(glGetUniformLocation(gfx->shader, "u_projection"), 1, GL_FALSE, &gfx->projection.elements[0]);
+    glUseProgram(0);
+}
 
-oslo_inline 
-size_t oslo_hash_siphash_bytes(void *p, size_t len, size_t seed)
+typedef struct __oslo_gfx_quad_batch_create_gl_t
 {
-  unsigned char *d = (unsigned char *) p;
-  size_t i,j;
-  size_t v0,v1,v2,v3, data;
+    oslo_gfx_quad_batch_t* batch;
+    u32* indices;
+} __oslo_gfx_quad_batch_create_gl_t;
 
-  // hash that works on 32- or 64-bit registers without knowing which we have
-  // (computes different results on 32-bit and 64-bit platform)
-  // derived from siphash, but on 32-bit platforms very different as it uses 4 32-bit state not 4 64-bit
-  v0 = ((((size_t) 0x736f6d65 << 16) << 16) + 0x70736575) ^  seed;
-  v1 = ((((size_t) 0x646f7261 << 16) << 16) + 0x6e646f6d) ^ ~seed;
-  v2 = ((((size_t) 0x6c796765 << 16) << 16) + 0x6e657261) ^  seed;
-  v3 = ((((size_t) 0x74656462 << 16) << 16) + 0x79746573) ^ ~seed;
+void __oslo_gfx_quad_batch_create_gl(void* data);
 
-  #ifdef STBDS_TEST_SIPHASH_2_4
-  // hardcoded with key material in the siphash test vectors
-  v0 ^= 0x0706050403020100ull ^  seed;
-  v1 ^= 0x0f0e0d0c0b0a0908ull ^ ~seed;
-  v2 ^= 0x0706050403020100ull ^  seed;
-  v3 ^= 0x0f0e0d0c0b0a0908ull ^ ~seed;
-  #endif
+bool oslo_gfx_quad_batch_create(size_t max_quads, oslo_gfx_quad_batch_t* out_batch)
+{
+    size_t size = (max_quads * 4) * sizeof(oslo_gfx_vertex_t);
 
-  #define oslo_sipround() \
-    do {                   \
-      v0 += v1; v1 = oslo_rotate_left(v1, 13);  v1 ^= v0; v0 = oslo_rotate_left(v0,OSLO_SIZE_T_BITS/2); \
-      v2 += v3; v3 = oslo_rotate_left(v3, 16);  v3 ^= v2;                                                 \
-      v2 += v1; v1 = oslo_rotate_left(v1, 17);  v1 ^= v2; v2 = oslo_rotate_left(v2,OSLO_SIZE_T_BITS/2); \
-      v0 += v3; v3 = oslo_rotate_left(v3, 21);  v3 ^= v0;                                                 \
-    } while (0)
+    out_batch->vertices = oslo_malloc(size);
+    memset(out_batch->vertices, 0, size);
 
-  for (i=0; i+sizeof(size_t) <= len; i += sizeof(size_t), d += sizeof(size_t)) {
-    data = d[0] | (d[1] << 8) | (d[2] << 16) | (d[3] << 24);
-    data |= (size_t) (d[4] | (d[5] << 8) | (d[6] << 16) | (d[7] << 24)) << 16 << 16; // discarded if size_t == 4
+    u32 max_indices = max_quads * 6;
+    out_batch->max_indices = max_indices;
+    size_t indices_size = max_indices * sizeof(u32);
+    u32* indices = oslo_malloc(indices_size);
+	memset(indices, 0, indices_size);
 
-    v3 ^= data;
-    for (j=0; j < OSLO_SIPHASH_C_ROUNDS; ++j)
-      oslo_sipround();
-    v0 ^= data;
-  }
-  data = len << (OSLO_SIZE_T_BITS-8);
-  switch (len - i) {
-    case 7: data |= ((size_t) d[6] << 24) << 24; // fall through
-    case 6: data |= ((size_t) d[5] << 20) << 20; // fall through
-    case 5: data |= ((size_t) d[4] << 16) << 16; // fall through
-    case 4: data |= (d[3] << 24); // fall through
-    case 3: data |= (d[2] << 16); // fall through
-    case 2: data |= (d[1] << 8); // fall through
-    case 1: data |= d[0]; // fall through
-    case 0: break;
-  }
-  v3 ^= data;
-  for (j=0; j < OSLO_SIPHASH_C_ROUNDS; ++j)
-    oslo_sipround();
-  v0 ^= data;
-  v2 ^= 0xff;
-  for (j=0; j < OSLO_SIPHASH_D_ROUNDS; ++j)
-    oslo_sipround();
+	u32 offset = 0;
+	for (u32 i = 0; i < max_indices; i += 6)
+	{
+		indices[i + 0] = offset + 0;
+		indices[i + 1] = offset + 1;
+		indices[i + 2] = offset + 2;
 
-#if 0
-  return v0^v1^v2^v3;
-#else
-  return v1^v2^v3; // slightly stronger since v0^v3 in above cancels out final round operation? I tweeted at the authors of SipHash about this but they didn't reply
-#endif
-}
+		indices[i + 3] = offset + 2;
+		indices[i + 4] = offset + 3;
+		indices[i + 5] = offset + 0;
 
-oslo_inline
-size_t oslo_hash_bytes(void *p, size_t len, size_t seed)
-{
-#if 0
-  return oslo_hash_siphash_bytes(p,len,seed);
-#else
-  unsigned char *d = (unsigned char *) p;
+		offset += 4;
+	}
 
-  // Len == 4 (off for now, so to force 64 bit hash)
-  if (len == 4) {
-    unsigned int hash = d[0] | (d[1] << 8) | (d[2] << 16) | (d[3] << 24);
-    hash ^= seed;
-    hash *= 0xcc9e2d51;
-    hash = (hash << 17) | (hash >> 15);
-    hash *= 0x1b873593;
-    hash ^= seed;
-    hash = (hash << 19) | (hash >> 13);
-    hash = hash*5 + 0xe6546b64;
-    hash ^= hash >> 16;
-    hash *= 0x85ebca6b;
-    hash ^= seed;
-    hash ^= hash >> 13;
-    hash *= 0xc2b2ae35;
-    hash ^= hash >> 16;
-    return (((size_t) hash << 16 << 16) | hash) ^ seed;
-  } else if (len == 8 && sizeof(size_t) == 8) {
-    size_t hash = d[0] | (d[1] << 8) | (d[2] << 16) | (d[3] << 24);
-    hash |= (size_t) (d[4] | (d[5] << 8) | (d[6] << 16) | (d[7] << 24)) << 16 << 16; // avoid warning if size_t == 4
-    hash ^= seed;
-    hash = (~hash) + (hash << 21);
-    hash ^= oslo_rotate_right(hash,24);
-    hash *= 265;
-    hash ^= oslo_rotate_right(hash,14);
-    hash ^= seed;
-    hash *= 21;
-    hash ^= oslo_rotate_right(hash,28);
-    hash += (hash << 31);
-    hash = (~hash) + (hash << 18);
-    return hash;
-  } else {
-    return oslo_hash_siphash_bytes(p,len,seed);
-  }
-#endif
-}
-#ifdef _MSC_VER
-#pragma warning(pop)
-#endif
+    out_batch->index_count = 0;
 
-#pragma endregion
+    oslo_gfx_exec(__oslo_gfx_quad_batch_create_gl, &(__oslo_gfx_quad_batch_create_gl_t){ out_batch, indices });
+    oslo_free(indices);
 
-#pragma region HASH_TABLE
+    out_batch->bound_textures[0] = instance->gfx.white_texture;
+    out_batch->texture_index = 1;
 
-#define OSLO_HASH_TABLE_HASH_SEED         0x31415296
-#define OSLO_HASH_TABLE_INVALID_INDEX     UINT32_MAX
+    return true;
+}
 
-typedef enum oslo_hash_table_entry_state
+void __oslo_gfx_quad_batch_create_gl(void* data)
 {
-    OSLO_HASH_TABLE_ENTRY_INACTIVE = 0x00,
-    OSLO_HASH_TABLE_ENTRY_ACTIVE = 0x01
-} oslo_hash_table_entry_state;
-
-#define __oslo_hash_table_entry(__HMK, __HMV)\
-    struct\
-    {\
-        __HMK key;\
-        __HMV val;\
-        oslo_hash_table_entry_state state;\
-    }
-
-#define oslo_hash_table(__HMK, __HMV)\
-    struct {\
-        __oslo_hash_table_entry(__HMK, __HMV)* data;\
-        __HMK tmp_key;\
-        __HMV tmp_val;\
-        size_t stride;\
-        size_t klpvl;\
-        size_t tmp_idx;\
-    }*
+    __oslo_gfx_quad_batch_create_gl_t* args = (__oslo_gfx_quad_batch_create_gl_t*)data;
+    oslo_gfx_quad_batch_t* out_batch = args->batch;
+    u32* indices = args->indices;
 
-// Need a way to create a temporary key so I can take the address of it
+    glGenVertexArrays(1, &out_batch->vao);
+    glGenBuffers(1, &out_batch->vbo);
+    glGenBuffers(1, &out_batch->ibo);
+    // bind the Vertex Array Object first, then bind and set vertex buffer(s), and then configure vertex attributes(s).
+    glBindVertexArray(out_batch->vao);
 
-#define oslo_hash_table_new(__K, __V)\
-    NULL
+    glBindBuffer(GL_ARRAY_BUFFER, out_batch->vbo);
+    glBufferData(GL_ARRAY_BUFFER, MAX_VERTICES * sizeof(oslo_gfx_vertex_t), out_batch->vertices, GL_DYNAMIC_DRAW);
 
-OSLO_API_DECL void __oslo_hash_table_init_impl(void** ht, size_t sz);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, out_batch->ibo);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, MAX_INDICES * sizeof(u32), indices, GL_STATIC_DRAW);
 
-#define oslo_hash_table_init(__HT, __K, __V)\
-    do {\
-        size_t entry_sz = sizeof(__K) + sizeof(__V) + sizeof(oslo_hash_table_entry_state);\
-        size_t ht_sz = sizeof(__K) + sizeof(__V) + sizeof(void*) + 3 * sizeof(size_t);\
-        __oslo_hash_table_init_impl((void**)&(__HT), ht_sz);\
-        memset((__HT), 0, ht_sz);\
-        oslo_dyn_array_reserve(__HT->data, 2);\
-        __HT->data[0].state = OSLO_HASH_TABLE_ENTRY_INACTIVE;\
-        __HT->data[1].state = OSLO_HASH_TABLE_ENTRY_INACTIVE;\
-        uintptr_t d0 = (uintptr_t)&((__HT)->data[0]);\
-        uintptr_t d1 = (uintptr_t)&((__HT)->data[1]);\
-        ptrdiff_t diff = (d1 - d0);\
-        ptrdiff_t klpvl = (uintptr_t)&(__HT->data[0].state) - (uintptr_t)(&__HT->data[0]);\
-        (__HT)->stride = (size_t)(diff);\
-        (__HT)->klpvl = (size_t)(klpvl);\
-    } while (0)
+    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(oslo_gfx_vertex_t), (void*)offsetof(oslo_gfx_vertex_t, position));
+    glEnableVertexAttribArray(0);
 
-#define oslo_hash_table_reserve(_HT, _KT, _VT, _CT)\
-    do {\
-        if ((_HT) == NULL) {\
-            oslo_hash_table_init((_HT), _KT, _VT);\
-        }\
-        oslo_dyn_array_reserve((_HT)->data, _CT);\
-    } while (0)
+    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(oslo_gfx_vertex_t), (void*)offsetof(oslo_gfx_vertex_t, color));
+    glEnableVertexAttribArray(1);
 
-    // ((__HT) != NULL ? (__HT)->size : 0) // oslo_dyn_array_size((__HT)->data) : 0)
-#define oslo_hash_table_size(__HT)\
-    ((__HT) != NULL ? oslo_dyn_array_size((__HT)->data) : 0)
+    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(oslo_gfx_vertex_t), (void*)offsetof(oslo_gfx_vertex_t, uv));
+    glEnableVertexAttribArray(2);
 
-#define oslo_hash_table_capacity(__HT)\
-    ((__HT) != NULL ? oslo_dyn_array_capacity((__HT)->data) : 0)
+    glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, sizeof(oslo_gfx_vertex_t), (void*)offsetof(oslo_gfx_vertex_t, tex_index));
+    glEnableVertexAttribArray(3);
+}
 
-#define oslo_hash_table_load_factor(__HT)\
-    (oslo_hash_table_capacity(__HT) ? (float)(oslo_hash_table_size(__HT)) / (float)(oslo_hash_table_capacity(__HT)) : 0.f)
+void __oslo_gfx_quad_batch_destroy_gl(void* data)
+{
+    oslo_gfx_quad_batch_t* batch = (oslo_gfx_quad_batch_t*)data;
+    glDeleteVertexArrays(1, &batch->vao);
+    glDeleteBuffers(1, &batch->vbo);
+    glDeleteBuffers(1, &batch->ibo);
+}
 
-#define oslo_hash_table_grow(__HT, __C)\
-    ((__HT)->data = oslo_dyn_array_resize_impl((__HT)->data, sizeof(*((__HT)->data)), (__C)))
+void oslo_gfx_quad_batch_destroy(oslo_gfx_quad_batch_t* batch)
+{
+    oslo_free(batch->vertices);
+    oslo_gfx_exec(__oslo_gfx_quad_batch_destroy_gl, batch);
+}
 
-#define oslo_hash_table_empty(__HT)\
-    ((__HT) != NULL ? oslo_dyn_array_size((__HT)->data) == 0 : true)
+void __oslo_gfx_draw_textured_indices(const int* texture_ids, uint32_t index_count)
+{
+    glUseProgram(instance->gfx.shader);
 
-#define oslo_hash_table_clear(__HT)\
-    do {\
-        if ((__HT) != NULL) {\
-            uint32_t capacity = oslo_dyn_array_capacity((__HT)->data);\
-            for (uint32_t i = 0; i < capacity; ++i) {\
-                (__HT)->data[i].state = oslo_HASH_TABLE_ENTRY_INACTIVE;\
-            }\
-            /*memset((__HT)->data, 0, oslo_dyn_array_capacity((__HT)->data) * );*/\
-            oslo_dyn_array_clear((__HT)->data);\
-        }\
-    } while (0)
+    // Upload textures
+    for (uint32_t i = 0; i < MAX_BATCH_TEXTURES; ++i)
+    {
+        glActiveTexture(GL_TEXTURE0 + i);
+        glBindTexture(GL_TEXTURE_2D, texture_ids[i]);
 
-#define oslo_hash_table_free(__HT)\
-    do {\
-        if ((__HT) != NULL) {\
-            oslo_dyn_array_free((__HT)->data);\
-            (__HT)->data = NULL;\
-            oslo_free(__HT);\
-            (__HT) = NULL;\
-        }\
-    } while (0)
+        char uniform_name[50];
+        sprintf(uniform_name, "u_textures[%i]", i);
+        glUniform1i(glGetUniformLocation(instance->gfx.shader, uniform_name), i);
+    }
 
-// Find available slot to insert k/v pair into
-#define oslo_hash_table_insert(__HT, __HMK, __HMV)\
-    do {\
-        /* Check for null hash table, init if necessary */\
-        if ((__HT) == NULL) {\
-            oslo_hash_table_init((__HT), (__HMK), (__HMV));\
-        }\
-    \
-        /* Grow table if necessary */\
-        uint32_t __CAP = oslo_hash_table_capacity(__HT);\
-        float __LF = oslo_hash_table_load_factor(__HT);\
-        if (__LF >= 0.5f || !__CAP)\
-        {\
-            uint32_t NEW_CAP = __CAP ? __CAP * 2 : 2;\
-            size_t ENTRY_SZ = sizeof((__HT)->tmp_key) + sizeof((__HT)->tmp_val) + sizeof(oslo_hash_table_entry_state);\
-            oslo_dyn_array_reserve((__HT)->data, NEW_CAP);\
-            /**((void **)&(__HT->data)) = oslo_dyn_array_resize_impl(__HT->data, ENTRY_SZ, NEW_CAP);*/\
-            /* Iterate through data and set state to null, from __CAP -> __CAP * 2 */\
-            /* Memset here instead */\
-            for (uint32_t __I = __CAP; __I < NEW_CAP; ++__I) {\
-                (__HT)->data[__I].state = OSLO_HASH_TABLE_ENTRY_INACTIVE;\
-            }\
-            __CAP = oslo_hash_table_capacity(__HT);\
-        }\
-    \
-        /* Get hash of key */\
-        (__HT)->tmp_key = (__HMK);\
-        size_t __HSH = oslo_hash_bytes((void*)&((__HT)->tmp_key), sizeof((__HT)->tmp_key), OSLO_HASH_TABLE_HASH_SEED);\
-        size_t __HSH_IDX = __HSH % __CAP;\
-        (__HT)->tmp_key = (__HT)->data[__HSH_IDX].key;\
-        uint32_t c = 0;\
-    \
-        /* Find valid idx and place data */\
-        while (\
-            c < __CAP\
-            && __HSH != oslo_hash_bytes((void*)&(__HT)->tmp_key, sizeof((__HT)->tmp_key), OSLO_HASH_TABLE_HASH_SEED)\
-            && (__HT)->data[__HSH_IDX].state == OSLO_HASH_TABLE_ENTRY_ACTIVE)\
-        {\
-            __HSH_IDX = ((__HSH_IDX + 1) % __CAP);\
-            (__HT)->tmp_key = (__HT)->data[__HSH_IDX].key;\
-            ++c;\
-        }\
-        (__HT)->data[__HSH_IDX].key = (__HMK);\
-        (__HT)->data[__HSH_IDX].val = (__HMV);\
-        (__HT)->data[__HSH_IDX].state = OSLO_HASH_TABLE_ENTRY_ACTIVE;\
-        oslo_dyn_array_head((__HT)->data)->size++;\
-    } while (0)
+    // draw mesh
+    glDrawElements(GL_TRIANGLES, index_count, GL_UNSIGNED_INT, NULL);
+}
 
-// Need size difference between two entries
-// Need size of key + val
+void oslo_gfx_quad_batch_render(oslo_gfx_quad_batch_t* batch)
+{
+    if (batch->index_count > 0)
+    {
+        // Resolve handles to GL ids here, so the render thread never reads the texture slot array
+        int texture_ids[MAX_BATCH_TEXTURES];
+        for (uint32_t i = 0; i < MAX_BATCH_TEXTURES; ++i)
+        {
+            oslo_gfx_texture_t* texture = oslo_slot_array_getp(instance->gfx.textures, batch->bound_textures[i]);
+            texture_ids[i] = texture != NULL ? texture->id : 0;
+        }
 
-oslo_inline
-uint32_t oslo_hash_table_get_key_index_func(void** data, void* key, size_t key_len, size_t val_len, size_t stride, size_t klpvl)
-{
-    if (!data || !key) return OSLO_HASH_TABLE_INVALID_INDEX;
-
-    // Need a better way to handle this. Can't do it like this anymore.
-    // Need to fix this. Seriously messing me up.
-    uint32_t capacity = oslo_dyn_array_capacity(*data);
-    size_t idx = (size_t)OSLO_HASH_TABLE_INVALID_INDEX;
-    size_t hash = (size_t)oslo_hash_bytes(key, key_len, OSLO_HASH_TABLE_HASH_SEED);
-    size_t hash_idx = (hash % capacity);
-
-    // Iterate through data 
-    for (size_t i = hash_idx, c = 0; c < capacity; ++c, i = ((i + 1) % capacity))
-    {
-        size_t offset = (i * stride);
-        void* k = ((char*)(*data) + (offset));  
-        size_t kh = oslo_hash_bytes(k, key_len, OSLO_HASH_TABLE_HASH_SEED);
-        bool comp = oslo_compare_bytes(k, key, key_len);
-        oslo_hash_table_entry_state state = *(oslo_hash_table_entry_state*)((char*)(*data) + offset + (klpvl)); 
-        if (comp && hash == kh && state == OSLO_HASH_TABLE_ENTRY_ACTIVE) {
-            idx = i;
-            break;
+        if (instance->gfx.render_thread)
+        {
+            oslo_gfx_record_batch(batch, texture_ids);
+            return;
         }
+
+        __oslo_gfx_draw_textured_indices(texture_ids, batch->index_count);
     }
-    return (uint32_t)idx;
 }
 
-// Get key at index
-#define oslo_hash_table_getk(__HT, __I)\
-    (((__HT))->data[(__I)].key)
+void oslo_gfx_quad_batch_update_content(oslo_gfx_quad_batch_t* batch)
+{
+    // Vertices are copied into the frame command stream by oslo_gfx_quad_batch_render instead
+    if (instance->gfx.render_thread)
+    {
+        return;
+    }
 
-// Get val at index
-#define oslo_hash_table_geti(__HT, __I)\
-    ((__HT)->data[(__I)].val)
+    glBindVertexArray(batch->vao);
+    // Update vbo data
+    uint32_t data_size = (uint32_t)((uint8_t*)batch->vert_ptr - (uint8_t*)batch->vertices);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, data_size, batch->vertices);
+}
 
-// Could search for the index in the macro instead now. Does this help me?
-#define oslo_hash_table_get(__HT, __HTK)\
-    ((__HT)->tmp_key = (__HTK),\
-        (oslo_hash_table_geti((__HT),\
-            oslo_hash_table_get_key_index_func((void**)&(__HT)->data, (void*)&((__HT)->tmp_key),\
-                sizeof((__HT)->tmp_key), sizeof((__HT)->tmp_val), (__HT)->stride, (__HT)->klpvl)))) 
+void oslo_gfx_quad_batch_reset(oslo_gfx_quad_batch_t* batch)
+{
+    batch->index_count = 0;
+	batch->vert_ptr = batch->vertices;
+    batch->texture_index = 1; // 0 is for white texture
+}
 
-#define oslo_hash_table_getp(__HT, __HTK)\
-    (\
-        (__HT)->tmp_key = (__HTK),\
-        ((__HT)->tmp_idx = (uint32_t)oslo_hash_table_get_key_index_func((void**)&(__HT->data), (void*)&(__HT->tmp_key), sizeof(__HT->tmp_key),\
-            sizeof(__HT->tmp_val), __HT->stride, __HT->klpvl)),\
-        ((__HT)->tmp_idx != OSLO_HASH_TABLE_INVALID_INDEX ? &oslo_hash_table_geti((__HT), (__HT)->tmp_idx) : NULL)\
-    )
+void oslo_gfx_quad_batch_draw_texture_section(oslo_gfx_quad_batch_t* batch, draw_texture_section_desc_t* desc)
+{
+    oslo_gfx_t* gfx = &instance->gfx;
+    oslo_gfx_texture_t* p_texture = oslo_slot_array_getp(gfx->textures, desc->texture);
+    uint32_t width = p_texture->width;
+    uint32_t height = p_texture->height;
 
-#define oslo_hash_table_key_exists(__HT, __HTK)\
-    ((__HT)->tmp_key = (__HTK),\
-        (oslo_hash_table_get_key_index_func((void**)&(__HT->data), (void*)&(__HT->tmp_key), sizeof(__HT->tmp_key),\
-            sizeof(__HT->tmp_val), __HT->stride, __HT->klpvl) != OSLO_HASH_TABLE_INVALID_INDEX))
+    float sprite_width = (float)(desc->section.max.x - desc->section.min.x) / width;
+	float sprite_height = (float)(desc->section.max.y - desc->section.min.y) / height;
+	float sprite_pos_x = (float)desc->section.min.x / width;
+	float sprite_pos_y = (float)desc->section.min.y / height;
 
-// uint32_t oslo_hash_table_get_key_index_func(void** data, void* key, size_t key_len, size_t val_len, size_t stride, size_t klpvl)
+    vec2 sprite_uvs[4] = { 0 };
 
-#define oslo_hash_table_exists(__HT, __HTK)\
-		(__HT && oslo_hash_table_key_exists((__HT), (__HTK)))
+    if (desc->flip_horizontal)
+	{
+		sprite_uvs[0] = v2(sprite_pos_x + sprite_width, sprite_pos_y);
+		sprite_uvs[1] = v2(sprite_pos_x, sprite_pos_y);
+		sprite_uvs[2] = v2(sprite_pos_x, sprite_pos_y + sprite_height);
+		sprite_uvs[3] = v2(sprite_pos_x + sprite_width, sprite_pos_y + sprite_height);
+	}
+	else
+	{
+		sprite_uvs[0] = v2(sprite_pos_x, sprite_pos_y);
+		sprite_uvs[1] = v2(sprite_pos_x + sprite_width, sprite_pos_y);
+		sprite_uvs[2] = v2(sprite_pos_x + sprite_width, sprite_pos_y + sprite_height);
+		sprite_uvs[3] = v2(sprite_pos_x, sprite_pos_y + sprite_height);
+	}
 
-#define oslo_hash_table_erase(__HT, __HTK)\
-    do {\
-        /* Get idx for key */\
-        (__HT)->tmp_key = (__HTK);\
-        uint32_t __IDX = oslo_hash_table_get_key_index_func((void**)&(__HT)->data, (void*)&((__HT)->tmp_key), sizeof((__HT)->tmp_key), sizeof((__HT)->tmp_val), (__HT)->stride, (__HT)->klpvl);\
-        if (__IDX != OSLO_HASH_TABLE_INVALID_INDEX) {\
-            (__HT)->data[__IDX].state = OSLO_HASH_TABLE_ENTRY_INACTIVE;\
-            if (oslo_dyn_array_head((__HT)->data)->size) oslo_dyn_array_head((__HT)->data)->size--;\
-        }\
-    } while (0)
+    if (oslo_gfx_quad_batch_is_full(batch))
+        return;//oslo_gfx_next_batch(instance);
 
-/*===== Hash Table Iterator ====*/
+    vec2 corners[4];
+    oslo_transform2d model = __oslo_gfx_quad_model(desc->position, desc->size, desc->rotation);
+    transform2d_apply_n(&model, quad_positions, corners, 4);
 
-typedef uint32_t oslo_hash_table_iter;
+    float texture_index = 0.0f;
+	for (uint32_t i = 1; i < batch->texture_index; ++i)
+	{
+		if (batch->bound_textures[i] == desc->texture)
+		{
+			texture_index = (float)i;
+			break;
+		}
+	}
 
-oslo_inline
-uint32_t __oslo_find_first_valid_iterator(void* data, size_t key_len, size_t val_len, uint32_t idx, size_t stride, size_t klpvl)
-{
-    uint32_t it = (uint32_t)idx;
-    for (; it < (uint32_t)oslo_dyn_array_capacity(data); ++it)
-    {
-        size_t offset = (it * stride);
-        oslo_hash_table_entry_state state = *(oslo_hash_table_entry_state*)((uint8_t*)data + offset + (klpvl));
-        if (state == OSLO_HASH_TABLE_ENTRY_ACTIVE)
-        {
-            break;
-        }
-    }
-    return it;
-}
+    if (texture_index == 0)
+	{
+		texture_index = (float)batch->texture_index;
+		batch->bound_textures[(int)batch->texture_index] = desc->texture;
+		batch->texture_index++;
+	}
 
-/* Find first valid iterator idx */
-#define oslo_hash_table_iter_new(__HT)\
-    (__HT ? __oslo_find_first_valid_iterator((__HT)->data, sizeof((__HT)->tmp_key), sizeof((__HT)->tmp_val), 0, (__HT)->stride, (__HT)->klpvl) : 0)
+    for (size_t i = 0; i < 4; ++i)
+	{
+		batch->vert_ptr->position = v4(corners[i].x, corners[i].y, 0.0f, 1.0f);
+		batch->vert_ptr->color = v4(desc->color.x, desc->color.y, desc->color.z, desc->color.w);
+		batch->vert_ptr->uv = sprite_uvs[i];
+        batch->vert_ptr->tex_index = texture_index; // 0 means white texture
+		batch->vert_ptr++;
+	}
 
-#define oslo_hash_table_iter_valid(__HT, __IT)\
-    ((__IT) < oslo_hash_table_capacity((__HT)))
+    batch->index_count += 6;
+}
 
-// Have to be able to do this for hash table...
-oslo_inline
-void __oslo_hash_table_iter_advance_func(void** data, size_t key_len, size_t val_len, uint32_t* it, size_t stride, size_t klpvl)
+void oslo_gfx_quad_batch_draw_textured_quad(oslo_gfx_quad_batch_t* batch, draw_textured_quad_desc_t* desc)
 {
-    (*it)++;
-    for (; *it < (uint32_t)oslo_dyn_array_capacity(*data); ++*it)
-    {
-        size_t offset = (size_t)(*it * stride);
-        oslo_hash_table_entry_state state = *(oslo_hash_table_entry_state*)((uint8_t*)*data + offset + (klpvl));
-        if (state == OSLO_HASH_TABLE_ENTRY_ACTIVE)
-        {
-            break;
-        }
-    }
-}
+    oslo_gfx_t* gfx = &instance->gfx;
+    oslo_gfx_texture_t* p_texture = oslo_slot_array_getp(gfx->textures, desc->texture);
+    uint32_t width = p_texture->width;
+    uint32_t height = p_texture->height;
 
-#define oslo_hash_table_find_valid_iter(__HT, __IT)\
-    ((__IT) = __oslo_find_first_valid_iterator((void**)&(__HT)->data, sizeof((__HT)->tmp_key), sizeof((__HT)->tmp_val), (__IT), (__HT)->stride, (__HT)->klpvl))
+    float sprite_width = (float)(desc->section.max.x - desc->section.min.x) / width;
+	float sprite_height = (float)(desc->section.max.y - desc->section.min.y) / height;
+	float sprite_pos_x = (float)desc->section.min.x / width;
+	float sprite_pos_y = (float)desc->section.min.y / height;
 
-#define oslo_hash_table_iter_advance(__HT, __IT)\
-    (__oslo_hash_table_iter_advance_func((void**)&(__HT)->data, sizeof((__HT)->tmp_key), sizeof((__HT)->tmp_val), &(__IT), (__HT)->stride, (__HT)->klpvl))
+    vec2 sprite_uvs[4] = { 0 };
 
-#define oslo_hash_table_iter_get(__HT, __IT)\
-    oslo_hash_table_geti(__HT, __IT)
+    if (desc->flip_horizontal)
+	{
+		sprite_uvs[0] = v2(sprite_pos_x + sprite_width, sprite_pos_y);
+		sprite_uvs[1] = v2(sprite_pos_x, sprite_pos_y);
+		sprite_uvs[2] = v2(sprite_pos_x, sprite_pos_y + sprite_height);
+		sprite_uvs[3] = v2(sprite_pos_x + sprite_width, sprite_pos_y + sprite_height);
+	}
+	else
+	{
+		sprite_uvs[0] = v2(sprite_pos_x, sprite_pos_y);
+		sprite_uvs[1] = v2(sprite_pos_x + sprite_width, sprite_pos_y);
+		sprite_uvs[2] = v2(sprite_pos_x + sprite_width, sprite_pos_y + sprite_height);
+		sprite_uvs[3] = v2(sprite_pos_x, sprite_pos_y + sprite_height);
+	}
 
-#define oslo_hash_table_iter_getp(__HT, __IT)\
-    (&(oslo_hash_table_geti(__HT, __IT)))
+    if (oslo_gfx_quad_batch_is_full(batch))
+        return;//oslo_gfx_next_batch(instance);
 
-#define oslo_hash_table_iter_getk(__HT, __IT)\
-    (oslo_hash_table_getk(__HT, __IT))
+    float texture_index = 0.0f;
+	for (uint32_t i = 1; i < batch->texture_index; ++i)
+	{
+		if (batch->bound_textures[i] == desc->texture)
+		{
+			texture_index = (float)i;
+			break;
+		}
+	}
 
-#define oslo_hash_table_iter_getkp(__HT, __IT)\
-    (&(oslo_hash_table_getk(__HT, __IT)))
+    if (texture_index == 0)
+	{
+		texture_index = (float)batch->texture_index;
+		batch->bound_textures[(int)batch->texture_index] = desc->texture;
+		batch->texture_index++;
+	}
 
-#pragma endregion
+    for (size_t i = 0; i < 4; ++i)
+	{
+		batch->vert_ptr->position = desc->quad[i];
+		batch->vert_ptr->color = v4(desc->color.x, desc->color.y, desc->color.z, desc->color.w);
+		batch->vert_ptr->uv = sprite_uvs[i];
+        batch->vert_ptr->tex_index = texture_index; // 0 means white texture
+		batch->vert_ptr++;
+	}
 
-#pragma region TIME
-// Time
-OSLO_API_DECL float oslo_get_delta_time();
-OSLO_API_DECL float oslo_get_elapsed_time();
-#pragma endregion
+    batch->index_count += 6;
+}
 
-#pragma region OSLO_MAIN
+void oslo_gfx_quad_batch_draw_quad(oslo_gfx_quad_batch_t* batch, draw_quad_desc_t* desc)
+{
+    oslo_gfx_t* gfx = &instance->gfx;
 
-OSLO_API_DECL oslo_desc_t oslo_main();
+    if (oslo_gfx_quad_batch_is_full(batch))
+        return;
 
-#pragma endregion
+    vec2 corners[4];
+    oslo_transform2d model = __oslo_gfx_quad_model(desc->position, desc->size, desc->rotation);
+    transform2d_apply_n(&model, quad_positions, corners, 4);
 
-#ifdef OSLO_IMPL
-#pragma region EXTERNAL_IMPL
+    for (size_t i = 0; i < 4; ++i)
+	{
+		batch->vert_ptr->position = v4(corners[i].x, corners[i].y, 0.0f, 1.0f);
+		batch->vert_ptr->color = v4(desc->color.x, desc->color.y, desc->color.z, desc->color.w);
+		batch->vert_ptr->uv = _uvs[i];
+        batch->vert_ptr->tex_index = 0; // 0 means white texture
+		batch->vert_ptr++;
+	}
 
-// Created as a global variable to avoid sending the instance around. It will have conflicts if working with dll.
-static oslo_t* instance = NULL;
+    batch->index_count += 6;
+}
 
-#define GLAD_IMPL
-#include "external/glad/glad_impl.h"
+void oslo_gfx_quad_batch_draw_texture(oslo_gfx_quad_batch_t* batch, draw_texture_desc_t* desc)
+{
+    oslo_gfx_t* gfx = &instance->gfx;
 
-#define GLFW_IMPL
-#include "external/glfw/glfw_impl.h"
+    if (oslo_gfx_quad_batch_is_full(batch))
+        return;//oslo_gfx_next_batch(instance);
 
-#define STB_IMAGE_IMPLEMENTATION
-#include "external/stb/stb_image.h"
+    vec2 corners[4];
+    oslo_transform2d model = __oslo_gfx_quad_model(desc->position, desc->size, desc->rotation);
+    transform2d_apply_n(&model, quad_positions, corners, 4);
+
+    float texture_index = 0.0f;
+	for (uint32_t i = 1; i < batch->texture_index; ++i)
+	{
+		if (batch->bound_textures[i] == desc->texture)
+		{
+			texture_index = (float)i;
+			break;
+		}
+	}
+
+    if (texture_index == 0)
+	{
+		texture_index = (float)batch->texture_index;
+		batch->bound_textures[(int)batch->texture_index] = desc->texture;
+		batch->texture_index++;
+	}
+
+    for (size_t i = 0; i < 4; ++i)
+	{
+		batch->vert_ptr->position = v4(corners[i].x, corners[i].y, 0.0f, 1.0f);
+		batch->vert_ptr->color = v4(desc->color.x, desc->color.y, desc->color.z, desc->color.w);
+		batch->vert_ptr->uv = _uvs[i];
+        batch->vert_ptr->tex_index = texture_index; // 0 means white texture
+		batch->vert_ptr++;
+	}
 
-#define STB_TRUETYPE_IMPLEMENTATION
-#include "external/stb/stb_truetype.h"
+    batch->index_count += 6;
+}
 
-#include "external/stb/stb_vorbis.c"
-#include "external/dr_libs/dr_wav.h"
-#include "external/dr_libs/dr_mp3.h"
+bool oslo_gfx_quad_batch_is_full(oslo_gfx_quad_batch_t* batch)
+{
+    return (batch->index_count >= batch->max_indices) || (batch->texture_index >= MAX_BATCH_TEXTURES);
+}
 
-#define MINIAUDIO_IMPLEMENTATION
-#include "external/miniaudio/miniaudio.h"
+void oslo_gfx_init(oslo_t* oslo)
+{
+    oslo_gfx_t* gfx = &oslo->gfx;
+    memset(gfx, 0, sizeof(oslo_gfx_t));
+    oslo_memory_category category = oslo_memory_push_category(OSLO_MEMORY_GFX);
 
-#pragma endregion
+    gfx->textures = oslo_slot_array_new(oslo_gfx_texture_t);
+    
+    load_shader(oslo);
+    setup_projection(oslo);
 
-#pragma region INPUT_CALLBACKS
-// Input callbacks
-void __glfw_key_callback(GLFWwindow* window, s32 key, s32 scancode, s32 action, s32 mods);
-void __glfw_char_callback(GLFWwindow* window, uint32_t codepoint);
-void __glfw_mouse_button_callback(GLFWwindow* window, s32 button, s32 action, s32 mods);
-void __glfw_mouse_cursor_position_callback(GLFWwindow* window, f64 x, f64 y);
-void __glfw_mouse_scroll_wheel_callback(GLFWwindow* window, f64 xoffset, f64 yoffset);
-void __glfw_mouse_cursor_enter_callback(GLFWwindow* window, s32 entered);
-void __glfw_frame_buffer_size_callback(GLFWwindow* window, s32 width, s32 height);
-void __glfw_drop_callback(GLFWwindow* window);
-#pragma endregion
+    // Textures
+    uint32_t white_texture_data = 0xffffffff;
+    gfx->white_texture = oslo_gfx_create_texture(&white_texture_data, 1, 1, 4);
 
-#pragma region GFX
-// GFX
-void oslo_gfx_init(oslo_t* oslo);
-void oslo_gfx_shutdown(oslo_t* oslo);
-void oslo_gfx_begin_batch(oslo_t* oslo);
-void oslo_gfx_next_batch(oslo_t* oslo);
-void unload_texture(oslo_gfx_texture_t* texture);
-#pragma endregion
+    oslo_gfx_quad_batch_create(MAX_QUADS, &gfx->default_batch);
 
-#pragma region AUDIO
-void oslo_audio_init();
-void oslo_audio_shutdown();
-#pragma endregion
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glEnable( GL_BLEND );
+    oslo_memory_pop_category(category);
+}
 
-#pragma region INPUT
-// Input
-void oslo_input_init(oslo_t* oslo);
-void oslo_update_input(oslo_input_t* input);
-#pragma endregion
+void oslo_gfx_shutdown(oslo_t* oslo)
+{
+    oslo_gfx_quad_batch_destroy(&oslo->gfx.default_batch);
 
-#pragma region SHADERS
-const char* v_src_2D = 
-"#version 330 core\n"
-"layout (location = 0) in vec4 aPos;\n"
-"layout (location = 1) in vec4 aColor;\n"
-"layout (location = 2) in vec2 aUV;\n"
-"layout (location = 3) in float aTextureIndex;\n"
-"uniform mat4 u_projection;\n"
-"out vec4 color;\n"
-"out vec2 uv;\n"
-"out float tex_index;\n"
-"void main()\n"
-"{\n"
-"   color = aColor;\n"
-"   tex_index = aTextureIndex;\n"
-"   uv = aUV;\n"
-"   gl_Position = u_projection * aPos;\n"
-"}\0";
+    oslo_slot_array_dense_for(oslo->gfx.textures, i)
+    {
+        unload_texture(oslo_slot_array_dense_getp(oslo->gfx.textures, i));
+    }
 
-const char* f_src_2D =
-"#version 330 core\n"
-"in vec4 color;\n"
-"in float tex_index;\n"
-"in vec2 uv;\n"
-"out vec4 FragColor;\n"
-"uniform sampler2D u_textures[32];\n"
-"void main()\n"
-"{\n"
-"	vec4 final_color = color;\n"
-"	switch (int(tex_index))							\n"
-"	{														\n"
-"	case  0: final_color *= texture(u_textures[0], uv); break;	\n"
-"	case  1: final_color *= texture(u_textures[1], uv); break;	\n"
-"	case  2: final_color *= texture(u_textures[2], uv); break;	\n"
-"	case  3: final_color *= texture(u_textures[3], uv); break;	\n"
-"	case  4: final_color *= texture(u_textures[4], uv); break;	\n"
-"	case  5: final_color *= texture(u_textures[5], uv); break;	\n"
-"	case  6: final_color *= texture(u_textures[6], uv); break;	\n"
-"	case  7: final_color *= texture(u_textures[7], uv); break;	\n"
-"	case  8: final_color *= texture(u_textures[8], uv); break;	\n"
-"	case  9: final_color *= texture(u_textures[9], uv); break;	\n"
-"	case 10: final_color *= texture(u_textures[10], uv); break;	\n"
-"	case 11: final_color *= texture(u_textures[11], uv); break;	\n"
-"	case 12: final_color *= texture(u_textures[12], uv); break;	\n"
-"	case 13: final_color *= texture(u_textures[13], uv); break;	\n"
-"	case 14: final_color *= texture(u_textures[14], uv); break;	\n"
-"	case 15: final_color *= texture(u_textures[15], uv); break;	\n"
-"	case 16: final_color *= texture(u_textures[16], uv); break;	\n"
-"	case 17: final_color *= texture(u_textures[17], uv); break;	\n"
-"	case 18: final_color *= texture(u_textures[18], uv); break;	\n"
-"	case 19: final_color *= texture(u_textures[19], uv); break;	\n"
-"	case 20: final_color *= texture(u_textures[20], uv); break;	\n"
-"	case 21: final_color *= texture(u_textures[21], uv); break;	\n"
-"	case 22: final_color *= texture(u_textures[22], uv); break;	\n"
-"	case 23: final_color *= texture(u_textures[23], uv); break;	\n"
-"	case 24: final_color *= texture(u_textures[24], uv); break;	\n"
-"	case 25: final_color *= texture(u_textures[25], uv); break;	\n"
-"	case 26: final_color *= texture(u_textures[26], uv); break;	\n"
-"	case 27: final_color *= texture(u_textures[27], uv); break;	\n"
-"	case 28: final_color *= texture(u_textures[28], uv); break;	\n"
-"	case 29: final_color *= texture(u_textures[29], uv); break;	\n"
-"	case 30: final_color *= texture(u_textures[30], uv); break;	\n"
-"	case 31: final_color *= texture(u_textures[31], uv); break;	\n"
-"	}\n"
-"   FragColor = final_color;\n"
-"}\n\0";
-#pragma endregion
+    oslo_slot_array_free(oslo->gfx.textures);
+    oslo_string_map_free(oslo->gfx.texture_names);
+    glDeleteProgram(oslo->gfx.shader);
+}
 
-#pragma region GFX_DEFINES
+void oslo_gfx_begin()
+{
+    // Update projection? 
+    // We can update projection only when framebuffer size changes, or on demand
+    oslo_gfx_begin_batch(instance);
+}
 
-#define MAX_QUADS 20000
-#define MAX_VERTICES MAX_QUADS * 4
-#define MAX_INDICES MAX_QUADS * 6
+void oslo_gfx_end()
+{
+    oslo_gfx_quad_batch_update_content(&instance->gfx.default_batch);
+    oslo_gfx_quad_batch_render(&instance->gfx.default_batch);
+}
 
-static vec2 _uvs[] =
+void oslo_gfx_begin_batch(oslo_t* oslo)
 {
-	{ 0.0f, 0.0f },
-	{ 1.0f, 0.0f },
-	{ 1.0f, 1.0f },
-	{ 0.0f, 1.0f }
-};
+    oslo_gfx_t* gfx = &oslo->gfx;
+    oslo_gfx_quad_batch_reset(&oslo->gfx.default_batch);
+}
 
-static vec4 quad_positions[] =
+void oslo_gfx_next_batch(oslo_t* oslo)
 {
-	{ -1.0f, -1.0f, 0.0f, 1.0f }, // TL
-	{  1.0f, -1.0f, 0.0f, 1.0f }, // TR
-	{  1.0f,  1.0f, 0.0f, 1.0f }, // BR
-	{ -1.0f,  1.0f, 0.0f, 1.0f } // BL
-};
-#pragma endregion
+    oslo_gfx_quad_batch_update_content(&oslo->gfx.default_batch);
+    oslo_gfx_quad_batch_render(&oslo->gfx.default_batch);
+    oslo_gfx_begin_batch(oslo);
+}
 
-#pragma region UTILITY_FUNCS
+void oslo_gfx_draw_quad(vec2 position, float rotation, vec2 size, vec4 color)
+{
+    if (oslo_gfx_quad_batch_is_full(&instance->gfx.default_batch))
+        oslo_gfx_next_batch(instance);
 
-#define oslo_min(A, B) ((A) < (B) ? (A) : (B))
-#define oslo_clamp(V, MIN, MAX) ((V) > (MAX) ? (MAX) : (V) < (MIN) ? (MIN) : (V))
+    oslo_gfx_quad_batch_draw_quad(&instance->gfx.default_batch, &(draw_quad_desc_t)
+    {
+        .position = position,
+        .rotation = rotation,
+        .size = size,
+        .color = color
+    });
+}
 
-void unload_texture(oslo_gfx_texture_t* texture)
+void oslo_gfx_draw_texture(vec2 position, float rotation, vec2 size, vec4 tint, oslo_texture_id texture)
 {
-    glDeleteTextures(1, &texture->id);
+    if (oslo_gfx_quad_batch_is_full(&instance->gfx.default_batch))
+        oslo_gfx_next_batch(instance);
+
+    oslo_gfx_quad_batch_draw_texture(&instance->gfx.default_batch, &(draw_texture_desc_t)
+    {
+        .position = position,
+        .rotation = rotation,
+        .size = size,
+        .color = tint,
+        .texture = texture
+    });
 }
 
-vec2 get_framebuffer_size(oslo_t* oslo)
+void oslo_gfx_draw_textured_quad(vec4 quad[4], vec4 tint, oslo_texture_id texture, oslo_rect_t rect, bool flip_horizontal)
 {
-    uint32_t w = 0;
-    uint32_t h = 0;
-    glfwGetFramebufferSize(oslo->window, &w, &h);
+   if (oslo_gfx_quad_batch_is_full(&instance->gfx.default_batch))
+        oslo_gfx_next_batch(instance);
 
-    return v2(w, h);
+    oslo_gfx_quad_batch_draw_textured_quad(&instance->gfx.default_batch, &(draw_textured_quad_desc_t)
+    {
+        .quad = {quad[0], quad[1], quad[2], quad[3]},
+        .color = tint,
+        .texture = texture,
+        .section = rect,
+        .flip_horizontal = flip_horizontal
+    });
 }
 
-void notify_error(oslo_t* oslo, oslo_error_code code, const char* msg)
+void oslo_gfx_draw_texture_section(vec2 position, float rotation, vec2 size, vec4 tint, oslo_texture_id texture, oslo_rect_t rect, bool flip_horizontal)
 {
-    if (oslo->desc.on_oslo_error != NULL)
+    if (oslo_gfx_quad_batch_is_full(&instance->gfx.default_batch))
+        oslo_gfx_next_batch(instance);
+
+    oslo_gfx_quad_batch_draw_texture_section(&instance->gfx.default_batch, &(draw_texture_section_desc_t)
     {
-        oslo->desc.on_oslo_error(code, msg);
-    }
+        .position = position,
+        .rotation = rotation,
+        .size = size,
+        .color = tint,
+        .texture = texture,
+        .section = rect,
+        .flip_horizontal = flip_horizontal
+    });
 }
 
-float oslo_get_elapsed_time()
+typedef struct __oslo_gfx_create_texture_gl_t
 {
-    return glfwGetTime();
-}
+    oslo_gfx_texture_t* texture;
+    void* data;
+} __oslo_gfx_create_texture_gl_t;
 
-void oslo_platform_sleep(float ms)
+void __oslo_gfx_create_texture_gl(void* args)
 {
-    #if (defined OSLO_PLATFORM_WIN)
+    oslo_gfx_texture_t* texture = ((__oslo_gfx_create_texture_gl_t*)args)->texture;
+    void* data = ((__oslo_gfx_create_texture_gl_t*)args)->data;
+    uint32_t width = texture->width;
+    uint32_t height = texture->height;
 
-            timeBeginPeriod(1);
-            Sleep((uint64_t)ms);
-            timeEndPeriod(1);
+    GLenum internal_format = 0, data_format = 0;
+    if (texture->channels == 4)
+    {
+        internal_format = GL_RGBA8;
+        data_format = GL_RGBA;
+    }
+    else
+    {
+        internal_format = GL_RGB8;
+        data_format = GL_RGB;
+    }
 
-    #elif (defined OSLO_PLATFORM_APPLE)
+    glCreateTextures(GL_TEXTURE_2D, 1, &texture->id);
+    glTextureStorage2D(texture->id, 1, internal_format, width, height);
 
-            usleep(ms * 1000.f); // unistd.h
-    #else
-	    if (ms < 0.f) {
-		return;
-	    }
+    glTextureParameteri(texture->id, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTextureParameteri(texture->id, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
 
-	    struct timespec ts = default_val();
-	    int32_t res = 0;
-	    ts.tv_sec = ms / 1000.f;
-	    ts.tv_nsec = ((uint64_t)ms % 1000) * 1000000;
-	    do {
-		res = nanosleep(&ts, &ts);
-	    } while (res && errno == EINTR);
+    glTextureParameteri(texture->id, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTextureParameteri(texture->id, GL_TEXTURE_WRAP_T, GL_REPEAT);
 
-            // usleep(ms * 1000.f); // unistd.h
-    #endif
+    glTextureSubImage2D(texture->id, 0, 0, 0, width, height, data_format, GL_UNSIGNED_BYTE, data);
 }
 
-bool oslo_platform_file_exists(const char* file_path)
+oslo_texture_id oslo_gfx_create_texture(void* data, uint32_t width, uint32_t height, uint32_t num_channels)
 {
-    const char* path = file_path;
+    oslo_gfx_texture_t texture = default_val();
+    texture.width = width;
+    texture.height = height;
+    texture.channels = num_channels;
+    texture.memory_category = oslo_memory_current_category();
 
-    #ifdef OSLO_PLATFORM_ANDROID
-        const char* internal_data_path = oslo_app()->android.internal_data_path;
-        oslo_snprintfc(tmp_path, 1024, "%s/%s", internal_data_path, file_path);
-        path = tmp_path;
-    #endif
+    oslo_gfx_exec(__oslo_gfx_create_texture_gl, &(__oslo_gfx_create_texture_gl_t){ &texture, data });
+    oslo_memory_track_gpu(texture.memory_category, __oslo_gfx_texture_gpu_bytes(&texture));
 
-    FILE* fp = fopen(path, "r");
-    if (fp) {
-        fclose(fp);
-        return true;
-    }
-    return false;
+    oslo_gfx_t* gfx = &instance->gfx;
+    return oslo_slot_array_insert(gfx->textures, texture);
 }
 
-oslo_inline void
-oslo_str_to_lower
-(
-    const char* src,
-    char* buffer,
-    size_t buffer_sz
-)
+oslo_texture_id oslo_gfx_load_texture(const char* path)
 {
-    size_t src_sz = string_length(src);
-    size_t len = oslo_min(src_sz, buffer_sz);
+    int width, height, channels;
+    oslo_memory_category category = oslo_memory_push_category(OSLO_MEMORY_GFX);
+    unsigned char *data = stbi_load(path, &width, &height, &channels, 0);
+    oslo_texture_id texture = oslo_gfx_create_texture(data, width, height, channels);   
+    stbi_image_free(data);
+    oslo_memory_pop_category(category);
 
-    for (uint32_t i = 0; i < len; ++i) {
-        buffer[i] = tolower(src[i]);
-    }
+    oslo_gfx_t* gfx = &instance->gfx;
+    oslo_string_id name = oslo_string_intern(path);
+    oslo_slot_array_getp(gfx->textures, texture)->name = name;
+    oslo_string_map_insert_id(gfx->texture_names, name, texture);
+    return texture;
 }
 
-oslo_inline bool 
-oslo_string_compare_equal
-(
-    const char*     txt, 
-    const char*     cmp 
-)
+void oslo_gfx_unload_texture(oslo_texture_id texture)
 {
-    // Grab sizes of both strings
-    uint32_t a_sz = string_length(txt);
-    uint32_t b_sz = string_length(cmp);
-
-    // Return false if sizes do not match
-    if (a_sz != b_sz) 
+    oslo_gfx_t* gfx = &instance->gfx;
+    if (oslo_slot_array_exists(gfx->textures, texture))
     {
-        return false;
-    }
+        oslo_gfx_texture_t* p_texture = oslo_slot_array_getp(gfx->textures, texture);
 
-    for(uint32_t i = 0; i < a_sz; ++i) 
-    {
-        if (*txt++ != *cmp++)
+        // Only drop the name if it still refers to this texture
+        oslo_texture_id* named = oslo_string_map_getp_id(gfx->texture_names, p_texture->name);
+        if (named && *named == texture)
         {
-            return false;
+            oslo_string_map_erase_id(gfx->texture_names, p_texture->name);
         }
-    };
 
-    return true;
+        unload_texture(p_texture);
+        oslo_slot_array_erase(gfx->textures, texture);
+    }
 }
 
-oslo_inline 
-void oslo_get_file_extension
-(
-    char* buffer,
-    uint32_t buffer_size,
-    const char* file_path 
-)
+oslo_texture_id oslo_gfx_find_texture(const char* path)
 {
-    uint32_t str_len = string_length(file_path);
-    const char* at = (file_path + str_len - 1);
-    while (*at != '.' && at != file_path)
-    {
-        at--;
-    }
+    oslo_texture_id* texture = oslo_string_map_getp(instance->gfx.texture_names, path);
+    return texture ? *texture : oslo_slot_array_INVALID_HANDLE;
+}
 
-    if (*at == '.')
+void oslo_gfx_text(const char* text, vec2 position, float size, vec4 color, oslo_font_t* font)
+{
+    while (text[0] != '\0')
     {
-        at++;
-        uint32_t i = 0; 
-        while (*at)
+        char c = text[0];
+        if (c >= 32 && c < 127)
         {
-            char c = *at;
-            buffer[i++] = *at++;
+            stbtt_aligned_quad q = default_val();
+			stbtt_GetBakedQuad((stbtt_bakedchar*)&font->glyphs[0], 512, 512, c-32, &position.x, &position.y, &q, 1);
+
+            oslo_rect_t section = 
+            {
+                .min = {q.s0 * 512, q.t0 * 512},
+                .max = {q.s1 * 512, q.t1 * 512}
+            };
+
+            vec4 quad[4] = 
+            {
+                {q.x0, q.y0, 0.0f, 1.0f},
+                {q.x1, q.y0, 0.0f, 1.0f},
+                {q.x1, q.y1, 0.0f, 1.0f},
+                {q.x0, q.y1, 0.0f, 1.0f}
+            };
+
+            oslo_gfx_draw_textured_quad(quad, color, font->texture, section, false);
         }
-        buffer[i] = '\0';
+
+        ++text;
     }
 }
 
 #pragma endregion
 
-#pragma region MAIN
-int main(int argc, char *argv[])
-{
-    if (!glfwInit())
-        return -1;
-
-    oslo_desc_t desc = oslo_main();
-
-    instance = malloc(sizeof(oslo_t));
-    memset(instance, 0, sizeof(oslo_t));
-    
-    instance->running = false;
-    instance->desc = desc;
-
-#if (defined PLATFORM_APPLE)
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 1);
-    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
-    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-    glfwWindowHint(GLFW_COCOA_RETINA_FRAMEBUFFER, GLFW_FALSE);
-#else
-    glfwWindowHint(GLFW_SCALE_TO_MONITOR, GLFW_TRUE);
-    // glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, platform->settings.video.graphics.opengl.major_version);
-    // glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, platform->settings.video.graphics.opengl.minor_version);
-    // glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
-    // glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 1);
-    // glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
-    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-   
-    //glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, GLFW_TRUE);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 5);
-#endif
+#pragma region RENDER_THREAD
+/*========================
+// Render Thread
+========================*/
 
-    
-    instance->window = glfwCreateWindow(desc.window_width, desc.window_height, desc.window_title, NULL, NULL);
-    if (!instance->window)
-    {
-        notify_error(instance, OSLO_PLATFORM_INIT_ERROR, "Failed create window!");
-        free(instance);
-        glfwTerminate();
-        return -1;
-    }
+typedef enum oslo_gfx_cmd_type
+{
+    OSLO_GFX_CMD_CLEAR,
+    OSLO_GFX_CMD_VIEWPORT,
+    OSLO_GFX_CMD_DRAW_BATCH
+} oslo_gfx_cmd_type;
 
-    /* Make the window's context current */
-    glfwMakeContextCurrent(instance->window);
-    glfwSwapInterval(1);
-    
-    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+typedef struct oslo_gfx_cmd_t
+{
+    oslo_gfx_cmd_type type;
+    union
     {
-        notify_error(instance, OSLO_GFX_INIT_ERROR, "Failed to initialize glad");
-        glfwDestroyWindow(instance->window);
-        free(instance);
-        glfwTerminate();
+        vec4 clear_color;
+        struct
+        {
+            int32_t width;
+            int32_t height;
+            mat4 projection;
+        } viewport;
+        struct
+        {
+            int vao;
+            int vbo;
+            uint32_t vertex_offset;
+            uint32_t vertex_count;
+            uint32_t index_count;
+            int textures[MAX_BATCH_TEXTURES];
+        } draw;
+    };
+} oslo_gfx_cmd_t;
 
-        return -1;
-    }
-    
-    oslo_input_init(instance);
-    oslo_gfx_init(instance);
-    oslo_audio_init();
+// Everything the render thread needs to replay one frame
+typedef struct oslo_gfx_frame_t
+{
+    oslo_dyn_array(oslo_gfx_vertex_t) vertices;
+    oslo_dyn_array(oslo_gfx_cmd_t) commands;
+} oslo_gfx_frame_t;
 
-    if (desc.init != NULL)
-	{
-		desc.init(desc.user_data);
-	}
+typedef struct oslo_gfx_render_thread_t
+{
+    ma_thread thread;
+    ma_mutex lock;
+    ma_semaphore work;
+    ma_semaphore frame_consumed;
+    ma_event call_done;
 
-    instance->running = true;
+    // Update thread records into frames[write] while the render thread replays frames[read]
+    oslo_gfx_frame_t frames[2];
+    uint32_t write;
+    uint32_t read;
 
-    instance->time.previous = glfwGetTime();
-    double target_fps = 1.0 / desc.max_fps;
+    void(*call)(void*);
+    void* call_data;
+    bool frame_pending;
+    bool quit;
+} oslo_gfx_render_thread_t;
 
-    while(instance->running)
+void __oslo_gfx_render_thread_execute(oslo_t* oslo, oslo_gfx_frame_t* frame)
+{
+    for (uint32_t i = 0; i < (uint32_t)oslo_dyn_array_size(frame->commands); ++i)
     {
-        oslo_time_t* time = &instance->time;
-
-        double frame_start = glfwGetTime();
-
-        float current_time = glfwGetTime();
-        time->delta = current_time - time->previous;
+        oslo_gfx_cmd_t* cmd = &frame->commands[i];
+        switch (cmd->type)
+        {
+            case OSLO_GFX_CMD_CLEAR:
+            {
+                glClearColor(cmd->clear_color.x, cmd->clear_color.y, cmd->clear_color.z, cmd->clear_color.w);
+                glClear(GL_COLOR_BUFFER_BIT);
+            } break;
 
-        oslo_update_input(&instance->input);
-         /* Poll for and process events */
-        glfwPollEvents();
+            case OSLO_GFX_CMD_VIEWPORT:
+            {
+                glUseProgram(oslo->gfx.shader);
+                glUniformMatrix4fv(glGetUniformLocation(oslo->gfx.shader, "u_projection"), 1, GL_FALSE, &cmd->viewport.projection.elements[0]);
+                glUseProgram(0);
+                glViewport(0, 0, cmd->viewport.width, cmd->viewport.height);
+            } break;
 
-         // Render
-        glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
-        glClear(GL_COLOR_BUFFER_BIT);
+            case OSLO_GFX_CMD_DRAW_BATCH:
+            {
+                glBindVertexArray(cmd->draw.vao);
+                glBindBuffer(GL_ARRAY_BUFFER, cmd->draw.vbo);
+                glBufferSubData(GL_ARRAY_BUFFER, 0, cmd->draw.vertex_count * sizeof(oslo_gfx_vertex_t), frame->vertices + cmd->draw.vertex_offset);
+                __oslo_gfx_draw_textured_indices(cmd->draw.textures, cmd->draw.index_count);
+            } break;
+        }
+    }
+}
 
-        // Update
-        if (desc.update != NULL)
-		{
-			desc.update(desc.user_data);
-		}
+ma_thread_result MA_THREADCALL __oslo_gfx_render_thread_proc(void* user_data)
+{
+    oslo_t* oslo = (oslo_t*)user_data;
+    oslo_gfx_render_thread_t* rt = (oslo_gfx_render_thread_t*)oslo->gfx.render_thread;
 
-        /* Swap front and back buffers */
-        glfwSwapBuffers(instance->window);
+    glfwMakeContextCurrent(oslo->window);
 
-        double frame_time = glfwGetTime() - frame_start;
+    for (;;)
+    {
+        ma_semaphore_wait(&rt->work);
+
+        ma_mutex_lock(&rt->lock);
+        void(*call)(void*) = rt->call;
+        void* call_data = rt->call_data;
+        bool frame_pending = rt->frame_pending;
+        bool quit = rt->quit;
+        uint32_t read = rt->read;
+        rt->call = NULL;
+        rt->frame_pending = false;
+        ma_mutex_unlock(&rt->lock);
+
+        // Replay the pending frame before any call, so resources it references are still alive
+        if (frame_pending)
+        {
+            __oslo_gfx_render_thread_execute(oslo, &rt->frames[read]);
+            glfwSwapBuffers(oslo->window);
+            ma_semaphore_release(&rt->frame_consumed);
+        }
 
-        if (target_fps > frame_time)
+        if (call != NULL)
         {
-            oslo_platform_sleep((target_fps - frame_time) * 1000);
-            time->previous = glfwGetTime();
+            call(call_data);
+            ma_event_signal(&rt->call_done);
         }
 
-        time->previous = current_time;
-        instance->running = !glfwWindowShouldClose(instance->window);
+        if (quit)
+        {
+            break;
+        }
     }
 
-    if (desc.shutdown != NULL)
-	{
-		desc.shutdown(desc.user_data);
-	}
+    glfwMakeContextCurrent(NULL);
+    return (ma_thread_result)0;
+}
 
-    oslo_audio_shutdown();
-    oslo_gfx_shutdown(instance);
-    glfwDestroyWindow(instance->window);
-    free(instance);
-    glfwTerminate();
+// Runs fn on the thread that owns the GL context, blocking until it returns
+void oslo_gfx_exec(void(*fn)(void*), void* data)
+{
+    oslo_gfx_render_thread_t* rt = (oslo_gfx_render_thread_t*)instance->gfx.render_thread;
+    if (rt == NULL)
+    {
+        fn(data);
+        return;
+    }
 
-    return 0;
+    ma_mutex_lock(&rt->lock);
+    rt->call = fn;
+    rt->call_data = data;
+    ma_mutex_unlock(&rt->lock);
+
+    ma_semaphore_release(&rt->work);
+    ma_event_wait(&rt->call_done);
 }
 
-#pragma endregion
+void oslo_gfx_render_thread_start(oslo_t* oslo)
+{
+    oslo_gfx_render_thread_t* rt = (oslo_gfx_render_thread_t*)oslo_malloc(sizeof(oslo_gfx_render_thread_t));
+    memset(rt, 0, sizeof(oslo_gfx_render_thread_t));
+    rt->write = 0;
+    rt->read = 1;
 
-#pragma region GFX
-/*========================
-// GFX
-========================*/
+    if (ma_mutex_init(&rt->lock) != MA_SUCCESS || 
+        ma_semaphore_init(0, &rt->work) != MA_SUCCESS || 
+        ma_semaphore_init(1, &rt->frame_consumed) != MA_SUCCESS || 
+        ma_event_init(&rt->call_done) != MA_SUCCESS)
+    {
+        notify_error(oslo, OSLO_GFX_INIT_ERROR, "Failed to init render thread sync objects");
+        oslo_free(rt);
+        return;
+    }
 
-void load_shader(oslo_t* oslo)
-{
-    oslo_gfx_t* gfx = &oslo->gfx;
-    // Create and compile shader
-    unsigned int vertex, fragment;
-    int success;
-    char infoLog[512];
-    
-    // vertex Shader
-    vertex = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertex, 1, &v_src_2D, NULL);
-    glCompileShader(vertex);
-    // print compile errors if any
-    glGetShaderiv(vertex, GL_COMPILE_STATUS, &success);
-    if(!success)
+    // The context can only be current on one thread at a time
+    oslo->gfx.render_thread = rt;
+    glfwMakeContextCurrent(NULL);
+
+    if (ma_thread_create(&rt->thread, ma_thread_priority_default, 0, __oslo_gfx_render_thread_proc, oslo) != MA_SUCCESS)
     {
-        glGetShaderInfoLog(vertex, 512, NULL, infoLog);
-        notify_error(oslo, OSLO_SHADER_COMPILE_ERROR, infoLog);
-    };
+        notify_error(oslo, OSLO_GFX_INIT_ERROR, "Failed to create render thread");
+        oslo->gfx.render_thread = NULL;
+        glfwMakeContextCurrent(oslo->window);
+        ma_mutex_uninit(&rt->lock);
+        ma_semaphore_uninit(&rt->work);
+        ma_semaphore_uninit(&rt->frame_consumed);
+        ma_event_uninit(&rt->call_done);
+        oslo_free(rt);
+    }
+}
 
-    // Fragment Shader
-    fragment = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fragment, 1, &f_src_2D, NULL);
-    glCompileShader(fragment);
-    // print compile errors if any
-    glGetShaderiv(fragment, GL_COMPILE_STATUS, &success);
-    if(!success)
+void oslo_gfx_render_thread_stop(oslo_t* oslo)
+{
+    oslo_gfx_render_thread_t* rt = (oslo_gfx_render_thread_t*)oslo->gfx.render_thread;
+    if (rt == NULL)
     {
-        glGetShaderInfoLog(fragment, 512, NULL, infoLog);
-        notify_error(oslo, OSLO_SHADER_COMPILE_ERROR, infoLog);
-    };
+        return;
+    }
 
-    // shader Program
-    gfx->shader = glCreateProgram();
-    glAttachShader(gfx->shader, vertex);
-    glAttachShader(gfx->shader, fragment);
-    glLinkProgram(gfx->shader);
-    // print linking errors if any
-    glGetProgramiv(gfx->shader, GL_LINK_STATUS, &success);
-    if(!success)
+    ma_mutex_lock(&rt->lock);
+    rt->quit = true;
+    ma_mutex_unlock(&rt->lock);
+    ma_semaphore_release(&rt->work);
+    ma_thread_wait(&rt->thread);
+
+    oslo->gfx.render_thread = NULL;
+    glfwMakeContextCurrent(oslo->window);
+
+    for (uint32_t i = 0; i < 2; ++i)
     {
-        glGetProgramInfoLog(gfx->shader, 512, NULL, infoLog);
-        notify_error(oslo, OSLO_SHADER_LINKER_ERROR, infoLog);
+        oslo_dyn_array_free(rt->frames[i].vertices);
+        oslo_dyn_array_free(rt->frames[i].commands);
     }
-    
-    // delete the shaders as they're linked into our program now and no longer necessary
-    glDeleteShader(vertex);
-    glDeleteShader(fragment);
-}  
 
-void setup_projection(oslo_t* oslo)
+    ma_mutex_uninit(&rt->lock);
+    ma_semaphore_uninit(&rt->work);
+    ma_semaphore_uninit(&rt->frame_consumed);
+    ma_event_uninit(&rt->call_done);
+    oslo_free(rt);
+}
+
+// Hands the recorded frame to the render thread, waits only if it is still busy with the previous one
+void oslo_gfx_render_thread_submit(oslo_t* oslo)
+{
+    oslo_gfx_render_thread_t* rt = (oslo_gfx_render_thread_t*)oslo->gfx.render_thread;
+
+    ma_semaphore_wait(&rt->frame_consumed);
+
+    ma_mutex_lock(&rt->lock);
+    rt->read = rt->write;
+    rt->write ^= 1;
+    rt->frame_pending = true;
+    ma_mutex_unlock(&rt->lock);
+    ma_semaphore_release(&rt->work);
+
+    oslo_dyn_array_clear(rt->frames[rt->write].vertices);
+    oslo_dyn_array_clear(rt->frames[rt->write].commands);
+}
+
+void oslo_gfx_record_clear(vec4 color)
 {
-    vec2 fbs = get_framebuffer_size(oslo);
+    oslo_gfx_render_thread_t* rt = (oslo_gfx_render_thread_t*)instance->gfx.render_thread;
+    oslo_gfx_cmd_t cmd = default_val();
+    cmd.type = OSLO_GFX_CMD_CLEAR;
+    cmd.clear_color = color;
+    oslo_dyn_array_push(rt->frames[rt->write].commands, cmd);
+}
 
-    oslo_gfx_t* gfx = &oslo->gfx;
+void oslo_gfx_record_viewport(int32_t width, int32_t height, mat4 projection)
+{
+    oslo_gfx_render_thread_t* rt = (oslo_gfx_render_thread_t*)instance->gfx.render_thread;
+    oslo_gfx_cmd_t cmd = default_val();
+    cmd.type = OSLO_GFX_CMD_VIEWPORT;
+    cmd.viewport.width = width;
+    cmd.viewport.height = height;
+    cmd.viewport.projection = projection;
+    oslo_dyn_array_push(rt->frames[rt->write].commands, cmd);
+}
 
-    // Setup projection based on window size
-    gfx->projection = mat4_ortho(0.0f, fbs.x, fbs.y, 0.0f, -1.0f, 1.0f);  
+void oslo_gfx_record_batch(oslo_gfx_quad_batch_t* batch, const int* texture_ids)
+{
+    oslo_gfx_render_thread_t* rt = (oslo_gfx_render_thread_t*)instance->gfx.render_thread;
+    oslo_gfx_frame_t* frame = &rt->frames[rt->write];
 
-    // Upload projection
-    glUseProgram(gfx->shader);
-    glUniformMatrix4fv(glGetUniformLocation(gfx->shader, "u_projection"), 1, GL_FALSE, &gfx->projection.elements[0]);
-    glUseProgram(0);
+    uint32_t vertex_count = (uint32_t)(batch->vert_ptr - batch->vertices);
+    uint32_t vertex_offset = oslo_dyn_array_size(frame->vertices);
+    if ((int32_t)(vertex_offset + vertex_count) > oslo_dyn_array_capacity(frame->vertices))
+    {
+        oslo_dyn_array_reserve(frame->vertices, oslo_max(vertex_offset + vertex_count, (uint32_t)oslo_dyn_array_capacity(frame->vertices) * 2));
+    }
+    memcpy(frame->vertices + vertex_offset, batch->vertices, vertex_count * sizeof(oslo_gfx_vertex_t));
+    oslo_dyn_array_head(frame->vertices)->size += vertex_count;
+
+    oslo_gfx_cmd_t cmd = default_val();
+    cmd.type = OSLO_GFX_CMD_DRAW_BATCH;
+    cmd.draw.vao = batch->vao;
+    cmd.draw.vbo = batch->vbo;
+    cmd.draw.vertex_offset = vertex_offset;
+    cmd.draw.vertex_count = vertex_count;
+    cmd.draw.index_count = batch->index_count;
+    memcpy(cmd.draw.textures, texture_ids, sizeof(cmd.draw.textures));
+    oslo_dyn_array_push(frame->commands, cmd);
 }
 
-bool oslo_gfx_quad_batch_create(size_t max_quads, oslo_gfx_quad_batch_t* out_batch)
+#pragma endregion
+
+#pragma region JOB
+/*========================
+// Job System
+========================*/
+
+#ifndef OSLO_JOB_QUEUE_SIZE
+    #define OSLO_JOB_QUEUE_SIZE 4096
+#endif
+
+#ifndef OSLO_JOB_STACK_SIZE
+    #define OSLO_JOB_STACK_SIZE (64 * 1024)
+#endif
+
+typedef struct oslo_job_t
 {
-    size_t size = (max_quads * 4) * sizeof(oslo_gfx_vertex_t);
+    oslo_job_func func;
+    void* data;
+    oslo_job_counter_t* dependency;
+    oslo_job_counter_t* counter;
+} oslo_job_t;
 
-    out_batch->vertices = malloc(size);
-    memset(out_batch->vertices, 0, size);
+// Jobs run inside a coroutine, so waiting on a counter suspends the job instead of the worker
+typedef struct oslo_job_fiber_t
+{
+    mco_coro* co;
+    oslo_job_t job;
+    oslo_job_counter_t* waiting_on;
+} oslo_job_fiber_t;
 
-    u32 max_indices = max_quads * 6;
-    out_batch->max_indices = max_indices;
-    size_t indices_size = max_indices * sizeof(u32);
-    u32* indices = malloc(indices_size);
-	memset(indices, 0, indices_size);
+typedef struct oslo_job_worker_t
+{
+    ma_thread thread;
+    ma_mutex lock;
 
-	u32 offset = 0;
-	for (u32 i = 0; i < max_indices; i += 6)
-	{
-		indices[i + 0] = offset + 0;
-		indices[i + 1] = offset + 1;
-		indices[i + 2] = offset + 2;
+    // The owner pushes and pops at bottom, other workers steal from top
+    oslo_job_t queue[OSLO_JOB_QUEUE_SIZE];
+    uint32_t top;
+    uint32_t bottom;
 
-		indices[i + 3] = offset + 2;
-		indices[i + 4] = offset + 3;
-		indices[i + 5] = offset + 0;
+    oslo_dyn_array(oslo_job_fiber_t*) free_fibers;
 
-		offset += 4;
-	}
+    uint32_t index;
+} oslo_job_worker_t;
 
-    out_batch->index_count = 0;
+typedef struct oslo_job_system_t
+{
+    // workers[0] is the main thread
+    oslo_job_worker_t* workers;
+    uint32_t worker_count;
+    ma_semaphore wake;
+    volatile uint32_t quit;
 
-    glGenVertexArrays(1, &out_batch->vao);
-    glGenBuffers(1, &out_batch->vbo);
-    glGenBuffers(1, &out_batch->ibo);
-    // bind the Vertex Array Object first, then bind and set vertex buffer(s), and then configure vertex attributes(s).
-    glBindVertexArray(out_batch->vao);
+    // Suspended fibers are shared, whichever worker sees a counter done resumes its fiber. A job may
+    // come back from a wait on another thread than the one it started on.
+    ma_mutex waiting_lock;
+    oslo_dyn_array(oslo_job_fiber_t*) waiting;
+    volatile uint32_t waiting_count;
+} oslo_job_system_t;
 
-    glBindBuffer(GL_ARRAY_BUFFER, out_batch->vbo);
-    glBufferData(GL_ARRAY_BUFFER, MAX_VERTICES * sizeof(oslo_gfx_vertex_t), out_batch->vertices, GL_DYNAMIC_DRAW);
+static MCO_THREAD_LOCAL int32_t __oslo_job_worker_index = -1;
+static MCO_THREAD_LOCAL oslo_job_fiber_t* __oslo_job_current_fiber = NULL;
 
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, out_batch->ibo);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, MAX_INDICES * sizeof(u32), indices, GL_STATIC_DRAW);
+bool __oslo_job_queue_push(oslo_job_worker_t* worker, const oslo_job_t* job)
+{
+    bool pushed = false;
+    ma_mutex_lock(&worker->lock);
+    if (worker->bottom - worker->top < OSLO_JOB_QUEUE_SIZE)
+    {
+        worker->queue[worker->bottom % OSLO_JOB_QUEUE_SIZE] = *job;
+        worker->bottom++;
+        pushed = true;
+    }
+    ma_mutex_unlock(&worker->lock);
+    return pushed;
+}
 
-    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(oslo_gfx_vertex_t), (void*)offsetof(oslo_gfx_vertex_t, position));
-    glEnableVertexAttribArray(0);
+bool __oslo_job_queue_pop(oslo_job_worker_t* worker, oslo_job_t* out_job)
+{
+    bool popped = false;
+    ma_mutex_lock(&worker->lock);
+    if (worker->bottom != worker->top)
+    {
+        worker->bottom--;
+        *out_job = worker->queue[worker->bottom % OSLO_JOB_QUEUE_SIZE];
+        popped = true;
+    }
+    ma_mutex_unlock(&worker->lock);
+    return popped;
+}
 
-    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(oslo_gfx_vertex_t), (void*)offsetof(oslo_gfx_vertex_t, color));
-    glEnableVertexAttribArray(1);
+bool __oslo_job_queue_steal(oslo_job_worker_t* worker, oslo_job_t* out_job)
+{
+    bool stolen = false;
+    ma_mutex_lock(&worker->lock);
+    if (worker->bottom != worker->top)
+    {
+        *out_job = worker->queue[worker->top % OSLO_JOB_QUEUE_SIZE];
+        worker->top++;
+        stolen = true;
+    }
+    ma_mutex_unlock(&worker->lock);
+    return stolen;
+}
 
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(oslo_gfx_vertex_t), (void*)offsetof(oslo_gfx_vertex_t, uv));
-    glEnableVertexAttribArray(2);
+void __oslo_job_execute(oslo_job_t* job)
+{
+    if (job->dependency != NULL)
+    {
+        oslo_job_wait(job->dependency);
+    }
 
-    glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, sizeof(oslo_gfx_vertex_t), (void*)offsetof(oslo_gfx_vertex_t, tex_index));
-    glEnableVertexAttribArray(3);
+    job->func(job->data);
 
-    out_batch->bound_textures[0] = instance->gfx.white_texture;
-    out_batch->texture_index = 1;
+    if (job->counter != NULL && c89atomic_fetch_sub_32(&job->counter->value, 1) == 1)
+    {
+        // Wake a sleeping worker in case a suspended fiber waits on this counter
+        oslo_job_system_t* js = instance ? (oslo_job_system_t*)instance->jobs : NULL;
+        if (js != NULL && c89atomic_load_32(&js->waiting_count))
+        {
+            ma_semaphore_release(&js->wake);
+        }
+    }
+}
 
-    return true;
+void __oslo_job_fiber_entry(mco_coro* co)
+{
+    oslo_job_fiber_t* fiber = (oslo_job_fiber_t*)mco_get_user_data(co);
+    __oslo_job_execute(&fiber->job);
 }
 
-void oslo_gfx_quad_batch_destroy(oslo_gfx_quad_batch_t* batch)
+oslo_job_fiber_t* __oslo_job_fiber_acquire(oslo_job_worker_t* worker, const oslo_job_t* job)
 {
-    free(batch->vertices);
-    glDeleteVertexArrays(1, &batch->vao);
-    glDeleteBuffers(1, &batch->vbo);
-    glDeleteBuffers(1, &batch->ibo);
+    oslo_job_fiber_t* fiber = NULL;
+    mco_desc desc = mco_desc_init(__oslo_job_fiber_entry, OSLO_JOB_STACK_SIZE);
+
+    if (oslo_dyn_array_size(worker->free_fibers))
+    {
+        // Recycle a dead coroutine, its memory already fits the same stack size
+        fiber = oslo_dyn_array_back(worker->free_fibers);
+        oslo_dyn_array_pop(worker->free_fibers);
+        mco_uninit(fiber->co);
+        desc.user_data = fiber;
+        mco_init(fiber->co, &desc);
+    }
+    else
+    {
+        oslo_memory_category category = oslo_memory_push_category(OSLO_MEMORY_JOBS);
+        fiber = (oslo_job_fiber_t*)oslo_malloc(sizeof(oslo_job_fiber_t));
+        desc.user_data = fiber;
+        bool created = mco_create(&fiber->co, &desc) == MCO_SUCCESS;
+        oslo_memory_pop_category(category);
+        if (!created)
+        {
+            oslo_free(fiber);
+            return NULL;
+        }
+    }
+
+    fiber->job = *job;
+    fiber->waiting_on = NULL;
+    return fiber;
 }
 
-void oslo_gfx_quad_batch_render(oslo_gfx_quad_batch_t* batch)
+void __oslo_job_fiber_resume(oslo_job_system_t* js, oslo_job_worker_t* worker, oslo_job_fiber_t* fiber)
 {
-    if (batch->index_count > 0)
+    oslo_job_fiber_t* prev = __oslo_job_current_fiber;
+    __oslo_job_current_fiber = fiber;
+    mco_resume(fiber->co);
+    __oslo_job_current_fiber = prev;
+
+    if (mco_status(fiber->co) == MCO_DEAD)
     {
-        glUseProgram(instance->gfx.shader);
+        oslo_dyn_array_push(worker->free_fibers, fiber);
+    }
+    else
+    {
+        ma_mutex_lock(&js->waiting_lock);
+        oslo_dyn_array_push(js->waiting, fiber);
+        c89atomic_fetch_add_32(&js->waiting_count, 1);
+        ma_mutex_unlock(&js->waiting_lock);
 
-        // Upload textures
-        for (uint32_t i = 0; i < MAX_BATCH_TEXTURES; ++i)
+        // The counter may have hit zero before the fiber was listed, when nobody knew to wake a worker
+        if (oslo_job_is_done(fiber->waiting_on))
         {
-            oslo_gfx_texture_t* texture = oslo_slot_array_getp(instance->gfx.textures, batch->bound_textures[i]);
-            int texture_id = 0;
-            if (texture != NULL)
+            ma_semaphore_release(&js->wake);
+        }
+    }
+}
+
+// Runs one unit of work on this worker, returns false when there was nothing to do
+bool __oslo_job_worker_step(oslo_job_system_t* js, oslo_job_worker_t* worker)
+{
+    // Suspended fibers whose counter reached zero go first
+    if (c89atomic_load_32(&js->waiting_count))
+    {
+        oslo_job_fiber_t* ready = NULL;
+        ma_mutex_lock(&js->waiting_lock);
+        for (uint32_t i = 0; i < (uint32_t)oslo_dyn_array_size(js->waiting); ++i)
+        {
+            if (oslo_job_is_done(js->waiting[i]->waiting_on))
             {
-                texture_id = texture->id;
+                ready = js->waiting[i];
+                js->waiting[i] = oslo_dyn_array_back(js->waiting);
+                oslo_dyn_array_pop(js->waiting);
+                c89atomic_fetch_sub_32(&js->waiting_count, 1);
+                break;
             }
+        }
+        ma_mutex_unlock(&js->waiting_lock);
 
-            glActiveTexture(GL_TEXTURE0 + i);
-            glBindTexture(GL_TEXTURE_2D, texture_id);
-
-            char uniform_name[50];
-            sprintf(uniform_name, "u_textures[%i]", i);
-            glUniform1i(glGetUniformLocation(instance->gfx.shader, uniform_name), i);
+        if (ready != NULL)
+        {
+            __oslo_job_fiber_resume(js, worker, ready);
+            return true;
         }
+    }
+
+    oslo_job_t job;
+    bool found = __oslo_job_queue_pop(worker, &job);
+    for (uint32_t i = 1; !found && i < js->worker_count; ++i)
+    {
+        found = __oslo_job_queue_steal(&js->workers[(worker->index + i) % js->worker_count], &job);
+    }
+
+    if (!found)
+    {
+        return false;
+    }
 
-        // draw mesh
-        glDrawElements(GL_TRIANGLES, batch->index_count, GL_UNSIGNED_INT, NULL);
+    oslo_job_fiber_t* fiber = __oslo_job_fiber_acquire(worker, &job);
+    if (fiber != NULL)
+    {
+        __oslo_job_fiber_resume(js, worker, fiber);
     }
+    else
+    {
+        __oslo_job_execute(&job);
+    }
+
+    return true;
 }
 
-void oslo_gfx_quad_batch_update_content(oslo_gfx_quad_batch_t* batch)
+ma_thread_result MA_THREADCALL __oslo_job_worker_proc(void* user_data)
 {
-    glBindVertexArray(batch->vao);
-    // Update vbo data
-    uint32_t data_size = (uint32_t)((uint8_t*)batch->vert_ptr - (uint8_t*)batch->vertices);
-    glBufferSubData(GL_ARRAY_BUFFER, 0, data_size, batch->vertices);
+    oslo_job_worker_t* worker = (oslo_job_worker_t*)user_data;
+    oslo_job_system_t* js = (oslo_job_system_t*)instance->jobs;
+    __oslo_job_worker_index = (int32_t)worker->index;
+
+    while (!c89atomic_load_32(&js->quit))
+    {
+        if (!__oslo_job_worker_step(js, worker))
+        {
+            // New jobs and counters reaching zero while fibers wait both post the semaphore
+            ma_semaphore_wait(&js->wake);
+        }
+    }
+
+    return (ma_thread_result)0;
 }
 
-void oslo_gfx_quad_batch_reset(oslo_gfx_quad_batch_t* batch)
+void oslo_job_init(oslo_t* oslo)
 {
-    batch->index_count = 0;
-	batch->vert_ptr = batch->vertices;
-    batch->texture_index = 1; // 0 is for white texture
+    oslo_memory_category category = oslo_memory_push_category(OSLO_MEMORY_JOBS);
+    oslo_job_system_t* js = (oslo_job_system_t*)oslo_malloc(sizeof(oslo_job_system_t));
+    memset(js, 0, sizeof(oslo_job_system_t));
+
+    js->worker_count = oslo->desc.job_workers ? oslo->desc.job_workers : oslo_platform_cpu_count();
+    js->workers = (oslo_job_worker_t*)oslo_malloc(js->worker_count * sizeof(oslo_job_worker_t));
+    oslo_memory_pop_category(category);
+    memset(js->workers, 0, js->worker_count * sizeof(oslo_job_worker_t));
+
+    if (ma_semaphore_init(0, &js->wake) != MA_SUCCESS)
+    {
+        notify_error(oslo, OSLO_PLATFORM_INIT_ERROR, "Failed to init job system semaphore");
+        oslo_free(js->workers);
+        oslo_free(js);
+        return;
+    }
+
+    for (uint32_t i = 0; i < js->worker_count; ++i)
+    {
+        js->workers[i].index = i;
+        ma_mutex_init(&js->workers[i].lock);
+    }
+    ma_mutex_init(&js->waiting_lock);
+
+    oslo->jobs = js;
+    __oslo_job_worker_index = 0;
+
+    for (uint32_t i = 1; i < js->worker_count; ++i)
+    {
+        if (ma_thread_create(&js->workers[i].thread, ma_thread_priority_default, 0, __oslo_job_worker_proc, &js->workers[i]) != MA_SUCCESS)
+        {
+            // Keep the workers that did start, jobs queued on the rest are stolen by them
+            notify_error(oslo, OSLO_PLATFORM_INIT_ERROR, "Failed to create job worker thread");
+            js->worker_count = i;
+            break;
+        }
+    }
 }
 
-void oslo_gfx_quad_batch_draw_texture_section(oslo_gfx_quad_batch_t* batch, draw_texture_section_desc_t* desc)
+void oslo_job_shutdown(oslo_t* oslo)
 {
-    oslo_gfx_t* gfx = &instance->gfx;
-    oslo_gfx_texture_t* p_texture = oslo_slot_array_getp(gfx->textures, desc->texture);
-    uint32_t width = p_texture->width;
-    uint32_t height = p_texture->height;
+    oslo_job_system_t* js = (oslo_job_system_t*)oslo->jobs;
+    if (js == NULL)
+    {
+        return;
+    }
 
-    float sprite_width = (float)(desc->section.max.x - desc->section.min.x) / width;
-	float sprite_height = (float)(desc->section.max.y - desc->section.min.y) / height;
-	float sprite_pos_x = (float)desc->section.min.x / width;
-	float sprite_pos_y = (float)desc->section.min.y / height;
+    c89atomic_store_32(&js->quit, 1);
+    for (uint32_t i = 1; i < js->worker_count; ++i)
+    {
+        ma_semaphore_release(&js->wake);
+    }
 
-    vec2 sprite_uvs[4] = { 0 };
+    for (uint32_t i = 1; i < js->worker_count; ++i)
+    {
+        ma_thread_wait(&js->workers[i].thread);
+    }
 
-    if (desc->flip_horizontal)
-	{
-		sprite_uvs[0] = v2(sprite_pos_x + sprite_width, sprite_pos_y);
-		sprite_uvs[1] = v2(sprite_pos_x, sprite_pos_y);
-		sprite_uvs[2] = v2(sprite_pos_x, sprite_pos_y + sprite_height);
-		sprite_uvs[3] = v2(sprite_pos_x + sprite_width, sprite_pos_y + sprite_height);
-	}
-	else
-	{
-		sprite_uvs[0] = v2(sprite_pos_x, sprite_pos_y);
-		sprite_uvs[1] = v2(sprite_pos_x + sprite_width, sprite_pos_y);
-		sprite_uvs[2] = v2(sprite_pos_x + sprite_width, sprite_pos_y + sprite_height);
-		sprite_uvs[3] = v2(sprite_pos_x, sprite_pos_y + sprite_height);
-	}
+    for (uint32_t i = 0; i < js->worker_count; ++i)
+    {
+        oslo_job_worker_t* worker = &js->workers[i];
+        for (uint32_t f = 0; f < (uint32_t)oslo_dyn_array_size(worker->free_fibers); ++f)
+        {
+            mco_destroy(worker->free_fibers[f]->co);
+            oslo_free(worker->free_fibers[f]);
+        }
+        oslo_dyn_array_free(worker->free_fibers);
+        ma_mutex_uninit(&worker->lock);
+    }
 
-    if (oslo_gfx_quad_batch_is_full(batch))
-        return;//oslo_gfx_next_batch(instance);
+    // Jobs still suspended at shutdown never finish
+    for (uint32_t f = 0; f < (uint32_t)oslo_dyn_array_size(js->waiting); ++f)
+    {
+        mco_destroy(js->waiting[f]->co);
+        oslo_free(js->waiting[f]);
+    }
+    oslo_dyn_array_free(js->waiting);
+    ma_mutex_uninit(&js->waiting_lock);
 
-    mat4 model = mat4_translate(desc->position.x, desc->position.y, 0);
-    model = mat4_mul(model, mat4_translatev(v3(0.5f * desc->size.x, 0.5f * desc->size.y, 0)));
-	model = mat4_mul(model, mat4_rotate(desc->rotation, 0, 0, 1));
-	model = mat4_mul(model, mat4_translatev(v3(-0.5f * desc->size.x, -0.5f * desc->size.y, 0)));
-	model = mat4_mul(model, mat4_scale(desc->size.x, desc->size.y, 1.0f));
+    ma_semaphore_uninit(&js->wake);
+    oslo_free(js->workers);
+    oslo_free(js);
+    oslo->jobs = NULL;
+}
 
-    float texture_index = 0.0f;
-	for (uint32_t i = 1; i < batch->texture_index; ++i)
-	{
-		if (batch->bound_textures[i] == desc->texture)
-		{
-			texture_index = (float)i;
-			break;
-		}
-	}
+void oslo_job_run(const oslo_job_desc_t* jobs, uint32_t count, oslo_job_counter_t* counter)
+{
+    oslo_job_system_t* js = instance ? (oslo_job_system_t*)instance->jobs : NULL;
 
-    if (texture_index == 0)
-	{
-		texture_index = (float)batch->texture_index;
-		batch->bound_textures[(int)batch->texture_index] = desc->texture;
-		batch->texture_index++;
-	}
+    if (counter != NULL)
+    {
+        c89atomic_fetch_add_32(&counter->value, count);
+    }
 
-    for (size_t i = 0; i < 4; ++i)
-	{
-		batch->vert_ptr->position = mat4_mul_vec4(model, quad_positions[i]);
-		batch->vert_ptr->color = v4(desc->color.x, desc->color.y, desc->color.z, desc->color.w);
-		batch->vert_ptr->uv = sprite_uvs[i];
-        batch->vert_ptr->tex_index = texture_index; // 0 means white texture
-		batch->vert_ptr++;
-	}
+    // Threads outside the pool, like the audio callback, hand their jobs to the main thread queue
+    oslo_job_worker_t* worker = js ? &js->workers[__oslo_job_worker_index > 0 ? __oslo_job_worker_index : 0] : NULL;
 
-    batch->index_count += 6;
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        oslo_job_t job = { jobs[i].func, jobs[i].data, jobs[i].dependency, counter };
+        if (worker == NULL || !__oslo_job_queue_push(worker, &job))
+        {
+            __oslo_job_execute(&job);
+        }
+    }
+
+    if (js != NULL)
+    {
+        for (uint32_t i = 0; i < oslo_min(count, js->worker_count - 1); ++i)
+        {
+            ma_semaphore_release(&js->wake);
+        }
+    }
+}
+
+bool oslo_job_is_done(oslo_job_counter_t* counter)
+{
+    return counter == NULL || c89atomic_load_32(&counter->value) == 0;
+}
+
+void oslo_job_wait(oslo_job_counter_t* counter)
+{
+    oslo_job_fiber_t* fiber = __oslo_job_current_fiber;
+    oslo_job_system_t* js = instance ? (oslo_job_system_t*)instance->jobs : NULL;
+
+    while (!oslo_job_is_done(counter))
+    {
+        if (fiber != NULL)
+        {
+            // Suspend the job, its worker picks up other work until the counter is done
+            fiber->waiting_on = counter;
+            mco_yield(fiber->co);
+        }
+        else if (js != NULL && __oslo_job_worker_index >= 0)
+        {
+            if (!__oslo_job_worker_step(js, &js->workers[__oslo_job_worker_index]))
+            {
+                ma_yield();
+            }
+        }
+        else
+        {
+            ma_yield();
+        }
+    }
 }
 
-void oslo_gfx_quad_batch_draw_textured_quad(oslo_gfx_quad_batch_t* batch, draw_textured_quad_desc_t* desc)
+typedef struct __oslo_job_range_t
 {
-    oslo_gfx_t* gfx = &instance->gfx;
-    oslo_gfx_texture_t* p_texture = oslo_slot_array_getp(gfx->textures, desc->texture);
-    uint32_t width = p_texture->width;
-    uint32_t height = p_texture->height;
+    oslo_job_range_func func;
+    void* data;
+    uint32_t start;
+    uint32_t end;
+} __oslo_job_range_t;
 
-    float sprite_width = (float)(desc->section.max.x - desc->section.min.x) / width;
-	float sprite_height = (float)(desc->section.max.y - desc->section.min.y) / height;
-	float sprite_pos_x = (float)desc->section.min.x / width;
-	float sprite_pos_y = (float)desc->section.min.y / height;
-
-    vec2 sprite_uvs[4] = { 0 };
+void __oslo_job_range_entry(void* data)
+{
+    __oslo_job_range_t* range = (__oslo_job_range_t*)data;
+    range->func(range->start, range->end, range->data);
+}
 
-    if (desc->flip_horizontal)
-	{
-		sprite_uvs[0] = v2(sprite_pos_x + sprite_width, sprite_pos_y);
-		sprite_uvs[1] = v2(sprite_pos_x, sprite_pos_y);
-		sprite_uvs[2] = v2(sprite_pos_x, sprite_pos_y + sprite_height);
-		sprite_uvs[3] = v2(sprite_pos_x + sprite_width, sprite_pos_y + sprite_height);
-	}
-	else
-	{
-		sprite_uvs[0] = v2(sprite_pos_x, sprite_pos_y);
-		sprite_uvs[1] = v2(sprite_pos_x + sprite_width, sprite_pos_y);
-		sprite_uvs[2] = v2(sprite_pos_x + sprite_width, sprite_pos_y + sprite_height);
-		sprite_uvs[3] = v2(sprite_pos_x, sprite_pos_y + sprite_height);
-	}
+void oslo_job_parallel_for(uint32_t count, uint32_t batch_size, oslo_job_range_func func, void* data)
+{
+    uint32_t workers = oslo_job_worker_count();
+    if (!batch_size)
+    {
+        // A few batches per worker keeps stealing effective without flooding the queues
+        batch_size = oslo_max(1u, (count + workers * 4 - 1) / (workers * 4));
+    }
 
-    if (oslo_gfx_quad_batch_is_full(batch))
-        return;//oslo_gfx_next_batch(instance);
+    uint32_t batches = (count + batch_size - 1) / batch_size;
+    if (batches <= 1 || workers <= 1)
+    {
+        if (count)
+        {
+            func(0, count, data);
+        }
+        return;
+    }
 
-    float texture_index = 0.0f;
-	for (uint32_t i = 1; i < batch->texture_index; ++i)
-	{
-		if (batch->bound_textures[i] == desc->texture)
-		{
-			texture_index = (float)i;
-			break;
-		}
-	}
+    const oslo_allocator_t* scratch = __oslo_scratch_allocator();
+    __oslo_job_range_t* ranges = (__oslo_job_range_t*)oslo_allocator_alloc(scratch, batches * (sizeof(__oslo_job_range_t) + sizeof(oslo_job_desc_t)));
+    oslo_job_desc_t* descs = (oslo_job_desc_t*)(ranges + batches);
 
-    if (texture_index == 0)
-	{
-		texture_index = (float)batch->texture_index;
-		batch->bound_textures[(int)batch->texture_index] = desc->texture;
-		batch->texture_index++;
-	}
+    for (uint32_t i = 0; i < batches; ++i)
+    {
+        ranges[i].func = func;
+        ranges[i].data = data;
+        ranges[i].start = i * batch_size;
+        ranges[i].end = oslo_min(count, (i + 1) * batch_size);
+
+        descs[i].func = __oslo_job_range_entry;
+        descs[i].data = &ranges[i];
+        descs[i].dependency = NULL;
+    }
 
-    for (size_t i = 0; i < 4; ++i)
-	{
-		batch->vert_ptr->position = desc->quad[i];
-		batch->vert_ptr->color = v4(desc->color.x, desc->color.y, desc->color.z, desc->color.w);
-		batch->vert_ptr->uv = sprite_uvs[i];
-        batch->vert_ptr->tex_index = texture_index; // 0 means white texture
-		batch->vert_ptr++;
-	}
+    oslo_job_counter_t counter = default_val();
+    oslo_job_run(descs, batches, &counter);
+    oslo_job_wait(&counter);
 
-    batch->index_count += 6;
+    oslo_allocator_free(scratch, ranges);
 }
 
-void oslo_gfx_quad_batch_draw_quad(oslo_gfx_quad_batch_t* batch, draw_quad_desc_t* desc)
+uint32_t oslo_job_worker_count()
 {
-    oslo_gfx_t* gfx = &instance->gfx;
-
-    if (oslo_gfx_quad_batch_is_full(batch))
-        return;
+    oslo_job_system_t* js = instance ? (oslo_job_system_t*)instance->jobs : NULL;
+    return js ? js->worker_count : 1;
+}
 
-    mat4 model = mat4_translate(desc->position.x, desc->position.y, 0);
-    model = mat4_mul(model, mat4_translatev(v3(0.5f * desc->size.x, 0.5f * desc->size.y, 0)));
-	model = mat4_mul(model, mat4_rotate(desc->rotation, 0, 0, 1));
-	model = mat4_mul(model, mat4_translatev(v3(-0.5f * desc->size.x, -0.5f * desc->size.y, 0)));
-	model = mat4_mul(model, mat4_scale(desc->size.x, desc->size.y, 1.0f));
+#pragma endregion
 
-    for (size_t i = 0; i < 4; ++i)
-	{
-		batch->vert_ptr->position = mat4_mul_vec4(model, quad_positions[i]);
-		batch->vert_ptr->color = v4(desc->color.x, desc->color.y, desc->color.z, desc->color.w);
-		batch->vert_ptr->uv = _uvs[i];
-        batch->vert_ptr->tex_index = 0; // 0 means white texture
-		batch->vert_ptr++;
-	}
+#pragma region ASYNC
+/*========================
+// Async
+========================*/
 
-    batch->index_count += 6;
-}
+#ifndef OSLO_ASYNC_STACK_SIZE
+    #define OSLO_ASYNC_STACK_SIZE (32 * 1024)
+#endif
 
-void oslo_gfx_quad_batch_draw_texture(oslo_gfx_quad_batch_t* batch, draw_texture_desc_t* desc)
+typedef enum oslo_async_wait_type
 {
-    oslo_gfx_t* gfx = &instance->gfx;
+    OSLO_ASYNC_WAIT_NONE = 0,
+    OSLO_ASYNC_WAIT_FRAMES,
+    OSLO_ASYNC_WAIT_TIME,
+    OSLO_ASYNC_WAIT_COUNTER
+} oslo_async_wait_type;
 
-    if (oslo_gfx_quad_batch_is_full(batch))
-        return;//oslo_gfx_next_batch(instance);
+typedef struct oslo_async_task_t
+{
+    mco_coro* co;
+    oslo_async_func func;
+    void* data;
 
-    mat4 model = mat4_translate(desc->position.x, desc->position.y, 0);
-    model = mat4_mul(model, mat4_translatev(v3(0.5f * desc->size.x, 0.5f * desc->size.y, 0)));
-	model = mat4_mul(model, mat4_rotate(desc->rotation, 0, 0, 1));
-	model = mat4_mul(model, mat4_translatev(v3(-0.5f * desc->size.x, -0.5f * desc->size.y, 0)));
-	model = mat4_mul(model, mat4_scale(desc->size.x, desc->size.y, 1.0f));
+    oslo_async_wait_type wait;
+    uint64_t wake_frame;
+    uint64_t wake_ns;
+    oslo_job_counter_t* counter;
+} oslo_async_task_t;
 
-    float texture_index = 0.0f;
-	for (uint32_t i = 1; i < batch->texture_index; ++i)
-	{
-		if (batch->bound_textures[i] == desc->texture)
-		{
-			texture_index = (float)i;
-			break;
-		}
-	}
+typedef struct oslo_async_scheduler_t
+{
+    // Tasks are heap allocated so spawning from inside a task can't move the running one
+    oslo_slot_array(oslo_async_task_t*) tasks;
+    oslo_dyn_array(oslo_async_task_t*) free_tasks;
+    oslo_dyn_array(oslo_async_id) finished;
+    oslo_async_task_t* current;
+} oslo_async_scheduler_t;
 
-    if (texture_index == 0)
-	{
-		texture_index = (float)batch->texture_index;
-		batch->bound_textures[(int)batch->texture_index] = desc->texture;
-		batch->texture_index++;
-	}
+void __oslo_async_entry(mco_coro* co)
+{
+    oslo_async_task_t* task = (oslo_async_task_t*)mco_get_user_data(co);
+    task->func(task->data);
+}
 
-    for (size_t i = 0; i < 4; ++i)
-	{
-		batch->vert_ptr->position = mat4_mul_vec4(model, quad_positions[i]);
-		batch->vert_ptr->color = v4(desc->color.x, desc->color.y, desc->color.z, desc->color.w);
-		batch->vert_ptr->uv = _uvs[i];
-        batch->vert_ptr->tex_index = texture_index; // 0 means white texture
-		batch->vert_ptr++;
-	}
+// Only the task's own coroutine may yield it, not a job fiber nested inside it
+oslo_async_task_t* __oslo_async_current_task()
+{
+    oslo_async_scheduler_t* as = instance ? (oslo_async_scheduler_t*)instance->async : NULL;
+    if (!as || !as->current || mco_running() != as->current->co)
+        return NULL;
 
-    batch->index_count += 6;
+    return as->current;
 }
 
-bool oslo_gfx_quad_batch_is_full(oslo_gfx_quad_batch_t* batch)
+bool __oslo_async_task_ready(const oslo_async_task_t* task, const oslo_time_t* time)
 {
-    return (batch->index_count >= batch->max_indices) || (batch->texture_index >= MAX_BATCH_TEXTURES);
+    switch (task->wait)
+    {
+        case OSLO_ASYNC_WAIT_FRAMES:  return time->frame_count >= task->wake_frame;
+        case OSLO_ASYNC_WAIT_TIME:    return time->elapsed_ns >= task->wake_ns;
+        case OSLO_ASYNC_WAIT_COUNTER: return oslo_job_is_done(task->counter);
+        default:                      return true;
+    }
 }
 
-void oslo_gfx_init(oslo_t* oslo)
+void oslo_async_init(oslo_t* oslo)
 {
-    oslo_gfx_t* gfx = &oslo->gfx;
-    memset(gfx, 0, sizeof(oslo_gfx_t));
+    oslo_memory_category category = oslo_memory_push_category(OSLO_MEMORY_JOBS);
+    oslo_async_scheduler_t* as = (oslo_async_scheduler_t*)oslo_malloc(sizeof(oslo_async_scheduler_t));
+    oslo_memory_pop_category(category);
+    memset(as, 0, sizeof(oslo_async_scheduler_t));
+    oslo->async = as;
+}
 
-    gfx->textures = oslo_slot_array_new(oslo_gfx_texture_t);
-    
-    load_shader(oslo);
-    setup_projection(oslo);
+void oslo_async_shutdown(oslo_t* oslo)
+{
+    oslo_async_scheduler_t* as = (oslo_async_scheduler_t*)oslo->async;
+    if (!as)
+        return;
 
-    // Textures
-    uint32_t white_texture_data = 0xffffffff;
-    gfx->white_texture = oslo_gfx_create_texture(&white_texture_data, 1, 1, 4);
+    // Unfinished tasks are dropped without being resumed
+    oslo_slot_array_dense_for(as->tasks, i)
+    {
+        oslo_async_task_t* task = oslo_slot_array_dense_get(as->tasks, i);
+        mco_destroy(task->co);
+        oslo_free(task);
+    }
 
-    oslo_gfx_quad_batch_create(MAX_QUADS, &gfx->default_batch);
+    for (uint32_t i = 0; i < (uint32_t)oslo_dyn_array_size(as->free_tasks); ++i)
+    {
+        mco_destroy(as->free_tasks[i]->co);
+        oslo_free(as->free_tasks[i]);
+    }
 
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-    glEnable( GL_BLEND );
+    oslo_slot_array_free(as->tasks);
+    oslo_dyn_array_free(as->free_tasks);
+    oslo_dyn_array_free(as->finished);
+    oslo_free(as);
+    oslo->async = NULL;
 }
 
-void oslo_gfx_shutdown(oslo_t* oslo)
+void oslo_async_update(oslo_t* oslo)
 {
-    oslo_gfx_quad_batch_destroy(&oslo->gfx.default_batch);
+    oslo_async_scheduler_t* as = (oslo_async_scheduler_t*)oslo->async;
+    if (!as || oslo_slot_array_empty(as->tasks))
+        return;
+
+    const oslo_time_t* time = &oslo->time;
 
-    for (oslo_slot_array_iter it = 1; oslo_slot_array_iter_valid(oslo->gfx.textures, it); oslo_slot_array_iter_advance(oslo->gfx.textures, it))
+    // Tasks spawned during this pass are appended past count and start on the next one
+    uint32_t count = oslo_slot_array_size(as->tasks);
+    for (uint32_t i = 0; i < count; ++i)
     {
-        oslo_gfx_texture_t* texture = oslo_slot_array_getp(oslo->gfx.textures, it);
-        unload_texture(texture);
+        oslo_async_task_t* task = oslo_slot_array_dense_get(as->tasks, i);
+        if (!__oslo_async_task_ready(task, time))
+            continue;
+
+        task->wait = OSLO_ASYNC_WAIT_NONE;
+        as->current = task;
+        mco_resume(task->co);
+        as->current = NULL;
+
+        if (mco_status(task->co) == MCO_DEAD)
+        {
+            oslo_dyn_array_push(as->finished, oslo_slot_array_dense_handle(as->tasks, i));
+        }
     }
 
-    oslo_slot_array_free(oslo->gfx.textures);
-    glDeleteProgram(oslo->gfx.shader);
+    for (uint32_t i = 0; i < (uint32_t)oslo_dyn_array_size(as->finished); ++i)
+    {
+        oslo_async_id id = as->finished[i];
+        oslo_dyn_array_push(as->free_tasks, oslo_slot_array_get(as->tasks, id));
+        oslo_slot_array_erase(as->tasks, id);
+    }
+    oslo_dyn_array_clear(as->finished);
 }
 
-void oslo_gfx_begin()
+oslo_async_id oslo_async_spawn(oslo_async_func func, void* data)
 {
-    // Update projection? 
-    // We can update projection only when framebuffer size changes, or on demand
-    oslo_gfx_begin_batch(instance);
-}
+    oslo_async_scheduler_t* as = instance ? (oslo_async_scheduler_t*)instance->async : NULL;
+    if (!as)
+    {
+        notify_error(instance, OSLO_PLATFORM_INIT_ERROR, "Async scheduler not initialized");
+        return oslo_slot_array_INVALID_HANDLE;
+    }
 
-void oslo_gfx_end()
-{
-    oslo_gfx_quad_batch_update_content(&instance->gfx.default_batch);
-    oslo_gfx_quad_batch_render(&instance->gfx.default_batch);
+    oslo_async_task_t* task = NULL;
+    mco_desc desc = mco_desc_init(__oslo_async_entry, OSLO_ASYNC_STACK_SIZE);
+
+    if (oslo_dyn_array_size(as->free_tasks))
+    {
+        task = oslo_dyn_array_back(as->free_tasks);
+        oslo_dyn_array_pop(as->free_tasks);
+        mco_uninit(task->co);
+        desc.user_data = task;
+        mco_init(task->co, &desc);
+    }
+    else
+    {
+        oslo_memory_category category = oslo_memory_push_category(OSLO_MEMORY_JOBS);
+        task = (oslo_async_task_t*)oslo_malloc(sizeof(oslo_async_task_t));
+        desc.user_data = task;
+        bool created = mco_create(&task->co, &desc) == MCO_SUCCESS;
+        oslo_memory_pop_category(category);
+        if (!created)
+        {
+            oslo_free(task);
+            return oslo_slot_array_INVALID_HANDLE;
+        }
+    }
+
+    task->func = func;
+    task->data = data;
+    task->wait = OSLO_ASYNC_WAIT_NONE;
+    task->wake_frame = 0;
+    task->wake_ns = 0;
+    task->counter = NULL;
+
+    return oslo_slot_array_insert(as->tasks, task);
 }
 
-void oslo_gfx_begin_batch(oslo_t* oslo)
+bool oslo_async_is_running(oslo_async_id id)
 {
-    oslo_gfx_t* gfx = &oslo->gfx;
-    oslo_gfx_quad_batch_reset(&oslo->gfx.default_batch);
+    oslo_async_scheduler_t* as = instance ? (oslo_async_scheduler_t*)instance->async : NULL;
+    return as && oslo_slot_array_exists(as->tasks, id);
 }
 
-void oslo_gfx_next_batch(oslo_t* oslo)
+void oslo_async_wait_frames(uint32_t frames)
 {
-    oslo_gfx_quad_batch_update_content(&oslo->gfx.default_batch);
-    oslo_gfx_quad_batch_render(&oslo->gfx.default_batch);
-    oslo_gfx_begin_batch(oslo);
+    oslo_async_task_t* task = __oslo_async_current_task();
+    if (!task)
+        return;
+
+    task->wait = OSLO_ASYNC_WAIT_FRAMES;
+    task->wake_frame = instance->time.frame_count + oslo_max(frames, 1u);
+    mco_yield(task->co);
 }
 
-void oslo_gfx_draw_quad(vec2 position, float rotation, vec2 size, vec4 color)
+void oslo_async_wait_seconds(float seconds)
 {
-    if (oslo_gfx_quad_batch_is_full(&instance->gfx.default_batch))
-        oslo_gfx_next_batch(instance);
+    oslo_async_task_t* task = __oslo_async_current_task();
+    if (!task)
+        return;
 
-    oslo_gfx_quad_batch_draw_quad(&instance->gfx.default_batch, &(draw_quad_desc_t)
-    {
-        .position = position,
-        .rotation = rotation,
-        .size = size,
-        .color = color
-    });
+    task->wait = OSLO_ASYNC_WAIT_TIME;
+    task->wake_ns = instance->time.elapsed_ns + (uint64_t)(oslo_max(seconds, 0.0f) * 1e9);
+    mco_yield(task->co);
 }
 
-void oslo_gfx_draw_texture(vec2 position, float rotation, vec2 size, vec4 tint, oslo_texture_id texture)
+void oslo_async_wait_counter(oslo_job_counter_t* counter)
 {
-    if (oslo_gfx_quad_batch_is_full(&instance->gfx.default_batch))
-        oslo_gfx_next_batch(instance);
-
-    oslo_gfx_quad_batch_draw_texture(&instance->gfx.default_batch, &(draw_texture_desc_t)
+    oslo_async_task_t* task = __oslo_async_current_task();
+    if (!task)
     {
-        .position = position,
-        .rotation = rotation,
-        .size = size,
-        .color = tint,
-        .texture = texture
-    });
+        // Outside of a task this is just a blocking wait
+        oslo_job_wait(counter);
+        return;
+    }
+
+    if (oslo_job_is_done(counter))
+        return;
+
+    task->wait = OSLO_ASYNC_WAIT_COUNTER;
+    task->counter = counter;
+    mco_yield(task->co);
 }
 
-void oslo_gfx_draw_textured_quad(vec4 quad[4], vec4 tint, oslo_texture_id texture, oslo_rect_t rect, bool flip_horizontal)
+#pragma endregion
+
+#pragma region STRING
+/*========================
+// String Interning
+========================*/
+
+#ifndef OSLO_STRING_BLOCK_SIZE
+    #define OSLO_STRING_BLOCK_SIZE (64 * 1024)
+#endif
+
+typedef struct oslo_string_entry_t
 {
-   if (oslo_gfx_quad_batch_is_full(&instance->gfx.default_batch))
-        oslo_gfx_next_batch(instance);
+    const char* str;
+    uint32_t length;
+    uint64_t hash;
+    // Next id whose hash collides with this one
+    oslo_string_id next;
+} oslo_string_entry_t;
 
-    oslo_gfx_quad_batch_draw_textured_quad(&instance->gfx.default_batch, &(draw_textured_quad_desc_t)
+typedef struct oslo_string_interner_t
+{
+    // oslo_hash_str64 -> first id with that hash
+    oslo_hash_table(uint64_t, oslo_string_id) lookup;
+    // entries[id - 1]
+    oslo_dyn_array(oslo_string_entry_t) entries;
+
+    // Characters live in blocks that never move, so oslo_string_get stays valid
+    oslo_dyn_array(char*) blocks;
+    char* block;
+    uint32_t block_used;
+
+    volatile uint32_t lock;
+} oslo_string_interner_t;
+
+static oslo_string_interner_t __oslo_strings = default_val();
+
+void __oslo_string_lock()
+{
+    while (c89atomic_exchange_32(&__oslo_strings.lock, 1))
     {
-        .quad = {quad[0], quad[1], quad[2], quad[3]},
-        .color = tint,
-        .texture = texture,
-        .section = rect,
-        .flip_horizontal = flip_horizontal
-    });
+        ma_yield();
+    }
 }
 
-void oslo_gfx_draw_texture_section(vec2 position, float rotation, vec2 size, vec4 tint, oslo_texture_id texture, oslo_rect_t rect, bool flip_horizontal)
+void __oslo_string_unlock()
 {
-    if (oslo_gfx_quad_batch_is_full(&instance->gfx.default_batch))
-        oslo_gfx_next_batch(instance);
-
-    oslo_gfx_quad_batch_draw_texture_section(&instance->gfx.default_batch, &(draw_texture_section_desc_t)
-    {
-        .position = position,
-        .rotation = rotation,
-        .size = size,
-        .color = tint,
-        .texture = texture,
-        .section = rect,
-        .flip_horizontal = flip_horizontal
-    });
+    c89atomic_store_32(&__oslo_strings.lock, 0);
 }
 
-oslo_texture_id oslo_gfx_create_texture(void* data, uint32_t width, uint32_t height, uint32_t num_channels)
+oslo_string_id __oslo_string_find_locked(const char* str, uint32_t length, uint64_t hash)
 {
-    oslo_gfx_texture_t texture = default_val();
-    texture.width = width;
-    texture.height = height;
-    texture.channels = num_channels;
+    oslo_string_id* first = __oslo_strings.lookup ? oslo_hash_table_getp(__oslo_strings.lookup, hash) : NULL;
+    for (oslo_string_id id = first ? *first : OSLO_STRING_ID_INVALID; id != OSLO_STRING_ID_INVALID; )
+    {
+        oslo_string_entry_t* e = &__oslo_strings.entries[id - 1];
+        if (e->length == length && memcmp(e->str, str, length) == 0)
+        {
+            return id;
+        }
+        id = e->next;
+    }
+    return OSLO_STRING_ID_INVALID;
+}
 
-    GLenum internal_format = 0, data_format = 0;
-    if (num_channels == 4)
+char* __oslo_string_store(const char* str, uint32_t length)
+{
+    char* dst = NULL;
+    if (length + 1 > OSLO_STRING_BLOCK_SIZE / 4)
     {
-        internal_format = GL_RGBA8;
-        data_format = GL_RGBA;
+        // Long strings get their own allocation instead of wasting the rest of a block
+        dst = (char*)oslo_malloc(length + 1);
+        oslo_dyn_array_push(__oslo_strings.blocks, dst);
     }
     else
     {
-        internal_format = GL_RGB8;
-        data_format = GL_RGB;
+        if (!__oslo_strings.block || __oslo_strings.block_used + length + 1 > OSLO_STRING_BLOCK_SIZE)
+        {
+            __oslo_strings.block = (char*)oslo_malloc(OSLO_STRING_BLOCK_SIZE);
+            __oslo_strings.block_used = 0;
+            oslo_dyn_array_push(__oslo_strings.blocks, __oslo_strings.block);
+        }
+        dst = __oslo_strings.block + __oslo_strings.block_used;
+        __oslo_strings.block_used += length + 1;
     }
 
-    glCreateTextures(GL_TEXTURE_2D, 1, &texture.id);
-    glTextureStorage2D(texture.id, 1, internal_format, width, height);
+    memcpy(dst, str, length);
+    dst[length] = '\0';
+    return dst;
+}
 
-    glTextureParameteri(texture.id, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTextureParameteri(texture.id, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+oslo_string_id oslo_string_intern(const char* str)
+{
+    if (!str)
+        return OSLO_STRING_ID_INVALID;
 
-    glTextureParameteri(texture.id, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTextureParameteri(texture.id, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    uint32_t length = string_length(str);
+    uint64_t hash = oslo_hash_str64(str);
 
-    glTextureSubImage2D(texture.id, 0, 0, 0, width, height, data_format, GL_UNSIGNED_BYTE, data);
+    __oslo_string_lock();
+    oslo_string_id id = __oslo_string_find_locked(str, length, hash);
+    if (id == OSLO_STRING_ID_INVALID)
+    {
+        oslo_string_entry_t e = default_val();
+        oslo_memory_category category = oslo_memory_push_category(OSLO_MEMORY_STRINGS);
+        e.str = __oslo_string_store(str, length);
+        oslo_memory_pop_category(category);
+        e.length = length;
+        e.hash = hash;
+
+        // New strings go to the front of their collision chain
+        oslo_string_id* first = __oslo_strings.lookup ? oslo_hash_table_getp(__oslo_strings.lookup, hash) : NULL;
+        e.next = first ? *first : OSLO_STRING_ID_INVALID;
+
+        oslo_dyn_array_push(__oslo_strings.entries, e);
+        id = (oslo_string_id)oslo_dyn_array_size(__oslo_strings.entries);
+        oslo_hash_table_insert(__oslo_strings.lookup, hash, id);
+    }
+    __oslo_string_unlock();
 
-    oslo_gfx_t* gfx = &instance->gfx;
-    return oslo_slot_array_insert(gfx->textures, texture);
+    return id;
 }
 
-oslo_texture_id oslo_gfx_load_texture(const char* path)
+oslo_string_id oslo_string_find(const char* str)
 {
-    int width, height, channels;
-    unsigned char *data = stbi_load(path, &width, &height, &channels, 0);
-    oslo_texture_id texture = oslo_gfx_create_texture(data, width, height, channels);   
-    stbi_image_free(data);
-    return texture;
+    if (!str)
+        return OSLO_STRING_ID_INVALID;
+
+    uint32_t length = string_length(str);
+    uint64_t hash = oslo_hash_str64(str);
+
+    __oslo_string_lock();
+    oslo_string_id id = __oslo_string_find_locked(str, length, hash);
+    __oslo_string_unlock();
+
+    return id;
 }
 
-void oslo_gfx_unload_texture(oslo_texture_id texture)
+const char* oslo_string_get(oslo_string_id id)
 {
-    oslo_gfx_texture_t* p_texture = oslo_slot_array_getp(instance->gfx.textures, texture);
-    if (p_texture != NULL)
+    const char* str = NULL;
+    __oslo_string_lock();
+    if (id != OSLO_STRING_ID_INVALID && id <= (oslo_string_id)oslo_dyn_array_size(__oslo_strings.entries))
     {
-        unload_texture(p_texture);
-        oslo_slot_array_erase(instance->gfx.textures, texture);
+        str = __oslo_strings.entries[id - 1].str;
     }
+    __oslo_string_unlock();
+    return str;
 }
 
-void oslo_gfx_text(const char* text, vec2 position, float size, vec4 color, oslo_font_t* font)
+uint32_t oslo_string_length(oslo_string_id id)
 {
-    while (text[0] != '\0')
+    uint32_t length = 0;
+    __oslo_string_lock();
+    if (id != OSLO_STRING_ID_INVALID && id <= (oslo_string_id)oslo_dyn_array_size(__oslo_strings.entries))
     {
-        char c = text[0];
-        if (c >= 32 && c < 127)
-        {
-            stbtt_aligned_quad q = default_val();
-			stbtt_GetBakedQuad((stbtt_bakedchar*)&font->glyphs[0], 512, 512, c-32, &position.x, &position.y, &q, 1);
-
-            oslo_rect_t section = 
-            {
-                .min = {q.s0 * 512, q.t0 * 512},
-                .max = {q.s1 * 512, q.t1 * 512}
-            };
-
-            vec4 quad[4] = 
-            {
-                {q.x0, q.y0, 0.0f, 1.0f},
-                {q.x1, q.y0, 0.0f, 1.0f},
-                {q.x1, q.y1, 0.0f, 1.0f},
-                {q.x0, q.y1, 0.0f, 1.0f}
-            };
-
-            oslo_gfx_draw_textured_quad(quad, color, font->texture, section, false);
-        }
+        length = __oslo_strings.entries[id - 1].length;
+    }
+    __oslo_string_unlock();
+    return length;
+}
 
-        ++text;
+void oslo_string_shutdown()
+{
+    for (uint32_t i = 0; i < (uint32_t)oslo_dyn_array_size(__oslo_strings.blocks); ++i)
+    {
+        oslo_free(__oslo_strings.blocks[i]);
     }
+    oslo_dyn_array_free(__oslo_strings.blocks);
+    oslo_dyn_array_free(__oslo_strings.entries);
+    oslo_hash_table_free(__oslo_strings.lookup);
+    memset(&__oslo_strings, 0, sizeof(__oslo_strings));
 }
 
 #pragma endregion
@@ -2671,6 +4843,12 @@ void __glfw_frame_buffer_size_callback(GLFWwindow* window, s32 width, s32 height
     // Since right now both share the same coords
     instance->gfx.projection = mat4_ortho(0.0f, width, height, 0.0f, -1.0f, 1.0f);
 
+    if (instance->gfx.render_thread)
+    {
+        oslo_gfx_record_viewport(width, height, instance->gfx.projection);
+        return;
+    }
+
     // Upload projection
     glUseProgram(instance->gfx.shader);
     glUniformMatrix4fv(glGetUniformLocation(instance->gfx.shader, "u_projection"), 1, GL_FALSE, &instance->gfx.projection.elements[0]);
@@ -2699,6 +4877,100 @@ float oslo_get_delta_time()
     return instance->time.delta;
 }
 
+uint64_t oslo_get_frame_count()
+{
+    return instance->time.frame_count;
+}
+
+float oslo_get_fixed_delta_time()
+{
+    return instance->time.fixed_delta;
+}
+
+float oslo_get_interpolation_alpha()
+{
+    return instance->time.alpha;
+}
+
+double oslo_get_delta_time_f64()
+{
+    return instance->time.delta_ns / 1000000000.0;
+}
+
+uint64_t oslo_get_delta_time_ns()
+{
+    return instance->time.delta_ns;
+}
+
+const oslo_frame_history_t* oslo_get_frame_history()
+{
+    return &instance->time.history;
+}
+
+void oslo_frame_history_push(oslo_frame_history_t* history, uint64_t duration_ns)
+{
+    history->durations[history->head] = duration_ns;
+    history->head = (history->head + 1) % OSLO_FRAME_HISTORY_SIZE;
+    if (history->count < OSLO_FRAME_HISTORY_SIZE)
+    {
+        history->count++;
+    }
+}
+
+uint64_t oslo_frame_history_min(const oslo_frame_history_t* history)
+{
+    uint64_t result = history->count ? UINT64_MAX : 0;
+    for (uint32_t i = 0; i < history->count; ++i)
+    {
+        result = oslo_min(result, history->durations[i]);
+    }
+    return result;
+}
+
+uint64_t oslo_frame_history_max(const oslo_frame_history_t* history)
+{
+    uint64_t result = 0;
+    for (uint32_t i = 0; i < history->count; ++i)
+    {
+        result = oslo_max(result, history->durations[i]);
+    }
+    return result;
+}
+
+uint64_t oslo_frame_history_avg(const oslo_frame_history_t* history)
+{
+    uint64_t sum = 0;
+    for (uint32_t i = 0; i < history->count; ++i)
+    {
+        sum += history->durations[i];
+    }
+    return history->count ? sum / history->count : 0;
+}
+
+int __oslo_compare_u64(const void* a, const void* b)
+{
+    uint64_t va = *(const uint64_t*)a;
+    uint64_t vb = *(const uint64_t*)b;
+    return (va > vb) - (va < vb);
+}
+
+// Nearest-rank percentile, percentile in the [0, 100] range
+uint64_t oslo_frame_history_percentile(const oslo_frame_history_t* history, float percentile)
+{
+    if (!history->count)
+    {
+        return 0;
+    }
+
+    uint64_t sorted[OSLO_FRAME_HISTORY_SIZE];
+    memcpy(sorted, history->durations, history->count * sizeof(uint64_t));
+    qsort(sorted, history->count, sizeof(uint64_t), __oslo_compare_u64);
+
+    float p = oslo_clamp(percentile, 0.0f, 100.0f);
+    uint32_t rank = (uint32_t)ceilf(p / 100.0f * history->count);
+    return sorted[rank ? rank - 1 : 0];
+}
+
 #pragma endregion
 
 #pragma region AUDIO
@@ -2717,8 +4989,6 @@ void ma_audio_commit(ma_device* device, void* output, const void* input, ma_uint
     miniaudio_data_t* ma = (miniaudio_data_t*)audio->user_data;
     memset(output, 0, frame_count * device->playback.channels * ma_get_bytes_per_sample(device->playback.format));
 
-    u32 destroy_count = 0;
-    uint32_t handles_to_destroy[32];
     if(!audio->instances)
         return;
 
@@ -2729,23 +4999,17 @@ void ma_audio_commit(ma_device* device, void* output, const void* input, ma_uint
 
     oslo_audio_mutex_lock();
     {
-        for (
-            oslo_slot_array_iter it = oslo_slot_array_iter_new(audio->instances);
-            oslo_slot_array_iter_valid(audio->instances, it);
-            oslo_slot_array_iter_advance(audio->instances, it)
-        )
+        // Walk backwards so destroying an instance swaps in one that was already mixed
+        for (uint32_t i = oslo_slot_array_size(audio->instances); i-- > 0;)
         {
-            if (it == -1)
-                continue;
-
-            oslo_audio_instance_t* inst = oslo_slot_array_iter_getp(audio->instances, it);
-            oslo_audio_source_t* src = oslo_slot_array_getp(audio->sources, inst->src);
+            oslo_audio_instance_t* inst = oslo_slot_array_dense_getp(audio->instances, i);
+            oslo_audio_source_t* src = oslo_slot_array_exists(audio->sources, inst->src) ? oslo_slot_array_getp(audio->sources, inst->src) : NULL;
 
             // Easy out if the instance is not playing currently or the source is invalid
             if ((!inst->playing) || !src)
             {
                 if (!inst->persistent)
-                    handles_to_destroy[destroy_count++] = it;
+                    oslo_slot_array_dense_erase(audio->instances, i);
                 
                 continue;
             }
@@ -2755,6 +5019,7 @@ void ma_audio_commit(ma_device* device, void* output, const void* input, ma_uint
 
             u64 samples_to_write = (u64)frame_count;
             f64 sample_volume = inst->volume;
+            bool destroy = false;
 
             // Write to channels
             for (u64 write_sample = 0; write_sample < samples_to_write; ++write_sample)
@@ -2813,21 +5078,16 @@ void ma_audio_commit(ma_device* device, void* output, const void* input, ma_uint
                     {
                         inst->playing = false;
                         inst->sample_position = 0;
-                        if (!inst->persistent)
-                        {
-                            // Need to destroy the instance at this point...
-                            handles_to_destroy[destroy_count++] = it;
-                        }
+                        destroy = !inst->persistent;
                         break;
                     }
                 }
             }
-        }
 
-        // Destroy instances
-        for (uint32_t i = 0; i < destroy_count; ++i)
-        {
-            oslo_slot_array_erase(audio->instances, handles_to_destroy[i]);
+            if (destroy)
+            {
+                oslo_slot_array_dense_erase(audio->instances, i);
+            }
         }
     }
 
@@ -2839,11 +5099,14 @@ void oslo_audio_init()
     oslo_audio_t* audio = &instance->audio;
     audio->sources = oslo_slot_array_new(oslo_audio_source_t);
     audio->instances = oslo_slot_array_new(oslo_audio_instance_t);
+    audio->source_names = oslo_string_map_new(oslo_audio_source_id);
     audio->max_volume = 1.0f;
     audio->min_volume = 0.0f;
     audio->commit = NULL;
 
-    audio->user_data = malloc(sizeof(miniaudio_data_t));
+    oslo_memory_category category = oslo_memory_push_category(OSLO_MEMORY_AUDIO);
+    audio->user_data = oslo_malloc(sizeof(miniaudio_data_t));
+    oslo_memory_pop_category(category);
     memset(audio->user_data, 0, sizeof(miniaudio_data_t));
 
     oslo_slot_array_reserve(audio->instances, 1024);
@@ -2915,19 +5178,26 @@ void oslo_audio_shutdown()
     ma_device_uninit(&ma->device);
     ma_mutex_uninit(&ma->lock);
 
+    oslo_slot_array_dense_for(audio->sources, i)
+    {
+        oslo_free(oslo_slot_array_dense_getp(audio->sources, i)->samples);
+    }
+
     oslo_slot_array_free(audio->sources);
     oslo_slot_array_free(audio->instances);
+    oslo_string_map_free(audio->source_names);
 
     miniaudio_data_t* data = (miniaudio_data_t*)audio->user_data;
-    free(data);
+    oslo_free(data);
 }
 
 bool oslo_audio_load_ogg_from_file(const char* path, int32_t* sample_count, int32_t* channels, int32_t* sample_rate, void** samples)
 {
     size_t len = 0;
-    char* file_data = oslo_read_file_contents(path, "rb", &len);
+    const oslo_allocator_t* scratch = __oslo_scratch_allocator();
+    char* file_data = oslo_read_file_contents_allocator(path, "rb", &len, scratch);
     *sample_count = stb_vorbis_decode_memory((const unsigned char*)file_data, (size_t)len, channels, sample_rate, (s16**)samples);
-    free(file_data);
+    oslo_allocator_free(scratch, file_data);
 
     if (!*samples || *sample_count == -1)
     {
@@ -2938,16 +5208,23 @@ bool oslo_audio_load_ogg_from_file(const char* path, int32_t* sample_count, int3
     
     *sample_count *= *channels;
 
+    // stb_vorbis decodes with malloc, move the samples to the global allocator like the other loaders
+    void* decoded = *samples;
+    *samples = oslo_malloc(*sample_count * sizeof(s16));
+    memcpy(*samples, decoded, *sample_count * sizeof(s16));
+    free(decoded);
+
     return true;
 }
 
 bool oslo_audio_load_wav_from_file(const char* path, int32_t* sample_count, int32_t* channels, int32_t* sample_rate, void** samples)
 {
     size_t len = 0;
-    char* file_data = oslo_read_file_contents(path, "rb", &len);
+    const oslo_allocator_t* scratch = __oslo_scratch_allocator();
+    char* file_data = oslo_read_file_contents_allocator(path, "rb", &len, scratch);
     uint64_t total_pcm_frame_count = 0;
     *samples =  drwav_open_memory_and_read_pcm_frames_s16(file_data, len, (uint32_t*)channels, (uint32_t*)sample_rate, &total_pcm_frame_count, NULL);
-    free(file_data);
+    oslo_allocator_free(scratch, file_data);
 
     if (!*samples) 
     {
@@ -2964,11 +5241,12 @@ bool oslo_audio_load_wav_from_file(const char* path, int32_t* sample_count, int3
 bool oslo_audio_load_mp3_from_file(const char* path, int32_t* sample_count, int32_t* channels, int32_t* sample_rate, void** samples)
 {
     size_t len = 0;
-    char* file_data = oslo_read_file_contents(path, "rb", &len);
+    const oslo_allocator_t* scratch = __oslo_scratch_allocator();
+    char* file_data = oslo_read_file_contents_allocator(path, "rb", &len, scratch);
     uint64_t total_pcm_frame_count = 0;
     drmp3_config cfg = default_val();
     *samples =  drmp3_open_memory_and_read_pcm_frames_s16(file_data, len, &cfg, (drmp3_uint64*)&total_pcm_frame_count, NULL);
-    free(file_data);
+    oslo_allocator_free(scratch, file_data);
 
     if (!*samples)
     {
@@ -3020,6 +5298,8 @@ oslo_audio_source_id oslo_audio_load_from_file(const char* path)
     oslo_str_to_lower(path, ext, sizeof(ext));
     oslo_get_file_extension(ext, sizeof(ext), ext);
 
+    oslo_memory_category category = oslo_memory_push_category(OSLO_MEMORY_AUDIO);
+
     // Load OGG data
     if (oslo_string_compare_equal(ext, "ogg"))
     {
@@ -3055,16 +5335,25 @@ oslo_audio_source_id oslo_audio_load_from_file(const char* path)
         );
     }
 
+    oslo_memory_pop_category(category);
+
     // Load raw source into memory and return handle id
     if (load_successful)
     {
         // Add to resource cache
         handle = oslo_slot_array_insert(audio->sources, src);
+        oslo_string_map_insert(audio->source_names, path, handle);
     }
 
     return handle;
 }
 
+oslo_audio_source_id oslo_audio_find_source(const char* path)
+{
+    oslo_audio_source_id* src = oslo_string_map_getp(instance->audio.source_names, path);
+    return src ? *src : (oslo_audio_source_id)-1;
+}
+
 oslo_audio_instance_id oslo_audio_create_instance(oslo_audio_instance_t* inst)
 {
     oslo_audio_t* audio = &instance->audio;
@@ -3090,7 +5379,7 @@ void oslo_audio_play(oslo_audio_instance_id inst)
 {
     oslo_audio_t* audio = &instance->audio;
     oslo_audio_mutex_lock();
-    if (inst != -1)
+    if (oslo_slot_array_exists(audio->instances, inst))
     {
         oslo_slot_array_getp(audio->instances, inst)->playing = true;
     }
@@ -3101,7 +5390,7 @@ void oslo_audio_pause(oslo_audio_instance_id inst)
 {
     oslo_audio_t* audio = &instance->audio;
     oslo_audio_mutex_lock();
-    if (inst != -1)
+    if (oslo_slot_array_exists(audio->instances, inst))
     {
         oslo_slot_array_getp(audio->instances, inst)->playing = false;
     }
@@ -3112,7 +5401,7 @@ void oslo_audio_stop(oslo_audio_instance_id inst)
 {
     oslo_audio_t* audio = &instance->audio;
     oslo_audio_mutex_lock();
-    if (inst != -1)
+    if (oslo_slot_array_exists(audio->instances, inst))
     {
         oslo_audio_instance_t* ip = oslo_slot_array_getp(audio->instances, inst);
         ip->playing = false;
@@ -3125,7 +5414,7 @@ void oslo_audio_restart(oslo_audio_instance_id inst)
 {
     oslo_audio_t* audio = &instance->audio;
     oslo_audio_mutex_lock();
-    if (inst != -1)
+    if (oslo_slot_array_exists(audio->instances, inst))
     {
         oslo_slot_array_getp(audio->instances, inst)->sample_position = 0;
     }
@@ -3137,7 +5426,7 @@ bool oslo_audio_is_playing(oslo_audio_instance_id inst)
     bool playing = false;
     oslo_audio_t* audio = &instance->audio;
     oslo_audio_mutex_lock();
-    if (inst != -1)
+    if (oslo_slot_array_exists(audio->instances, inst))
     {
         playing = oslo_slot_array_getp(audio->instances, inst)->playing;
     }
@@ -3149,7 +5438,7 @@ bool oslo_audio_is_playing(oslo_audio_instance_id inst)
 float oslo_audio_get_volume(oslo_audio_instance_id inst)
 {
     oslo_audio_t* audio = &instance->audio;
-    if (inst != -1)
+    if (oslo_slot_array_exists(audio->instances, inst))
     {
         return oslo_slot_array_getp(audio->instances, inst)->volume;
     }
@@ -3160,7 +5449,7 @@ float oslo_audio_get_volume(oslo_audio_instance_id inst)
 void oslo_audio_set_volume(oslo_audio_instance_id inst, float volume)
 {
     oslo_audio_t* audio = &instance->audio;
-    if (inst != -1)
+    if (oslo_slot_array_exists(audio->instances, inst))
     {
         oslo_slot_array_getp(audio->instances, inst)->volume = volume;
     }   
@@ -3198,6 +5487,11 @@ int32_t oslo_file_size_in_bytes(const char* file_path)
 }
 
 char* oslo_read_file_contents(const char* file_path, const char* mode, size_t* sz)
+{
+    return oslo_read_file_contents_allocator(file_path, mode, sz, NULL);
+}
+
+char* oslo_read_file_contents_allocator(const char* file_path, const char* mode, size_t* sz, const oslo_allocator_t* allocator)
 {
     const char* path = file_path;
 
@@ -3213,7 +5507,7 @@ char* oslo_read_file_contents(const char* file_path, const char* mode, size_t* s
     if (fp)
     {
         read_sz = oslo_file_size_in_bytes(file_path);
-        buffer = (char*)malloc(read_sz + 1);
+        buffer = (char*)oslo_allocator_alloc(allocator, read_sz + 1);
         if (buffer) {
            size_t _r = fread(buffer, 1, read_sz, fp);
         }
@@ -3231,7 +5525,9 @@ char* oslo_read_file_contents(const char* file_path, const char* mode, size_t* s
 bool oslo_load_font_from_file(const char* path, uint32_t point_size, oslo_font_t* out_font)
 {
     size_t len = 0;
-    char* ttf = oslo_read_file_contents(path, "rb", &len);
+    const oslo_allocator_t* scratch = __oslo_scratch_allocator();
+    oslo_memory_category category = oslo_memory_push_category(OSLO_MEMORY_FONTS);
+    char* ttf = oslo_read_file_contents_allocator(path, "rb", &len, scratch);
     if (!point_size) 
     {
         point_size = 16;
@@ -3243,65 +5539,331 @@ bool oslo_load_font_from_file(const char* path, uint32_t point_size, oslo_font_t
         notify_error(instance, OSLO_LOAD_ERROR, "Failed to load font!");
     }
 
-    free(ttf);
+    oslo_allocator_free(scratch, ttf);
+    oslo_memory_pop_category(category);
     return ret;
 }
 
 void oslo_unload_font(oslo_font_t* font)
 {
-    if (font != NULL)
+    if (font != NULL)
+    {
+        oslo_gfx_unload_texture(font->texture);
+    }
+}
+
+bool oslo_load_font_from_memory(void* memory, size_t len, uint32_t point_size, oslo_font_t* out_font)
+{
+    if (!point_size) 
+    {
+        point_size = 16;
+    }
+
+    const uint32_t num_comps = 4;
+    const oslo_allocator_t* scratch = __oslo_scratch_allocator();
+    oslo_memory_category category = oslo_memory_push_category(OSLO_MEMORY_FONTS);
+    u8* alpha_bitmap = (uint8_t*)oslo_allocator_alloc(scratch, 512 * 512);
+    u8* flipmap = (uint8_t*)oslo_allocator_alloc(scratch, 512 * 512 * num_comps);
+    memset(alpha_bitmap, 0, 512 * 512);
+    memset(flipmap, 0, 512 * 512 * num_comps);
+    s32 v = stbtt_BakeFontBitmap((u8*)memory, 0, (float)point_size, alpha_bitmap, 512, 512, 32, 96, (stbtt_bakedchar*)out_font->glyphs); // no guarantee this fits!
+
+    // Flip texture
+    u32 r = 512 - 1;
+    for (u32 i = 0; i < 512; ++i)
+    {
+        for (u32 j = 0; j < 512; ++j)
+        {
+            u32 i0 = i * 512 + j;
+            u32 i1 = i * 512 * num_comps + j * num_comps;
+            u8 a = alpha_bitmap[i0];
+            flipmap[i1 + 0] = 255;
+            flipmap[i1 + 1] = 255;
+            flipmap[i1 + 2] = 255;
+            flipmap[i1 + 3] = a;
+        }
+        r--;
+    } 
+
+    out_font->texture = oslo_gfx_create_texture(flipmap, 512, 512, 4);
+
+    bool success = false;
+    if (v <= 0) 
+    {
+        notify_error(instance, OSLO_LOAD_ERROR, "Font failed to load, Baked texture too small!");
+    }
+    else
+    {
+        success = true;
+    }
+
+    oslo_allocator_free(scratch, flipmap);
+    oslo_allocator_free(scratch, alpha_bitmap);
+    oslo_memory_pop_category(category);
+
+    return success;
+}
+
+#pragma endregion
+
+#pragma region ALLOCATOR
+/*========================
+// Allocator
+========================*/
+
+static void* __oslo_default_alloc(size_t size, void* user_data)
+{
+    (void)user_data;
+    return malloc(size);
+}
+
+static void* __oslo_default_realloc(void* ptr, size_t size, void* user_data)
+{
+    (void)user_data;
+    return realloc(ptr, size);
+}
+
+static void __oslo_default_free(void* ptr, void* user_data)
+{
+    (void)user_data;
+    free(ptr);
+}
+
+static oslo_allocator_t __oslo_allocator = { __oslo_default_alloc, __oslo_default_realloc, __oslo_default_free, NULL };
+
+const oslo_allocator_t* oslo_get_allocator()
+{
+    return &__oslo_allocator;
+}
+
+void oslo_set_allocator(const oslo_allocator_t* allocator)
+{
+    __oslo_allocator = *allocator;
+}
+
+static MCO_THREAD_LOCAL oslo_memory_category __oslo_memory_category = OSLO_MEMORY_GENERAL;
+
+oslo_memory_category oslo_memory_push_category(oslo_memory_category category)
+{
+    oslo_memory_category previous = __oslo_memory_category;
+    __oslo_memory_category = category;
+    return previous;
+}
+
+void oslo_memory_pop_category(oslo_memory_category previous)
+{
+    __oslo_memory_category = previous;
+}
+
+oslo_memory_category oslo_memory_current_category()
+{
+    return __oslo_memory_category;
+}
+
+const char* oslo_memory_category_name(oslo_memory_category category)
+{
+    static const char* names[OSLO_MEMORY_CATEGORY_COUNT] = { "general", "containers", "scratch", "strings", "gfx", "fonts", "audio", "jobs" };
+    return (uint32_t)category < OSLO_MEMORY_CATEGORY_COUNT ? names[category] : "unknown";
+}
+
+#ifdef OSLO_MEMORY_TRACKING
+
+typedef union __oslo_memory_header_t
+{
+    struct
+    {
+        size_t size;
+        uint32_t category;
+    } info;
+    // Keep the returned pointer 16 byte aligned
+    uint8_t pad[16];
+} __oslo_memory_header_t;
+
+typedef struct __oslo_memory_tracker_t
+{
+    volatile uint32_t lock;
+    // The last entry holds the totals
+    oslo_memory_stats_t stats[OSLO_MEMORY_CATEGORY_COUNT + 1];
+    uint32_t frame_allocs[OSLO_MEMORY_CATEGORY_COUNT + 1];
+} __oslo_memory_tracker_t;
+
+static __oslo_memory_tracker_t __oslo_memory = {0};
+
+static void __oslo_memory_lock()
+{
+    while (c89atomic_exchange_32(&__oslo_memory.lock, 1))
+    {
+        ma_yield();
+    }
+}
+
+static void __oslo_memory_unlock()
+{
+    c89atomic_store_32(&__oslo_memory.lock, 0);
+}
+
+static void __oslo_memory_track(uint32_t category, int64_t bytes, int64_t allocs, bool new_alloc)
+{
+    uint32_t entries[2] = { category, OSLO_MEMORY_CATEGORY_COUNT };
+
+    __oslo_memory_lock();
+    for (uint32_t i = 0; i < 2; ++i)
+    {
+        oslo_memory_stats_t* s = &__oslo_memory.stats[entries[i]];
+        s->live_bytes += bytes;
+        s->peak_bytes = oslo_max(s->peak_bytes, s->live_bytes);
+        s->live_allocs += allocs;
+        if (new_alloc)
+        {
+            s->total_allocs += allocs > 0 ? 1 : 0;
+            __oslo_memory.frame_allocs[entries[i]]++;
+        }
+    }
+    __oslo_memory_unlock();
+}
+
+#endif
+
+void oslo_memory_get_stats(oslo_memory_category category, oslo_memory_stats_t* out_stats)
+{
+    memset(out_stats, 0, sizeof(oslo_memory_stats_t));
+#ifdef OSLO_MEMORY_TRACKING
+    if ((uint32_t)category < OSLO_MEMORY_CATEGORY_COUNT)
+    {
+        __oslo_memory_lock();
+        *out_stats = __oslo_memory.stats[category];
+        __oslo_memory_unlock();
+    }
+#else
+    (void)category;
+#endif
+}
+
+void oslo_memory_get_total_stats(oslo_memory_stats_t* out_stats)
+{
+    memset(out_stats, 0, sizeof(oslo_memory_stats_t));
+#ifdef OSLO_MEMORY_TRACKING
+    __oslo_memory_lock();
+    *out_stats = __oslo_memory.stats[OSLO_MEMORY_CATEGORY_COUNT];
+    __oslo_memory_unlock();
+#endif
+}
+
+void oslo_memory_track_gpu(oslo_memory_category category, int64_t bytes)
+{
+#ifdef OSLO_MEMORY_TRACKING
+    if ((uint32_t)category < OSLO_MEMORY_CATEGORY_COUNT)
+    {
+        __oslo_memory_lock();
+        __oslo_memory.stats[category].gpu_bytes += bytes;
+        __oslo_memory.stats[OSLO_MEMORY_CATEGORY_COUNT].gpu_bytes += bytes;
+        __oslo_memory_unlock();
+    }
+#else
+    (void)category;
+    (void)bytes;
+#endif
+}
+
+void __oslo_memory_new_frame()
+{
+#ifdef OSLO_MEMORY_TRACKING
+    __oslo_memory_lock();
+    for (uint32_t i = 0; i <= OSLO_MEMORY_CATEGORY_COUNT; ++i)
     {
-        oslo_gfx_unload_texture(font->texture);
+        __oslo_memory.stats[i].frame_allocs = __oslo_memory.frame_allocs[i];
+        __oslo_memory.frame_allocs[i] = 0;
     }
+    __oslo_memory_unlock();
+#endif
 }
 
-bool oslo_load_font_from_memory(void* memory, size_t len, uint32_t point_size, oslo_font_t* out_font)
+void __oslo_memory_report_leaks(void(*on_error)(oslo_error_code, const char*))
 {
-    if (!point_size) 
+#ifdef OSLO_MEMORY_TRACKING
+    if (on_error == NULL)
     {
-        point_size = 16;
+        return;
     }
 
-    const uint32_t num_comps = 4;
-    u8* alpha_bitmap = (uint8_t*)malloc(512 * 512);
-    u8* flipmap = (uint8_t*)malloc(512 * 512 * num_comps);
-    memset(alpha_bitmap, 0, 512 * 512);
-    memset(flipmap, 0, 512 * 512 * num_comps);
-    s32 v = stbtt_BakeFontBitmap((u8*)memory, 0, (float)point_size, alpha_bitmap, 512, 512, 32, 96, (stbtt_bakedchar*)out_font->glyphs); // no guarantee this fits!
-
-    // Flip texture
-    u32 r = 512 - 1;
-    for (u32 i = 0; i < 512; ++i)
+    for (uint32_t i = 0; i < OSLO_MEMORY_CATEGORY_COUNT; ++i)
     {
-        for (u32 j = 0; j < 512; ++j)
+        oslo_memory_stats_t* s = &__oslo_memory.stats[i];
+        if (s->live_allocs || s->live_bytes || s->gpu_bytes)
         {
-            u32 i0 = i * 512 + j;
-            u32 i1 = i * 512 * num_comps + j * num_comps;
-            u8 a = alpha_bitmap[i0];
-            flipmap[i1 + 0] = 255;
-            flipmap[i1 + 1] = 255;
-            flipmap[i1 + 2] = 255;
-            flipmap[i1 + 3] = a;
+            char msg[256];
+            snprintf(msg, sizeof(msg), "Memory leak in %s: %lld bytes in %lld allocations, %lld gpu bytes",
+                oslo_memory_category_name((oslo_memory_category)i), (long long)s->live_bytes, (long long)s->live_allocs, (long long)s->gpu_bytes);
+            on_error(OSLO_MEMORY_LEAK, msg);
         }
-        r--;
-    } 
-
-    out_font->texture = oslo_gfx_create_texture(flipmap, 512, 512, 4);
+    }
+#else
+    (void)on_error;
+#endif
+}
 
-    bool success = false;
-    if (v <= 0) 
+void* oslo_allocator_alloc(const oslo_allocator_t* allocator, size_t size)
+{
+    const oslo_allocator_t* a = allocator ? allocator : &__oslo_allocator;
+#ifdef OSLO_MEMORY_TRACKING
+    if (a == &__oslo_allocator)
     {
-        notify_error(instance, OSLO_LOAD_ERROR, "Font failed to load, Baked texture too small!");
+        __oslo_memory_header_t* header = (__oslo_memory_header_t*)(a->alloc)(size + sizeof(__oslo_memory_header_t), a->user_data);
+        if (!header)
+        {
+            return NULL;
+        }
+        header->info.size = size;
+        header->info.category = __oslo_memory_category;
+        __oslo_memory_track(header->info.category, (int64_t)size, 1, true);
+        return header + 1;
     }
-    else
+#endif
+    return (a->alloc)(size, a->user_data);
+}
+
+void* oslo_allocator_realloc(const oslo_allocator_t* allocator, void* ptr, size_t size)
+{
+    const oslo_allocator_t* a = allocator ? allocator : &__oslo_allocator;
+#ifdef OSLO_MEMORY_TRACKING
+    if (a == &__oslo_allocator)
     {
-        success = true;
-    }
+        if (!ptr)
+        {
+            return oslo_allocator_alloc(a, size);
+        }
 
-    free(alpha_bitmap);
-    free(flipmap);
+        // The allocation keeps the category it was created with
+        __oslo_memory_header_t* header = (__oslo_memory_header_t*)ptr - 1;
+        size_t old_size = header->info.size;
+        header = (__oslo_memory_header_t*)(a->realloc)(header, size + sizeof(__oslo_memory_header_t), a->user_data);
+        if (!header)
+        {
+            return NULL;
+        }
+        header->info.size = size;
+        __oslo_memory_track(header->info.category, (int64_t)size - (int64_t)old_size, 0, true);
+        return header + 1;
+    }
+#endif
+    return (a->realloc)(ptr, size, a->user_data);
+}
 
-    return success;
+void oslo_allocator_free(const oslo_allocator_t* allocator, void* ptr)
+{
+    const oslo_allocator_t* a = allocator ? allocator : &__oslo_allocator;
+    if (ptr)
+    {
+#ifdef OSLO_MEMORY_TRACKING
+        if (a == &__oslo_allocator)
+        {
+            __oslo_memory_header_t* header = (__oslo_memory_header_t*)ptr - 1;
+            __oslo_memory_track(header->info.category, -(int64_t)header->info.size, -1, false);
+            ptr = header;
+        }
+#endif
+        (a->free)(ptr, a->user_data);
+    }
 }
 
 #pragma endregion
@@ -3322,30 +5884,42 @@ void* oslo_dyn_array_resize_impl(void* arr, size_t sz, size_t amount)
     }
 
     // Create new oslo_dyn_array with just the header information
-    oslo_dyn_array* data = (oslo_dyn_array*)realloc(arr ? oslo_dyn_array_head(arr) : 0, capacity * sz + sizeof(oslo_dyn_array));
+    const oslo_allocator_t* allocator = arr ? oslo_dyn_array_head(arr)->allocator : NULL;
+    oslo_memory_category category = oslo_memory_push_category(OSLO_MEMORY_CONTAINERS);
+    oslo_dyn_array* data = (oslo_dyn_array*)oslo_allocator_realloc(allocator, arr ? oslo_dyn_array_head(arr) : 0, capacity * sz + sizeof(oslo_dyn_array));
+    oslo_memory_pop_category(category);
 
     if (data) {
         if (!arr) {
             data->size = 0;
+            data->allocator = NULL;
         }
         data->capacity = (int32_t)capacity;
-        return ((int32_t*)data + 2);
+        return (void*)(data + 1);
     }
 
     return NULL;
 }
 
-void** oslo_dyn_array_init(void** arr, size_t val_len)
+void** oslo_dyn_array_init_allocator_impl(void** arr, size_t val_len, const oslo_allocator_t* allocator)
 {
     if (*arr == NULL) {
-        oslo_dyn_array* data = (oslo_dyn_array*)malloc(val_len + sizeof(oslo_dyn_array));  // Allocate capacity of one
+        oslo_memory_category category = oslo_memory_push_category(OSLO_MEMORY_CONTAINERS);
+        oslo_dyn_array* data = (oslo_dyn_array*)oslo_allocator_alloc(allocator, val_len + sizeof(oslo_dyn_array));  // Allocate capacity of one
+        oslo_memory_pop_category(category);
         data->size = 0;
         data->capacity = 1;
-        *arr = ((int32_t*)data + 2);
+        data->allocator = allocator;
+        *arr = (void*)(data + 1);
     }
     return arr;
 }
 
+void** oslo_dyn_array_init(void** arr, size_t val_len)
+{
+    return oslo_dyn_array_init_allocator_impl(arr, val_len, NULL);
+}
+
 void oslo_dyn_array_push_data(void** arr, void* val, size_t val_len)
 {
     if (*arr == NULL) {
@@ -3356,11 +5930,11 @@ void oslo_dyn_array_push_data(void** arr, void* val, size_t val_len)
         int32_t capacity = oslo_dyn_array_capacity(*arr) * 2;
 
         // Create new oslo_dyn_array with just the header information
-        oslo_dyn_array* data = (oslo_dyn_array*)realloc(oslo_dyn_array_head(*arr), capacity * val_len + sizeof(oslo_dyn_array));
+        oslo_dyn_array* data = (oslo_dyn_array*)oslo_allocator_realloc(oslo_dyn_array_head(*arr)->allocator, oslo_dyn_array_head(*arr), capacity * val_len + sizeof(oslo_dyn_array));
 
         if (data) {
             data->capacity = capacity;
-            *arr = ((int32_t*)data + 2);
+            *arr = (void*)(data + 1);
         }
     }
     size_t offset = oslo_dyn_array_size(*arr);
@@ -3370,16 +5944,320 @@ void oslo_dyn_array_push_data(void** arr, void* val, size_t val_len)
 
 #pragma endregion
 
+#pragma region ARENA
+/*========================
+// Linear Arena
+========================*/
+
+#define __OSLO_ARENA_HEADER_SIZE    16
+
+oslo_arena_block_t* __oslo_arena_new_block(oslo_arena_t* arena, size_t capacity)
+{
+    oslo_memory_category category = oslo_memory_push_category(OSLO_MEMORY_SCRATCH);
+    oslo_arena_block_t* block = (oslo_arena_block_t*)oslo_allocator_alloc(arena->backing, sizeof(oslo_arena_block_t) + capacity);
+    oslo_memory_pop_category(category);
+    block->next = arena->blocks;
+    block->capacity = capacity;
+    block->offset = 0;
+    arena->blocks = block;
+    return block;
+}
+
+void* oslo_arena_alloc_aligned(oslo_arena_t* arena, size_t size, size_t align)
+{
+    oslo_arena_block_t* block = arena->blocks;
+    uintptr_t base = block ? (uintptr_t)(block + 1) : 0;
+    uintptr_t ptr = block ? (base + block->offset + (align - 1)) & ~(uintptr_t)(align - 1) : 0;
+
+    if (!block || ptr + size > base + block->capacity)
+    {
+        block = __oslo_arena_new_block(arena, oslo_max(arena->block_size, size + align));
+        base = (uintptr_t)(block + 1);
+        ptr = (base + (align - 1)) & ~(uintptr_t)(align - 1);
+    }
+
+    size_t end = (size_t)(ptr + size - base);
+    arena->used += end - block->offset;
+    arena->peak = oslo_max(arena->peak, arena->used);
+    block->offset = end;
+    return (void*)ptr;
+}
+
+void oslo_arena_reset(oslo_arena_t* arena)
+{
+    if (arena->blocks && arena->blocks->next)
+    {
+        // Merge the chain into a single block that fits the peak
+        while (arena->blocks)
+        {
+            oslo_arena_block_t* next = arena->blocks->next;
+            oslo_allocator_free(arena->backing, arena->blocks);
+            arena->blocks = next;
+        }
+        arena->block_size = oslo_min(oslo_max(arena->block_size, arena->peak), oslo_max(arena->max_block_size, arena->block_size));
+        __oslo_arena_new_block(arena, arena->block_size);
+    }
+    else if (arena->blocks)
+    {
+        arena->blocks->offset = 0;
+    }
+    arena->used = 0;
+}
+
+// Allocator interface, every allocation is prefixed with its size so realloc can copy it
+void* __oslo_arena_allocator_alloc(size_t size, void* user_data)
+{
+    uint8_t* p = (uint8_t*)oslo_arena_alloc_aligned((oslo_arena_t*)user_data, size + __OSLO_ARENA_HEADER_SIZE, OSLO_ARENA_DEFAULT_ALIGN);
+    *(size_t*)p = size;
+    return p + __OSLO_ARENA_HEADER_SIZE;
+}
+
+void* __oslo_arena_allocator_realloc(void* ptr, size_t size, void* user_data)
+{
+    oslo_arena_t* arena = (oslo_arena_t*)user_data;
+    if (!ptr)
+    {
+        return __oslo_arena_allocator_alloc(size, user_data);
+    }
+
+    size_t* header = (size_t*)((uint8_t*)ptr - __OSLO_ARENA_HEADER_SIZE);
+    size_t old_size = *header;
+    oslo_arena_block_t* block = arena->blocks;
+
+    // The most recent allocation grows in place while the block has room
+    if ((uint8_t*)ptr + old_size == (uint8_t*)(block + 1) + block->offset && (uint8_t*)ptr + size <= (uint8_t*)(block + 1) + block->capacity)
+    {
+        if (size > old_size)
+        {
+            arena->used += size - old_size;
+            arena->peak = oslo_max(arena->peak, arena->used);
+        }
+        else
+        {
+            arena->used -= old_size - size;
+        }
+        block->offset = (size_t)((uint8_t*)ptr + size - (uint8_t*)(block + 1));
+        *header = size;
+        return ptr;
+    }
+
+    void* p = __oslo_arena_allocator_alloc(size, user_data);
+    memcpy(p, ptr, oslo_min(old_size, size));
+    return p;
+}
+
+void __oslo_arena_allocator_free(void* ptr, void* user_data)
+{
+    oslo_arena_t* arena = (oslo_arena_t*)user_data;
+    oslo_arena_block_t* block = arena->blocks;
+    size_t size = *(size_t*)((uint8_t*)ptr - __OSLO_ARENA_HEADER_SIZE);
+
+    // Only the top of the arena can be given back
+    if ((uint8_t*)ptr + size == (uint8_t*)(block + 1) + block->offset)
+    {
+        size_t start = (size_t)((uint8_t*)ptr - __OSLO_ARENA_HEADER_SIZE - (uint8_t*)(block + 1));
+        arena->used -= block->offset - start;
+        block->offset = start;
+    }
+}
+
+void oslo_arena_init(oslo_arena_t* arena, size_t block_size, const oslo_allocator_t* backing)
+{
+    memset(arena, 0, sizeof(oslo_arena_t));
+    arena->block_size = block_size;
+    arena->max_block_size = block_size * 16;
+    arena->backing = backing;
+    arena->allocator.alloc = __oslo_arena_allocator_alloc;
+    arena->allocator.realloc = __oslo_arena_allocator_realloc;
+    arena->allocator.free = __oslo_arena_allocator_free;
+    arena->allocator.user_data = arena;
+    __oslo_arena_new_block(arena, block_size);
+}
+
+void oslo_arena_free(oslo_arena_t* arena)
+{
+    while (arena->blocks)
+    {
+        oslo_arena_block_t* next = arena->blocks->next;
+        oslo_allocator_free(arena->backing, arena->blocks);
+        arena->blocks = next;
+    }
+    arena->used = 0;
+}
+
+oslo_arena_t* oslo_frame_arena()
+{
+    return &instance->frame_arena;
+}
+
+const oslo_allocator_t* __oslo_scratch_allocator()
+{
+    return (__oslo_is_main_thread && __oslo_job_current_fiber == NULL) ? oslo_frame_allocator() : NULL;
+}
+
+#pragma endregion
+
+#pragma region POOL
+/*========================
+// Object Pool
+========================*/
+
+#define __oslo_pool_align_up(__V, __A) (((__V) + ((__A) - 1)) & ~((size_t)(__A) - 1))
+
+void oslo_pool_init_func(oslo_pool_t* pool, size_t elem_size, size_t align, uint32_t chunk_capacity, const oslo_allocator_t* allocator)
+{
+    align = oslo_max(align, sizeof(uintptr_t));
+    memset(pool, 0, sizeof(oslo_pool_t));
+    pool->elem_size = elem_size;
+    pool->header_size = align;
+    // The free list link lives in the object itself
+    pool->stride = __oslo_pool_align_up(align + oslo_max(elem_size, sizeof(void*)), align);
+    pool->data_offset = __oslo_pool_align_up(sizeof(oslo_pool_chunk_t), align);
+    pool->chunk_capacity = chunk_capacity ? chunk_capacity : 64;
+    pool->allocator = allocator;
+}
+
+void* oslo_pool_alloc_func(oslo_pool_t* pool)
+{
+    uint8_t* slot = NULL;
+    oslo_pool_chunk_t* chunk = NULL;
+
+    if (pool->free_list)
+    {
+        uint8_t* obj = (uint8_t*)pool->free_list;
+        pool->free_list = *(void**)obj;
+        slot = obj - pool->header_size;
+        chunk = (oslo_pool_chunk_t*)(*(uintptr_t*)slot);
+    }
+    else
+    {
+        chunk = pool->last;
+        // Chunks after last are only there after a clear, and are empty
+        while (chunk && chunk->used == chunk->capacity && chunk->next)
+        {
+            chunk = pool->last = chunk->next;
+        }
+
+        if (!chunk || chunk->used == chunk->capacity)
+        {
+            oslo_memory_category category = oslo_memory_push_category(OSLO_MEMORY_CONTAINERS);
+            chunk = (oslo_pool_chunk_t*)oslo_allocator_alloc(pool->allocator, pool->data_offset + pool->chunk_capacity * pool->stride);
+            oslo_memory_pop_category(category);
+            chunk->next = NULL;
+            chunk->capacity = pool->chunk_capacity;
+            chunk->used = 0;
+            chunk->count = 0;
+            if (pool->last)
+            {
+                pool->last->next = chunk;
+            }
+            else
+            {
+                pool->chunks = chunk;
+            }
+            pool->last = chunk;
+        }
+        slot = __oslo_pool_slot(pool, chunk, chunk->used++);
+    }
+
+    *(uintptr_t*)slot = (uintptr_t)chunk | 1;
+    chunk->count++;
+    pool->size++;
+
+    void* obj = slot + pool->header_size;
+    memset(obj, 0, pool->elem_size);
+    return obj;
+}
+
+void oslo_pool_delete_func(oslo_pool_t* pool, void* ptr)
+{
+    if (!ptr)
+    {
+        return;
+    }
+
+    uintptr_t* header = (uintptr_t*)((uint8_t*)ptr - pool->header_size);
+    if (!(*header & 1))
+    {
+        return;
+    }
+
+    *header &= ~(uintptr_t)1;
+    ((oslo_pool_chunk_t*)(*header))->count--;
+    pool->size--;
+
+    *(void**)ptr = pool->free_list;
+    pool->free_list = ptr;
+}
+
+void oslo_pool_clear(oslo_pool_t* pool)
+{
+    // Keep the chunks, they are handed out again from the start
+    for (oslo_pool_chunk_t* chunk = pool->chunks; chunk != NULL; chunk = chunk->next)
+    {
+        chunk->used = 0;
+        chunk->count = 0;
+    }
+    pool->last = pool->chunks;
+    pool->free_list = NULL;
+    pool->size = 0;
+}
+
+void oslo_pool_free(oslo_pool_t* pool)
+{
+    while (pool->chunks)
+    {
+        oslo_pool_chunk_t* next = pool->chunks->next;
+        oslo_allocator_free(pool->allocator, pool->chunks);
+        pool->chunks = next;
+    }
+    pool->last = NULL;
+    pool->free_list = NULL;
+    pool->size = 0;
+}
+
+#pragma endregion
+
+#pragma region VEC2_SOA
+/*========================
+// Vec2 SoA Storage
+========================*/
+
+void oslo_vec2_soa_alloc(vec2_soa* soa, size_t count, const oslo_allocator_t* allocator)
+{
+    size_t padded = (count + 7) & ~(size_t)7;
+    uint8_t* block = (uint8_t*)oslo_allocator_alloc(allocator, 2 * padded * sizeof(f32) + 32);
+    f32* x = (f32*)(((uintptr_t)block + 31) & ~(uintptr_t)31);
+
+    soa->x = x;
+    soa->y = x + padded;
+    soa->count = count;
+    soa->block = block;
+    memset(x, 0, 2 * padded * sizeof(f32));
+}
+
+void oslo_vec2_soa_free(vec2_soa* soa, const oslo_allocator_t* allocator)
+{
+    oslo_allocator_free(allocator, soa->block);
+    memset(soa, 0, sizeof(vec2_soa));
+}
+
+#pragma endregion
+
 #pragma region SLOT_ARRAY
 /*========================
 // Slot Array
 ========================*/
 
-void** oslo_slot_array_init(void** sa, size_t sz)
+void** oslo_slot_array_init_allocator_impl(void** sa, size_t sz, const oslo_allocator_t* allocator)
 {
     if (*sa == NULL) {
-        *sa = malloc(sz);
+        oslo_memory_category category = oslo_memory_push_category(OSLO_MEMORY_CONTAINERS);
+        *sa = oslo_allocator_alloc(allocator, sz);
+        oslo_memory_pop_category(category);
         memset(*sa, 0, sz);
+        __oslo_slot_array_header(*sa)->free_head = oslo_slot_array_INVALID_HANDLE;
+        __oslo_slot_array_header(*sa)->allocator = allocator;
         return sa;
     }
     else {
@@ -3387,12 +6265,164 @@ void** oslo_slot_array_init(void** sa, size_t sz)
     }
 }
 
+void** oslo_slot_array_init(void** sa, size_t sz)
+{
+    return oslo_slot_array_init_allocator_impl(sa, sz, NULL);
+}
+
+void oslo_slot_array_clear_func(__oslo_slot_array_dummy_header* sa)
+{
+    for (uint32_t i = 0; i < (uint32_t)oslo_dyn_array_size(sa->handles); ++i)
+    {
+        uint32_t idx = oslo_slot_array_handle_index(sa->handles[i]);
+        sa->generations[idx] = oslo_slot_array_next_generation(sa->generations[idx], idx);
+        sa->indices[idx] = sa->free_head;
+        sa->free_head = idx;
+    }
+
+    oslo_dyn_array_clear(sa->data);
+    oslo_dyn_array_clear(sa->handles);
+}
+
 #pragma endregion
 
 #pragma region HASH_TABLE
-void __oslo_hash_table_init_impl(void** ht, size_t sz)
+void __oslo_hash_table_init_impl(void** ht, size_t sz, const oslo_allocator_t* allocator)
+{
+    oslo_memory_category category = oslo_memory_push_category(OSLO_MEMORY_CONTAINERS);
+    *ht = oslo_allocator_alloc(allocator, sz);
+    oslo_memory_pop_category(category);
+    memset(*ht, 0, sz);
+    ((__oslo_hash_table_header_t*)*ht)->allocator = allocator;
+}
+
+// Max load is 7/8 of the capacity
+uint32_t __oslo_hash_table_max_load(uint32_t capacity)
+{
+    return capacity - capacity / 8;
+}
+
+uint32_t __oslo_hash_table_find_available(const __oslo_hash_table_header_t* ht, uint32_t hash)
+{
+    uint32_t group_mask = ht->capacity / OSLO_HASH_TABLE_GROUP_WIDTH - 1;
+    uint32_t group = (hash >> 7) & group_mask;
+
+    // Load factor keeps at least one EMPTY byte around, so this always finds a slot
+    for (uint32_t probe = 1; ; ++probe)
+    {
+        __oslo_hash_table_mask m = __oslo_hash_table_group_match_available(ht->ctrl + group * OSLO_HASH_TABLE_GROUP_WIDTH);
+        if (m)
+        {
+            return group * OSLO_HASH_TABLE_GROUP_WIDTH + __oslo_hash_table_mask_next(m);
+        }
+        group = (group + probe) & group_mask;
+    }
+}
+
+// Moves every live entry into fresh storage of the given power of two capacity, dropping tombstones
+void __oslo_hash_table_resize(__oslo_hash_table_header_t* ht, uint32_t capacity)
+{
+    uint8_t* old_data = (uint8_t*)ht->data;
+    uint8_t* old_ctrl = ht->ctrl;
+    uint32_t old_capacity = ht->capacity;
+
+    oslo_memory_category category = oslo_memory_push_category(OSLO_MEMORY_CONTAINERS);
+    ht->data = oslo_allocator_alloc(ht->allocator, capacity * ht->stride);
+    ht->ctrl = (uint8_t*)oslo_allocator_alloc(ht->allocator, capacity);
+    oslo_memory_pop_category(category);
+    memset(ht->ctrl, OSLO_HASH_TABLE_CTRL_EMPTY, capacity);
+    ht->capacity = capacity;
+
+    for (uint32_t i = 0; i < old_capacity; ++i)
+    {
+        if (old_ctrl[i] & 0x80)
+            continue;
+
+        uint8_t* entry = old_data + i * ht->stride;
+        uint32_t idx = __oslo_hash_table_find_available(ht, *(uint32_t*)(entry + ht->klpvl));
+        ht->ctrl[idx] = old_ctrl[i];
+        memcpy((uint8_t*)ht->data + idx * ht->stride, entry, ht->stride);
+    }
+
+    ht->growth_left = __oslo_hash_table_max_load(capacity) - ht->size;
+
+    oslo_allocator_free(ht->allocator, old_data);
+    oslo_allocator_free(ht->allocator, old_ctrl);
+}
+
+void __oslo_hash_table_reserve_func(__oslo_hash_table_header_t* ht, uint32_t count)
+{
+    uint32_t capacity = OSLO_HASH_TABLE_GROUP_WIDTH;
+    while (__oslo_hash_table_max_load(capacity) < count)
+    {
+        capacity *= 2;
+    }
+
+    if (capacity > ht->capacity)
+    {
+        __oslo_hash_table_resize(ht, capacity);
+    }
+}
+
+void __oslo_hash_table_clear_func(__oslo_hash_table_header_t* ht)
+{
+    memset(ht->ctrl, OSLO_HASH_TABLE_CTRL_EMPTY, ht->capacity);
+    ht->size = 0;
+    ht->growth_left = __oslo_hash_table_max_load(ht->capacity);
+}
+
+uint32_t __oslo_hash_table_insert_func(__oslo_hash_table_header_t* ht, const void* key, size_t key_len)
+{
+    uint32_t hash = __oslo_hash_table_hash(key, key_len);
+    uint32_t idx = ht->size ? __oslo_hash_table_find(ht, key, key_len, hash) : OSLO_HASH_TABLE_INVALID_INDEX;
+    if (idx != OSLO_HASH_TABLE_INVALID_INDEX)
+    {
+        return idx;
+    }
+
+    idx = __oslo_hash_table_find_available(ht, hash);
+    if (!ht->growth_left && ht->ctrl[idx] == OSLO_HASH_TABLE_CTRL_EMPTY)
+    {
+        // Out of room. Grow, unless tombstones make up most of the load and a same size rehash frees enough.
+        bool grow = ht->size >= __oslo_hash_table_max_load(ht->capacity) / 2;
+        __oslo_hash_table_resize(ht, grow ? ht->capacity * 2 : ht->capacity);
+        idx = __oslo_hash_table_find_available(ht, hash);
+    }
+
+    if (ht->ctrl[idx] == OSLO_HASH_TABLE_CTRL_EMPTY)
+    {
+        ht->growth_left--;
+    }
+    ht->ctrl[idx] = (uint8_t)(hash & 0x7F);
+    ht->size++;
+
+    uint8_t* entry = (uint8_t*)ht->data + idx * ht->stride;
+    memcpy(entry, key, key_len);
+    *(uint32_t*)(entry + ht->klpvl) = hash;
+
+    return idx;
+}
+
+void __oslo_hash_table_erase_func(__oslo_hash_table_header_t* ht, const void* key, size_t key_len)
 {
-    *ht = malloc(sz);
+    uint32_t idx = oslo_hash_table_get_key_index_func(ht, key, key_len);
+    if (idx == OSLO_HASH_TABLE_INVALID_INDEX)
+    {
+        return;
+    }
+
+    // Probes only continue past groups without an EMPTY byte, anywhere else the slot can go back to EMPTY
+    const uint8_t* group = ht->ctrl + (idx & ~(uint32_t)(OSLO_HASH_TABLE_GROUP_WIDTH - 1));
+    if (__oslo_hash_table_group_match_empty(group))
+    {
+        ht->ctrl[idx] = OSLO_HASH_TABLE_CTRL_EMPTY;
+        ht->growth_left++;
+    }
+    else
+    {
+        ht->ctrl[idx] = OSLO_HASH_TABLE_CTRL_DELETED;
+    }
+    ht->size--;
 }
 #pragma endregion
 #endif
\ No newline at end of file
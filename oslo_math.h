@@ -29,6 +29,194 @@
 #define YAXIS    v3(0.f, 1.f, 0.f)
 #define ZAXIS    v3(0.f, 0.f, 1.f)
 
+/*================================================================================
+// SIMD
+================================================================================*/
+
+/*
+    vec4, mat4 and quat kernels use SSE2 (AVX for mat4_mul when enabled) or NEON when the target
+    has them, define OSLO_MATH_NO_SIMD to force the scalar code. Types keep their layout, so loads
+    are unaligned. Sums are reordered, results match the scalar path within float rounding.
+*/
+
+#if !defined(OSLO_MATH_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+    #define OSLO_MATH_SSE2
+    #include <emmintrin.h>
+    #if defined(__AVX__)
+        #define OSLO_MATH_AVX
+        #include <immintrin.h>
+    #endif
+#elif !defined(OSLO_MATH_NO_SIMD) && (defined(__ARM_NEON) || defined(__ARM_NEON__))
+    #define OSLO_MATH_NEON
+    #include <arm_neon.h>
+#endif
+
+#ifdef OSLO_MATH_SSE2
+    // Adds the four lanes, the total ends up in every lane
+    oslo_inline __m128 __oslo_simd_hsum(__m128 v)
+    {
+        __m128 s = _mm_add_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1)));
+        return _mm_add_ps(s, _mm_shuffle_ps(s, s, _MM_SHUFFLE(1, 0, 3, 2)));
+    }
+#endif
+
+#ifdef OSLO_MATH_NEON
+    oslo_inline float __oslo_simd_hsum(float32x4_t v)
+    {
+        float32x2_t s = vadd_f32(vget_low_f32(v), vget_high_f32(v));
+        return vget_lane_f32(vpadd_f32(s, s), 0);
+    }
+#endif
+
+/*
+    Integer and float lanes stepped together by the rng and noise kernels. Unlike the vec2 SoA
+    lanes these need 32 bit integer ops, so AVX without AVX2 stays on 4 SSE2 lanes.
+*/
+
+#if defined(OSLO_MATH_AVX) && defined(__AVX2__)
+    #define OSLO_MATH_WIDE_WIDTH                8
+    typedef __m256i __oslo_wide_u32;
+    typedef __m256 __oslo_wide_f32;
+    #define __oslo_wide_load(__P)               _mm256_loadu_si256((const __m256i*)(__P))
+    #define __oslo_wide_store(__P, __A)         _mm256_storeu_si256((__m256i*)(__P), (__A))
+    #define __oslo_wide_seti(__S)               _mm256_set1_epi32((int)(__S))
+    #define __oslo_wide_add(__A, __B)           _mm256_add_epi32((__A), (__B))
+    #define __oslo_wide_mul(__A, __B)           _mm256_mullo_epi32((__A), (__B))
+    #define __oslo_wide_and(__A, __B)           _mm256_and_si256((__A), (__B))
+    #define __oslo_wide_or(__A, __B)            _mm256_or_si256((__A), (__B))
+    #define __oslo_wide_xor(__A, __B)           _mm256_xor_si256((__A), (__B))
+    #define __oslo_wide_shl(__A, __N)           _mm256_slli_epi32((__A), (__N))
+    #define __oslo_wide_shr(__A, __N)           _mm256_srli_epi32((__A), (__N))
+    #define __oslo_wide_cmpeq(__A, __B)         _mm256_cmpeq_epi32((__A), (__B))
+    #define __oslo_wide_loadf(__P)              _mm256_loadu_ps(__P)
+    #define __oslo_wide_storef(__P, __A)        _mm256_storeu_ps((__P), (__A))
+    #define __oslo_wide_setf(__S)               _mm256_set1_ps(__S)
+    #define __oslo_wide_addf(__A, __B)          _mm256_add_ps((__A), (__B))
+    #define __oslo_wide_subf(__A, __B)          _mm256_sub_ps((__A), (__B))
+    #define __oslo_wide_mulf(__A, __B)          _mm256_mul_ps((__A), (__B))
+    #define __oslo_wide_maxf(__A, __B)          _mm256_max_ps((__A), (__B))
+    #define __oslo_wide_cmpgef(__A, __B)        _mm256_castps_si256(_mm256_cmp_ps((__A), (__B), _CMP_GE_OQ))
+    #define __oslo_wide_floori(__A)             _mm256_cvttps_epi32(_mm256_floor_ps(__A))
+    #define __oslo_wide_cvtf(__A)               _mm256_cvtepi32_ps(__A)
+    #define __oslo_wide_castf(__A)              _mm256_castsi256_ps(__A)
+    #define __oslo_wide_casti(__A)              _mm256_castps_si256(__A)
+    // Lanes of __M are all ones or all zeros
+    #define __oslo_wide_select(__M, __A, __B)   _mm256_blendv_ps((__B), (__A), _mm256_castsi256_ps(__M))
+    #define __oslo_wide_first(__A)              _mm256_cvtss_f32(__A)
+#elif defined(OSLO_MATH_SSE2)
+    #define OSLO_MATH_WIDE_WIDTH                4
+    typedef __m128i __oslo_wide_u32;
+    typedef __m128 __oslo_wide_f32;
+
+    #if defined(__SSE4_1__)
+        #include <smmintrin.h>
+        #define __oslo_wide_mul(__A, __B)       _mm_mullo_epi32((__A), (__B))
+    #else
+        // Low 32 bits of the even and odd lane products, interleaved back
+        oslo_inline __m128i __oslo_sse2_mullo_epi32(__m128i a, __m128i b)
+        {
+            __m128i even = _mm_mul_epu32(a, b);
+            __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+            return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+        }
+        #define __oslo_wide_mul(__A, __B)       __oslo_sse2_mullo_epi32((__A), (__B))
+    #endif
+
+    // Truncates, then steps down where that rounded up (negative non-integers)
+    oslo_inline __m128i __oslo_sse2_floori(__m128 a)
+    {
+        __m128i i = _mm_cvttps_epi32(a);
+        return _mm_add_epi32(i, _mm_castps_si128(_mm_cmpgt_ps(_mm_cvtepi32_ps(i), a)));
+    }
+
+    #define __oslo_wide_load(__P)               _mm_loadu_si128((const __m128i*)(__P))
+    #define __oslo_wide_store(__P, __A)         _mm_storeu_si128((__m128i*)(__P), (__A))
+    #define __oslo_wide_seti(__S)               _mm_set1_epi32((int)(__S))
+    #define __oslo_wide_add(__A, __B)           _mm_add_epi32((__A), (__B))
+    #define __oslo_wide_and(__A, __B)           _mm_and_si128((__A), (__B))
+    #define __oslo_wide_or(__A, __B)            _mm_or_si128((__A), (__B))
+    #define __oslo_wide_xor(__A, __B)           _mm_xor_si128((__A), (__B))
+    #define __oslo_wide_shl(__A, __N)           _mm_slli_epi32((__A), (__N))
+    #define __oslo_wide_shr(__A, __N)           _mm_srli_epi32((__A), (__N))
+    #define __oslo_wide_cmpeq(__A, __B)         _mm_cmpeq_epi32((__A), (__B))
+    #define __oslo_wide_loadf(__P)              _mm_loadu_ps(__P)
+    #define __oslo_wide_storef(__P, __A)        _mm_storeu_ps((__P), (__A))
+    #define __oslo_wide_setf(__S)               _mm_set1_ps(__S)
+    #define __oslo_wide_addf(__A, __B)          _mm_add_ps((__A), (__B))
+    #define __oslo_wide_subf(__A, __B)          _mm_sub_ps((__A), (__B))
+    #define __oslo_wide_mulf(__A, __B)          _mm_mul_ps((__A), (__B))
+    #define __oslo_wide_maxf(__A, __B)          _mm_max_ps((__A), (__B))
+    #define __oslo_wide_cmpgef(__A, __B)        _mm_castps_si128(_mm_cmpge_ps((__A), (__B)))
+    #define __oslo_wide_floori(__A)             __oslo_sse2_floori(__A)
+    #define __oslo_wide_cvtf(__A)               _mm_cvtepi32_ps(__A)
+    #define __oslo_wide_castf(__A)              _mm_castsi128_ps(__A)
+    #define __oslo_wide_casti(__A)              _mm_castps_si128(__A)
+    #define __oslo_wide_select(__M, __A, __B)   _mm_or_ps(_mm_and_ps(_mm_castsi128_ps(__M), (__A)), _mm_andnot_ps(_mm_castsi128_ps(__M), (__B)))
+    #define __oslo_wide_first(__A)              _mm_cvtss_f32(__A)
+#elif defined(OSLO_MATH_NEON) && defined(__aarch64__)
+    #define OSLO_MATH_WIDE_WIDTH                4
+    typedef uint32x4_t __oslo_wide_u32;
+    typedef float32x4_t __oslo_wide_f32;
+    #define __oslo_wide_load(__P)               vld1q_u32(__P)
+    #define __oslo_wide_store(__P, __A)         vst1q_u32((__P), (__A))
+    #define __oslo_wide_seti(__S)               vdupq_n_u32((u32)(__S))
+    #define __oslo_wide_add(__A, __B)           vaddq_u32((__A), (__B))
+    #define __oslo_wide_mul(__A, __B)           vmulq_u32((__A), (__B))
+    #define __oslo_wide_and(__A, __B)           vandq_u32((__A), (__B))
+    #define __oslo_wide_or(__A, __B)            vorrq_u32((__A), (__B))
+    #define __oslo_wide_xor(__A, __B)           veorq_u32((__A), (__B))
+    #define __oslo_wide_shl(__A, __N)           vshlq_n_u32((__A), (__N))
+    #define __oslo_wide_shr(__A, __N)           vshrq_n_u32((__A), (__N))
+    #define __oslo_wide_cmpeq(__A, __B)         vceqq_u32((__A), (__B))
+    #define __oslo_wide_loadf(__P)              vld1q_f32(__P)
+    #define __oslo_wide_storef(__P, __A)        vst1q_f32((__P), (__A))
+    #define __oslo_wide_setf(__S)               vdupq_n_f32(__S)
+    #define __oslo_wide_addf(__A, __B)          vaddq_f32((__A), (__B))
+    #define __oslo_wide_subf(__A, __B)          vsubq_f32((__A), (__B))
+    #define __oslo_wide_mulf(__A, __B)          vmulq_f32((__A), (__B))
+    #define __oslo_wide_maxf(__A, __B)          vmaxq_f32((__A), (__B))
+    #define __oslo_wide_cmpgef(__A, __B)        vcgeq_f32((__A), (__B))
+    #define __oslo_wide_floori(__A)             vreinterpretq_u32_s32(vcvtmq_s32_f32(__A))
+    #define __oslo_wide_cvtf(__A)               vcvtq_f32_s32(vreinterpretq_s32_u32(__A))
+    #define __oslo_wide_castf(__A)              vreinterpretq_f32_u32(__A)
+    #define __oslo_wide_casti(__A)              vreinterpretq_u32_f32(__A)
+    #define __oslo_wide_select(__M, __A, __B)   vbslq_f32((__M), (__A), (__B))
+    #define __oslo_wide_first(__A)              vgetq_lane_f32((__A), 0)
+#else
+    #define OSLO_MATH_WIDE_WIDTH                1
+    typedef u32 __oslo_wide_u32;
+    typedef f32 __oslo_wide_f32;
+
+    oslo_inline f32 __oslo_scalar_castf(u32 a) { union { u32 i; f32 f; } u; u.i = a; return u.f; }
+    oslo_inline u32 __oslo_scalar_casti(f32 a) { union { u32 i; f32 f; } u; u.f = a; return u.i; }
+
+    #define __oslo_wide_load(__P)               (*(__P))
+    #define __oslo_wide_store(__P, __A)         (*(__P) = (__A))
+    #define __oslo_wide_seti(__S)               ((u32)(__S))
+    #define __oslo_wide_add(__A, __B)           ((__A) + (__B))
+    #define __oslo_wide_mul(__A, __B)           ((__A) * (__B))
+    #define __oslo_wide_and(__A, __B)           ((__A) & (__B))
+    #define __oslo_wide_or(__A, __B)            ((__A) | (__B))
+    #define __oslo_wide_xor(__A, __B)           ((__A) ^ (__B))
+    #define __oslo_wide_shl(__A, __N)           ((__A) << (__N))
+    #define __oslo_wide_shr(__A, __N)           ((__A) >> (__N))
+    #define __oslo_wide_cmpeq(__A, __B)         ((__A) == (__B) ? 0xFFFFFFFFu : 0u)
+    #define __oslo_wide_loadf(__P)              (*(__P))
+    #define __oslo_wide_storef(__P, __A)        (*(__P) = (__A))
+    #define __oslo_wide_setf(__S)               ((f32)(__S))
+    #define __oslo_wide_addf(__A, __B)          ((__A) + (__B))
+    #define __oslo_wide_subf(__A, __B)          ((__A) - (__B))
+    #define __oslo_wide_mulf(__A, __B)          ((__A) * (__B))
+    #define __oslo_wide_maxf(__A, __B)          ((__A) > (__B) ? (__A) : (__B))
+    #define __oslo_wide_cmpgef(__A, __B)        ((__A) >= (__B) ? 0xFFFFFFFFu : 0u)
+    #define __oslo_wide_floori(__A)             ((u32)(s32)floorf(__A))
+    #define __oslo_wide_cvtf(__A)               ((f32)(s32)(__A))
+    #define __oslo_wide_castf(__A)              __oslo_scalar_castf(__A)
+    #define __oslo_wide_casti(__A)              __oslo_scalar_casti(__A)
+    #define __oslo_wide_select(__M, __A, __B)   ((__M) ? (__A) : (__B))
+    #define __oslo_wide_first(__A)              (__A)
+#endif
+
 /*================================================================================
 // Useful Common Math Functions
 ================================================================================*/
@@ -151,84 +339,1326 @@ vec2_sub(vec2 v0, vec2 v1)
     return vec2_ctor(v0.x - v1.x, v0.y - v1.y);
 }
 
-oslo_inline vec2 
-vec2_mul(vec2 v0, vec2 v1) 
+oslo_inline vec2 
+vec2_mul(vec2 v0, vec2 v1) 
+{
+    return vec2_ctor(v0.x * v1.x, v0.y * v1.y);
+}
+
+oslo_inline vec2 
+vec2_div(vec2 v0, vec2 v1) 
+{
+    return vec2_ctor(v0.x / v1.x, v0.y / v1.y);
+}
+
+oslo_inline bool
+vec2_equals(vec2 v0, vec2 v1)
+{
+    return (v0.x == v1.x && v0.y == v1.y);
+}
+
+oslo_inline vec2 
+vec2_scale(vec2 v, f32 s)
+{
+    return vec2_ctor(v.x * s, v.y * s);
+}
+
+oslo_inline f32 
+vec2_dot(vec2 v0, vec2 v1) 
+{
+    return (f32)(v0.x * v1.x + v0.y * v1.y);
+}
+
+oslo_inline f32 
+vec2_len(vec2 v)
+{
+    return (f32)sqrt(vec2_dot(v, v));
+}
+
+oslo_inline vec2
+vec2_project_onto(vec2 v0, vec2 v1)
+{
+    f32 dot = vec2_dot(v0, v1);
+    f32 len = vec2_dot(v1, v1);
+
+    // Orthogonal, so return v1
+    if (len == 0.f) return v1;
+
+    return vec2_scale(v1, dot / len);
+}
+
+oslo_inline vec2 vec2_norm(vec2 v) 
+{
+    f32 len = vec2_len(v);
+    return vec2_scale(v, len != 0.f ? 1.0f / vec2_len(v) : 1.f);
+}
+
+oslo_inline 
+f32 vec2_dist(vec2 a, vec2 b)
+{
+    f32 dx = (a.x - b.x);
+    f32 dy = (a.y - b.y);
+    return (float)(sqrt(dx * dx + dy * dy));
+}
+
+oslo_inline
+f32 vec2_cross(vec2 a, vec2 b) 
+{
+    return a.x * b.y - a.y * b.x;
+}
+
+oslo_inline
+f32 vec2_angle(vec2 a, vec2 b) 
+{
+    return (float)acos(vec2_dot(a, b) / (vec2_len(a) * vec2_len(b)));
+}
+
+oslo_inline
+b32 vec2_equal(vec2 a, vec2 b)
+{
+    return (a.x == b.x && a.y == b.y);
+}
+
+/*================================================================================
+// Vec2 SoA
+================================================================================*/
+
+/*
+    Bulk vec2 data split in an x array and a y array, so kernels process one SIMD register of x
+    and one of y per step. Arrays can have any alignment, loads are unaligned and the elements
+    left after the last full register go through the scalar path.
+*/
+
+typedef struct
+{
+    f32* x;
+    f32* y;
+    size_t count;
+    // Allocation holding x and y when created by oslo_vec2_soa_alloc
+    void* block;
+} vec2_soa_t;
+
+typedef vec2_soa_t vec2_soa;
+
+#if defined(OSLO_MATH_AVX)
+    #define OSLO_MATH_SOA_WIDTH     8
+    typedef __m256 __oslo_soa_f32;
+    #define __oslo_soa_load(__P)            _mm256_loadu_ps(__P)
+    #define __oslo_soa_store(__P, __V)      _mm256_storeu_ps((__P), (__V))
+    #define __oslo_soa_set1(__S)            _mm256_set1_ps(__S)
+    #define __oslo_soa_add(__A, __B)        _mm256_add_ps((__A), (__B))
+    #define __oslo_soa_sub(__A, __B)        _mm256_sub_ps((__A), (__B))
+    #define __oslo_soa_mul(__A, __B)        _mm256_mul_ps((__A), (__B))
+    #define __oslo_soa_div(__A, __B)        _mm256_div_ps((__A), (__B))
+    #define __oslo_soa_min(__A, __B)        _mm256_min_ps((__A), (__B))
+    #define __oslo_soa_max(__A, __B)        _mm256_max_ps((__A), (__B))
+    #define __oslo_soa_sqrt(__A)            _mm256_sqrt_ps(__A)
+    // Keeps __V where __A > __B, zero elsewhere
+    #define __oslo_soa_select_gt(__A, __B, __V) _mm256_and_ps(_mm256_cmp_ps((__A), (__B), _CMP_GT_OQ), (__V))
+#elif defined(OSLO_MATH_SSE2)
+    #define OSLO_MATH_SOA_WIDTH     4
+    typedef __m128 __oslo_soa_f32;
+    #define __oslo_soa_load(__P)            _mm_loadu_ps(__P)
+    #define __oslo_soa_store(__P, __V)      _mm_storeu_ps((__P), (__V))
+    #define __oslo_soa_set1(__S)            _mm_set1_ps(__S)
+    #define __oslo_soa_add(__A, __B)        _mm_add_ps((__A), (__B))
+    #define __oslo_soa_sub(__A, __B)        _mm_sub_ps((__A), (__B))
+    #define __oslo_soa_mul(__A, __B)        _mm_mul_ps((__A), (__B))
+    #define __oslo_soa_div(__A, __B)        _mm_div_ps((__A), (__B))
+    #define __oslo_soa_min(__A, __B)        _mm_min_ps((__A), (__B))
+    #define __oslo_soa_max(__A, __B)        _mm_max_ps((__A), (__B))
+    #define __oslo_soa_sqrt(__A)            _mm_sqrt_ps(__A)
+    #define __oslo_soa_select_gt(__A, __B, __V) _mm_and_ps(_mm_cmpgt_ps((__A), (__B)), (__V))
+#elif defined(OSLO_MATH_NEON) && defined(__aarch64__)
+    // ARMv7 NEON has no vector sqrt or division, it uses the scalar path
+    #define OSLO_MATH_SOA_WIDTH     4
+    typedef float32x4_t __oslo_soa_f32;
+    #define __oslo_soa_load(__P)            vld1q_f32(__P)
+    #define __oslo_soa_store(__P, __V)      vst1q_f32((__P), (__V))
+    #define __oslo_soa_set1(__S)            vdupq_n_f32(__S)
+    #define __oslo_soa_add(__A, __B)        vaddq_f32((__A), (__B))
+    #define __oslo_soa_sub(__A, __B)        vsubq_f32((__A), (__B))
+    #define __oslo_soa_mul(__A, __B)        vmulq_f32((__A), (__B))
+    #define __oslo_soa_div(__A, __B)        vdivq_f32((__A), (__B))
+    #define __oslo_soa_min(__A, __B)        vminnmq_f32((__A), (__B))
+    #define __oslo_soa_max(__A, __B)        vmaxnmq_f32((__A), (__B))
+    #define __oslo_soa_sqrt(__A)            vsqrtq_f32(__A)
+    #define __oslo_soa_select_gt(__A, __B, __V) vreinterpretq_f32_u32(vandq_u32(vcgtq_f32((__A), (__B)), vreinterpretq_u32_f32(__V)))
+#else
+    #define OSLO_MATH_SOA_WIDTH     1
+#endif
+
+// v += a * x, e.g. positions += dt * velocities
+oslo_inline void
+vec2_soa_axpy(vec2_soa* v, f32 a, const vec2_soa* x)
+{
+    size_t i = 0, n = v->count < x->count ? v->count : x->count;
+#if OSLO_MATH_SOA_WIDTH > 1
+    __oslo_soa_f32 va = __oslo_soa_set1(a);
+    for (; i + OSLO_MATH_SOA_WIDTH <= n; i += OSLO_MATH_SOA_WIDTH)
+    {
+        __oslo_soa_store(v->x + i, __oslo_soa_add(__oslo_soa_load(v->x + i), __oslo_soa_mul(va, __oslo_soa_load(x->x + i))));
+        __oslo_soa_store(v->y + i, __oslo_soa_add(__oslo_soa_load(v->y + i), __oslo_soa_mul(va, __oslo_soa_load(x->y + i))));
+    }
+#endif
+    for (; i < n; ++i)
+    {
+        v->x[i] += a * x->x[i];
+        v->y[i] += a * x->y[i];
+    }
+}
+
+oslo_inline void
+vec2_soa_scale(vec2_soa* v, f32 s)
+{
+    size_t i = 0, n = v->count;
+#if OSLO_MATH_SOA_WIDTH > 1
+    __oslo_soa_f32 vs = __oslo_soa_set1(s);
+    for (; i + OSLO_MATH_SOA_WIDTH <= n; i += OSLO_MATH_SOA_WIDTH)
+    {
+        __oslo_soa_store(v->x + i, __oslo_soa_mul(__oslo_soa_load(v->x + i), vs));
+        __oslo_soa_store(v->y + i, __oslo_soa_mul(__oslo_soa_load(v->y + i), vs));
+    }
+#endif
+    for (; i < n; ++i)
+    {
+        v->x[i] *= s;
+        v->y[i] *= s;
+    }
+}
+
+// Component-wise clamp to [min, max]
+oslo_inline void
+vec2_soa_clamp(vec2_soa* v, vec2 min, vec2 max)
+{
+    size_t i = 0, n = v->count;
+#if OSLO_MATH_SOA_WIDTH > 1
+    __oslo_soa_f32 minx = __oslo_soa_set1(min.x), miny = __oslo_soa_set1(min.y);
+    __oslo_soa_f32 maxx = __oslo_soa_set1(max.x), maxy = __oslo_soa_set1(max.y);
+    for (; i + OSLO_MATH_SOA_WIDTH <= n; i += OSLO_MATH_SOA_WIDTH)
+    {
+        __oslo_soa_store(v->x + i, __oslo_soa_min(__oslo_soa_max(__oslo_soa_load(v->x + i), minx), maxx));
+        __oslo_soa_store(v->y + i, __oslo_soa_min(__oslo_soa_max(__oslo_soa_load(v->y + i), miny), maxy));
+    }
+#endif
+    for (; i < n; ++i)
+    {
+        v->x[i] = v->x[i] < min.x ? min.x : v->x[i] > max.x ? max.x : v->x[i];
+        v->y[i] = v->y[i] < min.y ? min.y : v->y[i] > max.y ? max.y : v->y[i];
+    }
+}
+
+// Shortens vectors longer than max_len, e.g. to cap speeds
+oslo_inline void
+vec2_soa_clamp_len(vec2_soa* v, f32 max_len)
+{
+    size_t i = 0, n = v->count;
+#if OSLO_MATH_SOA_WIDTH > 1
+    __oslo_soa_f32 vmax = __oslo_soa_set1(max_len), one = __oslo_soa_set1(1.f);
+    for (; i + OSLO_MATH_SOA_WIDTH <= n; i += OSLO_MATH_SOA_WIDTH)
+    {
+        __oslo_soa_f32 x = __oslo_soa_load(v->x + i), y = __oslo_soa_load(v->y + i);
+        __oslo_soa_f32 len = __oslo_soa_sqrt(__oslo_soa_add(__oslo_soa_mul(x, x), __oslo_soa_mul(y, y)));
+        // Zero length divides to inf (or nan with a zero max_len), which min brings back to 1
+        __oslo_soa_f32 s = __oslo_soa_min(__oslo_soa_div(vmax, len), one);
+        __oslo_soa_store(v->x + i, __oslo_soa_mul(x, s));
+        __oslo_soa_store(v->y + i, __oslo_soa_mul(y, s));
+    }
+#endif
+    for (; i < n; ++i)
+    {
+        f32 len = sqrtf(v->x[i] * v->x[i] + v->y[i] * v->y[i]);
+        if (len > max_len)
+        {
+            v->x[i] *= max_len / len;
+            v->y[i] *= max_len / len;
+        }
+    }
+}
+
+oslo_inline void
+vec2_soa_len(const vec2_soa* v, f32* out)
+{
+    size_t i = 0, n = v->count;
+#if OSLO_MATH_SOA_WIDTH > 1
+    for (; i + OSLO_MATH_SOA_WIDTH <= n; i += OSLO_MATH_SOA_WIDTH)
+    {
+        __oslo_soa_f32 x = __oslo_soa_load(v->x + i), y = __oslo_soa_load(v->y + i);
+        __oslo_soa_store(out + i, __oslo_soa_sqrt(__oslo_soa_add(__oslo_soa_mul(x, x), __oslo_soa_mul(y, y))));
+    }
+#endif
+    for (; i < n; ++i)
+    {
+        out[i] = sqrtf(v->x[i] * v->x[i] + v->y[i] * v->y[i]);
+    }
+}
+
+// Zero vectors stay zero
+oslo_inline void
+vec2_soa_norm(vec2_soa* v)
+{
+    size_t i = 0, n = v->count;
+#if OSLO_MATH_SOA_WIDTH > 1
+    __oslo_soa_f32 zero = __oslo_soa_set1(0.f), one = __oslo_soa_set1(1.f);
+    for (; i + OSLO_MATH_SOA_WIDTH <= n; i += OSLO_MATH_SOA_WIDTH)
+    {
+        __oslo_soa_f32 x = __oslo_soa_load(v->x + i), y = __oslo_soa_load(v->y + i);
+        __oslo_soa_f32 len = __oslo_soa_sqrt(__oslo_soa_add(__oslo_soa_mul(x, x), __oslo_soa_mul(y, y)));
+        __oslo_soa_f32 inv = __oslo_soa_select_gt(len, zero, __oslo_soa_div(one, len));
+        __oslo_soa_store(v->x + i, __oslo_soa_mul(x, inv));
+        __oslo_soa_store(v->y + i, __oslo_soa_mul(y, inv));
+    }
+#endif
+    for (; i < n; ++i)
+    {
+        f32 len = sqrtf(v->x[i] * v->x[i] + v->y[i] * v->y[i]);
+        f32 inv = len > 0.f ? 1.f / len : 0.f;
+        v->x[i] *= inv;
+        v->y[i] *= inv;
+    }
+}
+
+// Distance from every element to p
+oslo_inline void
+vec2_soa_dist(const vec2_soa* v, vec2 p, f32* out)
+{
+    size_t i = 0, n = v->count;
+#if OSLO_MATH_SOA_WIDTH > 1
+    __oslo_soa_f32 px = __oslo_soa_set1(p.x), py = __oslo_soa_set1(p.y);
+    for (; i + OSLO_MATH_SOA_WIDTH <= n; i += OSLO_MATH_SOA_WIDTH)
+    {
+        __oslo_soa_f32 dx = __oslo_soa_sub(__oslo_soa_load(v->x + i), px);
+        __oslo_soa_f32 dy = __oslo_soa_sub(__oslo_soa_load(v->y + i), py);
+        __oslo_soa_store(out + i, __oslo_soa_sqrt(__oslo_soa_add(__oslo_soa_mul(dx, dx), __oslo_soa_mul(dy, dy))));
+    }
+#endif
+    for (; i < n; ++i)
+    {
+        f32 dx = v->x[i] - p.x;
+        f32 dy = v->y[i] - p.y;
+        out[i] = sqrtf(dx * dx + dy * dy);
+    }
+}
+
+/*================================================================================
+// Fixed Point
+================================================================================*/
+
+/*
+    Q16.16 (fx16) and Q32.32 (fx32) numbers for simulations that must give the same bits on every
+    compiler and platform, e.g. lockstep or replays. Everything is integer math, sqrt is an integer
+    square root and sin/cos/atan2 read baked tables, never libm. Float conversions are only exact
+    for values that came from the same float bits, do them once at the edges (setup, rendering).
+    Overflow wraps, range is +-32768 for fx16.
+*/
+
+typedef s32 fx16;
+typedef s64 fx32;
+
+typedef struct
+{
+    fx16 x;
+    fx16 y;
+} fx16_vec2_t;
+
+typedef fx16_vec2_t fx16_vec2;
+
+#define FX16_SHIFT      16
+#define FX16_ONE        ((fx16)1 << FX16_SHIFT)
+#define FX16_HALF       (FX16_ONE >> 1)
+#define FX16_MAX        ((fx16)INT32_MAX)
+#define FX16_MIN        ((fx16)INT32_MIN)
+#define FX16_PI         ((fx16)205887)
+#define FX16_HALF_PI    ((fx16)102944)
+#define FX16_TAU        ((fx16)411775)
+
+#define FX32_SHIFT      32
+#define FX32_ONE        ((fx32)1 << FX32_SHIFT)
+#define FX32_MAX        ((fx32)INT64_MAX)
+#define FX32_MIN        ((fx32)INT64_MIN)
+
+// sin over a quarter turn in 256 steps, entry 256 closes the last interval
+static const s32 __oslo_fx16_sin_table[257] =
+{
+    0, 402, 804, 1206, 1608, 2010, 2412, 2814,
+    3216, 3617, 4019, 4420, 4821, 5222, 5623, 6023,
+    6424, 6824, 7224, 7623, 8022, 8421, 8820, 9218,
+    9616, 10014, 10411, 10808, 11204, 11600, 11996, 12391,
+    12785, 13180, 13573, 13966, 14359, 14751, 15143, 15534,
+    15924, 16314, 16703, 17091, 17479, 17867, 18253, 18639,
+    19024, 19409, 19792, 20175, 20557, 20939, 21320, 21699,
+    22078, 22457, 22834, 23210, 23586, 23961, 24335, 24708,
+    25080, 25451, 25821, 26190, 26558, 26925, 27291, 27656,
+    28020, 28383, 28745, 29106, 29466, 29824, 30182, 30538,
+    30893, 31248, 31600, 31952, 32303, 32652, 33000, 33347,
+    33692, 34037, 34380, 34721, 35062, 35401, 35738, 36075,
+    36410, 36744, 37076, 37407, 37736, 38064, 38391, 38716,
+    39040, 39362, 39683, 40002, 40320, 40636, 40951, 41264,
+    41576, 41886, 42194, 42501, 42806, 43110, 43412, 43713,
+    44011, 44308, 44604, 44898, 45190, 45480, 45769, 46056,
+    46341, 46624, 46906, 47186, 47464, 47741, 48015, 48288,
+    48559, 48828, 49095, 49361, 49624, 49886, 50146, 50404,
+    50660, 50914, 51166, 51417, 51665, 51911, 52156, 52398,
+    52639, 52878, 53114, 53349, 53581, 53812, 54040, 54267,
+    54491, 54714, 54934, 55152, 55368, 55582, 55794, 56004,
+    56212, 56418, 56621, 56823, 57022, 57219, 57414, 57607,
+    57798, 57986, 58172, 58356, 58538, 58718, 58896, 59071,
+    59244, 59415, 59583, 59750, 59914, 60075, 60235, 60392,
+    60547, 60700, 60851, 60999, 61145, 61288, 61429, 61568,
+    61705, 61839, 61971, 62101, 62228, 62353, 62476, 62596,
+    62714, 62830, 62943, 63054, 63162, 63268, 63372, 63473,
+    63572, 63668, 63763, 63854, 63944, 64031, 64115, 64197,
+    64277, 64354, 64429, 64501, 64571, 64639, 64704, 64766,
+    64827, 64884, 64940, 64993, 65043, 65091, 65137, 65180,
+    65220, 65259, 65294, 65328, 65358, 65387, 65413, 65436,
+    65457, 65476, 65492, 65505, 65516, 65525, 65531, 65535,
+    65536
+};
+
+// atan over [0, 1] in 256 steps
+static const s32 __oslo_fx16_atan_table[257] =
+{
+    0, 256, 512, 768, 1024, 1280, 1536, 1792,
+    2047, 2303, 2559, 2814, 3070, 3325, 3580, 3836,
+    4091, 4346, 4600, 4855, 5110, 5364, 5618, 5872,
+    6126, 6380, 6633, 6887, 7140, 7392, 7645, 7898,
+    8150, 8402, 8653, 8905, 9156, 9407, 9657, 9908,
+    10158, 10408, 10657, 10906, 11155, 11403, 11652, 11899,
+    12147, 12394, 12641, 12887, 13133, 13379, 13624, 13869,
+    14114, 14358, 14601, 14845, 15088, 15330, 15572, 15814,
+    16055, 16296, 16536, 16776, 17015, 17254, 17492, 17730,
+    17968, 18205, 18441, 18677, 18913, 19148, 19382, 19616,
+    19850, 20083, 20315, 20547, 20779, 21009, 21240, 21469,
+    21699, 21927, 22156, 22383, 22610, 22836, 23062, 23288,
+    23512, 23737, 23960, 24183, 24406, 24627, 24849, 25069,
+    25289, 25509, 25727, 25946, 26163, 26380, 26597, 26813,
+    27028, 27242, 27456, 27670, 27882, 28094, 28306, 28517,
+    28727, 28936, 29145, 29354, 29561, 29768, 29975, 30180,
+    30386, 30590, 30794, 30997, 31200, 31402, 31603, 31803,
+    32003, 32203, 32401, 32600, 32797, 32994, 33190, 33385,
+    33580, 33774, 33968, 34160, 34353, 34544, 34735, 34925,
+    35115, 35304, 35492, 35680, 35867, 36053, 36239, 36424,
+    36608, 36792, 36975, 37158, 37340, 37521, 37701, 37881,
+    38060, 38239, 38417, 38594, 38771, 38947, 39123, 39297,
+    39472, 39645, 39818, 39990, 40162, 40333, 40503, 40673,
+    40842, 41010, 41178, 41346, 41512, 41678, 41844, 42008,
+    42172, 42336, 42499, 42661, 42823, 42984, 43145, 43304,
+    43464, 43622, 43780, 43938, 44095, 44251, 44407, 44562,
+    44716, 44870, 45024, 45176, 45328, 45480, 45631, 45781,
+    45931, 46080, 46229, 46377, 46525, 46672, 46818, 46964,
+    47109, 47254, 47398, 47542, 47685, 47827, 47969, 48111,
+    48251, 48392, 48531, 48671, 48809, 48947, 49085, 49222,
+    49359, 49495, 49630, 49765, 49899, 50033, 50167, 50299,
+    50432, 50563, 50695, 50826, 50956, 51086, 51215, 51344,
+    51472
+};
+
+oslo_inline fx16
+fx16_from_int(s32 v)
+{
+    return (fx16)((u32)v << FX16_SHIFT);
+}
+
+// Rounds to nearest
+oslo_inline fx16
+fx16_from_f32(f32 v)
+{
+    return (fx16)(v * 65536.f + (v >= 0.f ? 0.5f : -0.5f));
+}
+
+// Rounds towards -inf
+oslo_inline s32
+fx16_to_int(fx16 v)
+{
+    return v >> FX16_SHIFT;
+}
+
+oslo_inline f32
+fx16_to_f32(fx16 v)
+{
+    return (f32)v * (1.f / 65536.f);
+}
+
+// Rounds towards -inf like the vector kernels
+oslo_inline fx16
+fx16_mul(fx16 a, fx16 b)
+{
+    return (fx16)(((s64)a * b) >> FX16_SHIFT);
+}
+
+// Saturates on division by zero
+oslo_inline fx16
+fx16_div(fx16 a, fx16 b)
+{
+    if (b == 0)
+    {
+        return a >= 0 ? FX16_MAX : FX16_MIN;
+    }
+    return (fx16)(((s64)a * FX16_ONE) / b);
+}
+
+oslo_inline fx16
+fx16_abs(fx16 v)
+{
+    return v < 0 ? -v : v;
+}
+
+oslo_inline fx16
+fx16_lerp(fx16 a, fx16 b, fx16 t)
+{
+    return a + fx16_mul(b - a, t);
+}
+
+// floor(sqrt(v)), bit by bit
+oslo_inline u32
+__oslo_isqrt64(u64 v)
+{
+    u64 result = 0;
+    u64 bit = (u64)1 << 62;
+    while (bit > v)
+    {
+        bit >>= 2;
+    }
+    while (bit)
+    {
+        if (v >= result + bit)
+        {
+            v -= result + bit;
+            result = (result >> 1) + bit;
+        }
+        else
+        {
+            result >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (u32)result;
+}
+
+// 0 for v <= 0
+oslo_inline fx16
+fx16_sqrt(fx16 v)
+{
+    return v > 0 ? (fx16)__oslo_isqrt64((u64)v << FX16_SHIFT) : 0;
+}
+
+// Table position of an angle, 1024 steps per turn with 16 bits of fraction
+oslo_inline s64
+__oslo_fx16_turn_pos(fx16 angle)
+{
+    // 1024 / 2pi in Q16.16
+    return ((s64)angle * 10680707) >> FX16_SHIFT;
+}
+
+oslo_inline fx16
+__oslo_fx16_sin_pos(s64 pos)
+{
+    u32 step = (u32)(pos >> FX16_SHIFT) & 1023u;
+    s64 frac = pos & 0xFFFF;
+    u32 i = step & 255u;
+    s32 a, b;
+    if (step & 256u)
+    {
+        // Second and fourth quarter run the table backwards
+        a = __oslo_fx16_sin_table[256 - i];
+        b = __oslo_fx16_sin_table[255 - i];
+    }
+    else
+    {
+        a = __oslo_fx16_sin_table[i];
+        b = __oslo_fx16_sin_table[i + 1];
+    }
+    fx16 v = (fx16)(a + (((s64)(b - a) * frac) >> FX16_SHIFT));
+    return step & 512u ? -v : v;
+}
+
+// Angles in radians, absolute error about 3e-5 (2 ulp), atan2 about 5e-5
+oslo_inline fx16
+fx16_sin(fx16 angle)
+{
+    return __oslo_fx16_sin_pos(__oslo_fx16_turn_pos(angle));
+}
+
+oslo_inline fx16
+fx16_cos(fx16 angle)
+{
+    return __oslo_fx16_sin_pos(__oslo_fx16_turn_pos(angle) + ((s64)256 << FX16_SHIFT));
+}
+
+oslo_inline fx16
+fx16_atan2(fx16 y, fx16 x)
+{
+    s64 ax = x < 0 ? -(s64)x : x;
+    s64 ay = y < 0 ? -(s64)y : y;
+    if (ax == 0 && ay == 0)
+    {
+        return 0;
+    }
+
+    s64 mx = ax > ay ? ax : ay;
+    s64 mn = ax > ay ? ay : ax;
+    s64 ratio = (mn << FX16_SHIFT) / mx;
+    u32 i = (u32)(ratio >> 8);
+    s64 frac = (ratio & 0xFF) << 8;
+    s32 a = __oslo_fx16_atan_table[i];
+    s32 b = __oslo_fx16_atan_table[i < 256 ? i + 1 : 256];
+    fx16 r = (fx16)(a + (((s64)(b - a) * frac) >> FX16_SHIFT));
+
+    if (ay > ax) r = FX16_HALF_PI - r;
+    if (x < 0) r = FX16_PI - r;
+    return y < 0 ? -r : r;
+}
+
+oslo_inline fx16_vec2
+fx16_vec2_ctor(fx16 x, fx16 y)
+{
+    fx16_vec2 v;
+    v.x = x;
+    v.y = y;
+    return v;
+}
+
+oslo_inline fx16_vec2
+fx16_vec2_from_vec2(vec2 v)
+{
+    return fx16_vec2_ctor(fx16_from_f32(v.x), fx16_from_f32(v.y));
+}
+
+oslo_inline vec2
+fx16_vec2_to_vec2(fx16_vec2 v)
+{
+    return vec2_ctor(fx16_to_f32(v.x), fx16_to_f32(v.y));
+}
+
+oslo_inline fx16_vec2
+fx16_vec2_add(fx16_vec2 a, fx16_vec2 b)
+{
+    return fx16_vec2_ctor(a.x + b.x, a.y + b.y);
+}
+
+oslo_inline fx16_vec2
+fx16_vec2_sub(fx16_vec2 a, fx16_vec2 b)
+{
+    return fx16_vec2_ctor(a.x - b.x, a.y - b.y);
+}
+
+oslo_inline fx16_vec2
+fx16_vec2_scale(fx16_vec2 v, fx16 s)
+{
+    return fx16_vec2_ctor(fx16_mul(v.x, s), fx16_mul(v.y, s));
+}
+
+// Product kept in 64 bits, only the result has to fit
+oslo_inline fx16
+fx16_vec2_dot(fx16_vec2 a, fx16_vec2 b)
+{
+    return (fx16)(((s64)a.x * b.x + (s64)a.y * b.y) >> FX16_SHIFT);
+}
+
+oslo_inline fx16
+fx16_vec2_len(fx16_vec2 v)
+{
+    // The squared length in Q32.32 has its square root in Q16.16
+    return (fx16)__oslo_isqrt64((u64)((s64)v.x * v.x) + (u64)((s64)v.y * v.y));
+}
+
+oslo_inline fx16_vec2
+fx16_vec2_norm(fx16_vec2 v)
+{
+    fx16 len = fx16_vec2_len(v);
+    return len ? fx16_vec2_ctor(fx16_div(v.x, len), fx16_div(v.y, len)) : v;
+}
+
+oslo_inline fx16_vec2
+fx16_vec2_rotate(fx16_vec2 v, fx16 angle)
+{
+    fx16 s = fx16_sin(angle);
+    fx16 c = fx16_cos(angle);
+    return fx16_vec2_ctor(fx16_mul(v.x, c) - fx16_mul(v.y, s), fx16_mul(v.x, s) + fx16_mul(v.y, c));
+}
+
+oslo_inline fx32
+fx32_from_int(s32 v)
+{
+    return (fx32)((u64)(s64)v << FX32_SHIFT);
+}
+
+oslo_inline fx32
+fx32_from_f64(f64 v)
+{
+    return (fx32)(v * 4294967296.0 + (v >= 0.0 ? 0.5 : -0.5));
+}
+
+oslo_inline f64
+fx32_to_f64(fx32 v)
+{
+    return (f64)v * (1.0 / 4294967296.0);
+}
+
+oslo_inline fx32
+fx32_from_fx16(fx16 v)
+{
+    return (fx32)((u64)(s64)v << (FX32_SHIFT - FX16_SHIFT));
+}
+
+oslo_inline fx16
+fx32_to_fx16(fx32 v)
+{
+    return (fx16)(v >> (FX32_SHIFT - FX16_SHIFT));
+}
+
+// Without a 128 bit type, from 32 bit halves, rounds towards -inf
+oslo_inline fx32
+fx32_mul(fx32 a, fx32 b)
+{
+    s64 ah = a >> 32, bh = b >> 32;
+    u64 al = (u32)a, bl = (u32)b;
+    u64 r = ((u64)(ah * bh) << 32) + (u64)(ah * (s64)bl) + (u64)((s64)al * bh) + ((al * bl) >> 32);
+    return (fx32)r;
+}
+
+// Long division on the magnitudes, saturates on division by zero
+oslo_inline fx32
+fx32_div(fx32 a, fx32 b)
+{
+    if (b == 0)
+    {
+        return a >= 0 ? FX32_MAX : FX32_MIN;
+    }
+
+    bool negative = (a < 0) != (b < 0);
+    u64 ua = a < 0 ? 0 - (u64)a : (u64)a;
+    u64 ub = b < 0 ? 0 - (u64)b : (u64)b;
+    u64 q = (ua / ub) << 32;
+    u64 rem = ua % ub;
+    for (s32 bit = 31; bit >= 0; --bit)
+    {
+        // rem < ub <= 2^63, the shift can't overflow
+        rem <<= 1;
+        if (rem >= ub)
+        {
+            rem -= ub;
+            q |= (u64)1 << bit;
+        }
+    }
+    return negative ? (fx32)(0 - q) : (fx32)q;
+}
+
+// Integer square root as the first guess, then Newton steps for the low 16 bits
+oslo_inline fx32
+fx32_sqrt(fx32 v)
+{
+    if (v <= 0)
+    {
+        return 0;
+    }
+    fx32 r = (fx32)__oslo_isqrt64((u64)v) << 16;
+    if (r == 0)
+    {
+        r = 1;
+    }
+    r = (r + fx32_div(v, r)) >> 1;
+    r = (r + fx32_div(v, r)) >> 1;
+    return r;
+}
+
+// fx16 products of whole arrays, bit identical to fx16_mul
+#if defined(OSLO_MATH_AVX) && defined(__AVX2__)
+    #define __OSLO_FX16_WIDTH 8
+    typedef __m256i __oslo_fx16_lanes;
+    #define __oslo_fx16_load(__P)           _mm256_loadu_si256((const __m256i*)(__P))
+    #define __oslo_fx16_store(__P, __A)     _mm256_storeu_si256((__m256i*)(__P), (__A))
+    #define __oslo_fx16_set1(__S)           _mm256_set1_epi32(__S)
+    #define __oslo_fx16_add(__A, __B)       _mm256_add_epi32((__A), (__B))
+    // Even and odd lanes multiply to 64 bits separately, bits 16..47 are merged back
+    oslo_inline __m256i __oslo_fx16_mul_lanes(__m256i a, __m256i b)
+    {
+        __m256i even = _mm256_srli_epi64(_mm256_mul_epi32(a, b), 16);
+        __m256i odd = _mm256_srli_epi64(_mm256_mul_epi32(_mm256_srli_epi64(a, 32), _mm256_srli_epi64(b, 32)), 16);
+        return _mm256_blend_epi32(even, _mm256_slli_epi64(odd, 32), 0xAA);
+    }
+#elif defined(OSLO_MATH_SSE2) && defined(__SSE4_1__)
+    #include <smmintrin.h>
+    #define __OSLO_FX16_WIDTH 4
+    typedef __m128i __oslo_fx16_lanes;
+    #define __oslo_fx16_load(__P)           _mm_loadu_si128((const __m128i*)(__P))
+    #define __oslo_fx16_store(__P, __A)     _mm_storeu_si128((__m128i*)(__P), (__A))
+    #define __oslo_fx16_set1(__S)           _mm_set1_epi32(__S)
+    #define __oslo_fx16_add(__A, __B)       _mm_add_epi32((__A), (__B))
+    oslo_inline __m128i __oslo_fx16_mul_lanes(__m128i a, __m128i b)
+    {
+        __m128i even = _mm_srli_epi64(_mm_mul_epi32(a, b), 16);
+        __m128i odd = _mm_srli_epi64(_mm_mul_epi32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32)), 16);
+        return _mm_blend_epi16(even, _mm_slli_epi64(odd, 32), 0xCC);
+    }
+#elif defined(OSLO_MATH_NEON) && defined(__aarch64__)
+    #define __OSLO_FX16_WIDTH 4
+    typedef int32x4_t __oslo_fx16_lanes;
+    #define __oslo_fx16_load(__P)           vld1q_s32(__P)
+    #define __oslo_fx16_store(__P, __A)     vst1q_s32((__P), (__A))
+    #define __oslo_fx16_set1(__S)           vdupq_n_s32(__S)
+    #define __oslo_fx16_add(__A, __B)       vaddq_s32((__A), (__B))
+    oslo_inline int32x4_t __oslo_fx16_mul_lanes(int32x4_t a, int32x4_t b)
+    {
+        int64x2_t lo = vmull_s32(vget_low_s32(a), vget_low_s32(b));
+        int64x2_t hi = vmull_high_s32(a, b);
+        return vcombine_s32(vshrn_n_s64(lo, 16), vshrn_n_s64(hi, 16));
+    }
+#else
+    // SSE2 has no signed 32x32->64 multiply, plain loops
+    #define __OSLO_FX16_WIDTH 1
+#endif
+
+// y += a * x
+oslo_inline void
+fx16_axpy_n(fx16* y, fx16 a, const fx16* x, size_t n)
+{
+    size_t i = 0;
+#if __OSLO_FX16_WIDTH > 1
+    __oslo_fx16_lanes va = __oslo_fx16_set1(a);
+    for (; i + __OSLO_FX16_WIDTH <= n; i += __OSLO_FX16_WIDTH)
+    {
+        __oslo_fx16_store(y + i, __oslo_fx16_add(__oslo_fx16_load(y + i), __oslo_fx16_mul_lanes(va, __oslo_fx16_load(x + i))));
+    }
+#endif
+    for (; i < n; ++i)
+    {
+        y[i] = (fx16)((u32)y[i] + (u32)fx16_mul(a, x[i]));
+    }
+}
+
+// v *= s
+oslo_inline void
+fx16_scale_n(fx16* v, fx16 s, size_t n)
+{
+    size_t i = 0;
+#if __OSLO_FX16_WIDTH > 1
+    __oslo_fx16_lanes vs = __oslo_fx16_set1(s);
+    for (; i + __OSLO_FX16_WIDTH <= n; i += __OSLO_FX16_WIDTH)
+    {
+        __oslo_fx16_store(v + i, __oslo_fx16_mul_lanes(__oslo_fx16_load(v + i), vs));
+    }
+#endif
+    for (; i < n; ++i)
+    {
+        v[i] = fx16_mul(v[i], s);
+    }
+}
+
+// out = a * b element-wise, out may alias a or b
+oslo_inline void
+fx16_mul_n(fx16* out, const fx16* a, const fx16* b, size_t n)
+{
+    size_t i = 0;
+#if __OSLO_FX16_WIDTH > 1
+    for (; i + __OSLO_FX16_WIDTH <= n; i += __OSLO_FX16_WIDTH)
+    {
+        __oslo_fx16_store(out + i, __oslo_fx16_mul_lanes(__oslo_fx16_load(a + i), __oslo_fx16_load(b + i)));
+    }
+#endif
+    for (; i < n; ++i)
+    {
+        out[i] = fx16_mul(a[i], b[i]);
+    }
+}
+
+/*================================================================================
+// Fast Trig
+================================================================================*/
+
+/*
+    sin/cos/atan2/sqrt with a precision tier picked per call. With a constant tier the branch
+    folds away when inlined.
+        EXACT:  libm
+        MEDIUM: sin/cos/atan2 absolute error below 1e-4, sqrt relative error below 1e-5
+        LOW:    sin/cos/atan2 absolute error around 1e-3, sqrt relative error below 2e-3
+    sin/cos reduce the angle with a split 2*pi, accuracy holds for |x| up to about 1e5.
+    The approximations pay off mostly in oslo_sincos_n where they vectorize, a single scalar call
+    is not much faster than a good libm.
+*/
+
+typedef enum oslo_math_precision
+{
+    OSLO_MATH_PRECISION_EXACT,
+    OSLO_MATH_PRECISION_MEDIUM,
+    OSLO_MATH_PRECISION_LOW
+} oslo_math_precision;
+
+#define __OSLO_TRIG_INV_TAU     0.15915494309189535f
+// 2*pi = TAU_HI + TAU_LO, TAU_HI has few mantissa bits so k * TAU_HI is exact
+#define __OSLO_TRIG_TAU_HI      6.28125f
+#define __OSLO_TRIG_TAU_LO      0.0019353071795864769f
+#define __OSLO_TRIG_HALF_PI     1.5707963267948966f
+
+// Minimax odd polynomials, sin on [0, pi/2] and atan on [0, 1]
+#define __OSLO_SIN_MEDIUM_C1    0.99969673f
+#define __OSLO_SIN_MEDIUM_C3   -0.16567298f
+#define __OSLO_SIN_MEDIUM_C5    0.00751434f
+#define __OSLO_ATAN_MEDIUM_C1   0.99921372f
+#define __OSLO_ATAN_MEDIUM_C3  -0.32117401f
+#define __OSLO_ATAN_MEDIUM_C5   0.14626207f
+#define __OSLO_ATAN_MEDIUM_C7  -0.03898488f
+#define __OSLO_ATAN_LOW_C1      0.99535744f
+#define __OSLO_ATAN_LOW_C3     -0.28868730f
+#define __OSLO_ATAN_LOW_C5      0.07933598f
+
+// Parabola fit with a correction step, sin on [-pi, pi]
+#define __OSLO_SIN_LOW_B        1.2732395447351628f
+#define __OSLO_SIN_LOW_C       -0.4052847345693511f
+#define __OSLO_SIN_LOW_P        0.225f
+
+// Maps x to [-pi, pi]
+oslo_inline f32
+__oslo_trig_reduce(f32 x)
+{
+    f32 t = x * __OSLO_TRIG_INV_TAU;
+    f32 k = (f32)(s32)(t < 0.f ? t - 0.5f : t + 0.5f);
+    return (x - k * __OSLO_TRIG_TAU_HI) - k * __OSLO_TRIG_TAU_LO;
+}
+
+oslo_inline f32
+oslo_sin(f32 x, oslo_math_precision precision)
+{
+    if (precision == OSLO_MATH_PRECISION_EXACT)
+    {
+        return sinf(x);
+    }
+
+    f32 r = __oslo_trig_reduce(x);
+    if (precision == OSLO_MATH_PRECISION_LOW)
+    {
+        f32 y = __OSLO_SIN_LOW_B * r + __OSLO_SIN_LOW_C * r * fabsf(r);
+        return __OSLO_SIN_LOW_P * (y * fabsf(y) - y) + y;
+    }
+
+    // Fold to [-pi/2, pi/2] using sin(pi - r) = sin(r)
+    f32 a = __OSLO_TRIG_HALF_PI - fabsf(fabsf(r) - __OSLO_TRIG_HALF_PI);
+    a = r < 0.f ? -a : a;
+    f32 a2 = a * a;
+    return a * (__OSLO_SIN_MEDIUM_C1 + a2 * (__OSLO_SIN_MEDIUM_C3 + a2 * __OSLO_SIN_MEDIUM_C5));
+}
+
+oslo_inline f32
+oslo_cos(f32 x, oslo_math_precision precision)
+{
+    if (precision == OSLO_MATH_PRECISION_EXACT)
+    {
+        return cosf(x);
+    }
+    return oslo_sin(x + __OSLO_TRIG_HALF_PI, precision);
+}
+
+oslo_inline void
+oslo_sincos(f32 x, f32* out_sin, f32* out_cos, oslo_math_precision precision)
+{
+    *out_sin = oslo_sin(x, precision);
+    *out_cos = oslo_cos(x, precision);
+}
+
+oslo_inline f32
+oslo_atan2(f32 y, f32 x, oslo_math_precision precision)
+{
+    if (precision == OSLO_MATH_PRECISION_EXACT)
+    {
+        return atan2f(y, x);
+    }
+
+    f32 ax = fabsf(x);
+    f32 ay = fabsf(y);
+    f32 mx = ax > ay ? ax : ay;
+    f32 mn = ax > ay ? ay : ax;
+    f32 a = mx > 0.f ? mn / mx : 0.f;
+    f32 a2 = a * a;
+
+    f32 r = precision == OSLO_MATH_PRECISION_LOW ?
+        a * (__OSLO_ATAN_LOW_C1 + a2 * (__OSLO_ATAN_LOW_C3 + a2 * __OSLO_ATAN_LOW_C5)) :
+        a * (__OSLO_ATAN_MEDIUM_C1 + a2 * (__OSLO_ATAN_MEDIUM_C3 + a2 * (__OSLO_ATAN_MEDIUM_C5 + a2 * __OSLO_ATAN_MEDIUM_C7)));
+
+    if (ay > ax) r = __OSLO_TRIG_HALF_PI - r;
+    if (x < 0.f) r = (f32)PI - r;
+    return y < 0.f ? -r : r;
+}
+
+// Reciprocal square root estimate refined with Newton steps, 0 for x <= 0.
+// Hardware sqrtf is often as fast on x86, measure before switching.
+oslo_inline f32
+oslo_sqrt(f32 x, oslo_math_precision precision)
+{
+    if (precision == OSLO_MATH_PRECISION_EXACT)
+    {
+        return sqrtf(x);
+    }
+    if (x <= 0.f)
+    {
+        return 0.f;
+    }
+
+    union { f32 f; u32 i; } u;
+    u.f = x;
+    u.i = 0x5f3759df - (u.i >> 1);
+    f32 y = u.f;
+    y = y * (1.5f - 0.5f * x * y * y);
+    if (precision == OSLO_MATH_PRECISION_MEDIUM)
+    {
+        y = y * (1.5f - 0.5f * x * y * y);
+    }
+    return x * y;
+}
+
+#if OSLO_MATH_SOA_WIDTH > 1
+    #if defined(OSLO_MATH_AVX)
+        #define __oslo_soa_sign(__A)        _mm256_and_ps((__A), _mm256_set1_ps(-0.f))
+        #define __oslo_soa_abs(__A)         _mm256_andnot_ps(_mm256_set1_ps(-0.f), (__A))
+        #define __oslo_soa_xor(__A, __B)    _mm256_xor_ps((__A), (__B))
+        #define __oslo_soa_round(__A)       _mm256_round_ps((__A), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC)
+    #elif defined(OSLO_MATH_SSE2)
+        #define __oslo_soa_sign(__A)        _mm_and_ps((__A), _mm_set1_ps(-0.f))
+        #define __oslo_soa_abs(__A)         _mm_andnot_ps(_mm_set1_ps(-0.f), (__A))
+        #define __oslo_soa_xor(__A, __B)    _mm_xor_ps((__A), (__B))
+        // Through int32, fine for the angle range above
+        #define __oslo_soa_round(__A)       _mm_cvtepi32_ps(_mm_cvtps_epi32(__A))
+    #else
+        #define __oslo_soa_sign(__A)        vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(__A), vdupq_n_u32(0x80000000u)))
+        #define __oslo_soa_abs(__A)         vabsq_f32(__A)
+        #define __oslo_soa_xor(__A, __B)    vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(__A), vreinterpretq_u32_f32(__B)))
+        #define __oslo_soa_round(__A)       vrndnq_f32(__A)
+    #endif
+
+    oslo_inline __oslo_soa_f32
+    __oslo_soa_sin(__oslo_soa_f32 x, oslo_math_precision precision)
+    {
+        __oslo_soa_f32 k = __oslo_soa_round(__oslo_soa_mul(x, __oslo_soa_set1(__OSLO_TRIG_INV_TAU)));
+        __oslo_soa_f32 r = __oslo_soa_sub(__oslo_soa_sub(x, __oslo_soa_mul(k, __oslo_soa_set1(__OSLO_TRIG_TAU_HI))), __oslo_soa_mul(k, __oslo_soa_set1(__OSLO_TRIG_TAU_LO)));
+
+        if (precision == OSLO_MATH_PRECISION_LOW)
+        {
+            __oslo_soa_f32 y = __oslo_soa_add(__oslo_soa_mul(__oslo_soa_set1(__OSLO_SIN_LOW_B), r), __oslo_soa_mul(__oslo_soa_set1(__OSLO_SIN_LOW_C), __oslo_soa_mul(r, __oslo_soa_abs(r))));
+            return __oslo_soa_add(__oslo_soa_mul(__oslo_soa_set1(__OSLO_SIN_LOW_P), __oslo_soa_sub(__oslo_soa_mul(y, __oslo_soa_abs(y)), y)), y);
+        }
+
+        __oslo_soa_f32 half_pi = __oslo_soa_set1(__OSLO_TRIG_HALF_PI);
+        __oslo_soa_f32 a = __oslo_soa_sub(half_pi, __oslo_soa_abs(__oslo_soa_sub(__oslo_soa_abs(r), half_pi)));
+        a = __oslo_soa_xor(a, __oslo_soa_sign(r));
+        __oslo_soa_f32 a2 = __oslo_soa_mul(a, a);
+        __oslo_soa_f32 p = __oslo_soa_add(__oslo_soa_set1(__OSLO_SIN_MEDIUM_C3), __oslo_soa_mul(a2, __oslo_soa_set1(__OSLO_SIN_MEDIUM_C5)));
+        p = __oslo_soa_add(__oslo_soa_set1(__OSLO_SIN_MEDIUM_C1), __oslo_soa_mul(a2, p));
+        return __oslo_soa_mul(a, p);
+    }
+#endif
+
+// sin and cos of n angles, out_sin or out_cos may be NULL
+oslo_inline void
+oslo_sincos_n(const f32* angles, f32* out_sin, f32* out_cos, size_t n, oslo_math_precision precision)
+{
+    size_t i = 0;
+#if OSLO_MATH_SOA_WIDTH > 1
+    if (precision != OSLO_MATH_PRECISION_EXACT)
+    {
+        __oslo_soa_f32 half_pi = __oslo_soa_set1(__OSLO_TRIG_HALF_PI);
+        for (; i + OSLO_MATH_SOA_WIDTH <= n; i += OSLO_MATH_SOA_WIDTH)
+        {
+            __oslo_soa_f32 x = __oslo_soa_load(angles + i);
+            if (out_sin) __oslo_soa_store(out_sin + i, __oslo_soa_sin(x, precision));
+            if (out_cos) __oslo_soa_store(out_cos + i, __oslo_soa_sin(__oslo_soa_add(x, half_pi), precision));
+        }
+    }
+#endif
+    for (; i < n; ++i)
+    {
+        if (out_sin) out_sin[i] = oslo_sin(angles[i], precision);
+        if (out_cos) out_cos[i] = oslo_cos(angles[i], precision);
+    }
+}
+
+/*================================================================================
+// Random
+================================================================================*/
+
+/*
+    xoshiro128+ (Blackman, Vigna), seeded through splitmix64. oslo_rng is a single stream for
+    scalar draws. oslo_rng_wide runs OSLO_RNG_WIDE_LANES interleaved streams for the bulk fills,
+    element i comes from stream i % OSLO_RNG_WIDE_LANES, so a seed gives the same numbers with
+    or without SIMD. Not suitable for anything security related.
+*/
+
+typedef struct oslo_rng_t
+{
+    u32 s[4];
+} oslo_rng_t;
+
+typedef oslo_rng_t oslo_rng;
+
+#define OSLO_RNG_WIDE_LANES 8
+
+typedef struct oslo_rng_wide_t
+{
+    // s[word][lane]
+    u32 s[4][OSLO_RNG_WIDE_LANES];
+} oslo_rng_wide_t;
+
+typedef oslo_rng_wide_t oslo_rng_wide;
+
+oslo_inline u64
+__oslo_splitmix64(u64* x)
+{
+    u64 z = (*x += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+oslo_inline u32
+__oslo_rng_next(u32* s0, u32* s1, u32* s2, u32* s3)
+{
+    u32 result = *s0 + *s3;
+    u32 t = *s1 << 9;
+    *s2 ^= *s0;
+    *s3 ^= *s1;
+    *s1 ^= *s2;
+    *s0 ^= *s3;
+    *s2 ^= t;
+    *s3 = (*s3 << 11) | (*s3 >> 21);
+    return result;
+}
+
+// Top 24 bits to [0, 1), the low bits of xoshiro128+ are the weak ones
+oslo_inline f32
+__oslo_rng_unit(u32 r)
+{
+    return (f32)(r >> 8) * (1.f / 16777216.f);
+}
+
+oslo_inline void
+oslo_rng_seed(oslo_rng* rng, u64 seed)
+{
+    u64 a = __oslo_splitmix64(&seed);
+    u64 b = __oslo_splitmix64(&seed);
+    rng->s[0] = (u32)a; rng->s[1] = (u32)(a >> 32);
+    rng->s[2] = (u32)b; rng->s[3] = (u32)(b >> 32);
+}
+
+oslo_inline oslo_rng
+oslo_rng_ctor(u64 seed)
+{
+    oslo_rng rng;
+    oslo_rng_seed(&rng, seed);
+    return rng;
+}
+
+oslo_inline u32
+oslo_rng_u32(oslo_rng* rng)
+{
+    return __oslo_rng_next(&rng->s[0], &rng->s[1], &rng->s[2], &rng->s[3]);
+}
+
+// [0, 1)
+oslo_inline f32
+oslo_rng_f32(oslo_rng* rng)
+{
+    return __oslo_rng_unit(oslo_rng_u32(rng));
+}
+
+// [0, n), n > 0. Multiply-shift with rejection of the biased low range (Lemire).
+oslo_inline u32
+oslo_rng_below(oslo_rng* rng, u32 n)
+{
+    u64 m = (u64)oslo_rng_u32(rng) * n;
+    if ((u32)m < n)
+    {
+        u32 threshold = (0u - n) % n;
+        while ((u32)m < threshold)
+        {
+            m = (u64)oslo_rng_u32(rng) * n;
+        }
+    }
+    return (u32)(m >> 32);
+}
+
+// [min, max], both inclusive
+oslo_inline s32
+oslo_rng_range_s32(oslo_rng* rng, s32 min, s32 max)
 {
-    return vec2_ctor(v0.x * v1.x, v0.y * v1.y);
+    u32 span = (u32)max - (u32)min + 1u;
+    // Full 32 bit range wraps span to 0
+    return span ? (s32)((u32)min + oslo_rng_below(rng, span)) : (s32)oslo_rng_u32(rng);
 }
 
-oslo_inline vec2 
-vec2_div(vec2 v0, vec2 v1) 
+// [min, max)
+oslo_inline f32
+oslo_rng_range_f32(oslo_rng* rng, f32 min, f32 max)
 {
-    return vec2_ctor(v0.x / v1.x, v0.y / v1.y);
+    return min + (max - min) * oslo_rng_f32(rng);
 }
 
-oslo_inline bool
-vec2_equals(vec2 v0, vec2 v1)
+oslo_inline b32
+oslo_rng_chance(oslo_rng* rng, f32 probability)
 {
-    return (v0.x == v1.x && v0.y == v1.y);
+    return oslo_rng_f32(rng) < probability;
 }
 
-oslo_inline vec2 
-vec2_scale(vec2 v, f32 s)
+// Uniform in the rectangle [min, max)
+oslo_inline vec2
+oslo_rng_in_rect(oslo_rng* rng, vec2 min, vec2 max)
 {
-    return vec2_ctor(v.x * s, v.y * s);
+    f32 x = oslo_rng_range_f32(rng, min.x, max.x);
+    f32 y = oslo_rng_range_f32(rng, min.y, max.y);
+    return vec2_ctor(x, y);
 }
 
-oslo_inline f32 
-vec2_dot(vec2 v0, vec2 v1) 
+// Uniform over the disk, not biased towards the center
+oslo_inline vec2
+oslo_rng_in_circle(oslo_rng* rng, vec2 center, f32 radius)
 {
-    return (f32)(v0.x * v1.x + v0.y * v1.y);
+    f32 r = radius * sqrtf(oslo_rng_f32(rng));
+    f32 s, c;
+    oslo_sincos(oslo_rng_f32(rng) * (f32)TAU, &s, &c, OSLO_MATH_PRECISION_EXACT);
+    return vec2_ctor(center.x + r * c, center.y + r * s);
 }
 
-oslo_inline f32 
-vec2_len(vec2 v)
+oslo_inline vec2
+oslo_rng_unit_vec2(oslo_rng* rng)
 {
-    return (f32)sqrt(vec2_dot(v, v));
+    f32 s, c;
+    oslo_sincos(oslo_rng_f32(rng) * (f32)TAU, &s, &c, OSLO_MATH_PRECISION_EXACT);
+    return vec2_ctor(c, s);
 }
 
-oslo_inline vec2
-vec2_project_onto(vec2 v0, vec2 v1)
+// Index in [0, n) picked with probability weights[i] / sum(weights). Negative weights count as 0,
+// returns n when nothing has weight. For many draws over the same weights build a prefix sum once.
+oslo_inline size_t
+oslo_rng_weighted(oslo_rng* rng, const f32* weights, size_t n)
 {
-    f32 dot = vec2_dot(v0, v1);
-    f32 len = vec2_dot(v1, v1);
-
-    // Orthogonal, so return v1
-    if (len == 0.f) return v1;
+    f32 total = 0.f;
+    for (size_t i = 0; i < n; ++i)
+    {
+        total += weights[i] > 0.f ? weights[i] : 0.f;
+    }
+    if (total <= 0.f)
+    {
+        return n;
+    }
 
-    return vec2_scale(v1, dot / len);
+    f32 pick = oslo_rng_f32(rng) * total;
+    size_t last = n;
+    for (size_t i = 0; i < n; ++i)
+    {
+        if (weights[i] <= 0.f) continue;
+        if (pick < weights[i]) return i;
+        pick -= weights[i];
+        last = i;
+    }
+    // Rounding left pick >= the remaining weight
+    return last;
 }
 
-oslo_inline vec2 vec2_norm(vec2 v) 
+oslo_inline void
+oslo_rng_wide_seed(oslo_rng_wide* rng, u64 seed)
 {
-    f32 len = vec2_len(v);
-    return vec2_scale(v, len != 0.f ? 1.0f / vec2_len(v) : 1.f);
+    for (size_t lane = 0; lane < OSLO_RNG_WIDE_LANES; ++lane)
+    {
+        u64 a = __oslo_splitmix64(&seed);
+        u64 b = __oslo_splitmix64(&seed);
+        rng->s[0][lane] = (u32)a; rng->s[1][lane] = (u32)(a >> 32);
+        rng->s[2][lane] = (u32)b; rng->s[3][lane] = (u32)(b >> 32);
+    }
 }
 
-oslo_inline 
-f32 vec2_dist(vec2 a, vec2 b)
-{
-    f32 dx = (a.x - b.x);
-    f32 dy = (a.y - b.y);
-    return (float)(sqrt(dx * dx + dy * dy));
-}
+#define __oslo_rng_unitx(__A)\
+    __oslo_wide_mulf(__oslo_wide_cvtf(__oslo_wide_shr((__A), 8)), __oslo_wide_setf(1.f / 16777216.f))
 
-oslo_inline
-f32 vec2_cross(vec2 a, vec2 b) 
+// Same steps as __oslo_rng_next on a group of lanes
+#define __oslo_rng_stepx(__S0, __S1, __S2, __S3, __R)\
+    do {\
+        __oslo_wide_u32 __t = __oslo_wide_shl((__S1), 9);\
+        (__R) = __oslo_wide_add((__S0), (__S3));\
+        (__S2) = __oslo_wide_xor((__S2), (__S0));\
+        (__S3) = __oslo_wide_xor((__S3), (__S1));\
+        (__S1) = __oslo_wide_xor((__S1), (__S2));\
+        (__S0) = __oslo_wide_xor((__S0), (__S3));\
+        (__S2) = __oslo_wide_xor((__S2), __t);\
+        (__S3) = __oslo_wide_or(__oslo_wide_shl((__S3), 11), __oslo_wide_shr((__S3), 21));\
+    } while (0)
+
+// One value from every lane, for the tails
+oslo_inline void
+__oslo_rng_wide_block(oslo_rng_wide* rng, u32* out)
 {
-    return a.x * b.y - a.y * b.x;
+    for (size_t lane = 0; lane < OSLO_RNG_WIDE_LANES; ++lane)
+    {
+        out[lane] = __oslo_rng_next(&rng->s[0][lane], &rng->s[1][lane], &rng->s[2][lane], &rng->s[3][lane]);
+    }
 }
 
-oslo_inline
-f32 vec2_angle(vec2 a, vec2 b) 
+oslo_inline void
+oslo_rng_fill_u32(oslo_rng_wide* rng, u32* out, size_t n)
 {
-    return (float)acos(vec2_dot(a, b) / (vec2_len(a) * vec2_len(b)));
+    size_t blocks = n / OSLO_RNG_WIDE_LANES;
+    for (size_t g = 0; g < OSLO_RNG_WIDE_LANES; g += OSLO_MATH_WIDE_WIDTH)
+    {
+        __oslo_wide_u32 s0 = __oslo_wide_load(rng->s[0] + g);
+        __oslo_wide_u32 s1 = __oslo_wide_load(rng->s[1] + g);
+        __oslo_wide_u32 s2 = __oslo_wide_load(rng->s[2] + g);
+        __oslo_wide_u32 s3 = __oslo_wide_load(rng->s[3] + g);
+        for (size_t b = 0; b < blocks; ++b)
+        {
+            __oslo_wide_u32 r;
+            __oslo_rng_stepx(s0, s1, s2, s3, r);
+            __oslo_wide_store(out + b * OSLO_RNG_WIDE_LANES + g, r);
+        }
+        __oslo_wide_store(rng->s[0] + g, s0);
+        __oslo_wide_store(rng->s[1] + g, s1);
+        __oslo_wide_store(rng->s[2] + g, s2);
+        __oslo_wide_store(rng->s[3] + g, s3);
+    }
+
+    size_t done = blocks * OSLO_RNG_WIDE_LANES;
+    if (done < n)
+    {
+        u32 tail[OSLO_RNG_WIDE_LANES];
+        __oslo_rng_wide_block(rng, tail);
+        for (size_t i = done; i < n; ++i)
+        {
+            out[i] = tail[i - done];
+        }
+    }
 }
 
-oslo_inline
-b32 vec2_equal(vec2 a, vec2 b)
+// Uniform in [min, max), e.g. fill vec2_soa x and y with two calls
+oslo_inline void
+oslo_rng_fill_f32(oslo_rng_wide* rng, f32* out, size_t n, f32 min, f32 max)
 {
-    return (a.x == b.x && a.y == b.y);
+    f32 span = max - min;
+    size_t blocks = n / OSLO_RNG_WIDE_LANES;
+    __oslo_wide_f32 vspan = __oslo_wide_setf(span);
+    __oslo_wide_f32 vmin = __oslo_wide_setf(min);
+    for (size_t g = 0; g < OSLO_RNG_WIDE_LANES; g += OSLO_MATH_WIDE_WIDTH)
+    {
+        __oslo_wide_u32 s0 = __oslo_wide_load(rng->s[0] + g);
+        __oslo_wide_u32 s1 = __oslo_wide_load(rng->s[1] + g);
+        __oslo_wide_u32 s2 = __oslo_wide_load(rng->s[2] + g);
+        __oslo_wide_u32 s3 = __oslo_wide_load(rng->s[3] + g);
+        for (size_t b = 0; b < blocks; ++b)
+        {
+            __oslo_wide_u32 r;
+            __oslo_rng_stepx(s0, s1, s2, s3, r);
+            __oslo_wide_storef(out + b * OSLO_RNG_WIDE_LANES + g, __oslo_wide_addf(__oslo_wide_mulf(__oslo_rng_unitx(r), vspan), vmin));
+        }
+        __oslo_wide_store(rng->s[0] + g, s0);
+        __oslo_wide_store(rng->s[1] + g, s1);
+        __oslo_wide_store(rng->s[2] + g, s2);
+        __oslo_wide_store(rng->s[3] + g, s3);
+    }
+
+    size_t done = blocks * OSLO_RNG_WIDE_LANES;
+    if (done < n)
+    {
+        u32 tail[OSLO_RNG_WIDE_LANES];
+        __oslo_rng_wide_block(rng, tail);
+        for (size_t i = done; i < n; ++i)
+        {
+            out[i] = __oslo_rng_unit(tail[i - done]) * span + min;
+        }
+    }
 }
 
 /*================================================================================
@@ -461,37 +1891,93 @@ vec4_ctor(f32 _x, f32 _y, f32 _z, f32 _w)
 oslo_inline vec4
 vec4_add(vec4 v0, vec4 v1) 
 {
+#if defined(OSLO_MATH_SSE2)
+    vec4 r;
+    _mm_storeu_ps(r.xyzw, _mm_add_ps(_mm_loadu_ps(v0.xyzw), _mm_loadu_ps(v1.xyzw)));
+    return r;
+#elif defined(OSLO_MATH_NEON)
+    vec4 r;
+    vst1q_f32(r.xyzw, vaddq_f32(vld1q_f32(v0.xyzw), vld1q_f32(v1.xyzw)));
+    return r;
+#else
     return vec4_ctor(v0.x + v1.x, v0.y + v1.y, v0.z + v1.z, v0.w + v1.w);
+#endif
 }
 
 oslo_inline vec4
 vec4_sub(vec4 v0, vec4 v1) 
 {
+#if defined(OSLO_MATH_SSE2)
+    vec4 r;
+    _mm_storeu_ps(r.xyzw, _mm_sub_ps(_mm_loadu_ps(v0.xyzw), _mm_loadu_ps(v1.xyzw)));
+    return r;
+#elif defined(OSLO_MATH_NEON)
+    vec4 r;
+    vst1q_f32(r.xyzw, vsubq_f32(vld1q_f32(v0.xyzw), vld1q_f32(v1.xyzw)));
+    return r;
+#else
     return vec4_ctor(v0.x - v1.x, v0.y - v1.y, v0.z - v1.z, v0.w - v1.w);
+#endif
 }
 
 oslo_inline vec4
 vec4_mul(vec4 v0, vec4 v1) 
 {
+#if defined(OSLO_MATH_SSE2)
+    vec4 r;
+    _mm_storeu_ps(r.xyzw, _mm_mul_ps(_mm_loadu_ps(v0.xyzw), _mm_loadu_ps(v1.xyzw)));
+    return r;
+#elif defined(OSLO_MATH_NEON)
+    vec4 r;
+    vst1q_f32(r.xyzw, vmulq_f32(vld1q_f32(v0.xyzw), vld1q_f32(v1.xyzw)));
+    return r;
+#else
     return vec4_ctor(v0.x * v1.x, v0.y * v1.y, v0.z * v1.z, v0.w * v1.w);
+#endif
 }
 
 oslo_inline vec4
 vec4_div(vec4 v0, vec4 v1) 
 {
+#if defined(OSLO_MATH_SSE2)
+    vec4 r;
+    _mm_storeu_ps(r.xyzw, _mm_div_ps(_mm_loadu_ps(v0.xyzw), _mm_loadu_ps(v1.xyzw)));
+    return r;
+#elif defined(OSLO_MATH_NEON) && defined(__aarch64__)
+    vec4 r;
+    vst1q_f32(r.xyzw, vdivq_f32(vld1q_f32(v0.xyzw), vld1q_f32(v1.xyzw)));
+    return r;
+#else
     return vec4_ctor(v0.x / v1.x, v0.y / v1.y, v0.z / v1.z, v0.w / v1.w);
+#endif
 }
 
 oslo_inline vec4
 vec4_scale(vec4 v, f32 s) 
 {
+#if defined(OSLO_MATH_SSE2)
+    vec4 r;
+    _mm_storeu_ps(r.xyzw, _mm_mul_ps(_mm_loadu_ps(v.xyzw), _mm_set1_ps(s)));
+    return r;
+#elif defined(OSLO_MATH_NEON)
+    vec4 r;
+    vst1q_f32(r.xyzw, vmulq_n_f32(vld1q_f32(v.xyzw), s));
+    return r;
+#else
     return vec4_ctor(v.x * s, v.y * s, v.z * s, v.w * s);
+#endif
 }
 
 oslo_inline f32
 vec4_dot(vec4 v0, vec4 v1) 
 {
+#if defined(OSLO_MATH_SSE2)
+    return _mm_cvtss_f32(__oslo_simd_hsum(_mm_mul_ps(_mm_loadu_ps(v0.xyzw), _mm_loadu_ps(v1.xyzw))));
+#elif defined(OSLO_MATH_NEON)
+    return __oslo_simd_hsum(vmulq_f32(vld1q_f32(v0.xyzw), vld1q_f32(v1.xyzw)));
+#else
     return (f32)(v0.x * v1.x + v0.y * v1.y + v0.z * v1.z + v0.w * v1.w);
+#endif
 }
 
 oslo_inline f32
@@ -521,11 +2007,16 @@ vec4_norm(vec4 v)
 oslo_inline f32
 vec4_dist(vec4 v0, vec4 v1)
 {
+#if defined(OSLO_MATH_SSE2) || defined(OSLO_MATH_NEON)
+    vec4 d = vec4_sub(v0, v1);
+    return (float)sqrt(vec4_dot(d, d));
+#else
     f32 dx = (v0.x - v1.x);
     f32 dy = (v0.y - v1.y);
     f32 dz = (v0.z - v1.z);
     f32 dw = (v0.w - v1.w);
     return (float)(sqrt(dx * dx + dy * dy + dz * dz + dw * dw));
+#endif
 }
 
 /*================================================================================
@@ -598,7 +2089,51 @@ mat4 mat4_elem(const float* elements)
 oslo_inline mat4 
 mat4_mul(mat4 m0, mat4 m1)
 {
-    mat4 m_res = mat4_ctor(); 
+    mat4 m_res;
+#if defined(OSLO_MATH_AVX)
+    // Two result columns per iteration, each lane pair broadcasts one column of m1
+    __m256 c0 = _mm256_broadcast_ps((const __m128*)&m0.elements[0]);
+    __m256 c1 = _mm256_broadcast_ps((const __m128*)&m0.elements[4]);
+    __m256 c2 = _mm256_broadcast_ps((const __m128*)&m0.elements[8]);
+    __m256 c3 = _mm256_broadcast_ps((const __m128*)&m0.elements[12]);
+    for (u32 y = 0; y < 4; y += 2)
+    {
+        __m256 b = _mm256_loadu_ps(&m1.elements[y * 4]);
+        __m256 r = _mm256_mul_ps(c0, _mm256_shuffle_ps(b, b, 0x00));
+        r = _mm256_add_ps(r, _mm256_mul_ps(c1, _mm256_shuffle_ps(b, b, 0x55)));
+        r = _mm256_add_ps(r, _mm256_mul_ps(c2, _mm256_shuffle_ps(b, b, 0xAA)));
+        r = _mm256_add_ps(r, _mm256_mul_ps(c3, _mm256_shuffle_ps(b, b, 0xFF)));
+        _mm256_storeu_ps(&m_res.elements[y * 4], r);
+    }
+#elif defined(OSLO_MATH_SSE2)
+    __m128 c0 = _mm_loadu_ps(&m0.elements[0]);
+    __m128 c1 = _mm_loadu_ps(&m0.elements[4]);
+    __m128 c2 = _mm_loadu_ps(&m0.elements[8]);
+    __m128 c3 = _mm_loadu_ps(&m0.elements[12]);
+    for (u32 y = 0; y < 4; ++y)
+    {
+        const float* b = &m1.elements[y * 4];
+        __m128 r = _mm_mul_ps(c0, _mm_set1_ps(b[0]));
+        r = _mm_add_ps(r, _mm_mul_ps(c1, _mm_set1_ps(b[1])));
+        r = _mm_add_ps(r, _mm_mul_ps(c2, _mm_set1_ps(b[2])));
+        r = _mm_add_ps(r, _mm_mul_ps(c3, _mm_set1_ps(b[3])));
+        _mm_storeu_ps(&m_res.elements[y * 4], r);
+    }
+#elif defined(OSLO_MATH_NEON)
+    float32x4_t c0 = vld1q_f32(&m0.elements[0]);
+    float32x4_t c1 = vld1q_f32(&m0.elements[4]);
+    float32x4_t c2 = vld1q_f32(&m0.elements[8]);
+    float32x4_t c3 = vld1q_f32(&m0.elements[12]);
+    for (u32 y = 0; y < 4; ++y)
+    {
+        const float* b = &m1.elements[y * 4];
+        float32x4_t r = vmulq_n_f32(c0, b[0]);
+        r = vmlaq_n_f32(r, c1, b[1]);
+        r = vmlaq_n_f32(r, c2, b[2]);
+        r = vmlaq_n_f32(r, c3, b[3]);
+        vst1q_f32(&m_res.elements[y * 4], r);
+    }
+#else
     for (u32 y = 0; y < 4; ++y)
     {
         for (u32 x = 0; x < 4; ++x)
@@ -611,6 +2146,7 @@ mat4_mul(mat4 m0, mat4 m1)
             m_res.elements[x + y * 4] = sum;
         }
     }
+#endif
 
     return m_res;
 }
@@ -1013,6 +2549,23 @@ mat4 mat4_recompose(const float* translation, const float* rotation, const float
 oslo_inline
 vec4 mat4_mul_vec4(mat4 m, vec4 v)
 {
+#if defined(OSLO_MATH_SSE2)
+    vec4 res;
+    __m128 r = _mm_mul_ps(_mm_loadu_ps(&m.elements[0]), _mm_set1_ps(v.x));
+    r = _mm_add_ps(r, _mm_mul_ps(_mm_loadu_ps(&m.elements[4]), _mm_set1_ps(v.y)));
+    r = _mm_add_ps(r, _mm_mul_ps(_mm_loadu_ps(&m.elements[8]), _mm_set1_ps(v.z)));
+    r = _mm_add_ps(r, _mm_mul_ps(_mm_loadu_ps(&m.elements[12]), _mm_set1_ps(v.w)));
+    _mm_storeu_ps(res.xyzw, r);
+    return res;
+#elif defined(OSLO_MATH_NEON)
+    vec4 res;
+    float32x4_t r = vmulq_n_f32(vld1q_f32(&m.elements[0]), v.x);
+    r = vmlaq_n_f32(r, vld1q_f32(&m.elements[4]), v.y);
+    r = vmlaq_n_f32(r, vld1q_f32(&m.elements[8]), v.z);
+    r = vmlaq_n_f32(r, vld1q_f32(&m.elements[12]), v.w);
+    vst1q_f32(res.xyzw, r);
+    return res;
+#else
     return vec4_ctor
     (
         m.elements[0 + 4 * 0] * v.x + m.elements[0 + 4 * 1] * v.y + m.elements[0 + 4 * 2] * v.z + m.elements[0 + 4 * 3] * v.w,  
@@ -1020,6 +2573,7 @@ vec4 mat4_mul_vec4(mat4 m, vec4 v)
         m.elements[2 + 4 * 0] * v.x + m.elements[2 + 4 * 1] * v.y + m.elements[2 + 4 * 2] * v.z + m.elements[2 + 4 * 3] * v.w,  
         m.elements[3 + 4 * 0] * v.x + m.elements[3 + 4 * 1] * v.y + m.elements[3 + 4 * 2] * v.z + m.elements[3 + 4 * 3] * v.w
     );
+#endif
 }
 
 oslo_inline
@@ -1035,6 +2589,180 @@ vec3 mat4_mul_vec3(mat4 m, vec3 v)
     // );
 }
 
+/*================================================================================
+// Transform2D
+================================================================================*/
+
+/*
+    2x3 affine matrix for 2D work, stored column-major like mat4:
+        | a  c  tx |
+        | b  d  ty |
+    Composition follows mat4, transform2d_mul(t0, t1) applies t1 first.
+*/
+
+typedef struct
+{
+    union
+    {
+        f32 elements[6];
+        struct
+        {
+            f32 a, b, c, d, tx, ty;
+        };
+    };
+} oslo_transform2d_t;
+
+typedef oslo_transform2d_t oslo_transform2d;
+
+oslo_inline oslo_transform2d
+transform2d_ctor(f32 a, f32 b, f32 c, f32 d, f32 tx, f32 ty)
+{
+    oslo_transform2d t;
+    t.a = a;
+    t.b = b;
+    t.c = c;
+    t.d = d;
+    t.tx = tx;
+    t.ty = ty;
+    return t;
+}
+
+oslo_inline oslo_transform2d
+transform2d_identity()
+{
+    return transform2d_ctor(1.f, 0.f, 0.f, 1.f, 0.f, 0.f);
+}
+
+oslo_inline oslo_transform2d
+transform2d_translate(f32 x, f32 y)
+{
+    return transform2d_ctor(1.f, 0.f, 0.f, 1.f, x, y);
+}
+
+oslo_inline oslo_transform2d
+transform2d_rotate(f32 rad)
+{
+    f32 c = (f32)cos(rad);
+    f32 s = (f32)sin(rad);
+    return transform2d_ctor(c, s, -s, c, 0.f, 0.f);
+}
+
+oslo_inline oslo_transform2d
+transform2d_scale(f32 x, f32 y)
+{
+    return transform2d_ctor(x, 0.f, 0.f, y, 0.f, 0.f);
+}
+
+// Scale, then rotate, then translate
+oslo_inline oslo_transform2d
+transform2d_trs(vec2 translation, f32 rad, vec2 scale)
+{
+    f32 c = (f32)cos(rad);
+    f32 s = (f32)sin(rad);
+    return transform2d_ctor(c * scale.x, s * scale.x, -s * scale.y, c * scale.y, translation.x, translation.y);
+}
+
+oslo_inline oslo_transform2d
+transform2d_mul(oslo_transform2d t0, oslo_transform2d t1)
+{
+    return transform2d_ctor
+    (
+        t0.a * t1.a + t0.c * t1.b,
+        t0.b * t1.a + t0.d * t1.b,
+        t0.a * t1.c + t0.c * t1.d,
+        t0.b * t1.c + t0.d * t1.d,
+        t0.a * t1.tx + t0.c * t1.ty + t0.tx,
+        t0.b * t1.tx + t0.d * t1.ty + t0.ty
+    );
+}
+
+// Returns identity when the matrix is singular
+oslo_inline oslo_transform2d
+transform2d_inverse(oslo_transform2d t)
+{
+    f32 det = t.a * t.d - t.b * t.c;
+    if (fabsf(det) < EPSILON) return transform2d_identity();
+
+    f32 inv = 1.f / det;
+    f32 a = t.d * inv;
+    f32 b = -t.b * inv;
+    f32 c = -t.c * inv;
+    f32 d = t.a * inv;
+    return transform2d_ctor(a, b, c, d, -(a * t.tx + c * t.ty), -(b * t.tx + d * t.ty));
+}
+
+oslo_inline vec2
+transform2d_apply(oslo_transform2d t, vec2 p)
+{
+    return vec2_ctor(t.a * p.x + t.c * p.y + t.tx, t.b * p.x + t.d * p.y + t.ty);
+}
+
+// Ignores the translation, for directions and offsets
+oslo_inline vec2
+transform2d_apply_vector(oslo_transform2d t, vec2 v)
+{
+    return vec2_ctor(t.a * v.x + t.c * v.y, t.b * v.x + t.d * v.y);
+}
+
+// Transforms n points, in and out may be the same array
+oslo_inline void
+transform2d_apply_n(const oslo_transform2d* t, const vec2* in, vec2* out, size_t n)
+{
+    size_t i = 0;
+#if defined(OSLO_MATH_AVX)
+    // Four points per iteration, lanes hold x0 y0 x1 y1 ...
+    __m256 ab = _mm256_setr_ps(t->a, t->b, t->a, t->b, t->a, t->b, t->a, t->b);
+    __m256 cd = _mm256_setr_ps(t->c, t->d, t->c, t->d, t->c, t->d, t->c, t->d);
+    __m256 tr = _mm256_setr_ps(t->tx, t->ty, t->tx, t->ty, t->tx, t->ty, t->tx, t->ty);
+    for (; i + 4 <= n; i += 4)
+    {
+        __m256 p = _mm256_loadu_ps(&in[i].x);
+        __m256 xx = _mm256_shuffle_ps(p, p, _MM_SHUFFLE(2, 2, 0, 0));
+        __m256 yy = _mm256_shuffle_ps(p, p, _MM_SHUFFLE(3, 3, 1, 1));
+        _mm256_storeu_ps(&out[i].x, _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(ab, xx), _mm256_mul_ps(cd, yy)), tr));
+    }
+#endif
+#if defined(OSLO_MATH_SSE2)
+    __m128 ab4 = _mm_setr_ps(t->a, t->b, t->a, t->b);
+    __m128 cd4 = _mm_setr_ps(t->c, t->d, t->c, t->d);
+    __m128 tr4 = _mm_setr_ps(t->tx, t->ty, t->tx, t->ty);
+    for (; i + 2 <= n; i += 2)
+    {
+        __m128 p = _mm_loadu_ps(&in[i].x);
+        __m128 xx = _mm_shuffle_ps(p, p, _MM_SHUFFLE(2, 2, 0, 0));
+        __m128 yy = _mm_shuffle_ps(p, p, _MM_SHUFFLE(3, 3, 1, 1));
+        _mm_storeu_ps(&out[i].x, _mm_add_ps(_mm_add_ps(_mm_mul_ps(ab4, xx), _mm_mul_ps(cd4, yy)), tr4));
+    }
+#elif defined(OSLO_MATH_NEON)
+    // Deinterleaving loads give four x and four y
+    for (; i + 4 <= n; i += 4)
+    {
+        float32x4x2_t p = vld2q_f32(&in[i].x);
+        float32x4x2_t r;
+        r.val[0] = vmlaq_n_f32(vmlaq_n_f32(vdupq_n_f32(t->tx), p.val[0], t->a), p.val[1], t->c);
+        r.val[1] = vmlaq_n_f32(vmlaq_n_f32(vdupq_n_f32(t->ty), p.val[0], t->b), p.val[1], t->d);
+        vst2q_f32(&out[i].x, r);
+    }
+#endif
+    for (; i < n; ++i)
+    {
+        out[i] = transform2d_apply(*t, in[i]);
+    }
+}
+
+oslo_inline mat4
+transform2d_to_mat4(oslo_transform2d t)
+{
+    mat4 m = mat4_identity();
+    m.elements[0 + 0 * 4] = t.a;
+    m.elements[1 + 0 * 4] = t.b;
+    m.elements[0 + 1 * 4] = t.c;
+    m.elements[1 + 1 * 4] = t.d;
+    m.elements[0 + 3 * 4] = t.tx;
+    m.elements[1 + 3 * 4] = t.ty;
+    return m;
+}
+
 /*================================================================================
 // Quaternion
 ================================================================================*/
@@ -1086,24 +2814,44 @@ quat quat_ctor(f32 _x, f32 _y, f32 _z, f32 _w)
 oslo_inline quat 
 quat_add(quat q0, quat q1) 
 {
-    return quat_ctor(q0.x + q1.x, q0.y + q1.y, q0.z + q1.z, q0.w + q1.w);
+    quat q;
+    q.v = vec4_add(q0.v, q1.v);
+    return q;
 }
 
 oslo_inline quat 
 quat_sub(quat q0, quat q1)
 {
-    return quat_ctor(q0.x - q1.x, q0.y - q1.y, q0.z - q1.z, q0.w - q1.w);
+    quat q;
+    q.v = vec4_sub(q0.v, q1.v);
+    return q;
 }
 
 oslo_inline quat
 quat_mul(quat q0, quat q1)
 {
+#if defined(OSLO_MATH_SSE2)
+    // w0 * q1 + q0.xyzx * q1.wwwx + q0.yzxy * q1.zxyy - q0.zxyz * q1.yzxz, with w's middle terms negated
+    __m128 a = _mm_loadu_ps(q0.xyzw);
+    __m128 b = _mm_loadu_ps(q1.xyzw);
+    __m128 sign_w = _mm_castsi128_ps(_mm_set_epi32((int)0x80000000, 0, 0, 0));
+    __m128 r = _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 3, 3, 3)), b);
+    __m128 t0 = _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(0, 2, 1, 0)), _mm_shuffle_ps(b, b, _MM_SHUFFLE(0, 3, 3, 3)));
+    __m128 t1 = _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(1, 0, 2, 1)), _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 1, 0, 2)));
+    __m128 t2 = _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 1, 0, 2)), _mm_shuffle_ps(b, b, _MM_SHUFFLE(2, 0, 2, 1)));
+    r = _mm_add_ps(r, _mm_xor_ps(_mm_add_ps(t0, t1), sign_w));
+    r = _mm_sub_ps(r, t2);
+    quat q;
+    _mm_storeu_ps(q.xyzw, r);
+    return q;
+#else
     return quat_ctor(
         q0.w * q1.x + q1.w * q0.x + q0.y * q1.z - q1.y * q0.z,
         q0.w * q1.y + q1.w * q0.y + q0.z * q1.x - q1.z * q0.x,
         q0.w * q1.z + q1.w * q0.z + q0.x * q1.y - q1.x * q0.y,
         q0.w * q1.w - q0.x * q1.x - q0.y * q1.y - q0.z * q1.z
     );
+#endif
 }
 
 oslo_inline 
@@ -1123,24 +2871,21 @@ quat quat_mul_list(u32 count, ...)
 oslo_inline quat 
 quat_mul_quat(quat q0, quat q1)
 {
-    return quat_ctor(
-        q0.w * q1.x + q1.w * q0.x + q0.y * q1.z - q1.y * q0.z,
-        q0.w * q1.y + q1.w * q0.y + q0.z * q1.x - q1.z * q0.x,
-        q0.w * q1.z + q1.w * q0.z + q0.x * q1.y - q1.x * q0.y,
-        q0.w * q1.w - q0.x * q1.x - q0.y * q1.y - q0.z * q1.z
-    );
+    return quat_mul(q0, q1);
 }
 
 oslo_inline 
 quat quat_scale(quat q, f32 s)
 {
-    return quat_ctor(q.x * s, q.y * s, q.z * s, q.w * s);
+    quat r;
+    r.v = vec4_scale(q.v, s);
+    return r;
 }
 
 oslo_inline f32 
 quat_dot(quat q0, quat q1)
 {
-    return (f32)(q0.x * q1.x + q0.y * q1.y + q0.z * q1.z + q0.w * q1.w);
+    return vec4_dot(q0.v, q1.v);
 }
 
 oslo_inline 
@@ -1410,4 +3155,385 @@ oslo_inline
 vec3 quat_to_euler(quat* q)
 {
     return v3(quat_yaw(q), quat_pitch(q), quat_roll(q));
-}
\ No newline at end of file
+}
+
+/*================================================================================
+// Noise
+================================================================================*/
+
+/*
+    Simplex (Perlin 2001, layout after Gustavson) and value noise in 2D and 3D, roughly in [-1, 1].
+    Lattice points are hashed with the seed instead of looked up in a permutation table, so the
+    kernels run on OSLO_MATH_WIDE_WIDTH points at once. Single points go through the same kernels,
+    oslo_noise_fill_grid* results match point queries within float rounding.
+*/
+
+typedef enum oslo_noise_type
+{
+    OSLO_NOISE_SIMPLEX,
+    OSLO_NOISE_VALUE
+} oslo_noise_type;
+
+// Fractal (fBm) settings, zeroed fields use the defaults in brackets
+typedef struct oslo_noise_desc_t
+{
+    oslo_noise_type type;
+    u32 seed;
+    // Lattice cells per unit [1]
+    f32 frequency;
+    // Layers summed, octave n has frequency * lacunarity^n and weight gain^n [1]
+    u32 octaves;
+    f32 lacunarity; // [2]
+    f32 gain;       // [0.5]
+} oslo_noise_desc_t;
+
+typedef oslo_noise_desc_t oslo_noise_desc;
+
+#define __OSLO_NOISE_F2         0.36602540378f  // (sqrt(3) - 1) / 2
+#define __OSLO_NOISE_G2         0.21132486540f  // (3 - sqrt(3)) / 6
+#define __OSLO_NOISE_F3         0.33333333333f
+#define __OSLO_NOISE_G3         0.16666666667f
+// Measured peaks of the raw sums are about 0.011 (2D) and 0.031 (3D)
+#define __OSLO_NOISE_SIMPLEX2_SCALE     90.f
+#define __OSLO_NOISE_SIMPLEX3_SCALE     32.f
+
+oslo_inline __oslo_wide_u32
+__oslo_noise_hash2(__oslo_wide_u32 seed, __oslo_wide_u32 i, __oslo_wide_u32 j)
+{
+    __oslo_wide_u32 h = __oslo_wide_xor(__oslo_wide_mul(i, __oslo_wide_seti(0x9E3779B1u)), __oslo_wide_mul(j, __oslo_wide_seti(0x85EBCA77u)));
+    h = __oslo_wide_xor(h, seed);
+    h = __oslo_wide_mul(__oslo_wide_xor(h, __oslo_wide_shr(h, 15)), __oslo_wide_seti(0x2C1B3C6Du));
+    return __oslo_wide_xor(h, __oslo_wide_shr(h, 12));
+}
+
+oslo_inline __oslo_wide_u32
+__oslo_noise_hash3(__oslo_wide_u32 seed, __oslo_wide_u32 i, __oslo_wide_u32 j, __oslo_wide_u32 k)
+{
+    return __oslo_noise_hash2(__oslo_wide_xor(seed, __oslo_wide_mul(k, __oslo_wide_seti(0xC2B2AE3Du))), i, j);
+}
+
+// Flips the sign of a where bit 31 of bits is set
+#define __oslo_noise_flip(__A, __BITS)\
+    __oslo_wide_castf(__oslo_wide_xor(__oslo_wide_casti(__A), __oslo_wide_and((__BITS), __oslo_wide_seti(0x80000000u))))
+
+// Hash to [-1, 1)
+#define __oslo_noise_unit(__H)\
+    __oslo_wide_subf(__oslo_wide_mulf(__oslo_wide_cvtf(__oslo_wide_shr((__H), 8)), __oslo_wide_setf(2.f / 16777216.f)), __oslo_wide_setf(1.f))
+
+// 8 gradients (+-1, +-0.5) and (+-0.5, +-1), bit 2 swaps the axes, bits 0 and 1 pick the signs
+oslo_inline __oslo_wide_f32
+__oslo_noise_grad2(__oslo_wide_u32 h, __oslo_wide_f32 x, __oslo_wide_f32 y)
+{
+    __oslo_wide_u32 swap = __oslo_wide_cmpeq(__oslo_wide_and(h, __oslo_wide_seti(4)), __oslo_wide_seti(4));
+    __oslo_wide_f32 u = __oslo_wide_select(swap, y, x);
+    __oslo_wide_f32 v = __oslo_wide_select(swap, x, y);
+    u = __oslo_noise_flip(u, __oslo_wide_shl(h, 31));
+    v = __oslo_noise_flip(v, __oslo_wide_shl(h, 30));
+    return __oslo_wide_addf(u, __oslo_wide_mulf(v, __oslo_wide_setf(0.5f)));
+}
+
+// The 12 cube edge directions (Perlin's improved noise), from the low 4 bits
+oslo_inline __oslo_wide_f32
+__oslo_noise_grad3(__oslo_wide_u32 h, __oslo_wide_f32 x, __oslo_wide_f32 y, __oslo_wide_f32 z)
+{
+    __oslo_wide_u32 zero = __oslo_wide_seti(0);
+    __oslo_wide_u32 lt8 = __oslo_wide_cmpeq(__oslo_wide_and(h, __oslo_wide_seti(8)), zero);
+    __oslo_wide_u32 lt4 = __oslo_wide_cmpeq(__oslo_wide_and(h, __oslo_wide_seti(12)), zero);
+    __oslo_wide_u32 use_x = __oslo_wide_cmpeq(__oslo_wide_and(h, __oslo_wide_seti(13)), __oslo_wide_seti(12));
+    __oslo_wide_f32 u = __oslo_wide_select(lt8, x, y);
+    __oslo_wide_f32 v = __oslo_wide_select(lt4, y, __oslo_wide_select(use_x, x, z));
+    u = __oslo_noise_flip(u, __oslo_wide_shl(h, 31));
+    v = __oslo_noise_flip(v, __oslo_wide_shl(h, 30));
+    return __oslo_wide_addf(u, v);
+}
+
+// Falloff (r - d^2)^4 times the gradient ramp of one simplex corner
+oslo_inline __oslo_wide_f32
+__oslo_noise_corner2(__oslo_wide_u32 h, __oslo_wide_f32 x, __oslo_wide_f32 y)
+{
+    __oslo_wide_f32 t = __oslo_wide_subf(__oslo_wide_subf(__oslo_wide_setf(0.5f), __oslo_wide_mulf(x, x)), __oslo_wide_mulf(y, y));
+    t = __oslo_wide_maxf(t, __oslo_wide_setf(0.f));
+    t = __oslo_wide_mulf(t, t);
+    return __oslo_wide_mulf(__oslo_wide_mulf(t, t), __oslo_noise_grad2(h, x, y));
+}
+
+oslo_inline __oslo_wide_f32
+__oslo_noise_corner3(__oslo_wide_u32 h, __oslo_wide_f32 x, __oslo_wide_f32 y, __oslo_wide_f32 z)
+{
+    __oslo_wide_f32 t = __oslo_wide_subf(__oslo_wide_subf(__oslo_wide_subf(__oslo_wide_setf(0.6f), __oslo_wide_mulf(x, x)), __oslo_wide_mulf(y, y)), __oslo_wide_mulf(z, z));
+    t = __oslo_wide_maxf(t, __oslo_wide_setf(0.f));
+    t = __oslo_wide_mulf(t, t);
+    return __oslo_wide_mulf(__oslo_wide_mulf(t, t), __oslo_noise_grad3(h, x, y, z));
+}
+
+oslo_inline __oslo_wide_f32
+__oslo_noise_simplex2_wide(__oslo_wide_f32 x, __oslo_wide_f32 y, __oslo_wide_u32 seed)
+{
+    __oslo_wide_u32 one = __oslo_wide_seti(1);
+
+    // Skew to the square lattice to find the cell, unskew back for the offsets
+    __oslo_wide_f32 s = __oslo_wide_mulf(__oslo_wide_addf(x, y), __oslo_wide_setf(__OSLO_NOISE_F2));
+    __oslo_wide_u32 i = __oslo_wide_floori(__oslo_wide_addf(x, s));
+    __oslo_wide_u32 j = __oslo_wide_floori(__oslo_wide_addf(y, s));
+    __oslo_wide_f32 fi = __oslo_wide_cvtf(i);
+    __oslo_wide_f32 fj = __oslo_wide_cvtf(j);
+    __oslo_wide_f32 t = __oslo_wide_mulf(__oslo_wide_addf(fi, fj), __oslo_wide_setf(__OSLO_NOISE_G2));
+    __oslo_wide_f32 x0 = __oslo_wide_subf(x, __oslo_wide_subf(fi, t));
+    __oslo_wide_f32 y0 = __oslo_wide_subf(y, __oslo_wide_subf(fj, t));
+
+    // Lower or upper triangle of the cell
+    __oslo_wide_u32 lower = __oslo_wide_cmpgef(x0, y0);
+    __oslo_wide_u32 i1 = __oslo_wide_and(lower, one);
+    __oslo_wide_u32 j1 = __oslo_wide_xor(i1, one);
+
+    __oslo_wide_f32 x1 = __oslo_wide_addf(__oslo_wide_subf(x0, __oslo_wide_cvtf(i1)), __oslo_wide_setf(__OSLO_NOISE_G2));
+    __oslo_wide_f32 y1 = __oslo_wide_addf(__oslo_wide_subf(y0, __oslo_wide_cvtf(j1)), __oslo_wide_setf(__OSLO_NOISE_G2));
+    __oslo_wide_f32 x2 = __oslo_wide_addf(x0, __oslo_wide_setf(2.f * __OSLO_NOISE_G2 - 1.f));
+    __oslo_wide_f32 y2 = __oslo_wide_addf(y0, __oslo_wide_setf(2.f * __OSLO_NOISE_G2 - 1.f));
+
+    __oslo_wide_f32 n = __oslo_noise_corner2(__oslo_noise_hash2(seed, i, j), x0, y0);
+    n = __oslo_wide_addf(n, __oslo_noise_corner2(__oslo_noise_hash2(seed, __oslo_wide_add(i, i1), __oslo_wide_add(j, j1)), x1, y1));
+    n = __oslo_wide_addf(n, __oslo_noise_corner2(__oslo_noise_hash2(seed, __oslo_wide_add(i, one), __oslo_wide_add(j, one)), x2, y2));
+    return __oslo_wide_mulf(n, __oslo_wide_setf(__OSLO_NOISE_SIMPLEX2_SCALE));
+}
+
+oslo_inline __oslo_wide_f32
+__oslo_noise_simplex3_wide(__oslo_wide_f32 x, __oslo_wide_f32 y, __oslo_wide_f32 z, __oslo_wide_u32 seed)
+{
+    __oslo_wide_u32 one = __oslo_wide_seti(1);
+
+    __oslo_wide_f32 s = __oslo_wide_mulf(__oslo_wide_addf(__oslo_wide_addf(x, y), z), __oslo_wide_setf(__OSLO_NOISE_F3));
+    __oslo_wide_u32 i = __oslo_wide_floori(__oslo_wide_addf(x, s));
+    __oslo_wide_u32 j = __oslo_wide_floori(__oslo_wide_addf(y, s));
+    __oslo_wide_u32 k = __oslo_wide_floori(__oslo_wide_addf(z, s));
+    __oslo_wide_f32 fi = __oslo_wide_cvtf(i);
+    __oslo_wide_f32 fj = __oslo_wide_cvtf(j);
+    __oslo_wide_f32 fk = __oslo_wide_cvtf(k);
+    __oslo_wide_f32 t = __oslo_wide_mulf(__oslo_wide_addf(__oslo_wide_addf(fi, fj), fk), __oslo_wide_setf(__OSLO_NOISE_G3));
+    __oslo_wide_f32 x0 = __oslo_wide_subf(x, __oslo_wide_subf(fi, t));
+    __oslo_wide_f32 y0 = __oslo_wide_subf(y, __oslo_wide_subf(fj, t));
+    __oslo_wide_f32 z0 = __oslo_wide_subf(z, __oslo_wide_subf(fk, t));
+
+    // Which of the six tetrahedra, from the order of x0, y0 and z0
+    __oslo_wide_u32 xy = __oslo_wide_and(__oslo_wide_cmpgef(x0, y0), one);
+    __oslo_wide_u32 yz = __oslo_wide_and(__oslo_wide_cmpgef(y0, z0), one);
+    __oslo_wide_u32 xz = __oslo_wide_and(__oslo_wide_cmpgef(x0, z0), one);
+    __oslo_wide_u32 i1 = __oslo_wide_and(xy, xz);
+    __oslo_wide_u32 j1 = __oslo_wide_and(__oslo_wide_xor(xy, one), yz);
+    __oslo_wide_u32 k1 = __oslo_wide_and(__oslo_wide_xor(xz, one), __oslo_wide_xor(yz, one));
+    __oslo_wide_u32 i2 = __oslo_wide_or(xy, xz);
+    __oslo_wide_u32 j2 = __oslo_wide_or(__oslo_wide_xor(xy, one), yz);
+    __oslo_wide_u32 k2 = __oslo_wide_xor(__oslo_wide_and(xz, yz), one);
+
+    __oslo_wide_f32 g3 = __oslo_wide_setf(__OSLO_NOISE_G3);
+    __oslo_wide_f32 x1 = __oslo_wide_addf(__oslo_wide_subf(x0, __oslo_wide_cvtf(i1)), g3);
+    __oslo_wide_f32 y1 = __oslo_wide_addf(__oslo_wide_subf(y0, __oslo_wide_cvtf(j1)), g3);
+    __oslo_wide_f32 z1 = __oslo_wide_addf(__oslo_wide_subf(z0, __oslo_wide_cvtf(k1)), g3);
+    __oslo_wide_f32 g3_2 = __oslo_wide_setf(2.f * __OSLO_NOISE_G3);
+    __oslo_wide_f32 x2 = __oslo_wide_addf(__oslo_wide_subf(x0, __oslo_wide_cvtf(i2)), g3_2);
+    __oslo_wide_f32 y2 = __oslo_wide_addf(__oslo_wide_subf(y0, __oslo_wide_cvtf(j2)), g3_2);
+    __oslo_wide_f32 z2 = __oslo_wide_addf(__oslo_wide_subf(z0, __oslo_wide_cvtf(k2)), g3_2);
+    __oslo_wide_f32 g3_3 = __oslo_wide_setf(3.f * __OSLO_NOISE_G3 - 1.f);
+    __oslo_wide_f32 x3 = __oslo_wide_addf(x0, g3_3);
+    __oslo_wide_f32 y3 = __oslo_wide_addf(y0, g3_3);
+    __oslo_wide_f32 z3 = __oslo_wide_addf(z0, g3_3);
+
+    __oslo_wide_f32 n = __oslo_noise_corner3(__oslo_noise_hash3(seed, i, j, k), x0, y0, z0);
+    n = __oslo_wide_addf(n, __oslo_noise_corner3(__oslo_noise_hash3(seed, __oslo_wide_add(i, i1), __oslo_wide_add(j, j1), __oslo_wide_add(k, k1)), x1, y1, z1));
+    n = __oslo_wide_addf(n, __oslo_noise_corner3(__oslo_noise_hash3(seed, __oslo_wide_add(i, i2), __oslo_wide_add(j, j2), __oslo_wide_add(k, k2)), x2, y2, z2));
+    n = __oslo_wide_addf(n, __oslo_noise_corner3(__oslo_noise_hash3(seed, __oslo_wide_add(i, one), __oslo_wide_add(j, one), __oslo_wide_add(k, one)), x3, y3, z3));
+    return __oslo_wide_mulf(n, __oslo_wide_setf(__OSLO_NOISE_SIMPLEX3_SCALE));
+}
+
+// Quintic fade 6t^5 - 15t^4 + 10t^3, C2 continuous across cells
+oslo_inline __oslo_wide_f32
+__oslo_noise_fade(__oslo_wide_f32 t)
+{
+    __oslo_wide_f32 p = __oslo_wide_addf(__oslo_wide_mulf(t, __oslo_wide_setf(6.f)), __oslo_wide_setf(-15.f));
+    p = __oslo_wide_addf(__oslo_wide_mulf(t, p), __oslo_wide_setf(10.f));
+    return __oslo_wide_mulf(__oslo_wide_mulf(__oslo_wide_mulf(t, t), t), p);
+}
+
+oslo_inline __oslo_wide_f32
+__oslo_noise_lerp(__oslo_wide_f32 a, __oslo_wide_f32 b, __oslo_wide_f32 t)
+{
+    return __oslo_wide_addf(a, __oslo_wide_mulf(__oslo_wide_subf(b, a), t));
+}
+
+oslo_inline __oslo_wide_f32
+__oslo_noise_value2_wide(__oslo_wide_f32 x, __oslo_wide_f32 y, __oslo_wide_u32 seed)
+{
+    __oslo_wide_u32 one = __oslo_wide_seti(1);
+    __oslo_wide_u32 i = __oslo_wide_floori(x);
+    __oslo_wide_u32 j = __oslo_wide_floori(y);
+    __oslo_wide_f32 u = __oslo_noise_fade(__oslo_wide_subf(x, __oslo_wide_cvtf(i)));
+    __oslo_wide_f32 v = __oslo_noise_fade(__oslo_wide_subf(y, __oslo_wide_cvtf(j)));
+    __oslo_wide_u32 i1 = __oslo_wide_add(i, one);
+    __oslo_wide_u32 j1 = __oslo_wide_add(j, one);
+
+    __oslo_wide_f32 a = __oslo_noise_lerp(__oslo_noise_unit(__oslo_noise_hash2(seed, i, j)), __oslo_noise_unit(__oslo_noise_hash2(seed, i1, j)), u);
+    __oslo_wide_f32 b = __oslo_noise_lerp(__oslo_noise_unit(__oslo_noise_hash2(seed, i, j1)), __oslo_noise_unit(__oslo_noise_hash2(seed, i1, j1)), u);
+    return __oslo_noise_lerp(a, b, v);
+}
+
+oslo_inline __oslo_wide_f32
+__oslo_noise_value3_wide(__oslo_wide_f32 x, __oslo_wide_f32 y, __oslo_wide_f32 z, __oslo_wide_u32 seed)
+{
+    __oslo_wide_u32 one = __oslo_wide_seti(1);
+    __oslo_wide_u32 i = __oslo_wide_floori(x);
+    __oslo_wide_u32 j = __oslo_wide_floori(y);
+    __oslo_wide_u32 k = __oslo_wide_floori(z);
+    __oslo_wide_f32 u = __oslo_noise_fade(__oslo_wide_subf(x, __oslo_wide_cvtf(i)));
+    __oslo_wide_f32 v = __oslo_noise_fade(__oslo_wide_subf(y, __oslo_wide_cvtf(j)));
+    __oslo_wide_f32 w = __oslo_noise_fade(__oslo_wide_subf(z, __oslo_wide_cvtf(k)));
+    __oslo_wide_u32 i1 = __oslo_wide_add(i, one);
+    __oslo_wide_u32 j1 = __oslo_wide_add(j, one);
+    __oslo_wide_u32 k1 = __oslo_wide_add(k, one);
+
+    __oslo_wide_f32 a = __oslo_noise_lerp(__oslo_noise_unit(__oslo_noise_hash3(seed, i, j, k)), __oslo_noise_unit(__oslo_noise_hash3(seed, i1, j, k)), u);
+    __oslo_wide_f32 b = __oslo_noise_lerp(__oslo_noise_unit(__oslo_noise_hash3(seed, i, j1, k)), __oslo_noise_unit(__oslo_noise_hash3(seed, i1, j1, k)), u);
+    __oslo_wide_f32 c = __oslo_noise_lerp(__oslo_noise_unit(__oslo_noise_hash3(seed, i, j, k1)), __oslo_noise_unit(__oslo_noise_hash3(seed, i1, j, k1)), u);
+    __oslo_wide_f32 d = __oslo_noise_lerp(__oslo_noise_unit(__oslo_noise_hash3(seed, i, j1, k1)), __oslo_noise_unit(__oslo_noise_hash3(seed, i1, j1, k1)), u);
+    return __oslo_noise_lerp(__oslo_noise_lerp(a, b, v), __oslo_noise_lerp(c, d, v), w);
+}
+
+oslo_inline __oslo_wide_f32
+__oslo_noise_fbm2_wide(const oslo_noise_desc* desc, __oslo_wide_f32 x, __oslo_wide_f32 y)
+{
+    u32 octaves = desc->octaves ? desc->octaves : 1;
+    f32 frequency = desc->frequency != 0.f ? desc->frequency : 1.f;
+    f32 lacunarity = desc->lacunarity != 0.f ? desc->lacunarity : 2.f;
+    f32 gain = desc->gain != 0.f ? desc->gain : 0.5f;
+
+    __oslo_wide_f32 sum = __oslo_wide_setf(0.f);
+    f32 amplitude = 1.f;
+    f32 total = 0.f;
+    for (u32 o = 0; o < octaves; ++o)
+    {
+        __oslo_wide_f32 fx = __oslo_wide_mulf(x, __oslo_wide_setf(frequency));
+        __oslo_wide_f32 fy = __oslo_wide_mulf(y, __oslo_wide_setf(frequency));
+        // Each octave gets its own seed so the layers don't line up at the origin
+        __oslo_wide_u32 seed = __oslo_wide_seti(desc->seed + o * 0x9E3779B9u);
+        __oslo_wide_f32 n = desc->type == OSLO_NOISE_VALUE ? __oslo_noise_value2_wide(fx, fy, seed) : __oslo_noise_simplex2_wide(fx, fy, seed);
+        sum = __oslo_wide_addf(sum, __oslo_wide_mulf(n, __oslo_wide_setf(amplitude)));
+        total += amplitude;
+        amplitude *= gain;
+        frequency *= lacunarity;
+    }
+    return __oslo_wide_mulf(sum, __oslo_wide_setf(1.f / total));
+}
+
+oslo_inline __oslo_wide_f32
+__oslo_noise_fbm3_wide(const oslo_noise_desc* desc, __oslo_wide_f32 x, __oslo_wide_f32 y, __oslo_wide_f32 z)
+{
+    u32 octaves = desc->octaves ? desc->octaves : 1;
+    f32 frequency = desc->frequency != 0.f ? desc->frequency : 1.f;
+    f32 lacunarity = desc->lacunarity != 0.f ? desc->lacunarity : 2.f;
+    f32 gain = desc->gain != 0.f ? desc->gain : 0.5f;
+
+    __oslo_wide_f32 sum = __oslo_wide_setf(0.f);
+    f32 amplitude = 1.f;
+    f32 total = 0.f;
+    for (u32 o = 0; o < octaves; ++o)
+    {
+        __oslo_wide_f32 fx = __oslo_wide_mulf(x, __oslo_wide_setf(frequency));
+        __oslo_wide_f32 fy = __oslo_wide_mulf(y, __oslo_wide_setf(frequency));
+        __oslo_wide_f32 fz = __oslo_wide_mulf(z, __oslo_wide_setf(frequency));
+        __oslo_wide_u32 seed = __oslo_wide_seti(desc->seed + o * 0x9E3779B9u);
+        __oslo_wide_f32 n = desc->type == OSLO_NOISE_VALUE ? __oslo_noise_value3_wide(fx, fy, fz, seed) : __oslo_noise_simplex3_wide(fx, fy, fz, seed);
+        sum = __oslo_wide_addf(sum, __oslo_wide_mulf(n, __oslo_wide_setf(amplitude)));
+        total += amplitude;
+        amplitude *= gain;
+        frequency *= lacunarity;
+    }
+    return __oslo_wide_mulf(sum, __oslo_wide_setf(1.f / total));
+}
+
+oslo_inline f32
+oslo_noise_simplex2(f32 x, f32 y, u32 seed)
+{
+    return __oslo_wide_first(__oslo_noise_simplex2_wide(__oslo_wide_setf(x), __oslo_wide_setf(y), __oslo_wide_seti(seed)));
+}
+
+oslo_inline f32
+oslo_noise_simplex3(f32 x, f32 y, f32 z, u32 seed)
+{
+    return __oslo_wide_first(__oslo_noise_simplex3_wide(__oslo_wide_setf(x), __oslo_wide_setf(y), __oslo_wide_setf(z), __oslo_wide_seti(seed)));
+}
+
+oslo_inline f32
+oslo_noise_value2(f32 x, f32 y, u32 seed)
+{
+    return __oslo_wide_first(__oslo_noise_value2_wide(__oslo_wide_setf(x), __oslo_wide_setf(y), __oslo_wide_seti(seed)));
+}
+
+oslo_inline f32
+oslo_noise_value3(f32 x, f32 y, f32 z, u32 seed)
+{
+    return __oslo_wide_first(__oslo_noise_value3_wide(__oslo_wide_setf(x), __oslo_wide_setf(y), __oslo_wide_setf(z), __oslo_wide_seti(seed)));
+}
+
+oslo_inline f32
+oslo_noise_fbm2(const oslo_noise_desc* desc, f32 x, f32 y)
+{
+    return __oslo_wide_first(__oslo_noise_fbm2_wide(desc, __oslo_wide_setf(x), __oslo_wide_setf(y)));
+}
+
+oslo_inline f32
+oslo_noise_fbm3(const oslo_noise_desc* desc, f32 x, f32 y, f32 z)
+{
+    return __oslo_wide_first(__oslo_noise_fbm3_wide(desc, __oslo_wide_setf(x), __oslo_wide_setf(y), __oslo_wide_setf(z)));
+}
+
+static const f32 __oslo_noise_lane_offsets[8] = { 0.f, 1.f, 2.f, 3.f, 4.f, 5.f, 6.f, 7.f };
+
+// One row of width samples from (x, y) stepping step along x
+oslo_inline void
+__oslo_noise_fill_row(const oslo_noise_desc* desc, f32* out, u32 width, f32 x, f32 y, f32 z, f32 step, bool is_3d)
+{
+    __oslo_wide_f32 lanes = __oslo_wide_mulf(__oslo_wide_loadf(__oslo_noise_lane_offsets), __oslo_wide_setf(step));
+    __oslo_wide_f32 vy = __oslo_wide_setf(y);
+    __oslo_wide_f32 vz = __oslo_wide_setf(z);
+    for (u32 c = 0; c < width; c += OSLO_MATH_WIDE_WIDTH)
+    {
+        __oslo_wide_f32 vx = __oslo_wide_addf(__oslo_wide_setf(x + (f32)c * step), lanes);
+        __oslo_wide_f32 n = is_3d ? __oslo_noise_fbm3_wide(desc, vx, vy, vz) : __oslo_noise_fbm2_wide(desc, vx, vy);
+        if (c + OSLO_MATH_WIDE_WIDTH <= width)
+        {
+            __oslo_wide_storef(out + c, n);
+        }
+        else
+        {
+            f32 tail[OSLO_MATH_WIDE_WIDTH];
+            __oslo_wide_storef(tail, n);
+            for (u32 i = c; i < width; ++i)
+            {
+                out[i] = tail[i - c];
+            }
+        }
+    }
+}
+
+// Fills width * height samples row by row, sample (c, r) is at origin + (c, r) * step
+oslo_inline void
+oslo_noise_fill_grid2(const oslo_noise_desc* desc, f32* out, u32 width, u32 height, vec2 origin, f32 step)
+{
+    for (u32 r = 0; r < height; ++r)
+    {
+        __oslo_noise_fill_row(desc, out + (size_t)r * width, width, origin.x, origin.y + (f32)r * step, 0.f, step, false);
+    }
+}
+
+// Fills width * height * depth samples, slice by slice
+oslo_inline void
+oslo_noise_fill_grid3(const oslo_noise_desc* desc, f32* out, u32 width, u32 height, u32 depth, vec3 origin, f32 step)
+{
+    for (u32 s = 0; s < depth; ++s)
+    {
+        for (u32 r = 0; r < height; ++r)
+        {
+            f32* row = out + ((size_t)s * height + r) * width;
+            __oslo_noise_fill_row(desc, row, width, origin.x, origin.y + (f32)r * step, origin.z + (f32)s * step, step, true);
+        }
+    }
+}
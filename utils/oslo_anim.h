@@ -3,6 +3,8 @@
 typedef struct oslo_animation_event_t
 {
     const char* event_name;
+    // Interned event_name, filled in by oslo_animation_add_event
+    oslo_string_id event_id;
     float timepoint;
     bool triggered;
 } oslo_animation_event_t;
@@ -17,6 +19,8 @@ typedef struct oslo_animation_event_listener_t
 {
     void(*callback)(const char*, void*);
     void* user_data;
+    // Only receive this event, OSLO_STRING_ID_INVALID receives all of them
+    oslo_string_id event_id;
 } oslo_animation_event_listener_t;
 
 typedef struct oslo_animation_t
@@ -26,8 +30,8 @@ typedef struct oslo_animation_t
     oslo_dyn_array(oslo_animation_event_listener_t) event_listeners;
 
     uint32_t current_frame;
-    float time;
-    float frame_time;
+    double time;
+    double frame_time;
 
     bool is_playing;
     bool loop;
@@ -36,6 +40,11 @@ typedef struct oslo_animation_t
 OSLO_API_DECL void oslo_animation_create(oslo_animation_t* anim);
 OSLO_API_DECL void oslo_animation_destroy(oslo_animation_t* anim);
 
+// Heap animations taken from a shared pool, already created. The pointer stays valid until deleted.
+// Main thread only.
+OSLO_API_DECL oslo_animation_t* oslo_animation_new();
+OSLO_API_DECL void oslo_animation_delete(oslo_animation_t* anim);
+
 OSLO_API_DECL void oslo_animation_add_frame(oslo_animation_t* anim, oslo_animation_frame_t* frame);
 OSLO_API_DECL void oslo_animation_add_event(oslo_animation_t* anim, oslo_animation_event_t* event);
 OSLO_API_DECL void oslo_animation_add_event_listener(oslo_animation_t* anim, oslo_animation_event_listener_t* listener);
@@ -48,9 +57,16 @@ OSLO_API_DECL void oslo_animation_set_loop(oslo_animation_t* anim, bool loop);
 OSLO_API_DECL const oslo_animation_frame_t* oslo_animation_get_current_frame(oslo_animation_t* anim);
 
 OSLO_API_DECL void oslo_animation_tick(oslo_animation_t* anim);
+OSLO_API_DECL void oslo_animation_tick_delta(oslo_animation_t* anim, double dt);
 
 #ifdef OSLO_ANIM_IMPL
 
+#ifndef OSLO_ANIMATION_CHUNK_SIZE
+    #define OSLO_ANIMATION_CHUNK_SIZE 64
+#endif
+
+static oslo_pool_t __oslo_animation_pool = {0};
+
 void oslo_animation_reset_events(oslo_animation_t* anim)
 {
     for (int i = 0; i < oslo_dyn_array_size(anim->events); ++i)
@@ -65,7 +81,10 @@ void oslo_animation_notify_event(oslo_animation_t* anim, oslo_animation_event_t*
     for (int i = 0; i < oslo_dyn_array_size(anim->event_listeners); ++i)
     {
         oslo_animation_event_listener_t* listener = &anim->event_listeners[i];
-        listener->callback(e->event_name, listener->user_data);
+        if (listener->event_id == OSLO_STRING_ID_INVALID || listener->event_id == e->event_id)
+        {
+            listener->callback(e->event_name, listener->user_data);
+        }
     }
 }
 
@@ -94,6 +113,27 @@ void oslo_animation_destroy(oslo_animation_t* anim)
     }
 }
 
+oslo_animation_t* oslo_animation_new()
+{
+    if (!__oslo_animation_pool.stride)
+    {
+        oslo_pool_init(&__oslo_animation_pool, oslo_animation_t, OSLO_ANIMATION_CHUNK_SIZE);
+    }
+
+    oslo_animation_t* anim = oslo_pool_new(&__oslo_animation_pool, oslo_animation_t);
+    oslo_animation_create(anim);
+    return anim;
+}
+
+void oslo_animation_delete(oslo_animation_t* anim)
+{
+    if (anim != NULL)
+    {
+        oslo_animation_destroy(anim);
+        oslo_pool_delete(&__oslo_animation_pool, anim);
+    }
+}
+
 void oslo_animation_add_frame(oslo_animation_t* anim, oslo_animation_frame_t* frame)
 {
     oslo_dyn_array_push(anim->frames, *frame);
@@ -101,7 +141,11 @@ void oslo_animation_add_frame(oslo_animation_t* anim, oslo_animation_frame_t* fr
 
 void oslo_animation_add_event(oslo_animation_t* anim, oslo_animation_event_t* event)
 {
-    oslo_dyn_array_push(anim->events, *event);
+    // Keep the interned copy of the name so callers don't need to keep theirs alive
+    oslo_animation_event_t e = *event;
+    e.event_id = oslo_string_intern(e.event_name);
+    e.event_name = oslo_string_get(e.event_id);
+    oslo_dyn_array_push(anim->events, e);
 }
 
 void oslo_animation_add_event_listener(oslo_animation_t* anim, oslo_animation_event_listener_t* listener)
@@ -110,12 +154,16 @@ void oslo_animation_add_event_listener(oslo_animation_t* anim, oslo_animation_ev
 }
 
 void oslo_animation_tick(oslo_animation_t* anim)
+{
+    oslo_animation_tick_delta(anim, oslo_get_delta_time_f64());
+}
+
+void oslo_animation_tick_delta(oslo_animation_t* anim, double dt)
 {
     size_t num_frames = oslo_dyn_array_size(anim->frames);
     
     if (anim->is_playing && (num_frames > 0 && anim->current_frame < num_frames))
     {
-        float dt = oslo_get_delta_time();
         oslo_animation_frame_t* frame = &anim->frames[anim->current_frame];
 
         anim->time += dt;
@@ -3,6 +3,29 @@
 #define PIXELS_PER_METER 50
 #define G 9.81f
 
+// Bodies the arrays are sized for before the first grow, capacity doubles from there
+#ifndef OSLO_PHYSICS_INITIAL_BODY_CAPACITY
+    #define OSLO_PHYSICS_INITIAL_BODY_CAPACITY 256
+#endif
+
+// Pixels the AABB tree grows leaf boxes by, so bodies can move a little before a reinsert
+#ifndef OSLO_PHYSICS_TREE_MARGIN
+    #define OSLO_PHYSICS_TREE_MARGIN 4.0f
+#endif
+
+#ifndef OSLO_PHYSICS_MAX_POLYGON_VERTICES
+    #define OSLO_PHYSICS_MAX_POLYGON_VERTICES 8
+#endif
+
+/*
+    Define OSLO_PHYSICS_FIXED_POINT to integrate in Q16.16 meters (fx16), bit exact on every platform
+    for lockstep and replays as long as the inputs and dt are the same, e.g. fixed_update with a
+    constant step. The float position/velocity/acceleration are then refreshed from the fixed state
+    after every step, change them through oslo_physics_body_set_*. Limits: +-32 km, +-32k N per body.
+    Contacts are generated and solved in fx16 as well. Only the broadphase reads the float copies, and it
+    only adds and compares them, so which pairs it finds doesn't depend on how the compiler rounds.
+*/
+
 typedef enum oslo_physics_shape_type
 {
     Box2D,
@@ -16,14 +39,19 @@ typedef struct oslo_physics_circle_t
     vec2 center;
 } oslo_physics_circle_t;
 
+// Convex, vertices relative to the body position. Normals point out of each edge vertices[i] -> vertices[i + 1].
 typedef struct oslo_physics_polygon_t
 {
-    int t;
+    u32 count;
+    vec2 vertices[OSLO_PHYSICS_MAX_POLYGON_VERTICES];
+    vec2 normals[OSLO_PHYSICS_MAX_POLYGON_VERTICES];
 } oslo_physics_polygon_t;
 
+// Axis aligned, centered at the body position plus center
 typedef struct oslo_physics_box_2d_t
 {
-    int t;
+    vec2 half_size;
+    vec2 center;
 } oslo_physics_box_2d_t;
 
 typedef struct oslo_physics_shape_t
@@ -33,60 +61,414 @@ typedef struct oslo_physics_shape_t
     {
         oslo_physics_circle_t circle;
         oslo_physics_box_2d_t box;
+        oslo_physics_polygon_t polygon;
     };
 
 } oslo_physics_shape_t;
 
-typedef struct oslo_physics_body_t
+typedef struct oslo_physics_aabb_t
+{
+    vec2 min;
+    vec2 max;
+} oslo_physics_aabb_t;
+
+// Same layout as slot array handles: slot index in the low OSLO_SLOT_ARRAY_INDEX_BITS, generation above.
+// Removing a body bumps the generation, so old handles never reach the body that reuses the slot.
+typedef u32 oslo_physics_body_handle;
+
+#define OSLO_PHYSICS_INVALID_BODY oslo_slot_array_INVALID_HANDLE
+
+/*
+    Bodies are stored as parallel arrays, one entry per live body at a dense index in [0, count).
+    Removing swaps the last body into the hole, so the arrays stay packed and the integrate passes
+    run over whole SIMD registers. Dense indices move on removal, handles don't. The arrays can be
+    read directly with oslo_physics_body_index, e.g. bodies.position.x[index].
+*/
+typedef struct oslo_physics_bodies_t
 {
+    u32 count;
+    u32 capacity;
+
     // Linear motion
+    vec2_soa position;
+    vec2_soa velocity;
+    vec2_soa acceleration;
+
+    // Forces and torque, cleared every step
+    vec2_soa force;
+    float* torque;
+
+    // Mass and Moment of Inertia
+    float* mass;
+    float* inv_mass;
+
+    // Collision, bodies without a shape are skipped by the broadphase
+    oslo_physics_shape_t* shape;
+    bool* has_shape;
+    // World bounds of the shape, updated every step
+    oslo_physics_aabb_t* aabb;
+    // Two bodies collide when each one's layer bits intersect the other's mask
+    u32* layer;
+    u32* mask;
+    // Leaf in the broadphase tree, -1 when not in it
+    s32* proxy;
+
+#ifdef OSLO_PHYSICS_FIXED_POINT
+    // Meters, seconds and newtons
+    fx16* fx_position_x;
+    fx16* fx_position_y;
+    fx16* fx_velocity_x;
+    fx16* fx_velocity_y;
+    fx16* fx_force_x;
+    fx16* fx_force_y;
+    fx16* fx_mass;
+    fx16* fx_inv_mass;
+#endif
+
+    // Dense index -> handle
+    oslo_physics_body_handle* handles;
+    // Slot -> dense index, or the next free slot while the slot is unused
+    oslo_dyn_array(u32) indices;
+    oslo_dyn_array(u32) generations;
+    u32 free_head;
+} oslo_physics_bodies_t;
+
+typedef struct oslo_physics_contact_point_t
+{
+    // World position halfway between the two surfaces
     vec2 position;
-    vec2 velocity;
-    vec2 acceleration;
+    float penetration;
+    // Accumulated by the solver and carried over to the next step while the point id matches
+    float normal_impulse;
+    float tangent_impulse;
+    // Packs the features (edges, vertices) that made the point
+    u32 id;
+#ifdef OSLO_PHYSICS_FIXED_POINT
+    // What the solver works with, the float fields are copies
+    fx16 fx_penetration;
+    fx16 fx_normal_impulse;
+    fx16 fx_tangent_impulse;
+#endif
+} oslo_physics_contact_point_t;
+
+typedef struct oslo_physics_manifold_t
+{
+    oslo_physics_body_handle a;
+    oslo_physics_body_handle b;
+    // Points from a to b
+    vec2 normal;
+#ifdef OSLO_PHYSICS_FIXED_POINT
+    fx16_vec2 fx_normal;
+#endif
+    u32 point_count;
+    oslo_physics_contact_point_t points[2];
+    // Step that last found the pair touching
+    u32 step;
+} oslo_physics_manifold_t;
+
+// Bodies linked by contacts, solved on their own. Static bodies don't link islands, they can sit in several.
+typedef struct oslo_physics_island_t
+{
+    // Ranges in island_contacts and island_bodies
+    u32 contact_start;
+    u32 contact_count;
+    u32 body_start;
+    u32 body_count;
+    // Time the solver spent on the island last step
+    u64 solve_ns;
+} oslo_physics_island_t;
+
+typedef struct oslo_physics_solver_stats_t
+{
+    u32 island_count;
+    // Bodies in the largest island, it bounds how well the step spreads over the workers
+    u32 largest_island;
+    // Wall time of the whole solve and the sum of the island times, their ratio is the speed up
+    u64 solve_ns;
+    u64 island_ns;
+} oslo_physics_solver_stats_t;
+
+typedef enum oslo_physics_broadphase_type
+{
+    // Uniform grid, cheapest when bodies have similar sizes
+    OSLO_PHYSICS_BROADPHASE_GRID,
+    // Dynamic AABB tree updated incrementally, for mixed sizes
+    OSLO_PHYSICS_BROADPHASE_TREE
+} oslo_physics_broadphase_type;
 
-    // Forces and torque
-    vec2 sum_forces;
-    float sum_torque;
+typedef struct oslo_physics_pair_t
+{
+    oslo_physics_body_handle a;
+    oslo_physics_body_handle b;
+} oslo_physics_pair_t;
 
-     // Mass and Moment of Inertia
-    float mass;
-    float inv_mass;
+typedef struct oslo_physics_tree_node_t
+{
+    // Fattened by OSLO_PHYSICS_TREE_MARGIN for leaves
+    oslo_physics_aabb_t aabb;
+    // Next free node while in the free list
+    s32 parent;
+    s32 child1;
+    s32 child2;
+    // Leaves are 0, -1 for free nodes
+    s32 height;
+    // Dense index of the body for leaves, kept up to date when removals move bodies
+    u32 body;
+} oslo_physics_tree_node_t;
 
-} oslo_physics_body_t;
+typedef struct oslo_physics_tree_t
+{
+    oslo_dyn_array(oslo_physics_tree_node_t) nodes;
+    s32 root;
+    s32 free_list;
+    // Node index pairs still to visit while the tree is queried against itself
+    oslo_dyn_array(s32) stack;
+} oslo_physics_tree_t;
 
-OSLO_API_DECL void oslo_physics_body_add_force(oslo_physics_body_t* body, vec2 force);
-OSLO_API_DECL void oslo_physics_body_add_torque(oslo_physics_body_t* body, float torque);
-OSLO_API_DECL void oslo_physics_body_apply_impluse(oslo_physics_body_t* body, vec2 impulse);
+typedef struct oslo_physics_cell_entry_t
+{
+    u64 cell;
+    u32 body;
+} oslo_physics_cell_entry_t;
 
 typedef struct oslo_physics_t
 {
     oslo_dyn_array(vec2) forces;
     oslo_dyn_array(float) torques;
-    oslo_dyn_array(oslo_physics_body_t) bodies;
+    oslo_physics_bodies_t bodies;
+
+    oslo_physics_broadphase_type broadphase;
+    // Grid cell edge in pixels, 0 uses twice the average body extent of the step
+    float grid_cell_size;
+    // Bodies whose AABBs overlap and whose layers match, found by the last step. Each pair once, in no particular order.
+    oslo_dyn_array(oslo_physics_pair_t) pairs;
+
+    // Broadphase scratch, kept between steps
+    oslo_dyn_array(u32) bp_bodies;
+    oslo_dyn_array(oslo_physics_cell_entry_t) bp_cells;
+    oslo_dyn_array(oslo_physics_cell_entry_t) bp_cells_tmp;
+    oslo_physics_tree_t tree;
+
+    // Touching pairs keyed by { a, b } with a < b, pairs that stop touching are dropped at the end of the step
+    oslo_hash_table(oslo_physics_pair_t, oslo_physics_manifold_t) manifolds;
+    // Manifolds with at least one point this step, sorted by pair, valid until the next step
+    oslo_dyn_array(oslo_physics_manifold_t*) contacts;
+    oslo_dyn_array(oslo_physics_pair_t) manifold_keys;
+    u32 step;
+
+    // Contact solver, sequential impulses on the linear velocities
+    u32 velocity_iterations;
+    float friction;
+    // Fraction of the penetration past the slop (pixels) pushed out per step
+    float baumgarte;
+    float penetration_slop;
+
+    // Islands of the last step, contacts and dynamic bodies grouped by island
+    oslo_dyn_array(oslo_physics_island_t) islands;
+    oslo_dyn_array(oslo_physics_manifold_t*) island_contacts;
+    oslo_dyn_array(u32) island_bodies;
+    oslo_physics_solver_stats_t solver_stats;
+
+    // Island scratch: union find parents and island ids per dense body, and the batches handed to the workers
+    oslo_dyn_array(u32) island_parents;
+    oslo_dyn_array(u32) island_ids;
+    oslo_dyn_array(u64) island_order;
+    oslo_dyn_array(u32) island_batches;
 } oslo_physics_t;
 
 OSLO_API_DECL void oslo_physics_init(oslo_physics_t* out_physics);
 OSLO_API_DECL void oslo_physics_shutdown(oslo_physics_t* physics);
 OSLO_API_DECL void oslo_physics_update(oslo_physics_t* physics);
+OSLO_API_DECL void oslo_physics_update_delta(oslo_physics_t* physics, double dt);
 
-OSLO_API_DECL oslo_physics_body_t* oslo_physics_add_body(oslo_physics_t* physics, vec2 position, float mass);
-OSLO_API_DECL void oslo_physics_remove_body(oslo_physics_t* physics, oslo_physics_body_t* body);
+// OSLO_PHYSICS_INVALID_BODY once every slot index is taken
+OSLO_API_DECL oslo_physics_body_handle oslo_physics_add_body(oslo_physics_t* physics, vec2 position, float mass);
+// Moves the last body into the freed dense index, stale handles are ignored
+OSLO_API_DECL void oslo_physics_remove_body(oslo_physics_t* physics, oslo_physics_body_handle body);
+OSLO_API_DECL bool oslo_physics_body_valid(const oslo_physics_t* physics, oslo_physics_body_handle body);
+// Dense index into the body arrays, UINT32_MAX for stale handles. Valid until the next removal.
+OSLO_API_DECL u32 oslo_physics_body_index(const oslo_physics_t* physics, oslo_physics_body_handle body);
 
 OSLO_API_DECL void oslo_physics_add_force(oslo_physics_t* physics, vec2 force);
 OSLO_API_DECL void oslo_physics_add_torque(oslo_physics_t* physics, float torque);
 
+// Grid is the default. Switching drops the tree, it is rebuilt on the next step when needed.
+OSLO_API_DECL void oslo_physics_set_broadphase(oslo_physics_t* physics, oslo_physics_broadphase_type type);
+
+// Body accessors, all of them ignore stale handles
+OSLO_API_DECL void oslo_physics_body_add_force(oslo_physics_t* physics, oslo_physics_body_handle body, vec2 force);
+OSLO_API_DECL void oslo_physics_body_add_torque(oslo_physics_t* physics, oslo_physics_body_handle body, float torque);
+OSLO_API_DECL void oslo_physics_body_apply_impluse(oslo_physics_t* physics, oslo_physics_body_handle body, vec2 impulse);
+OSLO_API_DECL void oslo_physics_body_set_position(oslo_physics_t* physics, oslo_physics_body_handle body, vec2 position);
+OSLO_API_DECL void oslo_physics_body_set_velocity(oslo_physics_t* physics, oslo_physics_body_handle body, vec2 velocity);
+OSLO_API_DECL vec2 oslo_physics_body_get_position(const oslo_physics_t* physics, oslo_physics_body_handle body);
+OSLO_API_DECL vec2 oslo_physics_body_get_velocity(const oslo_physics_t* physics, oslo_physics_body_handle body);
+OSLO_API_DECL void oslo_physics_body_set_circle(oslo_physics_t* physics, oslo_physics_body_handle body, float radius, vec2 center);
+OSLO_API_DECL void oslo_physics_body_set_box(oslo_physics_t* physics, oslo_physics_body_handle body, vec2 half_size, vec2 center);
+// Vertices must form a convex polygon, either winding. Anything past OSLO_PHYSICS_MAX_POLYGON_VERTICES is dropped.
+OSLO_API_DECL void oslo_physics_body_set_polygon(oslo_physics_t* physics, oslo_physics_body_handle body, const vec2* vertices, u32 count);
+OSLO_API_DECL void oslo_physics_body_set_layer(oslo_physics_t* physics, oslo_physics_body_handle body, u32 layer, u32 mask);
+
+// Fills the manifold when the two shapes touch, impulses start at 0
+OSLO_API_DECL bool oslo_physics_collide(const oslo_physics_t* physics, oslo_physics_body_handle a, oslo_physics_body_handle b, oslo_physics_manifold_t* out_manifold);
+
 #ifdef OSLO_PHYSICS_IMPL
 
-void oslo_physics_body_integrate_forces(oslo_physics_body_t* body);
-void oslo_physics_body_integrate_velocities(oslo_physics_body_t* body);
+void __oslo_physics_integrate_forces(oslo_physics_t* physics, float dt);
+void __oslo_physics_integrate_velocities(oslo_physics_t* physics, float dt);
+void __oslo_physics_broadphase(oslo_physics_t* physics, float dt);
+void __oslo_physics_tree_remove(oslo_physics_tree_t* tree, s32 leaf);
+void __oslo_physics_narrowphase(oslo_physics_t* physics);
+void __oslo_physics_build_islands(oslo_physics_t* physics);
+void __oslo_physics_solve(oslo_physics_t* physics, float dt);
+
+#ifdef OSLO_PHYSICS_FIXED_POINT
+// Pixel space to meters and back
+#define __oslo_physics_to_fx(__F) fx16_from_f32((__F) * (1.0f / PIXELS_PER_METER))
+#define __oslo_physics_from_fx(__X) (fx16_to_f32(__X) * (float)PIXELS_PER_METER)
+#endif
+
+// The plain per body arrays, grown and swapped the same way. The vec2_soa ones are handled next to them.
+typedef struct __oslo_physics_column_t
+{
+    size_t offset;
+    size_t size;
+} __oslo_physics_column_t;
+
+static const __oslo_physics_column_t __oslo_physics_columns[] =
+{
+    { offsetof(oslo_physics_bodies_t, torque), sizeof(float) },
+    { offsetof(oslo_physics_bodies_t, mass), sizeof(float) },
+    { offsetof(oslo_physics_bodies_t, inv_mass), sizeof(float) },
+    { offsetof(oslo_physics_bodies_t, shape), sizeof(oslo_physics_shape_t) },
+    { offsetof(oslo_physics_bodies_t, has_shape), sizeof(bool) },
+    { offsetof(oslo_physics_bodies_t, aabb), sizeof(oslo_physics_aabb_t) },
+    { offsetof(oslo_physics_bodies_t, layer), sizeof(u32) },
+    { offsetof(oslo_physics_bodies_t, mask), sizeof(u32) },
+    { offsetof(oslo_physics_bodies_t, proxy), sizeof(s32) },
+#ifdef OSLO_PHYSICS_FIXED_POINT
+    { offsetof(oslo_physics_bodies_t, fx_position_x), sizeof(fx16) },
+    { offsetof(oslo_physics_bodies_t, fx_position_y), sizeof(fx16) },
+    { offsetof(oslo_physics_bodies_t, fx_velocity_x), sizeof(fx16) },
+    { offsetof(oslo_physics_bodies_t, fx_velocity_y), sizeof(fx16) },
+    { offsetof(oslo_physics_bodies_t, fx_force_x), sizeof(fx16) },
+    { offsetof(oslo_physics_bodies_t, fx_force_y), sizeof(fx16) },
+    { offsetof(oslo_physics_bodies_t, fx_mass), sizeof(fx16) },
+    { offsetof(oslo_physics_bodies_t, fx_inv_mass), sizeof(fx16) },
+#endif
+    { offsetof(oslo_physics_bodies_t, handles), sizeof(oslo_physics_body_handle) }
+};
+
+#define __oslo_physics_column_count (sizeof(__oslo_physics_columns) / sizeof(__oslo_physics_columns[0]))
+
+#define __oslo_physics_column(__BODIES, __C)\
+    ((u8**)((u8*)(__BODIES) + __oslo_physics_columns[__C].offset))
+
+oslo_inline void __oslo_physics_soa_columns(oslo_physics_bodies_t* bodies, vec2_soa* out[4])
+{
+    out[0] = &bodies->position;
+    out[1] = &bodies->velocity;
+    out[2] = &bodies->acceleration;
+    out[3] = &bodies->force;
+}
+
+void __oslo_physics_bodies_grow(oslo_physics_bodies_t* bodies)
+{
+    u32 capacity = bodies->capacity ? bodies->capacity * 2 : OSLO_PHYSICS_INITIAL_BODY_CAPACITY;
+
+    vec2_soa* soa[4];
+    __oslo_physics_soa_columns(bodies, soa);
+    for (u32 c = 0; c < 4; ++c)
+    {
+        vec2_soa grown;
+        oslo_vec2_soa_alloc(&grown, capacity, NULL);
+        if (soa[c]->block)
+        {
+            memcpy(grown.x, soa[c]->x, bodies->count * sizeof(f32));
+            memcpy(grown.y, soa[c]->y, bodies->count * sizeof(f32));
+            oslo_vec2_soa_free(soa[c], NULL);
+        }
+        grown.count = bodies->count;
+        *soa[c] = grown;
+    }
+
+    for (u32 c = 0; c < __oslo_physics_column_count; ++c)
+    {
+        u8** column = __oslo_physics_column(bodies, c);
+        *column = (u8*)oslo_realloc(*column, capacity * __oslo_physics_columns[c].size);
+    }
+    bodies->capacity = capacity;
+}
+
+void __oslo_physics_bodies_free(oslo_physics_bodies_t* bodies)
+{
+    vec2_soa* soa[4];
+    __oslo_physics_soa_columns(bodies, soa);
+    for (u32 c = 0; c < 4; ++c)
+    {
+        if (soa[c]->block)
+        {
+            oslo_vec2_soa_free(soa[c], NULL);
+        }
+    }
+    for (u32 c = 0; c < __oslo_physics_column_count; ++c)
+    {
+        oslo_free(*__oslo_physics_column(bodies, c));
+    }
+    oslo_dyn_array_free(bodies->indices);
+    oslo_dyn_array_free(bodies->generations);
+    memset(bodies, 0, sizeof(*bodies));
+    bodies->free_head = oslo_slot_array_INVALID_HANDLE;
+}
+
+// vec2_soa keeps its own element count for the kernels
+oslo_inline void __oslo_physics_bodies_set_count(oslo_physics_bodies_t* bodies, u32 count)
+{
+    bodies->count = count;
+    bodies->position.count = count;
+    bodies->velocity.count = count;
+    bodies->acceleration.count = count;
+    bodies->force.count = count;
+}
 
 void oslo_physics_init(oslo_physics_t* out_physics)
 {
     if (out_physics != NULL)
     {
-        out_physics->bodies = oslo_dyn_array_new(oslo_physics_body_t);
+        memset(&out_physics->bodies, 0, sizeof(out_physics->bodies));
+        out_physics->bodies.free_head = oslo_slot_array_INVALID_HANDLE;
+        out_physics->bodies.indices = oslo_dyn_array_new(u32);
+        out_physics->bodies.generations = oslo_dyn_array_new(u32);
         out_physics->forces = oslo_dyn_array_new(vec2);
         out_physics->torques = oslo_dyn_array_new(float);
+
+        out_physics->broadphase = OSLO_PHYSICS_BROADPHASE_GRID;
+        out_physics->grid_cell_size = 0.0f;
+        out_physics->pairs = oslo_dyn_array_new(oslo_physics_pair_t);
+        out_physics->bp_bodies = oslo_dyn_array_new(u32);
+        out_physics->bp_cells = oslo_dyn_array_new(oslo_physics_cell_entry_t);
+        out_physics->bp_cells_tmp = oslo_dyn_array_new(oslo_physics_cell_entry_t);
+        out_physics->tree.nodes = oslo_dyn_array_new(oslo_physics_tree_node_t);
+        out_physics->tree.stack = oslo_dyn_array_new(s32);
+        out_physics->tree.root = -1;
+        out_physics->tree.free_list = -1;
+        out_physics->manifolds = oslo_hash_table_new(oslo_physics_pair_t, oslo_physics_manifold_t);
+        out_physics->contacts = oslo_dyn_array_new(oslo_physics_manifold_t*);
+        out_physics->manifold_keys = oslo_dyn_array_new(oslo_physics_pair_t);
+        out_physics->step = 0;
+
+        out_physics->velocity_iterations = 8;
+        out_physics->friction = 0.4f;
+        out_physics->baumgarte = 0.2f;
+        out_physics->penetration_slop = 0.5f;
+        out_physics->islands = oslo_dyn_array_new(oslo_physics_island_t);
+        out_physics->island_contacts = oslo_dyn_array_new(oslo_physics_manifold_t*);
+        out_physics->island_bodies = oslo_dyn_array_new(u32);
+        memset(&out_physics->solver_stats, 0, sizeof(out_physics->solver_stats));
+        out_physics->island_parents = oslo_dyn_array_new(u32);
+        out_physics->island_ids = oslo_dyn_array_new(u32);
+        out_physics->island_order = oslo_dyn_array_new(u64);
+        out_physics->island_batches = oslo_dyn_array_new(u32);
     }
 }
 
@@ -94,75 +476,181 @@ void oslo_physics_shutdown(oslo_physics_t* physics)
 {
     if (physics != NULL)
     {
-        oslo_dyn_array_free(physics->bodies);
+        __oslo_physics_bodies_free(&physics->bodies);
         oslo_dyn_array_free(physics->forces);
         oslo_dyn_array_free(physics->torques);
+        oslo_dyn_array_free(physics->pairs);
+        oslo_dyn_array_free(physics->bp_bodies);
+        oslo_dyn_array_free(physics->bp_cells);
+        oslo_dyn_array_free(physics->bp_cells_tmp);
+        oslo_dyn_array_free(physics->tree.nodes);
+        oslo_dyn_array_free(physics->tree.stack);
+        oslo_hash_table_free(physics->manifolds);
+        oslo_dyn_array_free(physics->contacts);
+        oslo_dyn_array_free(physics->manifold_keys);
+        oslo_dyn_array_free(physics->islands);
+        oslo_dyn_array_free(physics->island_contacts);
+        oslo_dyn_array_free(physics->island_bodies);
+        oslo_dyn_array_free(physics->island_parents);
+        oslo_dyn_array_free(physics->island_ids);
+        oslo_dyn_array_free(physics->island_order);
+        oslo_dyn_array_free(physics->island_batches);
     }
 }
 
 void oslo_physics_update(oslo_physics_t* physics)
+{
+    oslo_physics_update_delta(physics, oslo_get_delta_time_f64());
+}
+
+void oslo_physics_update_delta(oslo_physics_t* physics, double dt)
 {
     if (physics != NULL)
     {
-        for (uint32_t i = 0; i < oslo_dyn_array_size(physics->bodies); ++i)
-        {
-            oslo_physics_body_t* body = &physics->bodies[i];
-            
-            // Apply gravity
-            vec2 weight = vec2_ctor(0.0f, body->mass * G * PIXELS_PER_METER);
-            oslo_physics_body_add_force(body, weight);
-
-            // Apply forces
-            for (uint32_t f = 0; f < oslo_dyn_array_size(physics->forces); ++f)
-            {
-                vec2* force = &physics->forces[f];
-                oslo_physics_body_add_force(body, *force);
-            }
-        }
-
-
-        for (uint32_t i = 0; i < oslo_dyn_array_size(physics->bodies); ++i)
-        {
-            oslo_physics_body_t* body = &physics->bodies[i];
-            oslo_physics_body_integrate_forces(body);
-        }
+        // Gravity and forces
+        __oslo_physics_integrate_forces(physics, (float)dt);
 
         // Check collisions
+        __oslo_physics_broadphase(physics, (float)dt);
+        __oslo_physics_narrowphase(physics);
 
-        for (uint32_t i = 0; i < oslo_dyn_array_size(physics->bodies); ++i)
-        {
-            oslo_physics_body_t* body = &physics->bodies[i];
-            oslo_physics_body_integrate_velocities(body);
-        }
+        // Resolve contacts, islands in parallel
+        __oslo_physics_build_islands(physics);
+        __oslo_physics_solve(physics, (float)dt);
+
+        __oslo_physics_integrate_velocities(physics, (float)dt);
     }
 }
 
-oslo_physics_body_t* oslo_physics_add_body(oslo_physics_t* physics, vec2 position, float mass)
+oslo_physics_body_handle oslo_physics_add_body(oslo_physics_t* physics, vec2 position, float mass)
 {
-    oslo_physics_body_t body = default_val();
-    body.position = position;
-    body.velocity = v2(0,0);
-    body.acceleration = v2(0,0);
-    body.sum_forces = v2(0,0);
-    body.sum_torque = 0.0f;
-    body.mass = mass;
-    if (mass != 0.0f)
+    oslo_physics_bodies_t* bodies = &physics->bodies;
+    if (bodies->free_head == oslo_slot_array_INVALID_HANDLE && (u32)oslo_dyn_array_size(bodies->indices) > oslo_slot_array_INDEX_MASK)
     {
-        body.inv_mass = 1.0f/mass;
+        // Any further slot index would run into the generation bits
+        return OSLO_PHYSICS_INVALID_BODY;
+    }
+    if (bodies->count == bodies->capacity)
+    {
+        __oslo_physics_bodies_grow(bodies);
+    }
+
+    // Pop a free slot, or append a new one
+    u32 slot = bodies->free_head;
+    if (slot != oslo_slot_array_INVALID_HANDLE)
+    {
+        bodies->free_head = bodies->indices[slot];
     }
     else
     {
-        body.inv_mass = 0.0f;
+        slot = (u32)oslo_dyn_array_size(bodies->indices);
+        oslo_dyn_array_push(bodies->indices, 0);
+        oslo_dyn_array_push(bodies->generations, 0);
+    }
+
+    u32 i = bodies->count;
+    oslo_physics_body_handle handle = (bodies->generations[slot] << OSLO_SLOT_ARRAY_INDEX_BITS) | slot;
+    bodies->indices[slot] = i;
+    bodies->handles[i] = handle;
+    __oslo_physics_bodies_set_count(bodies, i + 1);
+
+    bodies->position.x[i] = position.x;
+    bodies->position.y[i] = position.y;
+    bodies->velocity.x[i] = bodies->velocity.y[i] = 0.0f;
+    bodies->acceleration.x[i] = bodies->acceleration.y[i] = 0.0f;
+    bodies->force.x[i] = bodies->force.y[i] = 0.0f;
+    bodies->torque[i] = 0.0f;
+    bodies->mass[i] = mass;
+    bodies->inv_mass[i] = mass != 0.0f ? 1.0f / mass : 0.0f;
+    bodies->has_shape[i] = false;
+    bodies->aabb[i].min = position;
+    bodies->aabb[i].max = position;
+    bodies->layer[i] = 1u;
+    bodies->mask[i] = 0xFFFFFFFFu;
+    bodies->proxy[i] = -1;
+
+#ifdef OSLO_PHYSICS_FIXED_POINT
+    bodies->fx_position_x[i] = __oslo_physics_to_fx(position.x);
+    bodies->fx_position_y[i] = __oslo_physics_to_fx(position.y);
+    bodies->fx_velocity_x[i] = bodies->fx_velocity_y[i] = 0;
+    bodies->fx_force_x[i] = bodies->fx_force_y[i] = 0;
+    bodies->fx_mass[i] = fx16_from_f32(mass);
+    bodies->fx_inv_mass[i] = bodies->fx_mass[i] != 0 ? fx16_div(FX16_ONE, bodies->fx_mass[i]) : 0;
+#endif
+
+    return handle;
+}
+
+u32 oslo_physics_body_index(const oslo_physics_t* physics, oslo_physics_body_handle body)
+{
+    const oslo_physics_bodies_t* bodies = &physics->bodies;
+    u32 slot = oslo_slot_array_handle_index(body);
+    if (slot >= (u32)oslo_dyn_array_size(bodies->indices))
+    {
+        return UINT32_MAX;
     }
 
-    oslo_dyn_array_push(physics->bodies, body);
-    size_t size = oslo_dyn_array_size(physics->bodies);
-    return &physics->bodies[size - 1];
+    u32 i = bodies->indices[slot];
+    return i < bodies->count && bodies->handles[i] == body ? i : UINT32_MAX;
+}
+
+bool oslo_physics_body_valid(const oslo_physics_t* physics, oslo_physics_body_handle body)
+{
+    return physics != NULL && oslo_physics_body_index(physics, body) != UINT32_MAX;
 }
 
-void oslo_physics_remove_body(oslo_physics_t* physics, oslo_physics_body_t* body)
+void oslo_physics_remove_body(oslo_physics_t* physics, oslo_physics_body_handle body)
 {
-    // TODO
+    u32 i = physics != NULL ? oslo_physics_body_index(physics, body) : UINT32_MAX;
+    if (i == UINT32_MAX)
+    {
+        return;
+    }
+
+    oslo_physics_bodies_t* bodies = &physics->bodies;
+    if (bodies->proxy[i] != -1)
+    {
+        __oslo_physics_tree_remove(&physics->tree, bodies->proxy[i]);
+    }
+
+    // Cached manifolds keyed by the stale handle never match a pair again, the next narrowphase drops them.
+    // Last step's contact lists may still point at them, so those go now.
+    oslo_dyn_array_clear(physics->contacts);
+    oslo_dyn_array_clear(physics->islands);
+    oslo_dyn_array_clear(physics->island_contacts);
+    oslo_dyn_array_clear(physics->island_bodies);
+
+    // Swap and pop every array, then point the moved body's slot and tree leaf at its new index
+    u32 last = bodies->count - 1;
+    if (i != last)
+    {
+        vec2_soa* soa[4];
+        __oslo_physics_soa_columns(bodies, soa);
+        for (u32 c = 0; c < 4; ++c)
+        {
+            soa[c]->x[i] = soa[c]->x[last];
+            soa[c]->y[i] = soa[c]->y[last];
+        }
+        for (u32 c = 0; c < __oslo_physics_column_count; ++c)
+        {
+            u8* column = *__oslo_physics_column(bodies, c);
+            size_t size = __oslo_physics_columns[c].size;
+            memcpy(column + i * size, column + last * size, size);
+        }
+
+        bodies->indices[oslo_slot_array_handle_index(bodies->handles[i])] = i;
+        if (bodies->proxy[i] != -1)
+        {
+            physics->tree.nodes[bodies->proxy[i]].body = i;
+        }
+    }
+    __oslo_physics_bodies_set_count(bodies, last);
+
+    // Retire the handle and push the slot on the free list
+    u32 slot = oslo_slot_array_handle_index(body);
+    bodies->generations[slot] = oslo_slot_array_next_generation(bodies->generations[slot], slot);
+    bodies->indices[slot] = bodies->free_head;
+    bodies->free_head = slot;
 }
 
 void oslo_physics_add_force(oslo_physics_t* physics, vec2 force)
@@ -181,39 +669,2151 @@ void oslo_physics_add_torque(oslo_physics_t* physics, float torque)
     }
 }
 
-void oslo_physics_body_add_force(oslo_physics_body_t* body, vec2 force)
+void oslo_physics_set_broadphase(oslo_physics_t* physics, oslo_physics_broadphase_type type)
+{
+    if (physics == NULL || physics->broadphase == type)
+    {
+        return;
+    }
+
+    physics->broadphase = type;
+    for (u32 i = 0; i < physics->bodies.count; ++i)
+    {
+        physics->bodies.proxy[i] = -1;
+    }
+    oslo_dyn_array_clear(physics->tree.nodes);
+    physics->tree.root = -1;
+    physics->tree.free_list = -1;
+}
+
+void oslo_physics_body_add_force(oslo_physics_t* physics, oslo_physics_body_handle body, vec2 force)
+{
+    u32 i = oslo_physics_body_index(physics, body);
+    if (i == UINT32_MAX)
+    {
+        return;
+    }
+
+#ifdef OSLO_PHYSICS_FIXED_POINT
+    physics->bodies.fx_force_x[i] += __oslo_physics_to_fx(force.x);
+    physics->bodies.fx_force_y[i] += __oslo_physics_to_fx(force.y);
+#else
+    physics->bodies.force.x[i] += force.x;
+    physics->bodies.force.y[i] += force.y;
+#endif
+}
+
+void oslo_physics_body_add_torque(oslo_physics_t* physics, oslo_physics_body_handle body, float torque)
+{
+    u32 i = oslo_physics_body_index(physics, body);
+    if (i != UINT32_MAX)
+    {
+        physics->bodies.torque[i] += torque;
+    }
+}
+
+void oslo_physics_body_apply_impluse(oslo_physics_t* physics, oslo_physics_body_handle body, vec2 impulse)
+{
+    u32 i = oslo_physics_body_index(physics, body);
+    if (i == UINT32_MAX)
+    {
+        return;
+    }
+
+    oslo_physics_bodies_t* bodies = &physics->bodies;
+#ifdef OSLO_PHYSICS_FIXED_POINT
+    bodies->fx_velocity_x[i] += fx16_mul(__oslo_physics_to_fx(impulse.x), bodies->fx_inv_mass[i]);
+    bodies->fx_velocity_y[i] += fx16_mul(__oslo_physics_to_fx(impulse.y), bodies->fx_inv_mass[i]);
+    bodies->velocity.x[i] = __oslo_physics_from_fx(bodies->fx_velocity_x[i]);
+    bodies->velocity.y[i] = __oslo_physics_from_fx(bodies->fx_velocity_y[i]);
+#else
+    bodies->velocity.x[i] += impulse.x * bodies->inv_mass[i];
+    bodies->velocity.y[i] += impulse.y * bodies->inv_mass[i];
+#endif
+}
+
+void oslo_physics_body_set_position(oslo_physics_t* physics, oslo_physics_body_handle body, vec2 position)
+{
+    u32 i = oslo_physics_body_index(physics, body);
+    if (i == UINT32_MAX)
+    {
+        return;
+    }
+
+    physics->bodies.position.x[i] = position.x;
+    physics->bodies.position.y[i] = position.y;
+#ifdef OSLO_PHYSICS_FIXED_POINT
+    physics->bodies.fx_position_x[i] = __oslo_physics_to_fx(position.x);
+    physics->bodies.fx_position_y[i] = __oslo_physics_to_fx(position.y);
+#endif
+}
+
+void oslo_physics_body_set_velocity(oslo_physics_t* physics, oslo_physics_body_handle body, vec2 velocity)
+{
+    u32 i = oslo_physics_body_index(physics, body);
+    if (i == UINT32_MAX)
+    {
+        return;
+    }
+
+    physics->bodies.velocity.x[i] = velocity.x;
+    physics->bodies.velocity.y[i] = velocity.y;
+#ifdef OSLO_PHYSICS_FIXED_POINT
+    physics->bodies.fx_velocity_x[i] = __oslo_physics_to_fx(velocity.x);
+    physics->bodies.fx_velocity_y[i] = __oslo_physics_to_fx(velocity.y);
+#endif
+}
+
+vec2 oslo_physics_body_get_position(const oslo_physics_t* physics, oslo_physics_body_handle body)
+{
+    u32 i = oslo_physics_body_index(physics, body);
+    return i != UINT32_MAX ? v2(physics->bodies.position.x[i], physics->bodies.position.y[i]) : v2(0.0f, 0.0f);
+}
+
+vec2 oslo_physics_body_get_velocity(const oslo_physics_t* physics, oslo_physics_body_handle body)
+{
+    u32 i = oslo_physics_body_index(physics, body);
+    return i != UINT32_MAX ? v2(physics->bodies.velocity.x[i], physics->bodies.velocity.y[i]) : v2(0.0f, 0.0f);
+}
+
+void oslo_physics_body_set_circle(oslo_physics_t* physics, oslo_physics_body_handle body, float radius, vec2 center)
+{
+    u32 i = oslo_physics_body_index(physics, body);
+    if (i == UINT32_MAX)
+    {
+        return;
+    }
+
+    oslo_physics_shape_t* shape = &physics->bodies.shape[i];
+    shape->type = Circle;
+    shape->circle.radius = radius;
+    shape->circle.center = center;
+    physics->bodies.has_shape[i] = true;
+}
+
+void oslo_physics_body_set_box(oslo_physics_t* physics, oslo_physics_body_handle body, vec2 half_size, vec2 center)
+{
+    u32 i = oslo_physics_body_index(physics, body);
+    if (i == UINT32_MAX)
+    {
+        return;
+    }
+
+    oslo_physics_shape_t* shape = &physics->bodies.shape[i];
+    shape->type = Box2D;
+    shape->box.half_size = half_size;
+    shape->box.center = center;
+    physics->bodies.has_shape[i] = true;
+}
+
+void oslo_physics_body_set_polygon(oslo_physics_t* physics, oslo_physics_body_handle body, const vec2* vertices, u32 count)
+{
+    u32 i = oslo_physics_body_index(physics, body);
+    count = count < OSLO_PHYSICS_MAX_POLYGON_VERTICES ? count : OSLO_PHYSICS_MAX_POLYGON_VERTICES;
+    if (i == UINT32_MAX || count < 3)
+    {
+        return;
+    }
+
+    // Normals are (e.y, -e.x), outwards when the signed area is positive, so flip the winding otherwise
+    float area = 0.0f;
+    for (u32 v = 0; v < count; ++v)
+    {
+        vec2 v0 = vertices[v];
+        vec2 v1 = vertices[(v + 1) % count];
+        area += v0.x * v1.y - v1.x * v0.y;
+    }
+
+    oslo_physics_polygon_t* polygon = &physics->bodies.shape[i].polygon;
+    polygon->count = count;
+    for (u32 v = 0; v < count; ++v)
+    {
+        polygon->vertices[v] = vertices[area >= 0.0f ? v : count - 1 - v];
+    }
+    for (u32 v = 0; v < count; ++v)
+    {
+        vec2 edge = vec2_sub(polygon->vertices[(v + 1) % count], polygon->vertices[v]);
+        polygon->normals[v] = vec2_norm(v2(edge.y, -edge.x));
+    }
+
+    physics->bodies.shape[i].type = Polygon2D;
+    physics->bodies.has_shape[i] = true;
+}
+
+void oslo_physics_body_set_layer(oslo_physics_t* physics, oslo_physics_body_handle body, u32 layer, u32 mask)
+{
+    u32 i = oslo_physics_body_index(physics, body);
+    if (i != UINT32_MAX)
+    {
+        physics->bodies.layer[i] = layer;
+        physics->bodies.mask[i] = mask;
+    }
+}
+
+// Gravity and the global forces join the accumulated ones, acceleration = force * inv_mass and
+// velocity += acceleration * dt in one pass. Forces and torques are cleared for the next step.
+void __oslo_physics_integrate_forces(oslo_physics_t* physics, float dt)
+{
+    oslo_physics_bodies_t* bodies = &physics->bodies;
+    u32 n = bodies->count;
+    if (n == 0)
+    {
+        return;
+    }
+
+    vec2 global = v2(0.0f, 0.0f);
+    for (uint32_t f = 0; f < oslo_dyn_array_size(physics->forces); ++f)
+    {
+        global = vec2_add(global, physics->forces[f]);
+    }
+
+#ifdef OSLO_PHYSICS_FIXED_POINT
+    // The fx16 kernels give the same bits as the scalar fx16 ops on every instruction set
+    fx16 gx = __oslo_physics_to_fx(global.x);
+    fx16 gy = __oslo_physics_to_fx(global.y);
+    for (u32 i = 0; i < n; ++i)
+    {
+        bodies->fx_force_x[i] += gx;
+        bodies->fx_force_y[i] += gy;
+    }
+    fx16_axpy_n(bodies->fx_force_y, fx16_from_f32(G), bodies->fx_mass, n);
+
+    // Forces become accelerations in place
+    fx16_mul_n(bodies->fx_force_x, bodies->fx_force_x, bodies->fx_inv_mass, n);
+    fx16_mul_n(bodies->fx_force_y, bodies->fx_force_y, bodies->fx_inv_mass, n);
+    fx16 fx_dt = fx16_from_f32(dt);
+    fx16_axpy_n(bodies->fx_velocity_x, fx_dt, bodies->fx_force_x, n);
+    fx16_axpy_n(bodies->fx_velocity_y, fx_dt, bodies->fx_force_y, n);
+
+    for (u32 i = 0; i < n; ++i)
+    {
+        bodies->acceleration.x[i] = __oslo_physics_from_fx(bodies->fx_force_x[i]);
+        bodies->acceleration.y[i] = __oslo_physics_from_fx(bodies->fx_force_y[i]);
+        bodies->velocity.x[i] = __oslo_physics_from_fx(bodies->fx_velocity_x[i]);
+        bodies->velocity.y[i] = __oslo_physics_from_fx(bodies->fx_velocity_y[i]);
+    }
+    memset(bodies->fx_force_x, 0, n * sizeof(fx16));
+    memset(bodies->fx_force_y, 0, n * sizeof(fx16));
+#else
+    const float gravity = G * PIXELS_PER_METER;
+    f32* fx = bodies->force.x;
+    f32* fy = bodies->force.y;
+    f32* ax = bodies->acceleration.x;
+    f32* ay = bodies->acceleration.y;
+    f32* vx = bodies->velocity.x;
+    f32* vy = bodies->velocity.y;
+    const f32* mass = bodies->mass;
+    const f32* inv_mass = bodies->inv_mass;
+
+    u32 i = 0;
+#if OSLO_MATH_SOA_WIDTH > 1
+    __oslo_soa_f32 v_gx = __oslo_soa_set1(global.x);
+    __oslo_soa_f32 v_gy = __oslo_soa_set1(global.y);
+    __oslo_soa_f32 v_gravity = __oslo_soa_set1(gravity);
+    __oslo_soa_f32 v_dt = __oslo_soa_set1(dt);
+    __oslo_soa_f32 zero = __oslo_soa_set1(0.0f);
+    for (; i + OSLO_MATH_SOA_WIDTH <= n; i += OSLO_MATH_SOA_WIDTH)
+    {
+        __oslo_soa_f32 im = __oslo_soa_load(inv_mass + i);
+        __oslo_soa_f32 weight = __oslo_soa_mul(__oslo_soa_load(mass + i), v_gravity);
+        __oslo_soa_f32 acc_x = __oslo_soa_mul(__oslo_soa_add(__oslo_soa_load(fx + i), v_gx), im);
+        __oslo_soa_f32 acc_y = __oslo_soa_mul(__oslo_soa_add(__oslo_soa_add(__oslo_soa_load(fy + i), v_gy), weight), im);
+        __oslo_soa_store(ax + i, acc_x);
+        __oslo_soa_store(ay + i, acc_y);
+        __oslo_soa_store(vx + i, __oslo_soa_add(__oslo_soa_load(vx + i), __oslo_soa_mul(acc_x, v_dt)));
+        __oslo_soa_store(vy + i, __oslo_soa_add(__oslo_soa_load(vy + i), __oslo_soa_mul(acc_y, v_dt)));
+        __oslo_soa_store(fx + i, zero);
+        __oslo_soa_store(fy + i, zero);
+    }
+#endif
+    for (; i < n; ++i)
+    {
+        ax[i] = (fx[i] + global.x) * inv_mass[i];
+        ay[i] = (fy[i] + global.y + mass[i] * gravity) * inv_mass[i];
+        vx[i] += ax[i] * dt;
+        vy[i] += ay[i] * dt;
+        fx[i] = 0.0f;
+        fy[i] = 0.0f;
+    }
+#endif
+
+    memset(bodies->torque, 0, n * sizeof(float));
+}
+
+// position += velocity * dt
+void __oslo_physics_integrate_velocities(oslo_physics_t* physics, float dt)
+{
+    oslo_physics_bodies_t* bodies = &physics->bodies;
+#ifdef OSLO_PHYSICS_FIXED_POINT
+    fx16 fx_dt = fx16_from_f32(dt);
+    fx16_axpy_n(bodies->fx_position_x, fx_dt, bodies->fx_velocity_x, bodies->count);
+    fx16_axpy_n(bodies->fx_position_y, fx_dt, bodies->fx_velocity_y, bodies->count);
+    for (u32 i = 0; i < bodies->count; ++i)
+    {
+        bodies->position.x[i] = __oslo_physics_from_fx(bodies->fx_position_x[i]);
+        bodies->position.y[i] = __oslo_physics_from_fx(bodies->fx_position_y[i]);
+    }
+#else
+    vec2_soa_axpy(&bodies->position, dt, &bodies->velocity);
+#endif
+}
+
+/*========================
+// Broadphase
+========================*/
+
+oslo_inline oslo_physics_aabb_t __oslo_physics_aabb_union(oslo_physics_aabb_t a, oslo_physics_aabb_t b)
+{
+    oslo_physics_aabb_t r;
+    r.min = v2(fminf(a.min.x, b.min.x), fminf(a.min.y, b.min.y));
+    r.max = v2(fmaxf(a.max.x, b.max.x), fmaxf(a.max.y, b.max.y));
+    return r;
+}
+
+oslo_inline bool __oslo_physics_aabb_overlap(const oslo_physics_aabb_t* a, const oslo_physics_aabb_t* b)
+{
+    return a->min.x <= b->max.x && b->min.x <= a->max.x && a->min.y <= b->max.y && b->min.y <= a->max.y;
+}
+
+oslo_inline bool __oslo_physics_aabb_contains(const oslo_physics_aabb_t* outer, const oslo_physics_aabb_t* inner)
+{
+    return outer->min.x <= inner->min.x && outer->min.y <= inner->min.y && inner->max.x <= outer->max.x && inner->max.y <= outer->max.y;
+}
+
+oslo_inline float __oslo_physics_aabb_perimeter(oslo_physics_aabb_t a)
 {
-    body->sum_forces = vec2_add(body->sum_forces, force);
+    return 2.0f * ((a.max.x - a.min.x) + (a.max.y - a.min.y));
 }
 
-void oslo_physics_body_add_torque(oslo_physics_body_t* body, float torque)
+oslo_inline bool __oslo_physics_layers_match(const oslo_physics_bodies_t* bodies, u32 a, u32 b)
 {
-    body->sum_torque += torque;
+    return (bodies->layer[a] & bodies->mask[b]) && (bodies->layer[b] & bodies->mask[a]);
+}
+
+oslo_physics_aabb_t __oslo_physics_body_compute_aabb(const oslo_physics_bodies_t* bodies, u32 i)
+{
+    const oslo_physics_shape_t* shape = &bodies->shape[i];
+    vec2 center = v2(bodies->position.x[i], bodies->position.y[i]);
+    vec2 extent = v2(0.0f, 0.0f);
+    switch (shape->type)
+    {
+        case Circle:
+            center = vec2_add(center, shape->circle.center);
+            extent = v2(shape->circle.radius, shape->circle.radius);
+            break;
+        case Box2D:
+            center = vec2_add(center, shape->box.center);
+            extent = shape->box.half_size;
+            break;
+        case Polygon2D:
+        {
+            const oslo_physics_polygon_t* polygon = &shape->polygon;
+            oslo_physics_aabb_t aabb;
+            aabb.min = aabb.max = polygon->vertices[0];
+            for (u32 i = 1; i < polygon->count; ++i)
+            {
+                aabb.min = v2(fminf(aabb.min.x, polygon->vertices[i].x), fminf(aabb.min.y, polygon->vertices[i].y));
+                aabb.max = v2(fmaxf(aabb.max.x, polygon->vertices[i].x), fmaxf(aabb.max.y, polygon->vertices[i].y));
+            }
+            aabb.min = vec2_add(aabb.min, center);
+            aabb.max = vec2_add(aabb.max, center);
+            return aabb;
+        }
+        default:
+            break;
+    }
+
+    oslo_physics_aabb_t aabb;
+    aabb.min = vec2_sub(center, extent);
+    aabb.max = vec2_add(center, extent);
+    return aabb;
 }
 
-void oslo_physics_body_apply_impluse(oslo_physics_body_t* body, vec2 impulse)
+oslo_inline void __oslo_physics_push_pair(oslo_physics_t* physics, u32 a, u32 b)
 {
-    body->velocity = vec2_add(body->velocity, vec2_scale(impulse, body->inv_mass));
+    oslo_physics_pair_t pair = { physics->bodies.handles[a], physics->bodies.handles[b] };
+    oslo_dyn_array_push(physics->pairs, pair);
 }
 
-void oslo_physics_body_integrate_forces(oslo_physics_body_t* body)
+// LSD radix sort on the cell keys, 8 bits per pass. Passes where every key has the same byte are skipped,
+// so small worlds sort in 2-4 passes. Returns whichever buffer holds the result.
+oslo_physics_cell_entry_t* __oslo_physics_sort_cells(oslo_physics_cell_entry_t* entries, oslo_physics_cell_entry_t* tmp, u32 count)
 {
-    float dt = oslo_get_delta_time();
+    for (u32 shift = 0; shift < 64; shift += 8)
+    {
+        u32 histogram[256] = { 0 };
+        for (u32 i = 0; i < count; ++i)
+        {
+            histogram[(entries[i].cell >> shift) & 0xFF]++;
+        }
+        if (histogram[(entries[0].cell >> shift) & 0xFF] == count)
+        {
+            continue;
+        }
 
-    body->acceleration = vec2_scale(body->sum_forces, body->inv_mass);
-    body->velocity = vec2_add(body->velocity, vec2_scale(body->acceleration, dt));
+        u32 offset = 0;
+        for (u32 b = 0; b < 256; ++b)
+        {
+            u32 n = histogram[b];
+            histogram[b] = offset;
+            offset += n;
+        }
+        for (u32 i = 0; i < count; ++i)
+        {
+            tmp[histogram[(entries[i].cell >> shift) & 0xFF]++] = entries[i];
+        }
 
-    // Clear all the forces and torque acting on the object before the next physics step
-    body->sum_forces = v2(0,0);
-    body->sum_torque = 0.0f;
+        oslo_physics_cell_entry_t* swap = entries;
+        entries = tmp;
+        tmp = swap;
+    }
+    return entries;
 }
 
-void oslo_physics_body_integrate_velocities(oslo_physics_body_t* body)
+oslo_inline u64 __oslo_physics_cell_key(s32 x, s32 y)
 {
-    float dt = oslo_get_delta_time();
+    return ((u64)(u32)y << 32) | (u32)x;
+}
 
-    // Integrate the velocity to find the new position
-    body->position = vec2_add(body->position, vec2_scale(body->velocity, dt));
+// Bodies are binned into every cell their AABB touches, cells sorted by key, and bodies sharing a cell tested.
+// A pair is only reported from the cell holding the min corner of the two AABBs' intersection, so it comes out once.
+void __oslo_physics_broadphase_grid(oslo_physics_t* physics)
+{
+    const oslo_physics_aabb_t* aabbs = physics->bodies.aabb;
+    u32 count = (u32)oslo_dyn_array_size(physics->bp_bodies);
+    if (count < 2)
+    {
+        return;
+    }
+
+    float cell_size = physics->grid_cell_size;
+    if (cell_size <= 0.0f)
+    {
+        float extent = 0.0f;
+        for (u32 i = 0; i < count; ++i)
+        {
+            const oslo_physics_aabb_t* aabb = &aabbs[physics->bp_bodies[i]];
+            extent += oslo_max(aabb->max.x - aabb->min.x, aabb->max.y - aabb->min.y);
+        }
+        cell_size = oslo_max(1.0f, 2.0f * extent / count);
+    }
+    float inv_cell = 1.0f / cell_size;
+
+    oslo_dyn_array_clear(physics->bp_cells);
+    for (u32 i = 0; i < count; ++i)
+    {
+        const oslo_physics_aabb_t* aabb = &aabbs[physics->bp_bodies[i]];
+        s32 x0 = (s32)floorf(aabb->min.x * inv_cell);
+        s32 y0 = (s32)floorf(aabb->min.y * inv_cell);
+        s32 x1 = (s32)floorf(aabb->max.x * inv_cell);
+        s32 y1 = (s32)floorf(aabb->max.y * inv_cell);
+        for (s32 y = y0; y <= y1; ++y)
+        {
+            for (s32 x = x0; x <= x1; ++x)
+            {
+                oslo_physics_cell_entry_t entry = { __oslo_physics_cell_key(x, y), i };
+                oslo_dyn_array_push(physics->bp_cells, entry);
+            }
+        }
+    }
+
+    u32 entry_count = (u32)oslo_dyn_array_size(physics->bp_cells);
+    oslo_dyn_array_reserve(physics->bp_cells_tmp, entry_count);
+    oslo_physics_cell_entry_t* cells = __oslo_physics_sort_cells(physics->bp_cells, physics->bp_cells_tmp, entry_count);
+
+    for (u32 start = 0; start < entry_count;)
+    {
+        u64 key = cells[start].cell;
+        u32 end = start + 1;
+        while (end < entry_count && cells[end].cell == key)
+        {
+            end++;
+        }
+
+        for (u32 i = start; i < end; ++i)
+        {
+            u32 a = physics->bp_bodies[cells[i].body];
+            for (u32 j = i + 1; j < end; ++j)
+            {
+                u32 b = physics->bp_bodies[cells[j].body];
+                if (!__oslo_physics_aabb_overlap(&aabbs[a], &aabbs[b]) || !__oslo_physics_layers_match(&physics->bodies, a, b))
+                {
+                    continue;
+                }
+
+                s32 cx = (s32)floorf(oslo_max(aabbs[a].min.x, aabbs[b].min.x) * inv_cell);
+                s32 cy = (s32)floorf(oslo_max(aabbs[a].min.y, aabbs[b].min.y) * inv_cell);
+                if (__oslo_physics_cell_key(cx, cy) == key)
+                {
+                    __oslo_physics_push_pair(physics, a, b);
+                }
+            }
+        }
+        start = end;
+    }
+}
+
+s32 __oslo_physics_tree_alloc(oslo_physics_tree_t* tree)
+{
+    s32 index = tree->free_list;
+    if (index != -1)
+    {
+        tree->free_list = tree->nodes[index].parent;
+    }
+    else
+    {
+        oslo_physics_tree_node_t node = { 0 };
+        index = (s32)oslo_dyn_array_size(tree->nodes);
+        oslo_dyn_array_push(tree->nodes, node);
+    }
+
+    oslo_physics_tree_node_t* node = &tree->nodes[index];
+    node->parent = -1;
+    node->child1 = -1;
+    node->child2 = -1;
+    node->height = 0;
+    node->body = 0;
+    return index;
+}
+
+void __oslo_physics_tree_free(oslo_physics_tree_t* tree, s32 index)
+{
+    tree->nodes[index].parent = tree->free_list;
+    tree->nodes[index].height = -1;
+    tree->free_list = index;
+}
+
+oslo_inline void __oslo_physics_tree_replace_child(oslo_physics_tree_t* tree, s32 parent, s32 old_child, s32 new_child)
+{
+    if (parent == -1)
+    {
+        tree->root = new_child;
+    }
+    else if (tree->nodes[parent].child1 == old_child)
+    {
+        tree->nodes[parent].child1 = new_child;
+    }
+    else
+    {
+        tree->nodes[parent].child2 = new_child;
+    }
+}
+
+// AVL style rotation when the children of a differ in height by more than one, returns the new subtree root
+s32 __oslo_physics_tree_balance(oslo_physics_tree_t* tree, s32 ia)
+{
+    oslo_physics_tree_node_t* nodes = tree->nodes;
+    oslo_physics_tree_node_t* a = &nodes[ia];
+    if (a->child1 == -1 || a->height < 2)
+    {
+        return ia;
+    }
+
+    s32 ib = a->child1;
+    s32 ic = a->child2;
+    oslo_physics_tree_node_t* b = &nodes[ib];
+    oslo_physics_tree_node_t* c = &nodes[ic];
+    s32 balance = c->height - b->height;
+
+    // Rotate c up
+    if (balance > 1)
+    {
+        s32 i_f = c->child1;
+        s32 i_g = c->child2;
+        oslo_physics_tree_node_t* f = &nodes[i_f];
+        oslo_physics_tree_node_t* g = &nodes[i_g];
+
+        c->child1 = ia;
+        c->parent = a->parent;
+        a->parent = ic;
+        __oslo_physics_tree_replace_child(tree, c->parent, ia, ic);
+
+        if (f->height > g->height)
+        {
+            c->child2 = i_f;
+            a->child2 = i_g;
+            g->parent = ia;
+            a->aabb = __oslo_physics_aabb_union(b->aabb, g->aabb);
+            c->aabb = __oslo_physics_aabb_union(a->aabb, f->aabb);
+            a->height = 1 + oslo_max(b->height, g->height);
+            c->height = 1 + oslo_max(a->height, f->height);
+        }
+        else
+        {
+            c->child2 = i_g;
+            a->child2 = i_f;
+            f->parent = ia;
+            a->aabb = __oslo_physics_aabb_union(b->aabb, f->aabb);
+            c->aabb = __oslo_physics_aabb_union(a->aabb, g->aabb);
+            a->height = 1 + oslo_max(b->height, f->height);
+            c->height = 1 + oslo_max(a->height, g->height);
+        }
+        return ic;
+    }
+
+    // Rotate b up
+    if (balance < -1)
+    {
+        s32 i_d = b->child1;
+        s32 i_e = b->child2;
+        oslo_physics_tree_node_t* d = &nodes[i_d];
+        oslo_physics_tree_node_t* e = &nodes[i_e];
+
+        b->child1 = ia;
+        b->parent = a->parent;
+        a->parent = ib;
+        __oslo_physics_tree_replace_child(tree, b->parent, ia, ib);
+
+        if (d->height > e->height)
+        {
+            b->child2 = i_d;
+            a->child1 = i_e;
+            e->parent = ia;
+            a->aabb = __oslo_physics_aabb_union(c->aabb, e->aabb);
+            b->aabb = __oslo_physics_aabb_union(a->aabb, d->aabb);
+            a->height = 1 + oslo_max(c->height, e->height);
+            b->height = 1 + oslo_max(a->height, d->height);
+        }
+        else
+        {
+            b->child2 = i_e;
+            a->child1 = i_d;
+            d->parent = ia;
+            a->aabb = __oslo_physics_aabb_union(c->aabb, d->aabb);
+            b->aabb = __oslo_physics_aabb_union(a->aabb, e->aabb);
+            a->height = 1 + oslo_max(c->height, d->height);
+            b->height = 1 + oslo_max(a->height, e->height);
+        }
+        return ib;
+    }
+
+    return ia;
+}
+
+// Refits boxes and heights from index to the root, balancing on the way
+void __oslo_physics_tree_refit(oslo_physics_tree_t* tree, s32 index)
+{
+    while (index != -1)
+    {
+        index = __oslo_physics_tree_balance(tree, index);
+        oslo_physics_tree_node_t* node = &tree->nodes[index];
+        const oslo_physics_tree_node_t* child1 = &tree->nodes[node->child1];
+        const oslo_physics_tree_node_t* child2 = &tree->nodes[node->child2];
+        node->height = 1 + oslo_max(child1->height, child2->height);
+        node->aabb = __oslo_physics_aabb_union(child1->aabb, child2->aabb);
+        index = node->parent;
+    }
+}
+
+// Walks down to the sibling with the lowest perimeter cost (surface area heuristic in 2D)
+void __oslo_physics_tree_insert(oslo_physics_tree_t* tree, s32 leaf)
+{
+    if (tree->root == -1)
+    {
+        tree->root = leaf;
+        tree->nodes[leaf].parent = -1;
+        return;
+    }
+
+    oslo_physics_aabb_t leaf_aabb = tree->nodes[leaf].aabb;
+    s32 index = tree->root;
+    while (tree->nodes[index].child1 != -1)
+    {
+        const oslo_physics_tree_node_t* node = &tree->nodes[index];
+        float area = __oslo_physics_aabb_perimeter(node->aabb);
+        float combined = __oslo_physics_aabb_perimeter(__oslo_physics_aabb_union(node->aabb, leaf_aabb));
+
+        // Cost of making a new parent here, and the growth every level below pays for
+        float cost = 2.0f * combined;
+        float inheritance = 2.0f * (combined - area);
+
+        float child_cost[2];
+        s32 children[2] = { node->child1, node->child2 };
+        for (u32 c = 0; c < 2; ++c)
+        {
+            const oslo_physics_tree_node_t* child = &tree->nodes[children[c]];
+            float grown = __oslo_physics_aabb_perimeter(__oslo_physics_aabb_union(child->aabb, leaf_aabb));
+            child_cost[c] = (child->child1 == -1 ? grown : grown - __oslo_physics_aabb_perimeter(child->aabb)) + inheritance;
+        }
+
+        if (cost < child_cost[0] && cost < child_cost[1])
+        {
+            break;
+        }
+        index = child_cost[0] < child_cost[1] ? children[0] : children[1];
+    }
+
+    s32 sibling = index;
+    s32 new_parent = __oslo_physics_tree_alloc(tree);
+    oslo_physics_tree_node_t* nodes = tree->nodes;
+    s32 old_parent = nodes[sibling].parent;
+    nodes[new_parent].parent = old_parent;
+    nodes[new_parent].aabb = __oslo_physics_aabb_union(leaf_aabb, nodes[sibling].aabb);
+    nodes[new_parent].height = nodes[sibling].height + 1;
+    nodes[new_parent].child1 = sibling;
+    nodes[new_parent].child2 = leaf;
+    nodes[sibling].parent = new_parent;
+    nodes[leaf].parent = new_parent;
+    __oslo_physics_tree_replace_child(tree, old_parent, sibling, new_parent);
+
+    __oslo_physics_tree_refit(tree, nodes[leaf].parent);
+}
+
+void __oslo_physics_tree_detach(oslo_physics_tree_t* tree, s32 leaf)
+{
+    if (leaf == tree->root)
+    {
+        tree->root = -1;
+        return;
+    }
+
+    oslo_physics_tree_node_t* nodes = tree->nodes;
+    s32 parent = nodes[leaf].parent;
+    s32 grand_parent = nodes[parent].parent;
+    s32 sibling = nodes[parent].child1 == leaf ? nodes[parent].child2 : nodes[parent].child1;
+
+    __oslo_physics_tree_replace_child(tree, grand_parent, parent, sibling);
+    nodes[sibling].parent = grand_parent;
+    __oslo_physics_tree_free(tree, parent);
+    __oslo_physics_tree_refit(tree, grand_parent);
+}
+
+// The body's proxy is left for the caller to reset
+void __oslo_physics_tree_remove(oslo_physics_tree_t* tree, s32 leaf)
+{
+    __oslo_physics_tree_detach(tree, leaf);
+    __oslo_physics_tree_free(tree, leaf);
+}
+
+// Grown by the margin and stretched along a few steps of motion, so moving bodies don't reinsert every step
+oslo_inline oslo_physics_aabb_t __oslo_physics_fatten(oslo_physics_aabb_t aabb, vec2 velocity, float dt)
+{
+    vec2 margin = v2(OSLO_PHYSICS_TREE_MARGIN, OSLO_PHYSICS_TREE_MARGIN);
+    vec2 motion = vec2_scale(velocity, 4.0f * dt);
+    aabb.min = vec2_sub(aabb.min, margin);
+    aabb.max = vec2_add(aabb.max, margin);
+    if (motion.x < 0.0f) aabb.min.x += motion.x; else aabb.max.x += motion.x;
+    if (motion.y < 0.0f) aabb.min.y += motion.y; else aabb.max.y += motion.y;
+    return aabb;
+}
+
+// The stack is reserved before the traversal, so pushes only ever double it
+oslo_inline void __oslo_physics_tree_push_pair(oslo_physics_tree_t* tree, s32 i, s32 j)
+{
+    oslo_dyn_array* head = oslo_dyn_array_head(tree->stack);
+    if (head->size + 2 > head->capacity)
+    {
+        tree->stack = (s32*)oslo_dyn_array_resize_impl(tree->stack, sizeof(s32), (size_t)head->capacity * 2);
+        head = oslo_dyn_array_head(tree->stack);
+    }
+    tree->stack[head->size] = i;
+    tree->stack[head->size + 1] = j;
+    head->size += 2;
+}
+
+// Leaves are only reinserted once the body leaves its fattened box
+void __oslo_physics_broadphase_tree(oslo_physics_t* physics, float dt)
+{
+    oslo_physics_tree_t* tree = &physics->tree;
+    oslo_physics_bodies_t* bodies = &physics->bodies;
+    u32 count = (u32)oslo_dyn_array_size(physics->bp_bodies);
+
+    for (u32 i = 0; i < count; ++i)
+    {
+        u32 body = physics->bp_bodies[i];
+        s32 proxy = bodies->proxy[body];
+        vec2 velocity = v2(bodies->velocity.x[body], bodies->velocity.y[body]);
+        if (proxy == -1)
+        {
+            proxy = bodies->proxy[body] = __oslo_physics_tree_alloc(tree);
+            tree->nodes[proxy].body = body;
+            tree->nodes[proxy].aabb = __oslo_physics_fatten(bodies->aabb[body], velocity, dt);
+            __oslo_physics_tree_insert(tree, proxy);
+        }
+        else if (!__oslo_physics_aabb_contains(&tree->nodes[proxy].aabb, &bodies->aabb[body]))
+        {
+            __oslo_physics_tree_detach(tree, proxy);
+            tree->nodes[proxy].aabb = __oslo_physics_fatten(bodies->aabb[body], velocity, dt);
+            __oslo_physics_tree_insert(tree, proxy);
+        }
+    }
+
+    if (tree->root == -1)
+    {
+        return;
+    }
+
+    // The tree is collided against itself: a node paired with itself expands into its children and their
+    // cross pair, two overlapping nodes split the taller one. Each overlapping leaf pair comes up exactly once.
+    oslo_dyn_array_reserve(tree->stack, 64);
+    oslo_dyn_array_clear(tree->stack);
+    __oslo_physics_tree_push_pair(tree, tree->root, tree->root);
+    while (!oslo_dyn_array_empty(tree->stack))
+    {
+        u32 top = oslo_dyn_array_size(tree->stack);
+        s32 i = tree->stack[top - 2];
+        s32 j = tree->stack[top - 1];
+        oslo_dyn_array_head(tree->stack)->size = top - 2;
+
+        const oslo_physics_tree_node_t* a = &tree->nodes[i];
+        const oslo_physics_tree_node_t* b = &tree->nodes[j];
+        if (i == j)
+        {
+            if (a->child1 != -1)
+            {
+                __oslo_physics_tree_push_pair(tree, a->child1, a->child1);
+                __oslo_physics_tree_push_pair(tree, a->child2, a->child2);
+                __oslo_physics_tree_push_pair(tree, a->child1, a->child2);
+            }
+            continue;
+        }
+
+        if (!__oslo_physics_aabb_overlap(&a->aabb, &b->aabb))
+        {
+            continue;
+        }
+
+        if (a->child1 == -1 && b->child1 == -1)
+        {
+            if (__oslo_physics_aabb_overlap(&bodies->aabb[a->body], &bodies->aabb[b->body]) && __oslo_physics_layers_match(bodies, a->body, b->body))
+            {
+                __oslo_physics_push_pair(physics, a->body, b->body);
+            }
+        }
+        else if (b->child1 == -1 || (a->child1 != -1 && a->height >= b->height))
+        {
+            __oslo_physics_tree_push_pair(tree, a->child1, j);
+            __oslo_physics_tree_push_pair(tree, a->child2, j);
+        }
+        else
+        {
+            __oslo_physics_tree_push_pair(tree, i, b->child1);
+            __oslo_physics_tree_push_pair(tree, i, b->child2);
+        }
+    }
+}
+
+void __oslo_physics_broadphase(oslo_physics_t* physics, float dt)
+{
+    oslo_dyn_array_clear(physics->pairs);
+    oslo_dyn_array_clear(physics->bp_bodies);
+
+    oslo_physics_bodies_t* bodies = &physics->bodies;
+    oslo_dyn_array_reserve(physics->bp_bodies, bodies->count);
+    for (u32 i = 0; i < bodies->count; ++i)
+    {
+        if (!bodies->has_shape[i])
+        {
+            if (bodies->proxy[i] != -1)
+            {
+                __oslo_physics_tree_remove(&physics->tree, bodies->proxy[i]);
+                bodies->proxy[i] = -1;
+            }
+            continue;
+        }
+
+        bodies->aabb[i] = __oslo_physics_body_compute_aabb(bodies, i);
+        oslo_dyn_array_push(physics->bp_bodies, i);
+    }
+
+    if (physics->broadphase == OSLO_PHYSICS_BROADPHASE_TREE)
+    {
+        __oslo_physics_broadphase_tree(physics, dt);
+    }
+    else
+    {
+        __oslo_physics_broadphase_grid(physics);
+    }
+}
+
+/*========================
+// Narrowphase
+========================*/
+
+// Which shape is the reference, its edge and the incident vertex, so a point keeps its id while the same features touch
+#define __oslo_physics_contact_id(__FLIP, __REF, __INC) (((u32)(__FLIP) << 16) | ((u32)(__REF) << 8) | (u32)(__INC))
+
+// What the narrowphase needs of a body, gathered from the body arrays
+typedef struct __oslo_physics_collider_t
+{
+    vec2 position;
+    const oslo_physics_shape_t* shape;
+} __oslo_physics_collider_t;
+
+// One point between a circle and a surface, the normal points towards the circle
+oslo_inline void __oslo_physics_circle_point(oslo_physics_manifold_t* m, vec2 normal, vec2 center, float radius, float penetration)
+{
+    m->normal = normal;
+    m->point_count = 1;
+    m->points[0].position = vec2_sub(center, vec2_scale(normal, radius - 0.5f * penetration));
+    m->points[0].penetration = penetration;
+    m->points[0].id = 0;
+}
+
+bool __oslo_physics_collide_circles(const __oslo_physics_collider_t* a, const __oslo_physics_collider_t* b, oslo_physics_manifold_t* m)
+{
+    vec2 ca = vec2_add(a->position, a->shape->circle.center);
+    vec2 cb = vec2_add(b->position, b->shape->circle.center);
+    float radius = a->shape->circle.radius + b->shape->circle.radius;
+    vec2 d = vec2_sub(cb, ca);
+    float dist_sq = vec2_dot(d, d);
+    if (dist_sq > radius * radius)
+    {
+        return false;
+    }
+
+    float dist = sqrtf(dist_sq);
+    vec2 normal = dist > 0.0f ? vec2_scale(d, 1.0f / dist) : v2(0.0f, 1.0f);
+    __oslo_physics_circle_point(m, normal, cb, b->shape->circle.radius, radius - dist);
+    return true;
+}
+
+bool __oslo_physics_collide_box_circle(const __oslo_physics_collider_t* a, const __oslo_physics_collider_t* b, oslo_physics_manifold_t* m)
+{
+    vec2 half = a->shape->box.half_size;
+    vec2 center = vec2_add(b->position, b->shape->circle.center);
+    float radius = b->shape->circle.radius;
+    vec2 d = vec2_sub(center, vec2_add(a->position, a->shape->box.center));
+    vec2 closest = v2(fminf(fmaxf(d.x, -half.x), half.x), fminf(fmaxf(d.y, -half.y), half.y));
+
+    if (closest.x == d.x && closest.y == d.y)
+    {
+        // Center inside the box, push out through the nearest face
+        float dx = half.x - fabsf(d.x);
+        float dy = half.y - fabsf(d.y);
+        if (dx < dy)
+        {
+            __oslo_physics_circle_point(m, v2(d.x < 0.0f ? -1.0f : 1.0f, 0.0f), center, radius, radius + dx);
+        }
+        else
+        {
+            __oslo_physics_circle_point(m, v2(0.0f, d.y < 0.0f ? -1.0f : 1.0f), center, radius, radius + dy);
+        }
+        return true;
+    }
+
+    vec2 delta = vec2_sub(d, closest);
+    float dist_sq = vec2_dot(delta, delta);
+    if (dist_sq > radius * radius)
+    {
+        return false;
+    }
+
+    float dist = sqrtf(dist_sq);
+    __oslo_physics_circle_point(m, vec2_scale(delta, 1.0f / dist), center, radius, radius - dist);
+    return true;
+}
+
+// Both boxes are axis aligned, so SAT only has x and y to try. The axis with the least overlap wins and the
+// two points span the overlap along the other axis.
+bool __oslo_physics_collide_boxes(const __oslo_physics_collider_t* a, const __oslo_physics_collider_t* b, oslo_physics_manifold_t* m)
+{
+    vec2 ca = vec2_add(a->position, a->shape->box.center);
+    vec2 cb = vec2_add(b->position, b->shape->box.center);
+    vec2 ha = a->shape->box.half_size;
+    vec2 hb = b->shape->box.half_size;
+    vec2 d = vec2_sub(cb, ca);
+    float overlap_x = ha.x + hb.x - fabsf(d.x);
+    float overlap_y = ha.y + hb.y - fabsf(d.y);
+    if (overlap_x < 0.0f || overlap_y < 0.0f)
+    {
+        return false;
+    }
+
+    u32 axis = overlap_y < overlap_x;
+    float sign = (axis ? d.y : d.x) < 0.0f ? -1.0f : 1.0f;
+    float penetration = axis ? overlap_y : overlap_x;
+    float face = axis ? ca.y + sign * (ha.y - 0.5f * penetration) : ca.x + sign * (ha.x - 0.5f * penetration);
+    float lo = axis ? fmaxf(ca.x - ha.x, cb.x - hb.x) : fmaxf(ca.y - ha.y, cb.y - hb.y);
+    float hi = axis ? fminf(ca.x + ha.x, cb.x + hb.x) : fminf(ca.y + ha.y, cb.y + hb.y);
+
+    m->normal = axis ? v2(0.0f, sign) : v2(sign, 0.0f);
+    m->point_count = hi > lo ? 2 : 1;
+    for (u32 i = 0; i < m->point_count; ++i)
+    {
+        float along = i ? hi : lo;
+        m->points[i].position = axis ? v2(along, face) : v2(face, along);
+        m->points[i].penetration = penetration;
+        m->points[i].id = __oslo_physics_contact_id(0, axis, i);
+    }
+    return true;
+}
+
+// Boxes and polygons in world space, so the SAT routines don't care which one they got
+void __oslo_physics_world_polygon(const __oslo_physics_collider_t* body, oslo_physics_polygon_t* out)
+{
+    if (body->shape->type == Box2D)
+    {
+        vec2 c = vec2_add(body->position, body->shape->box.center);
+        vec2 h = body->shape->box.half_size;
+        out->count = 4;
+        out->vertices[0] = v2(c.x - h.x, c.y - h.y);
+        out->vertices[1] = v2(c.x + h.x, c.y - h.y);
+        out->vertices[2] = v2(c.x + h.x, c.y + h.y);
+        out->vertices[3] = v2(c.x - h.x, c.y + h.y);
+        out->normals[0] = v2(0.0f, -1.0f);
+        out->normals[1] = v2(1.0f, 0.0f);
+        out->normals[2] = v2(0.0f, 1.0f);
+        out->normals[3] = v2(-1.0f, 0.0f);
+        return;
+    }
+
+    const oslo_physics_polygon_t* polygon = &body->shape->polygon;
+    out->count = polygon->count;
+    for (u32 i = 0; i < polygon->count; ++i)
+    {
+        out->vertices[i] = vec2_add(body->position, polygon->vertices[i]);
+        out->normals[i] = polygon->normals[i];
+    }
+}
+
+// Largest distance from an edge of a to the deepest vertex of b, positive means a separating axis
+float __oslo_physics_max_separation(const oslo_physics_polygon_t* a, const oslo_physics_polygon_t* b, u32* out_edge)
+{
+    float best = -FLT_MAX;
+    *out_edge = 0;
+    for (u32 i = 0; i < a->count; ++i)
+    {
+        float separation = FLT_MAX;
+        for (u32 j = 0; j < b->count; ++j)
+        {
+            separation = fminf(separation, vec2_dot(a->normals[i], vec2_sub(b->vertices[j], a->vertices[i])));
+        }
+        if (separation > best)
+        {
+            best = separation;
+            *out_edge = i;
+        }
+    }
+    return best;
+}
+
+// Keeps the part of the segment where dot(normal, x) <= offset. A point made by the clip takes the id
+// of the vertex it replaced with bit 7 set.
+u32 __oslo_physics_clip_segment(vec2 out[2], u32 out_ids[2], const vec2 in[2], const u32 in_ids[2], vec2 normal, float offset)
+{
+    u32 count = 0;
+    float d0 = vec2_dot(normal, in[0]) - offset;
+    float d1 = vec2_dot(normal, in[1]) - offset;
+    if (d0 <= 0.0f)
+    {
+        out[count] = in[0];
+        out_ids[count++] = in_ids[0];
+    }
+    if (d1 <= 0.0f)
+    {
+        out[count] = in[1];
+        out_ids[count++] = in_ids[1];
+    }
+    if (d0 * d1 < 0.0f)
+    {
+        out[count] = vec2_add(in[0], vec2_scale(vec2_sub(in[1], in[0]), d0 / (d0 - d1)));
+        out_ids[count++] = (d0 > 0.0f ? in_ids[0] : in_ids[1]) | 0x80;
+    }
+    return count;
+}
+
+// SAT on the edge normals of both polygons, then the incident edge is clipped against the reference face
+bool __oslo_physics_collide_polygons(const oslo_physics_polygon_t* a, const oslo_physics_polygon_t* b, oslo_physics_manifold_t* m)
+{
+    u32 edge_a, edge_b;
+    float separation_a = __oslo_physics_max_separation(a, b, &edge_a);
+    if (separation_a > 0.0f)
+    {
+        return false;
+    }
+    float separation_b = __oslo_physics_max_separation(b, a, &edge_b);
+    if (separation_b > 0.0f)
+    {
+        return false;
+    }
+
+    // Stick with a's face unless b's is clearly better, so the reference doesn't flicker between steps
+    const oslo_physics_polygon_t* ref = a;
+    const oslo_physics_polygon_t* inc = b;
+    u32 ref_edge = edge_a;
+    u32 flip = 0;
+    if (separation_b > 0.98f * separation_a + 0.001f)
+    {
+        ref = b;
+        inc = a;
+        ref_edge = edge_b;
+        flip = 1;
+    }
+
+    vec2 normal = ref->normals[ref_edge];
+    u32 inc_edge = 0;
+    float min_dot = FLT_MAX;
+    for (u32 i = 0; i < inc->count; ++i)
+    {
+        float d = vec2_dot(normal, inc->normals[i]);
+        if (d < min_dot)
+        {
+            min_dot = d;
+            inc_edge = i;
+        }
+    }
+
+    u32 inc_next = (inc_edge + 1) % inc->count;
+    vec2 incident[2] = { inc->vertices[inc_edge], inc->vertices[inc_next] };
+    u32 ids[2] = { inc_edge, inc_next };
+    vec2 v1 = ref->vertices[ref_edge];
+    vec2 v2_ = ref->vertices[(ref_edge + 1) % ref->count];
+    vec2 tangent = vec2_norm(vec2_sub(v2_, v1));
+
+    // Side planes of the reference face
+    vec2 clip1[2], clip2[2];
+    u32 ids1[2], ids2[2];
+    if (__oslo_physics_clip_segment(clip1, ids1, incident, ids, vec2_scale(tangent, -1.0f), -vec2_dot(tangent, v1)) < 2)
+    {
+        return false;
+    }
+    if (__oslo_physics_clip_segment(clip2, ids2, clip1, ids1, tangent, vec2_dot(tangent, v2_)) < 2)
+    {
+        return false;
+    }
+
+    float front = vec2_dot(normal, v1);
+    m->normal = flip ? vec2_scale(normal, -1.0f) : normal;
+    m->point_count = 0;
+    for (u32 i = 0; i < 2; ++i)
+    {
+        float separation = vec2_dot(normal, clip2[i]) - front;
+        if (separation <= 0.0f)
+        {
+            oslo_physics_contact_point_t* point = &m->points[m->point_count++];
+            point->position = vec2_sub(clip2[i], vec2_scale(normal, 0.5f * separation));
+            point->penetration = -separation;
+            point->id = __oslo_physics_contact_id(flip, ref_edge, ids2[i]);
+        }
+    }
+    return m->point_count > 0;
+}
+
+// Normal points from the polygon to the circle
+bool __oslo_physics_collide_polygon_circle(const oslo_physics_polygon_t* polygon, vec2 center, float radius, oslo_physics_manifold_t* m)
+{
+    float separation = -FLT_MAX;
+    u32 edge = 0;
+    for (u32 i = 0; i < polygon->count; ++i)
+    {
+        float s = vec2_dot(polygon->normals[i], vec2_sub(center, polygon->vertices[i]));
+        if (s > radius)
+        {
+            return false;
+        }
+        if (s > separation)
+        {
+            separation = s;
+            edge = i;
+        }
+    }
+
+    // Past the end of the closest edge the nearest feature is a vertex
+    vec2 v1 = polygon->vertices[edge];
+    vec2 v2_ = polygon->vertices[(edge + 1) % polygon->count];
+    vec2 corner = v1;
+    bool vertex = false;
+    if (separation > 0.0f)
+    {
+        if (vec2_dot(vec2_sub(center, v1), vec2_sub(v2_, v1)) <= 0.0f)
+        {
+            vertex = true;
+        }
+        else if (vec2_dot(vec2_sub(center, v2_), vec2_sub(v1, v2_)) <= 0.0f)
+        {
+            corner = v2_;
+            vertex = true;
+        }
+    }
+
+    if (!vertex)
+    {
+        __oslo_physics_circle_point(m, polygon->normals[edge], center, radius, radius - separation);
+        return true;
+    }
+
+    vec2 d = vec2_sub(center, corner);
+    float dist_sq = vec2_dot(d, d);
+    if (dist_sq > radius * radius)
+    {
+        return false;
+    }
+
+    float dist = sqrtf(dist_sq);
+    __oslo_physics_circle_point(m, dist > 0.0f ? vec2_scale(d, 1.0f / dist) : polygon->normals[edge], center, radius, radius - dist);
+    return true;
+}
+
+bool __oslo_physics_collide_colliders(const __oslo_physics_collider_t* a, const __oslo_physics_collider_t* b, oslo_physics_manifold_t* m)
+{
+    // Only the pairs with the lower shape type first are written out, the rest swap and flip the normal back
+    if (a->shape->type > b->shape->type)
+    {
+        bool hit = __oslo_physics_collide_colliders(b, a, m);
+        m->normal = vec2_scale(m->normal, -1.0f);
+        return hit;
+    }
+
+    memset(m, 0, sizeof(*m));
+
+    oslo_physics_polygon_t pa, pb;
+    switch (a->shape->type)
+    {
+        case Box2D:
+            if (b->shape->type == Box2D)
+            {
+                return __oslo_physics_collide_boxes(a, b, m);
+            }
+            if (b->shape->type == Circle)
+            {
+                return __oslo_physics_collide_box_circle(a, b, m);
+            }
+            break;
+        case Circle:
+            if (b->shape->type == Circle)
+            {
+                return __oslo_physics_collide_circles(a, b, m);
+            }
+            __oslo_physics_world_polygon(b, &pb);
+            if (__oslo_physics_collide_polygon_circle(&pb, vec2_add(a->position, a->shape->circle.center), a->shape->circle.radius, m))
+            {
+                m->normal = vec2_scale(m->normal, -1.0f);
+                return true;
+            }
+            return false;
+        default:
+            break;
+    }
+
+    __oslo_physics_world_polygon(a, &pa);
+    __oslo_physics_world_polygon(b, &pb);
+    return __oslo_physics_collide_polygons(&pa, &pb, m);
+}
+
+#ifdef OSLO_PHYSICS_FIXED_POINT
+/*
+    The same routines in fx16 meters for the fixed point build, so the contacts the solver sees don't depend on
+    float rounding. Shape sizes are converted as they are read, and the float fields of the manifold are copies.
+*/
+
+typedef struct __oslo_physics_fx_collider_t
+{
+    fx16_vec2 position;
+    const oslo_physics_shape_t* shape;
+} __oslo_physics_fx_collider_t;
+
+typedef struct __oslo_physics_fx_polygon_t
+{
+    u32 count;
+    fx16_vec2 vertices[OSLO_PHYSICS_MAX_POLYGON_VERTICES];
+    fx16_vec2 normals[OSLO_PHYSICS_MAX_POLYGON_VERTICES];
+} __oslo_physics_fx_polygon_t;
+
+oslo_inline fx16_vec2 __oslo_physics_to_fx_vec2(vec2 v)
+{
+    return fx16_vec2_ctor(__oslo_physics_to_fx(v.x), __oslo_physics_to_fx(v.y));
+}
+
+oslo_inline fx16 __oslo_physics_fx_min(fx16 a, fx16 b)
+{
+    return a < b ? a : b;
+}
+
+oslo_inline fx16 __oslo_physics_fx_max(fx16 a, fx16 b)
+{
+    return a > b ? a : b;
+}
+
+oslo_inline fx16 __oslo_physics_fx_clamp(fx16 v, fx16 lo, fx16 hi)
+{
+    return __oslo_physics_fx_min(__oslo_physics_fx_max(v, lo), hi);
+}
+
+// Squared length in Q32.32, it would overflow fx16 past 181 m
+oslo_inline s64 __oslo_physics_fx_len_sq(fx16_vec2 v)
+{
+    return (s64)v.x * v.x + (s64)v.y * v.y;
+}
+
+oslo_inline void __oslo_physics_fx_set_normal(oslo_physics_manifold_t* m, fx16_vec2 normal)
+{
+    m->fx_normal = normal;
+    m->normal = fx16_vec2_to_vec2(normal);
+}
+
+oslo_inline void __oslo_physics_fx_set_point(oslo_physics_manifold_t* m, u32 index, fx16_vec2 position, fx16 penetration, u32 id)
+{
+    oslo_physics_contact_point_t* point = &m->points[index];
+    point->position = v2(__oslo_physics_from_fx(position.x), __oslo_physics_from_fx(position.y));
+    point->penetration = __oslo_physics_from_fx(penetration);
+    point->fx_penetration = penetration;
+    point->id = id;
+}
+
+oslo_inline void __oslo_physics_fx_circle_point(oslo_physics_manifold_t* m, fx16_vec2 normal, fx16_vec2 center, fx16 radius, fx16 penetration)
+{
+    __oslo_physics_fx_set_normal(m, normal);
+    m->point_count = 1;
+    __oslo_physics_fx_set_point(m, 0, fx16_vec2_sub(center, fx16_vec2_scale(normal, radius - (penetration >> 1))), penetration, 0);
+}
+
+bool __oslo_physics_fx_collide_circles(const __oslo_physics_fx_collider_t* a, const __oslo_physics_fx_collider_t* b, oslo_physics_manifold_t* m)
+{
+    fx16_vec2 ca = fx16_vec2_add(a->position, __oslo_physics_to_fx_vec2(a->shape->circle.center));
+    fx16_vec2 cb = fx16_vec2_add(b->position, __oslo_physics_to_fx_vec2(b->shape->circle.center));
+    fx16 radius_b = __oslo_physics_to_fx(b->shape->circle.radius);
+    fx16 radius = __oslo_physics_to_fx(a->shape->circle.radius) + radius_b;
+    fx16_vec2 d = fx16_vec2_sub(cb, ca);
+    if (__oslo_physics_fx_len_sq(d) > (s64)radius * radius)
+    {
+        return false;
+    }
+
+    fx16 dist = fx16_vec2_len(d);
+    fx16_vec2 normal = dist > 0 ? fx16_vec2_ctor(fx16_div(d.x, dist), fx16_div(d.y, dist)) : fx16_vec2_ctor(0, FX16_ONE);
+    __oslo_physics_fx_circle_point(m, normal, cb, radius_b, radius - dist);
+    return true;
+}
+
+bool __oslo_physics_fx_collide_box_circle(const __oslo_physics_fx_collider_t* a, const __oslo_physics_fx_collider_t* b, oslo_physics_manifold_t* m)
+{
+    fx16_vec2 half = __oslo_physics_to_fx_vec2(a->shape->box.half_size);
+    fx16_vec2 center = fx16_vec2_add(b->position, __oslo_physics_to_fx_vec2(b->shape->circle.center));
+    fx16 radius = __oslo_physics_to_fx(b->shape->circle.radius);
+    fx16_vec2 d = fx16_vec2_sub(center, fx16_vec2_add(a->position, __oslo_physics_to_fx_vec2(a->shape->box.center)));
+    fx16_vec2 closest = fx16_vec2_ctor(__oslo_physics_fx_clamp(d.x, -half.x, half.x), __oslo_physics_fx_clamp(d.y, -half.y, half.y));
+
+    if (closest.x == d.x && closest.y == d.y)
+    {
+        // Center inside the box, push out through the nearest face
+        fx16 dx = half.x - fx16_abs(d.x);
+        fx16 dy = half.y - fx16_abs(d.y);
+        if (dx < dy)
+        {
+            __oslo_physics_fx_circle_point(m, fx16_vec2_ctor(d.x < 0 ? -FX16_ONE : FX16_ONE, 0), center, radius, radius + dx);
+        }
+        else
+        {
+            __oslo_physics_fx_circle_point(m, fx16_vec2_ctor(0, d.y < 0 ? -FX16_ONE : FX16_ONE), center, radius, radius + dy);
+        }
+        return true;
+    }
+
+    fx16_vec2 delta = fx16_vec2_sub(d, closest);
+    if (__oslo_physics_fx_len_sq(delta) > (s64)radius * radius)
+    {
+        return false;
+    }
+
+    fx16 dist = fx16_vec2_len(delta);
+    __oslo_physics_fx_circle_point(m, fx16_vec2_ctor(fx16_div(delta.x, dist), fx16_div(delta.y, dist)), center, radius, radius - dist);
+    return true;
+}
+
+bool __oslo_physics_fx_collide_boxes(const __oslo_physics_fx_collider_t* a, const __oslo_physics_fx_collider_t* b, oslo_physics_manifold_t* m)
+{
+    fx16_vec2 ca = fx16_vec2_add(a->position, __oslo_physics_to_fx_vec2(a->shape->box.center));
+    fx16_vec2 cb = fx16_vec2_add(b->position, __oslo_physics_to_fx_vec2(b->shape->box.center));
+    fx16_vec2 ha = __oslo_physics_to_fx_vec2(a->shape->box.half_size);
+    fx16_vec2 hb = __oslo_physics_to_fx_vec2(b->shape->box.half_size);
+    fx16_vec2 d = fx16_vec2_sub(cb, ca);
+    fx16 overlap_x = ha.x + hb.x - fx16_abs(d.x);
+    fx16 overlap_y = ha.y + hb.y - fx16_abs(d.y);
+    if (overlap_x < 0 || overlap_y < 0)
+    {
+        return false;
+    }
+
+    u32 axis = overlap_y < overlap_x;
+    fx16 sign = (axis ? d.y : d.x) < 0 ? -1 : 1;
+    fx16 penetration = axis ? overlap_y : overlap_x;
+    fx16 face = axis ? ca.y + sign * (ha.y - (penetration >> 1)) : ca.x + sign * (ha.x - (penetration >> 1));
+    fx16 lo = axis ? __oslo_physics_fx_max(ca.x - ha.x, cb.x - hb.x) : __oslo_physics_fx_max(ca.y - ha.y, cb.y - hb.y);
+    fx16 hi = axis ? __oslo_physics_fx_min(ca.x + ha.x, cb.x + hb.x) : __oslo_physics_fx_min(ca.y + ha.y, cb.y + hb.y);
+
+    __oslo_physics_fx_set_normal(m, axis ? fx16_vec2_ctor(0, sign * FX16_ONE) : fx16_vec2_ctor(sign * FX16_ONE, 0));
+    m->point_count = hi > lo ? 2 : 1;
+    for (u32 i = 0; i < m->point_count; ++i)
+    {
+        fx16 along = i ? hi : lo;
+        __oslo_physics_fx_set_point(m, i, axis ? fx16_vec2_ctor(along, face) : fx16_vec2_ctor(face, along), penetration, __oslo_physics_contact_id(0, axis, i));
+    }
+    return true;
+}
+
+// Polygon normals are rebuilt from the fixed vertices, the float ones went through sqrtf
+void __oslo_physics_fx_world_polygon(const __oslo_physics_fx_collider_t* body, __oslo_physics_fx_polygon_t* out)
+{
+    if (body->shape->type == Box2D)
+    {
+        fx16_vec2 c = fx16_vec2_add(body->position, __oslo_physics_to_fx_vec2(body->shape->box.center));
+        fx16_vec2 h = __oslo_physics_to_fx_vec2(body->shape->box.half_size);
+        out->count = 4;
+        out->vertices[0] = fx16_vec2_ctor(c.x - h.x, c.y - h.y);
+        out->vertices[1] = fx16_vec2_ctor(c.x + h.x, c.y - h.y);
+        out->vertices[2] = fx16_vec2_ctor(c.x + h.x, c.y + h.y);
+        out->vertices[3] = fx16_vec2_ctor(c.x - h.x, c.y + h.y);
+        out->normals[0] = fx16_vec2_ctor(0, -FX16_ONE);
+        out->normals[1] = fx16_vec2_ctor(FX16_ONE, 0);
+        out->normals[2] = fx16_vec2_ctor(0, FX16_ONE);
+        out->normals[3] = fx16_vec2_ctor(-FX16_ONE, 0);
+        return;
+    }
+
+    const oslo_physics_polygon_t* polygon = &body->shape->polygon;
+    out->count = polygon->count;
+    for (u32 i = 0; i < polygon->count; ++i)
+    {
+        out->vertices[i] = fx16_vec2_add(body->position, __oslo_physics_to_fx_vec2(polygon->vertices[i]));
+    }
+    for (u32 i = 0; i < polygon->count; ++i)
+    {
+        fx16_vec2 edge = fx16_vec2_sub(out->vertices[(i + 1) % polygon->count], out->vertices[i]);
+        out->normals[i] = fx16_vec2_norm(fx16_vec2_ctor(edge.y, -edge.x));
+    }
+}
+
+fx16 __oslo_physics_fx_max_separation(const __oslo_physics_fx_polygon_t* a, const __oslo_physics_fx_polygon_t* b, u32* out_edge)
+{
+    fx16 best = FX16_MIN;
+    *out_edge = 0;
+    for (u32 i = 0; i < a->count; ++i)
+    {
+        fx16 separation = FX16_MAX;
+        for (u32 j = 0; j < b->count; ++j)
+        {
+            fx16 s = fx16_vec2_dot(a->normals[i], fx16_vec2_sub(b->vertices[j], a->vertices[i]));
+            separation = __oslo_physics_fx_min(separation, s);
+        }
+        if (separation > best)
+        {
+            best = separation;
+            *out_edge = i;
+        }
+    }
+    return best;
+}
+
+u32 __oslo_physics_fx_clip_segment(fx16_vec2 out[2], u32 out_ids[2], const fx16_vec2 in[2], const u32 in_ids[2], fx16_vec2 normal, fx16 offset)
+{
+    u32 count = 0;
+    fx16 d0 = fx16_vec2_dot(normal, in[0]) - offset;
+    fx16 d1 = fx16_vec2_dot(normal, in[1]) - offset;
+    if (d0 <= 0)
+    {
+        out[count] = in[0];
+        out_ids[count++] = in_ids[0];
+    }
+    if (d1 <= 0)
+    {
+        out[count] = in[1];
+        out_ids[count++] = in_ids[1];
+    }
+    if ((d0 < 0 && d1 > 0) || (d0 > 0 && d1 < 0))
+    {
+        out[count] = fx16_vec2_add(in[0], fx16_vec2_scale(fx16_vec2_sub(in[1], in[0]), fx16_div(d0, d0 - d1)));
+        out_ids[count++] = (d0 > 0 ? in_ids[0] : in_ids[1]) | 0x80;
+    }
+    return count;
+}
+
+bool __oslo_physics_fx_collide_polygons(const __oslo_physics_fx_polygon_t* a, const __oslo_physics_fx_polygon_t* b, oslo_physics_manifold_t* m)
+{
+    u32 edge_a, edge_b;
+    fx16 separation_a = __oslo_physics_fx_max_separation(a, b, &edge_a);
+    if (separation_a > 0)
+    {
+        return false;
+    }
+    fx16 separation_b = __oslo_physics_fx_max_separation(b, a, &edge_b);
+    if (separation_b > 0)
+    {
+        return false;
+    }
+
+    const __oslo_physics_fx_polygon_t* ref = a;
+    const __oslo_physics_fx_polygon_t* inc = b;
+    u32 ref_edge = edge_a;
+    u32 flip = 0;
+    if (separation_b > fx16_mul(fx16_from_f32(0.98f), separation_a) + __oslo_physics_to_fx(0.001f))
+    {
+        ref = b;
+        inc = a;
+        ref_edge = edge_b;
+        flip = 1;
+    }
+
+    fx16_vec2 normal = ref->normals[ref_edge];
+    u32 inc_edge = 0;
+    fx16 min_dot = FX16_MAX;
+    for (u32 i = 0; i < inc->count; ++i)
+    {
+        fx16 d = fx16_vec2_dot(normal, inc->normals[i]);
+        if (d < min_dot)
+        {
+            min_dot = d;
+            inc_edge = i;
+        }
+    }
+
+    u32 inc_next = (inc_edge + 1) % inc->count;
+    fx16_vec2 incident[2] = { inc->vertices[inc_edge], inc->vertices[inc_next] };
+    u32 ids[2] = { inc_edge, inc_next };
+    fx16_vec2 v1 = ref->vertices[ref_edge];
+    fx16_vec2 v2_ = ref->vertices[(ref_edge + 1) % ref->count];
+    fx16_vec2 tangent = fx16_vec2_norm(fx16_vec2_sub(v2_, v1));
+
+    fx16_vec2 clip1[2], clip2[2];
+    u32 ids1[2], ids2[2];
+    if (__oslo_physics_fx_clip_segment(clip1, ids1, incident, ids, fx16_vec2_ctor(-tangent.x, -tangent.y), -fx16_vec2_dot(tangent, v1)) < 2)
+    {
+        return false;
+    }
+    if (__oslo_physics_fx_clip_segment(clip2, ids2, clip1, ids1, tangent, fx16_vec2_dot(tangent, v2_)) < 2)
+    {
+        return false;
+    }
+
+    fx16 front = fx16_vec2_dot(normal, v1);
+    __oslo_physics_fx_set_normal(m, flip ? fx16_vec2_ctor(-normal.x, -normal.y) : normal);
+    m->point_count = 0;
+    for (u32 i = 0; i < 2; ++i)
+    {
+        fx16 separation = fx16_vec2_dot(normal, clip2[i]) - front;
+        if (separation <= 0)
+        {
+            fx16_vec2 position = fx16_vec2_sub(clip2[i], fx16_vec2_scale(normal, separation >> 1));
+            __oslo_physics_fx_set_point(m, m->point_count++, position, -separation, __oslo_physics_contact_id(flip, ref_edge, ids2[i]));
+        }
+    }
+    return m->point_count > 0;
+}
+
+bool __oslo_physics_fx_collide_polygon_circle(const __oslo_physics_fx_polygon_t* polygon, fx16_vec2 center, fx16 radius, oslo_physics_manifold_t* m)
+{
+    fx16 separation = FX16_MIN;
+    u32 edge = 0;
+    for (u32 i = 0; i < polygon->count; ++i)
+    {
+        fx16 s = fx16_vec2_dot(polygon->normals[i], fx16_vec2_sub(center, polygon->vertices[i]));
+        if (s > radius)
+        {
+            return false;
+        }
+        if (s > separation)
+        {
+            separation = s;
+            edge = i;
+        }
+    }
+
+    fx16_vec2 v1 = polygon->vertices[edge];
+    fx16_vec2 v2_ = polygon->vertices[(edge + 1) % polygon->count];
+    fx16_vec2 corner = v1;
+    bool vertex = false;
+    if (separation > 0)
+    {
+        if (fx16_vec2_dot(fx16_vec2_sub(center, v1), fx16_vec2_sub(v2_, v1)) <= 0)
+        {
+            vertex = true;
+        }
+        else if (fx16_vec2_dot(fx16_vec2_sub(center, v2_), fx16_vec2_sub(v1, v2_)) <= 0)
+        {
+            corner = v2_;
+            vertex = true;
+        }
+    }
+
+    if (!vertex)
+    {
+        __oslo_physics_fx_circle_point(m, polygon->normals[edge], center, radius, radius - separation);
+        return true;
+    }
+
+    fx16_vec2 d = fx16_vec2_sub(center, corner);
+    if (__oslo_physics_fx_len_sq(d) > (s64)radius * radius)
+    {
+        return false;
+    }
+
+    fx16 dist = fx16_vec2_len(d);
+    fx16_vec2 normal = dist > 0 ? fx16_vec2_ctor(fx16_div(d.x, dist), fx16_div(d.y, dist)) : polygon->normals[edge];
+    __oslo_physics_fx_circle_point(m, normal, center, radius, radius - dist);
+    return true;
+}
+
+bool __oslo_physics_fx_collide_colliders(const __oslo_physics_fx_collider_t* a, const __oslo_physics_fx_collider_t* b, oslo_physics_manifold_t* m)
+{
+    if (a->shape->type > b->shape->type)
+    {
+        bool hit = __oslo_physics_fx_collide_colliders(b, a, m);
+        __oslo_physics_fx_set_normal(m, fx16_vec2_ctor(-m->fx_normal.x, -m->fx_normal.y));
+        return hit;
+    }
+
+    memset(m, 0, sizeof(*m));
+
+    __oslo_physics_fx_polygon_t pa, pb;
+    switch (a->shape->type)
+    {
+        case Box2D:
+            if (b->shape->type == Box2D)
+            {
+                return __oslo_physics_fx_collide_boxes(a, b, m);
+            }
+            if (b->shape->type == Circle)
+            {
+                return __oslo_physics_fx_collide_box_circle(a, b, m);
+            }
+            break;
+        case Circle:
+            if (b->shape->type == Circle)
+            {
+                return __oslo_physics_fx_collide_circles(a, b, m);
+            }
+            __oslo_physics_fx_world_polygon(b, &pb);
+            if (__oslo_physics_fx_collide_polygon_circle(&pb, fx16_vec2_add(a->position, __oslo_physics_to_fx_vec2(a->shape->circle.center)), __oslo_physics_to_fx(a->shape->circle.radius), m))
+            {
+                __oslo_physics_fx_set_normal(m, fx16_vec2_ctor(-m->fx_normal.x, -m->fx_normal.y));
+                return true;
+            }
+            return false;
+        default:
+            break;
+    }
+
+    __oslo_physics_fx_world_polygon(a, &pa);
+    __oslo_physics_fx_world_polygon(b, &pb);
+    return __oslo_physics_fx_collide_polygons(&pa, &pb, m);
+}
+#endif
+
+bool __oslo_physics_collide_bodies(const oslo_physics_bodies_t* bodies, u32 ia, u32 ib, oslo_physics_manifold_t* m)
+{
+    if (!bodies->has_shape[ia] || !bodies->has_shape[ib])
+    {
+        memset(m, 0, sizeof(*m));
+        return false;
+    }
+
+#ifdef OSLO_PHYSICS_FIXED_POINT
+    __oslo_physics_fx_collider_t a = { fx16_vec2_ctor(bodies->fx_position_x[ia], bodies->fx_position_y[ia]), &bodies->shape[ia] };
+    __oslo_physics_fx_collider_t b = { fx16_vec2_ctor(bodies->fx_position_x[ib], bodies->fx_position_y[ib]), &bodies->shape[ib] };
+    bool hit = __oslo_physics_fx_collide_colliders(&a, &b, m);
+#else
+    __oslo_physics_collider_t a = { v2(bodies->position.x[ia], bodies->position.y[ia]), &bodies->shape[ia] };
+    __oslo_physics_collider_t b = { v2(bodies->position.x[ib], bodies->position.y[ib]), &bodies->shape[ib] };
+    bool hit = __oslo_physics_collide_colliders(&a, &b, m);
+#endif
+    m->a = bodies->handles[ia];
+    m->b = bodies->handles[ib];
+    return hit;
+}
+
+bool oslo_physics_collide(const oslo_physics_t* physics, oslo_physics_body_handle a, oslo_physics_body_handle b, oslo_physics_manifold_t* out_manifold)
+{
+    u32 ia = oslo_physics_body_index(physics, a);
+    u32 ib = oslo_physics_body_index(physics, b);
+    if (ia == UINT32_MAX || ib == UINT32_MAX)
+    {
+        memset(out_manifold, 0, sizeof(*out_manifold));
+        return false;
+    }
+    return __oslo_physics_collide_bodies(&physics->bodies, ia, ib, out_manifold);
+}
+
+// Manifolds of the broadphase pairs that touch are refreshed, impulses carried over by point id, and pairs
+// that stopped touching are dropped
+void __oslo_physics_narrowphase(oslo_physics_t* physics)
+{
+    physics->step++;
+    oslo_dyn_array_clear(physics->contacts);
+    oslo_dyn_array_clear(physics->manifold_keys);
+
+    u32 pair_count = (u32)oslo_dyn_array_size(physics->pairs);
+    for (u32 p = 0; p < pair_count; ++p)
+    {
+        oslo_physics_pair_t key = physics->pairs[p];
+        if (key.b < key.a)
+        {
+            key.a = physics->pairs[p].b;
+            key.b = physics->pairs[p].a;
+        }
+
+        oslo_physics_manifold_t manifold;
+        u32 ia = physics->bodies.indices[oslo_slot_array_handle_index(key.a)];
+        u32 ib = physics->bodies.indices[oslo_slot_array_handle_index(key.b)];
+        if (!__oslo_physics_collide_bodies(&physics->bodies, ia, ib, &manifold))
+        {
+            continue;
+        }
+        manifold.step = physics->step;
+
+        oslo_physics_manifold_t* cached = physics->manifolds ? oslo_hash_table_getp(physics->manifolds, key) : NULL;
+        if (cached)
+        {
+            for (u32 i = 0; i < manifold.point_count; ++i)
+            {
+                for (u32 j = 0; j < cached->point_count; ++j)
+                {
+                    if (manifold.points[i].id == cached->points[j].id)
+                    {
+                        manifold.points[i].normal_impulse = cached->points[j].normal_impulse;
+                        manifold.points[i].tangent_impulse = cached->points[j].tangent_impulse;
+#ifdef OSLO_PHYSICS_FIXED_POINT
+                        manifold.points[i].fx_normal_impulse = cached->points[j].fx_normal_impulse;
+                        manifold.points[i].fx_tangent_impulse = cached->points[j].fx_tangent_impulse;
+#endif
+                        break;
+                    }
+                }
+            }
+            *cached = manifold;
+        }
+        else
+        {
+            oslo_hash_table_insert(physics->manifolds, key, manifold);
+        }
+        oslo_dyn_array_push(physics->manifold_keys, key);
+    }
+
+    // Inserts may have moved the entries, so the pointers are taken once all of them are in. Erasing doesn't move them.
+    // They go out sorted by pair, the solver is order dependent and the order pairs come out of the broadphase isn't
+    // stable: it changes with the broadphase type and with the float rounding of the tree's fattened boxes.
+    // The broadphase is done with its cell buffers, they do the radix sort.
+    u32 touching = (u32)oslo_dyn_array_size(physics->manifold_keys);
+    oslo_dyn_array_clear(physics->bp_cells);
+    for (u32 k = 0; k < touching; ++k)
+    {
+        oslo_physics_pair_t key = physics->manifold_keys[k];
+        oslo_physics_cell_entry_t entry = { ((u64)key.a << 32) | key.b, k };
+        oslo_dyn_array_push(physics->bp_cells, entry);
+    }
+    oslo_dyn_array_reserve(physics->bp_cells_tmp, touching);
+    oslo_physics_cell_entry_t* sorted = touching ? __oslo_physics_sort_cells(physics->bp_cells, physics->bp_cells_tmp, touching) : NULL;
+    for (u32 k = 0; k < touching; ++k)
+    {
+        oslo_dyn_array_push(physics->contacts, oslo_hash_table_getp(physics->manifolds, physics->manifold_keys[sorted[k].body]));
+    }
+
+    oslo_dyn_array_clear(physics->manifold_keys);
+    for (oslo_hash_table_iter it = oslo_hash_table_iter_new(physics->manifolds); oslo_hash_table_iter_valid(physics->manifolds, it); oslo_hash_table_iter_advance(physics->manifolds, it))
+    {
+        if (oslo_hash_table_iter_getp(physics->manifolds, it)->step != physics->step)
+        {
+            oslo_dyn_array_push(physics->manifold_keys, oslo_hash_table_iter_getk(physics->manifolds, it));
+        }
+    }
+    u32 stale = (u32)oslo_dyn_array_size(physics->manifold_keys);
+    for (u32 k = 0; k < stale; ++k)
+    {
+        oslo_hash_table_erase(physics->manifolds, physics->manifold_keys[k]);
+    }
+}
+
+//=============================
+// Islands
+//=============================
+
+oslo_inline u32 __oslo_physics_island_find(u32* parents, u32 i)
+{
+    while (parents[i] != i)
+    {
+        parents[i] = parents[parents[i]];
+        i = parents[i];
+    }
+    return i;
+}
+
+// The island of a contact is the one of its dynamic body, contacts between two static bodies have none
+oslo_inline u32 __oslo_physics_contact_root(oslo_physics_t* physics, const oslo_physics_manifold_t* m)
+{
+    const oslo_physics_bodies_t* bodies = &physics->bodies;
+    u32 ia = bodies->indices[oslo_slot_array_handle_index(m->a)];
+    u32 ib = bodies->indices[oslo_slot_array_handle_index(m->b)];
+    u32 dynamic = bodies->inv_mass[ia] != 0.0f ? ia : ib;
+    if (bodies->inv_mass[dynamic] == 0.0f)
+    {
+        return UINT32_MAX;
+    }
+    return __oslo_physics_island_find(physics->island_parents, dynamic);
+}
+
+// Union find over the contacts, then contacts and bodies are bucketed by island. Islands are numbered in the
+// order their first contact shows up, and everything inside keeps contact and body order, so the grouping only
+// depends on the contacts and not on who solves them.
+void __oslo_physics_build_islands(oslo_physics_t* physics)
+{
+    oslo_physics_bodies_t* bodies = &physics->bodies;
+    u32 n = bodies->count;
+    u32 contact_count = (u32)oslo_dyn_array_size(physics->contacts);
+    oslo_dyn_array_clear(physics->islands);
+    oslo_dyn_array_clear(physics->island_contacts);
+    oslo_dyn_array_clear(physics->island_bodies);
+    if (contact_count == 0)
+    {
+        return;
+    }
+
+    oslo_dyn_array_reserve(physics->island_parents, n);
+    oslo_dyn_array_reserve(physics->island_ids, n);
+    oslo_dyn_array_head(physics->island_parents)->size = n;
+    oslo_dyn_array_head(physics->island_ids)->size = n;
+    u32* parents = physics->island_parents;
+    u32* ids = physics->island_ids;
+    for (u32 i = 0; i < n; ++i)
+    {
+        parents[i] = i;
+        ids[i] = UINT32_MAX;
+    }
+
+    for (u32 c = 0; c < contact_count; ++c)
+    {
+        const oslo_physics_manifold_t* m = physics->contacts[c];
+        u32 ia = bodies->indices[oslo_slot_array_handle_index(m->a)];
+        u32 ib = bodies->indices[oslo_slot_array_handle_index(m->b)];
+        if (bodies->inv_mass[ia] == 0.0f || bodies->inv_mass[ib] == 0.0f)
+        {
+            continue;
+        }
+        u32 ra = __oslo_physics_island_find(parents, ia);
+        u32 rb = __oslo_physics_island_find(parents, ib);
+        if (ra != rb)
+        {
+            parents[oslo_max(ra, rb)] = ra < rb ? ra : rb;
+        }
+    }
+
+    // Count the contacts of each island, numbering islands on the way
+    for (u32 c = 0; c < contact_count; ++c)
+    {
+        u32 root = __oslo_physics_contact_root(physics, physics->contacts[c]);
+        if (root == UINT32_MAX)
+        {
+            continue;
+        }
+        if (ids[root] == UINT32_MAX)
+        {
+            ids[root] = (u32)oslo_dyn_array_size(physics->islands);
+            oslo_physics_island_t island = {0};
+            oslo_dyn_array_push(physics->islands, island);
+        }
+        physics->islands[ids[root]].contact_count++;
+    }
+
+    u32 island_count = (u32)oslo_dyn_array_size(physics->islands);
+    for (u32 i = 0; i < n; ++i)
+    {
+        if (bodies->inv_mass[i] != 0.0f)
+        {
+            u32 id = ids[__oslo_physics_island_find(parents, i)];
+            if (id != UINT32_MAX)
+            {
+                physics->islands[id].body_count++;
+            }
+        }
+    }
+
+    // Prefix sums give the ranges, the counts are rebuilt while filling
+    u32 contact_start = 0;
+    u32 body_start = 0;
+    for (u32 k = 0; k < island_count; ++k)
+    {
+        oslo_physics_island_t* island = &physics->islands[k];
+        island->contact_start = contact_start;
+        island->body_start = body_start;
+        contact_start += island->contact_count;
+        body_start += island->body_count;
+        island->contact_count = 0;
+        island->body_count = 0;
+    }
+
+    oslo_dyn_array_reserve(physics->island_contacts, contact_start);
+    oslo_dyn_array_reserve(physics->island_bodies, body_start);
+    oslo_dyn_array_head(physics->island_contacts)->size = contact_start;
+    oslo_dyn_array_head(physics->island_bodies)->size = body_start;
+
+    for (u32 c = 0; c < contact_count; ++c)
+    {
+        u32 root = __oslo_physics_contact_root(physics, physics->contacts[c]);
+        if (root != UINT32_MAX)
+        {
+            oslo_physics_island_t* island = &physics->islands[ids[root]];
+            physics->island_contacts[island->contact_start + island->contact_count++] = physics->contacts[c];
+        }
+    }
+    for (u32 i = 0; i < n; ++i)
+    {
+        if (bodies->inv_mass[i] != 0.0f)
+        {
+            u32 id = ids[__oslo_physics_island_find(parents, i)];
+            if (id != UINT32_MAX)
+            {
+                oslo_physics_island_t* island = &physics->islands[id];
+                physics->island_bodies[island->body_start + island->body_count++] = i;
+            }
+        }
+    }
+}
+
+#ifdef OSLO_PHYSICS_FIXED_POINT
+oslo_inline void __oslo_physics_apply_impulse(oslo_physics_bodies_t* bodies, u32 ia, u32 ib, fx16_vec2 impulse)
+{
+    fx16 ima = bodies->fx_inv_mass[ia];
+    fx16 imb = bodies->fx_inv_mass[ib];
+    if (ima != 0)
+    {
+        bodies->fx_velocity_x[ia] -= fx16_mul(impulse.x, ima);
+        bodies->fx_velocity_y[ia] -= fx16_mul(impulse.y, ima);
+    }
+    if (imb != 0)
+    {
+        bodies->fx_velocity_x[ib] += fx16_mul(impulse.x, imb);
+        bodies->fx_velocity_y[ib] += fx16_mul(impulse.y, imb);
+    }
+}
+
+oslo_inline fx16_vec2 __oslo_physics_relative_velocity(const oslo_physics_bodies_t* bodies, u32 ia, u32 ib)
+{
+    return fx16_vec2_ctor(bodies->fx_velocity_x[ib] - bodies->fx_velocity_x[ia], bodies->fx_velocity_y[ib] - bodies->fx_velocity_y[ia]);
+}
+
+// Velocities, impulses and contact data all in fx16 meters, so the solve is as exact as the integrator
+void __oslo_physics_solve_contacts(oslo_physics_t* physics, const oslo_physics_island_t* island, float dt)
+{
+    oslo_physics_bodies_t* bodies = &physics->bodies;
+    oslo_physics_manifold_t** contacts = physics->island_contacts + island->contact_start;
+    fx16 fx_dt = fx16_from_f32(dt);
+    fx16 bias_factor = fx_dt > 0 ? fx16_div(fx16_from_f32(physics->baumgarte), fx_dt) : 0;
+    fx16 slop = __oslo_physics_to_fx(physics->penetration_slop);
+    fx16 friction = fx16_from_f32(physics->friction);
+
+    for (u32 c = 0; c < island->contact_count; ++c)
+    {
+        oslo_physics_manifold_t* m = contacts[c];
+        u32 ia = bodies->indices[oslo_slot_array_handle_index(m->a)];
+        u32 ib = bodies->indices[oslo_slot_array_handle_index(m->b)];
+        fx16_vec2 tangent = fx16_vec2_ctor(-m->fx_normal.y, m->fx_normal.x);
+        for (u32 p = 0; p < m->point_count; ++p)
+        {
+            const oslo_physics_contact_point_t* point = &m->points[p];
+            fx16_vec2 impulse = fx16_vec2_add(fx16_vec2_scale(m->fx_normal, point->fx_normal_impulse), fx16_vec2_scale(tangent, point->fx_tangent_impulse));
+            __oslo_physics_apply_impulse(bodies, ia, ib, impulse);
+        }
+    }
+
+    for (u32 it = 0; it < physics->velocity_iterations; ++it)
+    {
+        for (u32 c = 0; c < island->contact_count; ++c)
+        {
+            oslo_physics_manifold_t* m = contacts[c];
+            u32 ia = bodies->indices[oslo_slot_array_handle_index(m->a)];
+            u32 ib = bodies->indices[oslo_slot_array_handle_index(m->b)];
+            fx16 inv_mass = bodies->fx_inv_mass[ia] + bodies->fx_inv_mass[ib];
+            if (inv_mass == 0)
+            {
+                continue;
+            }
+            fx16 mass = fx16_div(FX16_ONE, inv_mass);
+            fx16_vec2 tangent = fx16_vec2_ctor(-m->fx_normal.y, m->fx_normal.x);
+
+            for (u32 p = 0; p < m->point_count; ++p)
+            {
+                oslo_physics_contact_point_t* point = &m->points[p];
+
+                fx16_vec2 dv = __oslo_physics_relative_velocity(bodies, ia, ib);
+                fx16 limit = fx16_mul(friction, point->fx_normal_impulse);
+                fx16 tangent_impulse = __oslo_physics_fx_clamp(point->fx_tangent_impulse - fx16_mul(fx16_vec2_dot(dv, tangent), mass), -limit, limit);
+                __oslo_physics_apply_impulse(bodies, ia, ib, fx16_vec2_scale(tangent, tangent_impulse - point->fx_tangent_impulse));
+                point->fx_tangent_impulse = tangent_impulse;
+
+                dv = __oslo_physics_relative_velocity(bodies, ia, ib);
+                fx16 bias = fx16_mul(bias_factor, __oslo_physics_fx_max(point->fx_penetration - slop, 0));
+                fx16 normal_impulse = __oslo_physics_fx_max(point->fx_normal_impulse + fx16_mul(bias - fx16_vec2_dot(dv, m->fx_normal), mass), 0);
+                __oslo_physics_apply_impulse(bodies, ia, ib, fx16_vec2_scale(m->fx_normal, normal_impulse - point->fx_normal_impulse));
+                point->fx_normal_impulse = normal_impulse;
+            }
+        }
+    }
+
+    // Refresh the float copies
+    for (u32 c = 0; c < island->contact_count; ++c)
+    {
+        oslo_physics_manifold_t* m = contacts[c];
+        for (u32 p = 0; p < m->point_count; ++p)
+        {
+            m->points[p].normal_impulse = __oslo_physics_from_fx(m->points[p].fx_normal_impulse);
+            m->points[p].tangent_impulse = __oslo_physics_from_fx(m->points[p].fx_tangent_impulse);
+        }
+    }
+    const u32* island_bodies = physics->island_bodies + island->body_start;
+    for (u32 b = 0; b < island->body_count; ++b)
+    {
+        u32 i = island_bodies[b];
+        bodies->velocity.x[i] = __oslo_physics_from_fx(bodies->fx_velocity_x[i]);
+        bodies->velocity.y[i] = __oslo_physics_from_fx(bodies->fx_velocity_y[i]);
+    }
+}
+#else
+oslo_inline void __oslo_physics_apply_impulse(oslo_physics_bodies_t* bodies, u32 ia, u32 ib, vec2 impulse)
+{
+    float ima = bodies->inv_mass[ia];
+    float imb = bodies->inv_mass[ib];
+    if (ima != 0.0f)
+    {
+        bodies->velocity.x[ia] -= impulse.x * ima;
+        bodies->velocity.y[ia] -= impulse.y * ima;
+    }
+    if (imb != 0.0f)
+    {
+        bodies->velocity.x[ib] += impulse.x * imb;
+        bodies->velocity.y[ib] += impulse.y * imb;
+    }
+}
+
+void __oslo_physics_solve_contacts(oslo_physics_t* physics, const oslo_physics_island_t* island, float dt)
+{
+    oslo_physics_bodies_t* bodies = &physics->bodies;
+    oslo_physics_manifold_t** contacts = physics->island_contacts + island->contact_start;
+    float bias_factor = dt > 0.0f ? physics->baumgarte / dt : 0.0f;
+
+    for (u32 c = 0; c < island->contact_count; ++c)
+    {
+        oslo_physics_manifold_t* m = contacts[c];
+        u32 ia = bodies->indices[oslo_slot_array_handle_index(m->a)];
+        u32 ib = bodies->indices[oslo_slot_array_handle_index(m->b)];
+        vec2 tangent = v2(-m->normal.y, m->normal.x);
+        for (u32 p = 0; p < m->point_count; ++p)
+        {
+            const oslo_physics_contact_point_t* point = &m->points[p];
+            vec2 impulse = vec2_add(vec2_scale(m->normal, point->normal_impulse), vec2_scale(tangent, point->tangent_impulse));
+            __oslo_physics_apply_impulse(bodies, ia, ib, impulse);
+        }
+    }
+
+    for (u32 it = 0; it < physics->velocity_iterations; ++it)
+    {
+        for (u32 c = 0; c < island->contact_count; ++c)
+        {
+            oslo_physics_manifold_t* m = contacts[c];
+            u32 ia = bodies->indices[oslo_slot_array_handle_index(m->a)];
+            u32 ib = bodies->indices[oslo_slot_array_handle_index(m->b)];
+            float inv_mass = bodies->inv_mass[ia] + bodies->inv_mass[ib];
+            if (inv_mass == 0.0f)
+            {
+                continue;
+            }
+            float mass = 1.0f / inv_mass;
+            vec2 tangent = v2(-m->normal.y, m->normal.x);
+
+            for (u32 p = 0; p < m->point_count; ++p)
+            {
+                oslo_physics_contact_point_t* point = &m->points[p];
+
+                // Friction first, bounded by the normal impulse so far
+                vec2 dv = v2(bodies->velocity.x[ib] - bodies->velocity.x[ia], bodies->velocity.y[ib] - bodies->velocity.y[ia]);
+                float limit = physics->friction * point->normal_impulse;
+                float tangent_impulse = fminf(fmaxf(point->tangent_impulse - vec2_dot(dv, tangent) * mass, -limit), limit);
+                __oslo_physics_apply_impulse(bodies, ia, ib, vec2_scale(tangent, tangent_impulse - point->tangent_impulse));
+                point->tangent_impulse = tangent_impulse;
+
+                // The accumulated normal impulse may only push
+                dv = v2(bodies->velocity.x[ib] - bodies->velocity.x[ia], bodies->velocity.y[ib] - bodies->velocity.y[ia]);
+                float bias = bias_factor * fmaxf(point->penetration - physics->penetration_slop, 0.0f);
+                float normal_impulse = fmaxf(point->normal_impulse + (bias - vec2_dot(dv, m->normal)) * mass, 0.0f);
+                __oslo_physics_apply_impulse(bodies, ia, ib, vec2_scale(m->normal, normal_impulse - point->normal_impulse));
+                point->normal_impulse = normal_impulse;
+            }
+        }
+    }
+}
+#endif
+
+// Sequential impulses, warm started from last step's impulses. Only the island's dynamic bodies are written,
+// static ones are read only, so islands can run side by side and each gives the same result on any thread.
+void __oslo_physics_solve_island(oslo_physics_t* physics, oslo_physics_island_t* island, float dt)
+{
+    u64 start = oslo_platform_time_ns();
+    __oslo_physics_solve_contacts(physics, island, dt);
+    island->solve_ns = oslo_platform_time_ns() - start;
+}
+
+typedef struct __oslo_physics_solve_job_t
+{
+    oslo_physics_t* physics;
+    float dt;
+} __oslo_physics_solve_job_t;
+
+void __oslo_physics_solve_batches(u32 start, u32 end, void* data)
+{
+    __oslo_physics_solve_job_t* job = (__oslo_physics_solve_job_t*)data;
+    oslo_physics_t* physics = job->physics;
+    for (u32 b = start; b < end; ++b)
+    {
+        for (u32 k = physics->island_batches[b]; k < physics->island_batches[b + 1]; ++k)
+        {
+            u32 island = (u32)(physics->island_order[k] & 0xFFFFFFFFu);
+            __oslo_physics_solve_island(physics, &physics->islands[island], job->dt);
+        }
+    }
+}
+
+int __oslo_physics_compare_u64(const void* a, const void* b)
+{
+    u64 x = *(const u64*)a;
+    u64 y = *(const u64*)b;
+    return (x > y) - (x < y);
+}
+
+// Islands go out largest first, packed into batches of about equal contact count so one worker doesn't end up
+// with all the big ones. Which worker gets an island doesn't change its result.
+void __oslo_physics_solve(oslo_physics_t* physics, float dt)
+{
+    oslo_physics_solver_stats_t* stats = &physics->solver_stats;
+    memset(stats, 0, sizeof(*stats));
+    u32 island_count = (u32)oslo_dyn_array_size(physics->islands);
+    if (island_count == 0)
+    {
+        return;
+    }
+
+    u64 start = oslo_platform_time_ns();
+    oslo_dyn_array_clear(physics->island_order);
+    for (u32 k = 0; k < island_count; ++k)
+    {
+        // Contact count inverted in the high half, so ascending order is largest first with ties by island index
+        u64 key = ((u64)(0xFFFFFFFFu - physics->islands[k].contact_count) << 32) | k;
+        oslo_dyn_array_push(physics->island_order, key);
+    }
+    qsort(physics->island_order, island_count, sizeof(u64), __oslo_physics_compare_u64);
+
+    u32 workers = oslo_job_worker_count();
+    u32 target = (u32)oslo_dyn_array_size(physics->island_contacts) / (workers * 4);
+    target = oslo_max(target, 64u);
+    oslo_dyn_array_clear(physics->island_batches);
+    oslo_dyn_array_push(physics->island_batches, 0);
+    u32 batch_contacts = 0;
+    for (u32 k = 0; k < island_count; ++k)
+    {
+        batch_contacts += physics->islands[physics->island_order[k] & 0xFFFFFFFFu].contact_count;
+        if (batch_contacts >= target || k + 1 == island_count)
+        {
+            oslo_dyn_array_push(physics->island_batches, k + 1);
+            batch_contacts = 0;
+        }
+    }
+
+    __oslo_physics_solve_job_t job = { physics, dt };
+    oslo_job_parallel_for((u32)oslo_dyn_array_size(physics->island_batches) - 1, 1, __oslo_physics_solve_batches, &job);
+
+    stats->island_count = island_count;
+    stats->solve_ns = oslo_platform_time_ns() - start;
+    for (u32 k = 0; k < island_count; ++k)
+    {
+        stats->largest_island = oslo_max(stats->largest_island, physics->islands[k].body_count);
+        stats->island_ns += physics->islands[k].solve_ns;
+    }
 }
 
-#endif
\ No newline at end of file
+#endif